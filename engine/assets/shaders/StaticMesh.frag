@@ -0,0 +1,14 @@
+#version 450
+
+layout(location = 0) in vec3 inNormal;
+layout(location = 1) in vec2 inTexcoord;
+
+layout(location = 0) out vec4 outColor;
+
+void main()
+{
+    //fixed directional light until materials exist
+    vec3 lightDirection = normalize(vec3(0.4, 1.0, 0.6));
+    float diffuse = max(dot(normalize(inNormal), lightDirection), 0.0);
+    outColor = vec4(vec3(0.15 + 0.85 * diffuse), 1.0);
+}
\ No newline at end of file
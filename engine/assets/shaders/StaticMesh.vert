@@ -0,0 +1,45 @@
+#version 450
+
+//set for quantized vertices: positions are relative to the mesh bounds and normals octahedral
+layout(constant_id = 0) const bool QUANTIZED = false;
+
+layout(location = 0) in vec3 inPosition;
+layout(location = 1) in vec3 inNormal;
+layout(location = 2) in vec2 inTexcoord;
+
+//transforms of every instance drawn this frame, draws select theirs with firstInstance
+layout(std430, set = 0, binding = 0) readonly buffer Instances
+{
+    mat4 models[];
+} instances;
+
+layout(push_constant) uniform PushConstants
+{
+    mat4 viewProjection;
+    vec4 positionScale;
+    vec4 positionOffset;
+} pc;
+
+layout(location = 0) out vec3 outNormal;
+layout(location = 1) out vec2 outTexcoord;
+
+vec3 OctahedralDecode(vec2 _encoded)
+{
+    vec3 normal = vec3(_encoded, 1.0 - abs(_encoded.x) - abs(_encoded.y));
+    float fold = max(-normal.z, 0.0);
+    normal.x += normal.x >= 0.0 ? -fold : fold;
+    normal.y += normal.y >= 0.0 ? -fold : fold;
+    return normalize(normal);
+}
+
+void main()
+{
+    mat4 model = instances.models[gl_InstanceIndex];
+    vec3 position = inPosition * pc.positionScale.xyz + pc.positionOffset.xyz;
+    vec3 normal = QUANTIZED ? OctahedralDecode(inNormal.xy) : inNormal;
+
+    //uniform scale is assumed, non uniform scales would need the inverse transpose
+    outNormal = mat3(model) * normal;
+    outTexcoord = inTexcoord;
+    gl_Position = pc.viewProjection * model * vec4(position, 1.0);
+}
\ No newline at end of file
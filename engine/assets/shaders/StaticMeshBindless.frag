@@ -0,0 +1,20 @@
+#version 450
+#extension GL_EXT_nonuniform_qualifier : require
+
+layout(location = 0) in vec3 inNormal;
+layout(location = 1) in vec2 inTexcoord;
+
+//the bindless table, see VulkanBindlessTable
+layout(set = 1, binding = 0) uniform texture2D textures[];
+layout(set = 1, binding = 1) uniform sampler samplers[3];
+
+layout(location = 0) out vec4 outColor;
+
+void main()
+{
+    //fixed directional light and the default texture until materials exist
+    vec3 lightDirection = normalize(vec3(0.4, 1.0, 0.6));
+    float diffuse = max(dot(normalize(inNormal), lightDirection), 0.0);
+    vec4 albedo = texture(sampler2D(textures[0], samplers[0]), inTexcoord);
+    outColor = vec4(albedo.rgb * (0.15 + 0.85 * diffuse), albedo.a);
+}
\ No newline at end of file
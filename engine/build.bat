@@ -17,5 +17,15 @@ SET includeFlags=-Isource -I%VULKAN_SDK%/Include
 SET linkerFlags=-luser32 -lvulkan-1 -L%VULKAN_SDK%/Lib
 SET defines=-D_DEBUG -DCEXPORT -D_CRT_SECURE_NO_WARNINGS
 
+REM Opt-in instruction sets for the math library, CMATH_SIMD=avx2 targets AVX2 and FMA. SSE2 is the x64 baseline
+IF "%CMATH_SIMD%"=="avx2" SET compilerFlags=%compilerFlags% -mavx2 -mfma
+
 ECHO "Building %assembly%%..."
-clang %cFilenames% %compilerFlags% -o ../bin/%assembly%.dll %defines% %includeFlags% %linkerFlags%
\ No newline at end of file
+clang %cFilenames% %compilerFlags% -o ../bin/%assembly%.dll %defines% %includeFlags% %linkerFlags%
+
+REM Shaders are compiled to SPIR-V next to the binaries, the renderer loads them from assets/shaders
+ECHO "Compiling shaders..."
+IF NOT EXIST ..\bin\assets\shaders mkdir ..\bin\assets\shaders
+FOR %%s in (assets\shaders\*.vert assets\shaders\*.frag assets\shaders\*.comp) do (
+    %VULKAN_SDK%\bin\glslc.exe %%s -o ..\bin\%%s.spv
+)
\ No newline at end of file
@@ -14,8 +14,20 @@ compilerFlags="-g -shared -fdeclspec -fPIC"
 #-fms-extensions
 #-Wall -Werror
 includeFlags="-Isource -I$VULKAN_SDK/include"
-linkerFlags="-lvulkan -lxcb -lX11 -lX11-xcb -lxkbcommon -L$VULKAN_SDK/lib -Lusr/X11r6/lib"
+linkerFlags="-lvulkan -lm -lpthread -lxcb -lxcb-xinput -lX11 -lX11-xcb -lxkbcommon -L$VULKAN_SDK/lib -Lusr/X11r6/lib"
 defines="-D_DEBUG -DCEXPORT"
 
+#opt-in instruction sets for the math library, CMATH_SIMD=avx2 targets AVX2 and FMA. SSE2 is the x64 baseline
+if [ "$CMATH_SIMD" = "avx2" ]; then
+    compilerFlags="$compilerFlags -mavx2 -mfma"
+fi
+
 echo "Building $assembly..."
-clang $cFilenames $compilerFlags -o ../bin/lib$assembly.so $defines $includeFlags $linkerFlags
\ No newline at end of file
+clang $cFilenames $compilerFlags -o ../bin/lib$assembly.so $defines $includeFlags $linkerFlags
+
+#shaders are compiled to SPIR-V next to the binaries, the renderer loads them from assets/shaders
+echo "Compiling shaders..."
+mkdir -p ../bin/assets/shaders
+for shader in assets/shaders/*.vert assets/shaders/*.frag assets/shaders/*.comp; do
+    $VULKAN_SDK/bin/glslc $shader -o ../bin/$shader.spv
+done
\ No newline at end of file
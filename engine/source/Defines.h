@@ -99,4 +99,13 @@ STATIC_ASSERT(sizeof(f64) == 8, "Expected f64 to be 8 bytes.\n");
 #   endif
 #endif
 
+//inlining, static so every translation unit gets its own copy
+#if defined(_MSC_VER)
+#   define CINLINE static __forceinline
+#   define CNOINLINE __declspec(noinline)
+#else
+#   define CINLINE static inline __attribute__((always_inline))
+#   define CNOINLINE __attribute__((noinline))
+#endif
+
 #define CCLAMP(_value, _min, _max) (_value <= _min) ? _min : (_value >= _max) ? _max : _value;
\ No newline at end of file
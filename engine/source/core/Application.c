@@ -8,6 +8,7 @@
 #include "core/Event.h"
 #include "core/Input.h"
 #include "core/Clock.h"
+#include "core/Job.h"
 
 #include "renderer/RendererFrontend.h"
 
@@ -60,6 +61,13 @@ b8 ApplicationCreate(Game* _gameInst)
     EventRegister(EVENT_CODE_KEY_RELEASED, 0, ApplicationOnKey);
     EventRegister(EVENT_CODE_RESIZED, 0, ApplicationOnResize);
 
+    i32 processorCount = PlatformGetProcessorCount();
+    if(!JobSystemInitialize(processorCount > 0 ? (u32)processorCount : 1))
+    {
+        LOG_ERROR("Job system failed to initialize, Application cannot continue.");
+        return FALSE;
+    }
+
     if(!PlatformStartup(&appState.platform, 
         _gameInst->appConfig.name, 
         _gameInst->appConfig.startPosX, 
@@ -70,7 +78,7 @@ b8 ApplicationCreate(Game* _gameInst)
         return FALSE;
     }
 
-    if(!RendererInitialize(_gameInst->appConfig.name, &appState.platform))
+    if(!RendererInitialize(_gameInst->appConfig.name, &_gameInst->appConfig.renderer, &appState.platform))
     {
         LOG_FATAL("Failed to initialize renderer. Aborting application.");
         return FALSE;
@@ -103,6 +111,10 @@ b8 ApplicationRun()
 
     while(appState.isRunning) 
     {
+        //in low latency mode wait for the display before sampling input
+        if(!appState.isSuspended)
+            RendererPaceFrame();
+
         if(!PlatformPumpMessages(&appState.platform))
             appState.isRunning = FALSE;
 
@@ -130,9 +142,9 @@ b8 ApplicationRun()
                 break;
             }
 
-            //TODO: change packet creation
+            //draws the game submitted while rendering, sorted by the frontend
             RenderPacket packet;
-            packet.deltaTime = delta;
+            RendererPreparePacket(&packet, (f32)delta);
             RendererDrawFrame(&packet);
 
             //figure out how long frame took
@@ -171,6 +183,7 @@ b8 ApplicationRun()
 
     EventShutdown();
     InputShutdown();
+    JobSystemShutdown();
 
     RendererShutdown();
 
@@ -2,6 +2,8 @@
 
 #include "Defines.h"
 
+#include "renderer/RendererTypes.inl"
+
 struct Game;
 
 typedef struct ApplicationConfig
@@ -16,6 +18,8 @@ typedef struct ApplicationConfig
     i16 startHeight;
     //application name
     char* name;
+    //present mode, frames in flight and latency settings
+    RendererConfig renderer;
 }ApplicationConfig;
 
 CAPI b8 ApplicationCreate(struct Game* _gameInst);
@@ -92,37 +92,13 @@ void* cSetMemory(void* _dest, i32 _value, u64 _size)
 
 char* GetMemoryUsageStr()
 {
-    const u64 gib = 1024 * 1024 * 1024;
-    const u64 mib = 1024 * 1024;
-    const u64 kib = 1024;
-
     char buffer[8000] = "System memory use (tagged):\n";
     u64 offset = strlen(buffer);
     for(u32 i = 0; i < MEMORY_TAG_MAX_TAGS; ++i)
     {
-        char unit[4] = "XiB";
-        float amount = 1.f;
-        if(stats.taggedAllocations[i] >= gib)
-        {
-            unit[0] = 'G';
-            amount = stats.taggedAllocations[i] / (float)gib;
-        }
-        else if(stats.taggedAllocations[i] >= mib)
-        {
-            unit[0] = 'M';
-            amount = stats.taggedAllocations[i] / (float)mib;
-        }
-        else if(stats.taggedAllocations[i] >= kib)
-        {
-            unit[0] = 'K';
-            amount = stats.taggedAllocations[i] / (float)kib;
-        }
-        else
-        {
-            unit[0] = 'B';
-            unit[1] = 0;
-            amount = (float)stats.taggedAllocations[i];
-        }
+        char unit[4];
+        f32 amount;
+        FormatMemorySize(stats.taggedAllocations[i], &amount, unit);
 
         i32 length = snprintf(buffer + offset, 8000, "  %s: %.2f%s\n", memoryTagStrings[i], amount, unit);
         offset += length;
@@ -132,4 +108,36 @@ char* GetMemoryUsageStr()
     char* outStr = StringDuplicate(buffer);
 
     return outStr;
+}
+
+void FormatMemorySize(u64 _bytes, f32* _outAmount, char* _outUnit)
+{
+    const u64 gib = 1024 * 1024 * 1024;
+    const u64 mib = 1024 * 1024;
+    const u64 kib = 1024;
+
+    _outUnit[1] = 'i';
+    _outUnit[2] = 'B';
+    _outUnit[3] = 0;
+    if(_bytes >= gib)
+    {
+        _outUnit[0] = 'G';
+        *_outAmount = _bytes / (f32)gib;
+    }
+    else if(_bytes >= mib)
+    {
+        _outUnit[0] = 'M';
+        *_outAmount = _bytes / (f32)mib;
+    }
+    else if(_bytes >= kib)
+    {
+        _outUnit[0] = 'K';
+        *_outAmount = _bytes / (f32)kib;
+    }
+    else
+    {
+        _outUnit[0] = 'B';
+        _outUnit[1] = 0;
+        *_outAmount = (f32)_bytes;
+    }
 }
\ No newline at end of file
@@ -35,4 +35,7 @@ CAPI void* cZeroMemory(void* _block, u64 _size);
 CAPI void* cCopyMemory(void* _dest, const void* _src, u64 _size);
 CAPI void* cSetMemory(void* _dest, i32 _value, u64 _size);
 
-CAPI char* GetMemoryUsageStr();
\ No newline at end of file
+CAPI char* GetMemoryUsageStr();
+
+//scales _bytes to the largest binary unit below it, _outUnit receives "GiB", "MiB", "KiB" or "B" and needs 4 chars
+CAPI void FormatMemorySize(u64 _bytes, f32* _outAmount, char* _outUnit);
\ No newline at end of file
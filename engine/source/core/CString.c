@@ -19,4 +19,9 @@ char* StringDuplicate(const char* _str)
 b8 StringsEqual(const char* _str0, const char* _str1)
 {
     return strcmp(_str0, _str1) == 0;
+}
+
+b8 StringContains(const char* _str, const char* _substring)
+{
+    return strstr(_str, _substring) != 0;
 }
\ No newline at end of file
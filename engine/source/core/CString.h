@@ -9,4 +9,7 @@ CAPI u64 StringLength(const char* _str);
 CAPI char* StringDuplicate(const char* _str);
 
 //case sensitive string comparision, true if same, false otherwise
-CAPI b8 StringsEqual(const char* _str0, const char* _str1);
\ No newline at end of file
+CAPI b8 StringsEqual(const char* _str0, const char* _str1);
+
+//case sensitive, true if _substring occurs anywhere in _str
+CAPI b8 StringContains(const char* _str, const char* _substring);
\ No newline at end of file
@@ -98,9 +98,9 @@ typedef enum SystemEventCode
      */
     EVENT_CODE_MOUSE_MOVED = 0x06,
 
-    // Mouse moved.
+    // Mouse wheel scrolled.
     /* Context usage:
-     * u8 z_delta = data.data.u8[0];
+     * i8 z_delta = data.data.i8[0];
      */
     EVENT_CODE_MOUSE_WHEEL = 0x07,
 
@@ -111,5 +111,12 @@ typedef enum SystemEventCode
      */
     EVENT_CODE_RESIZED = 0x08,
 
+    // Raw (unaccelerated) mouse motion, accumulated over a single message pump.
+    /* Context usage:
+     * i32 delta_x = data.data.i32[0];
+     * i32 delta_y = data.data.i32[1];
+     */
+    EVENT_CODE_MOUSE_RAW_MOVED = 0x09,
+
     MAX_EVENT_CODE = 0xFF
 } SystemEventCode;
\ No newline at end of file
@@ -21,6 +21,10 @@ typedef struct InputState
     KeyboardState keyboardPrev;
     MouseState mouseCurr;
     MouseState mousePrev;
+
+    //raw motion accumulated over the current frame
+    i32 mouseDeltaX;
+    i32 mouseDeltaY;
 } InputState;
 
 //internal input state
@@ -48,6 +52,10 @@ void InputUpdate(f64 _deltaTime)
     //copy current states to previous states
     cCopyMemory(&state.keyboardPrev, &state.keyboardCurr, sizeof(KeyboardState));
     cCopyMemory(&state.mousePrev, &state.mouseCurr, sizeof(MouseState));
+
+    //deltas only cover a single frame
+    state.mouseDeltaX = 0;
+    state.mouseDeltaY = 0;
 }
 
 void InputProcessKey(Keys _key, b8 _pressed)
@@ -106,10 +114,26 @@ void InputProcessMouseWheel(i8 _zDelta)
 
     //fire event
     EventContext context;
-    context.data.u8[0] = _zDelta;
+    context.data.i8[0] = _zDelta;
     EventFire(EVENT_CODE_MOUSE_WHEEL, 0, context);
 }
 
+void InputProcessMouseRawMotion(i32 _deltaX, i32 _deltaY)
+{
+    if(_deltaX == 0 && _deltaY == 0)
+        return;
+
+    //update internal state
+    state.mouseDeltaX += _deltaX;
+    state.mouseDeltaY += _deltaY;
+
+    //fire event
+    EventContext context;
+    context.data.i32[0] = _deltaX;
+    context.data.i32[1] = _deltaY;
+    EventFire(EVENT_CODE_MOUSE_RAW_MOVED, 0, context);
+}
+
 b8 InputIsKeyDown(Keys _key)
 {
     if(!initialized)
@@ -198,4 +222,17 @@ void InputGetPreviousMousePosition(i32* _x, i32* _y)
 
     *_x = state.mousePrev.x;
     *_y = state.mousePrev.y;
+}
+
+void InputGetMouseDelta(i32* _x, i32* _y)
+{
+    if(!initialized)
+    {
+        *_x = 0;
+        *_y = 0;
+        return;
+    }
+
+    *_x = state.mouseDeltaX;
+    *_y = state.mouseDeltaY;
 }
\ No newline at end of file
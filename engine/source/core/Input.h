@@ -164,6 +164,12 @@ CAPI b8 InputWasButtonUp(Buttons _button);
 CAPI void InputGetMousePosition(i32* _x, i32* _y);
 CAPI void InputGetPreviousMousePosition(i32* _x, i32* _y);
 
+//raw mouse motion accumulated since the last InputUpdate, 0 when raw input is unavailable
+CAPI void InputGetMouseDelta(i32* _x, i32* _y);
+
 void InputProcessButton(Buttons _button, b8 _pressed);
 void InputProcessMouseMove(i16 _x, i16 _y);
-void InputProcessMouseWheel(i8 _zDelta);
\ No newline at end of file
+void InputProcessMouseWheel(i8 _zDelta);
+
+//platform layers should accumulate raw motion and call this at most once per message pump
+void InputProcessMouseRawMotion(i32 _deltaX, i32 _deltaY);
\ No newline at end of file
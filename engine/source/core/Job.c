@@ -0,0 +1,142 @@
+#include "core/Job.h"
+
+#include "core/Logger.h"
+#include "core/CMemory.h"
+#include "platform/Platform.h"
+
+typedef struct JobWorker
+{
+    PlatformThread thread;
+    PlatformSemaphore start;
+    u32 threadIndex;
+} JobWorker;
+
+typedef struct JobSystemState
+{
+    u32 threadCount;
+    JobWorker workers[JOB_MAX_THREADS];
+
+    //current batch, written before the workers are signaled
+    PFNJobRun run;
+    void* data;
+    u32 count;
+    u32 next;
+
+    //signaled once by each woken worker when the batch has no indices left
+    PlatformSemaphore done;
+    b8 quit;
+} JobSystemState;
+
+static JobSystemState jobState;
+
+u32 JobWorkerRun(void* _params);
+void JobDrain(u32 _threadIndex);
+
+b8 JobSystemInitialize(u32 _threadCount)
+{
+    cZeroMemory(&jobState, sizeof(JobSystemState));
+    jobState.threadCount = 1;
+
+    if(!PlatformSemaphoreCreate(0, &jobState.done))
+        return FALSE;
+
+    //index 0 is the thread that submits the batch
+    for(u32 i = 1; i < _threadCount && i < JOB_MAX_THREADS; ++i)
+    {
+        JobWorker* worker = &jobState.workers[i];
+        worker->threadIndex = i;
+        if(!PlatformSemaphoreCreate(0, &worker->start))
+            break;
+
+        if(!PlatformThreadCreate(JobWorkerRun, worker, &worker->thread))
+        {
+            PlatformSemaphoreDestroy(&worker->start);
+            break;
+        }
+
+        jobState.threadCount++;
+    }
+
+    LOG_INFO("Job system running on %u threads.", jobState.threadCount);
+    return TRUE;
+}
+
+void JobSystemShutdown()
+{
+    jobState.quit = TRUE;
+    for(u32 i = 1; i < jobState.threadCount; ++i)
+    {
+        JobWorker* worker = &jobState.workers[i];
+        PlatformSemaphoreSignal(&worker->start);
+        PlatformThreadJoin(&worker->thread);
+        PlatformSemaphoreDestroy(&worker->start);
+    }
+
+    PlatformSemaphoreDestroy(&jobState.done);
+    cZeroMemory(&jobState, sizeof(JobSystemState));
+}
+
+u32 JobSystemGetThreadCount()
+{
+    return jobState.threadCount > 0 ? jobState.threadCount : 1;
+}
+
+void JobRunParallel(PFNJobRun _run, void* _data, u32 _count)
+{
+    if(!_count)
+        return;
+
+    //not initialized, or nothing to share
+    if(jobState.threadCount <= 1 || _count == 1)
+    {
+        for(u32 i = 0; i < _count; ++i)
+            _run(_data, i, 0);
+        return;
+    }
+
+    jobState.run = _run;
+    jobState.data = _data;
+    jobState.count = _count;
+    __atomic_store_n(&jobState.next, 0, __ATOMIC_RELEASE);
+
+    //no point waking more workers than there are jobs besides the one the calling thread takes
+    u32 woken = jobState.threadCount - 1;
+    if(woken > _count - 1)
+        woken = _count - 1;
+
+    for(u32 i = 1; i <= woken; ++i)
+        PlatformSemaphoreSignal(&jobState.workers[i].start);
+
+    JobDrain(0);
+
+    for(u32 i = 0; i < woken; ++i)
+        PlatformSemaphoreWait(&jobState.done);
+}
+
+void JobDrain(u32 _threadIndex)
+{
+    for(;;)
+    {
+        u32 index = __atomic_fetch_add(&jobState.next, 1, __ATOMIC_ACQ_REL);
+        if(index >= jobState.count)
+            break;
+
+        jobState.run(jobState.data, index, _threadIndex);
+    }
+}
+
+u32 JobWorkerRun(void* _params)
+{
+    JobWorker* worker = (JobWorker*)_params;
+    for(;;)
+    {
+        PlatformSemaphoreWait(&worker->start);
+        if(jobState.quit)
+            break;
+
+        JobDrain(worker->threadIndex);
+        PlatformSemaphoreSignal(&jobState.done);
+    }
+
+    return 0;
+}
\ No newline at end of file
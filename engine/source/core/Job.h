@@ -0,0 +1,21 @@
+#pragma once
+
+#include "Defines.h"
+
+#define JOB_MAX_THREADS 16
+
+//_index is the job within the batch, _threadIndex is 0 on the calling thread and 1 .. count - 1 on workers
+typedef void (*PFNJobRun)(void* _data, u32 _index, u32 _threadIndex);
+
+b8 JobSystemInitialize(u32 _threadCount);
+void JobSystemShutdown();
+
+//threads a batch is spread across, including the calling thread
+CAPI u32 JobSystemGetThreadCount();
+
+/**
+ * Runs _run once for every index in 0 .. _count - 1. The workers and the calling thread pull indices
+ * until the batch is empty, and this returns once every job has finished.
+ * Only one batch runs at a time, so this must not be called from inside a job.
+ */
+CAPI void JobRunParallel(PFNJobRun _run, void* _data, u32 _count);
\ No newline at end of file
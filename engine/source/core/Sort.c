@@ -0,0 +1,49 @@
+#include "core/Sort.h"
+
+#include "core/CMemory.h"
+
+void RadixSortPairs(SortPair* _pairs, SortPair* _scratch, u64 _count)
+{
+    if(_count < 2)
+        return;
+
+    //histograms of all eight bytes in one read of the keys
+    u64 histograms[8][256];
+    cZeroMemory(histograms, sizeof(histograms));
+    for(u64 i = 0; i < _count; ++i)
+    {
+        u64 key = _pairs[i].key;
+        for(u32 b = 0; b < 8; ++b)
+            histograms[b][(key >> (b * 8)) & 0xFF]++;
+    }
+
+    SortPair* src = _pairs;
+    SortPair* dst = _scratch;
+    for(u32 b = 0; b < 8; ++b)
+    {
+        u64* histogram = histograms[b];
+        u32 shift = b * 8;
+
+        //every key has the same value in this byte, the pass would not move anything
+        if(histogram[(src[0].key >> shift) & 0xFF] == _count)
+            continue;
+
+        u64 offset = 0;
+        for(u32 d = 0; d < 256; ++d)
+        {
+            u64 digitCount = histogram[d];
+            histogram[d] = offset;
+            offset += digitCount;
+        }
+
+        for(u64 i = 0; i < _count; ++i)
+            dst[histogram[(src[i].key >> shift) & 0xFF]++] = src[i];
+
+        SortPair* swap = src;
+        src = dst;
+        dst = swap;
+    }
+
+    if(src != _pairs)
+        cCopyMemory(_pairs, src, sizeof(SortPair) * _count);
+}
\ No newline at end of file
@@ -0,0 +1,16 @@
+#pragma once
+
+#include "Defines.h"
+
+typedef struct SortPair
+{
+    u64 key;
+    u64 value;
+} SortPair;
+
+/**
+ * Stable LSD radix sort of _pairs by key, one byte per pass. Bytes every key shares are skipped,
+ * so keys that only differ in a few fields cost a few passes.
+ * @param _scratch Space for _count pairs, its contents are clobbered.
+ */
+CAPI void RadixSortPairs(SortPair* _pairs, SortPair* _scratch, u64 _count);
\ No newline at end of file
@@ -0,0 +1,446 @@
+#include "ecs/Ecs.h"
+
+#include "core/Logger.h"
+#include "core/CMemory.h"
+
+#include "containers/DArray.h"
+
+//columns start on this boundary so SIMD loads of component data stay aligned
+#define ECS_COLUMN_ALIGNMENT 16
+
+u32 EcsArchetypeGetOrCreate(EcsWorld* _world, u64 _mask);
+u32 EcsArchetypeAllocateRow(EcsArchetype* _archetype, u32* _outChunk);
+void EcsArchetypeRemoveRow(EcsWorld* _world, EcsArchetype* _archetype, u32 _chunk, u32 _row);
+void EcsEntityMove(EcsWorld* _world, EcsEntityRecord* _record, Entity _entity, u32 _archetype);
+EcsEntityRecord* EcsEntityLookup(const EcsWorld* _world, Entity _entity);
+b8 EcsQueryMatches(const EcsQuery* _query, const EcsArchetype* _archetype);
+
+b8 EcsWorldCreate(EcsWorld* _outWorld)
+{
+    cZeroMemory(_outWorld, sizeof(EcsWorld));
+    _outWorld->archetypes = DArrayCreate(EcsArchetype*);
+    _outWorld->records = DArrayCreate(EcsEntityRecord);
+    _outWorld->freeRecords = DArrayCreate(u32);
+    _outWorld->queries = DArrayCreate(EcsQuery*);
+    _outWorld->systems = DArrayCreate(EcsSystem);
+    _outWorld->jobs = DArrayCreate(EcsSystemJob);
+
+    //entities without components still need somewhere to live
+    if(EcsArchetypeGetOrCreate(_outWorld, 0) != 0)
+    {
+        EcsWorldDestroy(_outWorld);
+        return FALSE;
+    }
+
+    return TRUE;
+}
+
+void EcsWorldDestroy(EcsWorld* _world)
+{
+    if(_world->archetypes)
+    {
+        u64 archetypeCount = DArrayLength(_world->archetypes);
+        for(u64 i = 0; i < archetypeCount; ++i)
+        {
+            EcsArchetype* archetype = _world->archetypes[i];
+            u64 chunkCount = DArrayLength(archetype->chunks);
+            for(u64 c = 0; c < chunkCount; ++c)
+                cFree(archetype->chunks[c].data, ECS_CHUNK_SIZE, MEMORY_TAG_ENTITY);
+
+            DArrayDestroy(archetype->chunks);
+            cFree(archetype, sizeof(EcsArchetype), MEMORY_TAG_ENTITY);
+        }
+
+        DArrayDestroy(_world->archetypes);
+    }
+
+    if(_world->queries)
+    {
+        u64 queryCount = DArrayLength(_world->queries);
+        for(u64 i = 0; i < queryCount; ++i)
+        {
+            DArrayDestroy(_world->queries[i]->archetypes);
+            cFree(_world->queries[i], sizeof(EcsQuery), MEMORY_TAG_ENTITY);
+        }
+
+        DArrayDestroy(_world->queries);
+    }
+
+    if(_world->records)
+        DArrayDestroy(_world->records);
+    if(_world->freeRecords)
+        DArrayDestroy(_world->freeRecords);
+    if(_world->systems)
+        DArrayDestroy(_world->systems);
+    if(_world->jobs)
+        DArrayDestroy(_world->jobs);
+
+    cZeroMemory(_world, sizeof(EcsWorld));
+}
+
+u32 EcsComponentRegister(EcsWorld* _world, const char* _name, u32 _size)
+{
+    if(_world->componentCount == ECS_MAX_COMPONENTS)
+    {
+        LOG_ERROR("EcsComponentRegister: '%s' exceeds the limit of %u components.", _name, ECS_MAX_COMPONENTS);
+        return ECS_INVALID_ID;
+    }
+
+    //a row of the component alone has to fit in a chunk next to its entity
+    if(_size > ECS_CHUNK_SIZE / 4)
+    {
+        LOG_ERROR("EcsComponentRegister: '%s' is %u bytes, components are limited to %u.", _name, _size, ECS_CHUNK_SIZE / 4);
+        return ECS_INVALID_ID;
+    }
+
+    u32 id = _world->componentCount++;
+    _world->components[id].name = _name;
+    _world->components[id].size = _size;
+    return id;
+}
+
+Entity EcsEntityCreate(EcsWorld* _world)
+{
+    u32 index;
+    if(DArrayLength(_world->freeRecords) > 0)
+    {
+        DArrayPop(_world->freeRecords, &index);
+    }
+    else
+    {
+        index = (u32)DArrayLength(_world->records);
+        EcsEntityRecord record = {};
+        record.generation = 1;
+        DArrayPush(_world->records, record);
+    }
+
+    EcsEntityRecord* record = &_world->records[index];
+    Entity entity = ((u64)record->generation << 32) | index;
+
+    EcsArchetype* empty = _world->archetypes[0];
+    record->archetype = 0;
+    record->row = EcsArchetypeAllocateRow(empty, &record->chunk);
+    ((Entity*)empty->chunks[record->chunk].data)[record->row] = entity;
+
+    _world->entityCount++;
+    return entity;
+}
+
+void EcsEntityDestroy(EcsWorld* _world, Entity _entity)
+{
+    EcsEntityRecord* record = EcsEntityLookup(_world, _entity);
+    if(!record)
+        return;
+
+    EcsArchetypeRemoveRow(_world, _world->archetypes[record->archetype], record->chunk, record->row);
+
+    //a new generation makes every handle to this slot stale, 0 is skipped since it means null
+    record->generation++;
+    if(record->generation == 0)
+        record->generation = 1;
+
+    DArrayPush(_world->freeRecords, ENTITY_INDEX(_entity));
+    _world->entityCount--;
+}
+
+b8 EcsEntityIsAlive(const EcsWorld* _world, Entity _entity)
+{
+    return EcsEntityLookup(_world, _entity) != 0;
+}
+
+void* EcsComponentAdd(EcsWorld* _world, Entity _entity, u32 _component)
+{
+    EcsEntityRecord* record = EcsEntityLookup(_world, _entity);
+    if(!record || _component >= _world->componentCount)
+        return 0;
+
+    EcsArchetype* archetype = _world->archetypes[record->archetype];
+    if(!(archetype->mask & ECS_COMPONENT_BIT(_component)))
+    {
+        u32 target = archetype->addEdges[_component];
+        if(target == ECS_INVALID_ID)
+        {
+            target = EcsArchetypeGetOrCreate(_world, archetype->mask | ECS_COMPONENT_BIT(_component));
+            if(target == ECS_INVALID_ID)
+                return 0;
+
+            //creating the archetype can grow the array, but the archetypes themselves do not move
+            archetype->addEdges[_component] = target;
+            _world->archetypes[target]->removeEdges[_component] = record->archetype;
+        }
+
+        EcsEntityMove(_world, record, _entity, target);
+    }
+
+    return EcsComponentGet(_world, _entity, _component);
+}
+
+void EcsComponentRemove(EcsWorld* _world, Entity _entity, u32 _component)
+{
+    EcsEntityRecord* record = EcsEntityLookup(_world, _entity);
+    if(!record || _component >= _world->componentCount)
+        return;
+
+    EcsArchetype* archetype = _world->archetypes[record->archetype];
+    if(!(archetype->mask & ECS_COMPONENT_BIT(_component)))
+        return;
+
+    u32 target = archetype->removeEdges[_component];
+    if(target == ECS_INVALID_ID)
+    {
+        target = EcsArchetypeGetOrCreate(_world, archetype->mask & ~ECS_COMPONENT_BIT(_component));
+        if(target == ECS_INVALID_ID)
+            return;
+
+        archetype->removeEdges[_component] = target;
+        _world->archetypes[target]->addEdges[_component] = record->archetype;
+    }
+
+    EcsEntityMove(_world, record, _entity, target);
+}
+
+void* EcsComponentGet(const EcsWorld* _world, Entity _entity, u32 _component)
+{
+    EcsEntityRecord* record = EcsEntityLookup(_world, _entity);
+    if(!record || _component >= ECS_MAX_COMPONENTS)
+        return 0;
+
+    const EcsArchetype* archetype = _world->archetypes[record->archetype];
+    u32 offset = archetype->columnOffsets[_component];
+    if(offset == ECS_INVALID_ID)
+        return 0;
+
+    return archetype->chunks[record->chunk].data + offset + (u64)record->row * _world->components[_component].size;
+}
+
+b8 EcsComponentHas(const EcsWorld* _world, Entity _entity, u32 _component)
+{
+    EcsEntityRecord* record = EcsEntityLookup(_world, _entity);
+    if(!record || _component >= ECS_MAX_COMPONENTS)
+        return FALSE;
+
+    return (_world->archetypes[record->archetype]->mask & ECS_COMPONENT_BIT(_component)) != 0;
+}
+
+EcsQuery* EcsQueryCreate(EcsWorld* _world, const EcsQueryDesc* _desc)
+{
+    EcsQuery* query = cAllocate(sizeof(EcsQuery), MEMORY_TAG_ENTITY);
+    query->desc = *_desc;
+    query->include = _desc->read | _desc->write;
+    query->archetypes = DArrayCreate(u32);
+
+    u32 archetypeCount = (u32)DArrayLength(_world->archetypes);
+    for(u32 i = 0; i < archetypeCount; ++i)
+    {
+        if(EcsQueryMatches(query, _world->archetypes[i]))
+            DArrayPush(query->archetypes, i);
+    }
+
+    DArrayPush(_world->queries, query);
+    return query;
+}
+
+u32 EcsQueryCount(const EcsWorld* _world, const EcsQuery* _query)
+{
+    u32 count = 0;
+    u64 archetypeCount = DArrayLength(_query->archetypes);
+    for(u64 i = 0; i < archetypeCount; ++i)
+        count += _world->archetypes[_query->archetypes[i]]->entityCount;
+
+    return count;
+}
+
+EcsQueryIter EcsQueryIterBegin(EcsWorld* _world, const EcsQuery* _query)
+{
+    EcsQueryIter iter = {};
+    iter.world = _world;
+    iter.query = _query;
+    return iter;
+}
+
+b8 EcsQueryIterNext(EcsQueryIter* _iter)
+{
+    u32 archetypeCount = (u32)DArrayLength(_iter->query->archetypes);
+    while(_iter->archetypeCursor < archetypeCount)
+    {
+        EcsArchetype* archetype = _iter->world->archetypes[_iter->query->archetypes[_iter->archetypeCursor]];
+        if(_iter->chunkCursor < DArrayLength(archetype->chunks))
+        {
+            EcsChunk* chunk = &archetype->chunks[_iter->chunkCursor++];
+            _iter->view.archetype = archetype;
+            _iter->view.data = chunk->data;
+            _iter->view.count = chunk->count;
+            _iter->view.entities = (const Entity*)chunk->data;
+            return TRUE;
+        }
+
+        _iter->archetypeCursor++;
+        _iter->chunkCursor = 0;
+    }
+
+    return FALSE;
+}
+
+u32 EcsArchetypeGetOrCreate(EcsWorld* _world, u64 _mask)
+{
+    u32 archetypeCount = (u32)DArrayLength(_world->archetypes);
+    for(u32 i = 0; i < archetypeCount; ++i)
+    {
+        if(_world->archetypes[i]->mask == _mask)
+            return i;
+    }
+
+    //rows are the entity plus one element of every column, padding reserves room to align each column
+    u32 rowSize = sizeof(Entity);
+    u32 columnCount = 0;
+    for(u32 c = 0; c < ECS_MAX_COMPONENTS; ++c)
+    {
+        if(_mask & ECS_COMPONENT_BIT(c))
+        {
+            rowSize += _world->components[c].size;
+            columnCount++;
+        }
+    }
+
+    u32 padding = columnCount * ECS_COLUMN_ALIGNMENT;
+    u32 rowCapacity = (ECS_CHUNK_SIZE - padding) / rowSize;
+    if(rowCapacity == 0)
+    {
+        LOG_ERROR("EcsArchetypeGetOrCreate: a %u byte row does not fit in a chunk.", rowSize);
+        return ECS_INVALID_ID;
+    }
+
+    EcsArchetype* archetype = cAllocate(sizeof(EcsArchetype), MEMORY_TAG_ENTITY);
+    cZeroMemory(archetype, sizeof(EcsArchetype));
+    archetype->mask = _mask;
+    archetype->rowCapacity = rowCapacity;
+    archetype->chunks = DArrayCreate(EcsChunk);
+
+    u32 offset = sizeof(Entity) * rowCapacity;
+    for(u32 c = 0; c < ECS_MAX_COMPONENTS; ++c)
+    {
+        archetype->addEdges[c] = ECS_INVALID_ID;
+        archetype->removeEdges[c] = ECS_INVALID_ID;
+        archetype->columnOffsets[c] = ECS_INVALID_ID;
+        if(_mask & ECS_COMPONENT_BIT(c))
+        {
+            offset = (offset + ECS_COLUMN_ALIGNMENT - 1) & ~(ECS_COLUMN_ALIGNMENT - 1);
+            archetype->columnOffsets[c] = offset;
+            offset += _world->components[c].size * rowCapacity;
+        }
+    }
+
+    u32 index = archetypeCount;
+    DArrayPush(_world->archetypes, archetype);
+
+    //cached queries pick up the new archetype here instead of searching on every iteration
+    u64 queryCount = DArrayLength(_world->queries);
+    for(u64 i = 0; i < queryCount; ++i)
+    {
+        if(EcsQueryMatches(_world->queries[i], archetype))
+            DArrayPush(_world->queries[i]->archetypes, index);
+    }
+
+    return index;
+}
+
+u32 EcsArchetypeAllocateRow(EcsArchetype* _archetype, u32* _outChunk)
+{
+    u32 chunkCount = (u32)DArrayLength(_archetype->chunks);
+    if(chunkCount == 0 || _archetype->chunks[chunkCount - 1].count == _archetype->rowCapacity)
+    {
+        EcsChunk chunk = {};
+        chunk.data = cAllocate(ECS_CHUNK_SIZE, MEMORY_TAG_ENTITY);
+        DArrayPush(_archetype->chunks, chunk);
+        chunkCount++;
+    }
+
+    _archetype->entityCount++;
+    *_outChunk = chunkCount - 1;
+    return _archetype->chunks[chunkCount - 1].count++;
+}
+
+void EcsArchetypeRemoveRow(EcsWorld* _world, EcsArchetype* _archetype, u32 _chunk, u32 _row)
+{
+    //the archetype's last row fills the hole so every chunk but the last stays full
+    u32 lastChunk = (u32)DArrayLength(_archetype->chunks) - 1;
+    EcsChunk* last = &_archetype->chunks[lastChunk];
+    u32 lastRow = last->count - 1;
+
+    if(_chunk != lastChunk || _row != lastRow)
+    {
+        EcsChunk* hole = &_archetype->chunks[_chunk];
+        Entity moved = ((Entity*)last->data)[lastRow];
+        ((Entity*)hole->data)[_row] = moved;
+
+        for(u32 c = 0; c < _world->componentCount; ++c)
+        {
+            u32 offset = _archetype->columnOffsets[c];
+            if(offset == ECS_INVALID_ID)
+                continue;
+
+            u32 size = _world->components[c].size;
+            cCopyMemory(hole->data + offset + (u64)_row * size, last->data + offset + (u64)lastRow * size, size);
+        }
+
+        EcsEntityRecord* record = &_world->records[ENTITY_INDEX(moved)];
+        record->chunk = _chunk;
+        record->row = _row;
+    }
+
+    last->count--;
+    _archetype->entityCount--;
+    if(last->count == 0)
+    {
+        cFree(last->data, ECS_CHUNK_SIZE, MEMORY_TAG_ENTITY);
+        DArrayLengthSet(_archetype->chunks, lastChunk);
+    }
+}
+
+void EcsEntityMove(EcsWorld* _world, EcsEntityRecord* _record, Entity _entity, u32 _archetype)
+{
+    EcsArchetype* source = _world->archetypes[_record->archetype];
+    EcsArchetype* target = _world->archetypes[_archetype];
+
+    u32 chunkIndex;
+    u32 row = EcsArchetypeAllocateRow(target, &chunkIndex);
+    EcsChunk* chunk = &target->chunks[chunkIndex];
+    const EcsChunk* sourceChunk = &source->chunks[_record->chunk];
+    ((Entity*)chunk->data)[row] = _entity;
+
+    //shared components are copied, new ones start zeroed
+    for(u32 c = 0; c < _world->componentCount; ++c)
+    {
+        u32 offset = target->columnOffsets[c];
+        if(offset == ECS_INVALID_ID)
+            continue;
+
+        u32 size = _world->components[c].size;
+        u8* dst = chunk->data + offset + (u64)row * size;
+        u32 sourceOffset = source->columnOffsets[c];
+        if(sourceOffset != ECS_INVALID_ID)
+            cCopyMemory(dst, sourceChunk->data + sourceOffset + (u64)_record->row * size, size);
+        else
+            cZeroMemory(dst, size);
+    }
+
+    EcsArchetypeRemoveRow(_world, source, _record->chunk, _record->row);
+
+    _record->archetype = _archetype;
+    _record->chunk = chunkIndex;
+    _record->row = row;
+}
+
+EcsEntityRecord* EcsEntityLookup(const EcsWorld* _world, Entity _entity)
+{
+    u32 index = ENTITY_INDEX(_entity);
+    if(index >= DArrayLength(_world->records) || _world->records[index].generation != ENTITY_GENERATION(_entity))
+        return 0;
+
+    return &_world->records[index];
+}
+
+b8 EcsQueryMatches(const EcsQuery* _query, const EcsArchetype* _archetype)
+{
+    return (_archetype->mask & _query->include) == _query->include && (_archetype->mask & _query->desc.exclude) == 0;
+}
\ No newline at end of file
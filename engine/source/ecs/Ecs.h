@@ -0,0 +1,180 @@
+#pragma once
+
+#include "Defines.h"
+
+//entities live in fixed size chunks, one column per component
+#define ECS_CHUNK_SIZE (16 * 1024)
+#define ECS_MAX_COMPONENTS 64
+#define ECS_INVALID_ID 0xFFFFFFFF
+
+#define ECS_COMPONENT_BIT(_component) (1ull << (_component))
+
+//generation in the high 32 bits and slot in the low 32, generations start at 1 so 0 is never alive
+typedef u64 Entity;
+#define ENTITY_NULL 0
+#define ENTITY_INDEX(_entity) ((u32)((_entity) & 0xFFFFFFFF))
+#define ENTITY_GENERATION(_entity) ((u32)((_entity) >> 32))
+
+typedef struct EcsComponentInfo
+{
+    const char* name;
+    u32 size;
+} EcsComponentInfo;
+
+typedef struct EcsChunk
+{
+    u32 count;
+    //ECS_CHUNK_SIZE bytes, the entity column followed by the component columns
+    u8* data;
+} EcsChunk;
+
+//every entity with exactly the same set of components
+typedef struct EcsArchetype
+{
+    u64 mask;
+    u32 rowCapacity;
+    u32 entityCount;
+
+    //byte offset of every component's column inside a chunk, ECS_INVALID_ID if not in this archetype
+    u32 columnOffsets[ECS_MAX_COMPONENTS];
+    //archetype reached by adding or removing a component, ECS_INVALID_ID until first used
+    u32 addEdges[ECS_MAX_COMPONENTS];
+    u32 removeEdges[ECS_MAX_COMPONENTS];
+
+    //darray, only the last chunk is ever partially filled
+    EcsChunk* chunks;
+} EcsArchetype;
+
+typedef struct EcsEntityRecord
+{
+    u32 generation;
+    u32 archetype;
+    u32 chunk;
+    u32 row;
+} EcsEntityRecord;
+
+//components a query reads and writes, entities need all of them and none of exclude
+typedef struct EcsQueryDesc
+{
+    u64 read;
+    u64 write;
+    u64 exclude;
+} EcsQueryDesc;
+
+typedef struct EcsQuery
+{
+    EcsQueryDesc desc;
+    u64 include;
+    //darray of matching archetypes, extended whenever the world creates a new one
+    u32* archetypes;
+} EcsQuery;
+
+typedef struct EcsChunkView
+{
+    const EcsArchetype* archetype;
+    u8* data;
+    u32 count;
+    const Entity* entities;
+} EcsChunkView;
+
+typedef struct EcsQueryIter
+{
+    struct EcsWorld* world;
+    const EcsQuery* query;
+    u32 archetypeCursor;
+    u32 chunkCursor;
+    EcsChunkView view;
+} EcsQueryIter;
+
+typedef void (*PFNEcsSystemRun)(const EcsChunkView* _view, f32 _deltaTime, void* _userData);
+
+typedef struct EcsSystemDesc
+{
+    const char* name;
+    EcsQueryDesc query;
+    PFNEcsSystemRun run;
+    void* userData;
+} EcsSystemDesc;
+
+typedef struct EcsSystem
+{
+    EcsSystemDesc desc;
+    EcsQuery* query;
+    //systems in one phase touch disjoint data and run together
+    u32 phase;
+} EcsSystem;
+
+//one chunk for one system, the unit systems are scheduled in
+typedef struct EcsSystemJob
+{
+    const EcsSystem* system;
+    EcsChunkView view;
+} EcsSystemJob;
+
+typedef struct EcsWorld
+{
+    EcsComponentInfo components[ECS_MAX_COMPONENTS];
+    u32 componentCount;
+
+    //darray of pointers, archetype 0 has no components
+    EcsArchetype** archetypes;
+
+    //darray indexed by ENTITY_INDEX, and darray of free slots
+    EcsEntityRecord* records;
+    u32* freeRecords;
+    u32 entityCount;
+
+    //darray of every query the world keeps matched
+    EcsQuery** queries;
+
+    //darray in registration order, and darray of jobs reused every run
+    EcsSystem* systems;
+    EcsSystemJob* jobs;
+    u32 phaseCount;
+} EcsWorld;
+
+CAPI b8 EcsWorldCreate(EcsWorld* _outWorld);
+CAPI void EcsWorldDestroy(EcsWorld* _world);
+
+//returns the component id, or ECS_INVALID_ID once ECS_MAX_COMPONENTS are registered. _name is not copied
+CAPI u32 EcsComponentRegister(EcsWorld* _world, const char* _name, u32 _size);
+
+CAPI Entity EcsEntityCreate(EcsWorld* _world);
+CAPI void EcsEntityDestroy(EcsWorld* _world, Entity _entity);
+CAPI b8 EcsEntityIsAlive(const EcsWorld* _world, Entity _entity);
+
+/**
+ * Structural changes move the entity to another archetype and invalidate component pointers.
+ * They must not happen while a query is iterated or systems are running.
+ * @returns The zeroed component, or the existing one if the entity already has it. 0 if the entity is dead.
+ */
+CAPI void* EcsComponentAdd(EcsWorld* _world, Entity _entity, u32 _component);
+CAPI void EcsComponentRemove(EcsWorld* _world, Entity _entity, u32 _component);
+CAPI void* EcsComponentGet(const EcsWorld* _world, Entity _entity, u32 _component);
+CAPI b8 EcsComponentHas(const EcsWorld* _world, Entity _entity, u32 _component);
+
+//the world owns the query and keeps its archetype list current, it is freed with the world
+CAPI EcsQuery* EcsQueryCreate(EcsWorld* _world, const EcsQueryDesc* _desc);
+CAPI u32 EcsQueryCount(const EcsWorld* _world, const EcsQuery* _query);
+
+//walks the chunks of every matching archetype in order
+CAPI EcsQueryIter EcsQueryIterBegin(EcsWorld* _world, const EcsQuery* _query);
+CAPI b8 EcsQueryIterNext(EcsQueryIter* _iter);
+
+//column of _component in a chunk, 0 if the archetype does not have it
+CINLINE void* EcsViewColumn(const EcsChunkView* _view, u32 _component)
+{
+    u32 offset = _view->archetype->columnOffsets[_component];
+    return offset == ECS_INVALID_ID ? 0 : _view->data + offset;
+}
+
+/**
+ * Adds a system that runs on every chunk its query matches. Systems are grouped into phases in
+ * registration order, a system joins the phase after the last earlier system it conflicts with,
+ * two systems conflict when either one writes a component the other reads or writes.
+ * @returns The system index, or ECS_INVALID_ID.
+ */
+CAPI u32 EcsSystemRegister(EcsWorld* _world, const EcsSystemDesc* _desc);
+
+//runs every phase as one batch of chunk jobs on the job system, phases run one after the other
+CAPI void EcsSystemsRun(EcsWorld* _world, f32 _deltaTime);
\ No newline at end of file
@@ -0,0 +1,94 @@
+#include "ecs/Ecs.h"
+
+#include "core/Logger.h"
+#include "core/Job.h"
+
+#include "containers/DArray.h"
+
+typedef struct EcsSystemsRunContext
+{
+    const EcsSystemJob* jobs;
+    f32 deltaTime;
+} EcsSystemsRunContext;
+
+b8 EcsSystemsConflict(const EcsQueryDesc* _a, const EcsQueryDesc* _b);
+void EcsSystemJobRun(void* _data, u32 _index, u32 _threadIndex);
+
+u32 EcsSystemRegister(EcsWorld* _world, const EcsSystemDesc* _desc)
+{
+    if(!_desc->run)
+    {
+        LOG_ERROR("EcsSystemRegister: '%s' has no run function.", _desc->name);
+        return ECS_INVALID_ID;
+    }
+
+    if((_desc->query.read | _desc->query.write) == 0)
+    {
+        LOG_ERROR("EcsSystemRegister: '%s' does not access any component.", _desc->name);
+        return ECS_INVALID_ID;
+    }
+
+    EcsSystem system = {};
+    system.desc = *_desc;
+    system.query = EcsQueryCreate(_world, &_desc->query);
+
+    //earlier systems are already placed, so the phase only depends on the ones this one conflicts with
+    u32 systemCount = (u32)DArrayLength(_world->systems);
+    for(u32 i = 0; i < systemCount; ++i)
+    {
+        const EcsSystem* other = &_world->systems[i];
+        if(other->phase + 1 > system.phase && EcsSystemsConflict(&other->desc.query, &_desc->query))
+            system.phase = other->phase + 1;
+    }
+
+    if(system.phase + 1 > _world->phaseCount)
+        _world->phaseCount = system.phase + 1;
+
+    DArrayPush(_world->systems, system);
+    return systemCount;
+}
+
+void EcsSystemsRun(EcsWorld* _world, f32 _deltaTime)
+{
+    u32 systemCount = (u32)DArrayLength(_world->systems);
+    for(u32 phase = 0; phase < _world->phaseCount; ++phase)
+    {
+        //every chunk of every system in the phase is an independent job
+        DArrayClear(_world->jobs);
+        for(u32 s = 0; s < systemCount; ++s)
+        {
+            const EcsSystem* system = &_world->systems[s];
+            if(system->phase != phase)
+                continue;
+
+            EcsQueryIter iter = EcsQueryIterBegin(_world, system->query);
+            while(EcsQueryIterNext(&iter))
+            {
+                if(iter.view.count == 0)
+                    continue;
+
+                EcsSystemJob job = {};
+                job.system = system;
+                job.view = iter.view;
+                DArrayPush(_world->jobs, job);
+            }
+        }
+
+        EcsSystemsRunContext context = {};
+        context.jobs = _world->jobs;
+        context.deltaTime = _deltaTime;
+        JobRunParallel(EcsSystemJobRun, &context, (u32)DArrayLength(_world->jobs));
+    }
+}
+
+b8 EcsSystemsConflict(const EcsQueryDesc* _a, const EcsQueryDesc* _b)
+{
+    return (_a->write & (_b->read | _b->write)) != 0 || (_b->write & (_a->read | _a->write)) != 0;
+}
+
+void EcsSystemJobRun(void* _data, u32 _index, u32 _threadIndex)
+{
+    const EcsSystemsRunContext* context = (const EcsSystemsRunContext*)_data;
+    const EcsSystemJob* job = &context->jobs[_index];
+    job->system->desc.run(&job->view, context->deltaTime, job->system->desc.userData);
+}
\ No newline at end of file
@@ -0,0 +1,254 @@
+#include "math/CMath.h"
+
+#include <math.h>
+
+f32 CSin(f32 _x)
+{
+    return sinf(_x);
+}
+
+f32 CCos(f32 _x)
+{
+    return cosf(_x);
+}
+
+f32 CTan(f32 _x)
+{
+    return tanf(_x);
+}
+
+f32 CAcos(f32 _x)
+{
+    return acosf(_x);
+}
+
+f32 CSqrt(f32 _x)
+{
+    return sqrtf(_x);
+}
+
+f32 CAbs(f32 _x)
+{
+    return fabsf(_x);
+}
+
+const char* CMathSimdName()
+{
+#if defined(CMATH_SIMD_AVX2)
+    return "AVX2";
+#elif defined(CMATH_SIMD_SSE)
+    return "SSE";
+#elif defined(CMATH_SIMD_NEON)
+    return "NEON";
+#else
+    return "scalar";
+#endif
+}
+
+Quat QuatSlerp(Quat _a, Quat _b, f32 _t)
+{
+    //take the short way around, q and -q are the same rotation
+    f32 cosTheta = QuatDot(_a, _b);
+    if(cosTheta < 0.f)
+    {
+        _b = Vec4Scale(_b, -1.f);
+        cosTheta = -cosTheta;
+    }
+
+    //nearly parallel, sin(theta) is too small to divide by
+    if(cosTheta > 0.9995f)
+        return QuatNormalize(Vec4Add(_a, Vec4Scale(Vec4Sub(_b, _a), _t)));
+
+    f32 theta = CAcos(cosTheta);
+    f32 sinTheta = CSin(theta);
+    f32 weightA = CSin((1.f - _t) * theta) / sinTheta;
+    f32 weightB = CSin(_t * theta) / sinTheta;
+    return Vec4Add(Vec4Scale(_a, weightA), Vec4Scale(_b, weightB));
+}
+
+Mat4 Mat4Perspective(f32 _fovRadians, f32 _aspect, f32 _near, f32 _far)
+{
+    f32 f = 1.f / CTan(_fovRadians * 0.5f);
+
+    Mat4 result;
+    result.columns[0] = Vec4Create(f / _aspect, 0.f, 0.f, 0.f);
+    result.columns[1] = Vec4Create(0.f, f, 0.f, 0.f);
+    result.columns[2] = Vec4Create(0.f, 0.f, _far / (_near - _far), -1.f);
+    result.columns[3] = Vec4Create(0.f, 0.f, (_near * _far) / (_near - _far), 0.f);
+    return result;
+}
+
+Mat4 Mat4Orthographic(f32 _left, f32 _right, f32 _bottom, f32 _top, f32 _near, f32 _far)
+{
+    f32 width = _right - _left;
+    f32 height = _top - _bottom;
+    f32 depth = _far - _near;
+
+    Mat4 result;
+    result.columns[0] = Vec4Create(2.f / width, 0.f, 0.f, 0.f);
+    result.columns[1] = Vec4Create(0.f, 2.f / height, 0.f, 0.f);
+    result.columns[2] = Vec4Create(0.f, 0.f, -1.f / depth, 0.f);
+    result.columns[3] = Vec4Create(-(_right + _left) / width, -(_top + _bottom) / height, -_near / depth, 1.f);
+    return result;
+}
+
+Mat4 Mat4LookAt(Vec3 _eye, Vec3 _target, Vec3 _up)
+{
+    Vec3 forward = Vec3Normalize(Vec3Sub(_target, _eye));
+    Vec3 right = Vec3Normalize(Vec3Cross(forward, _up));
+    Vec3 up = Vec3Cross(right, forward);
+
+    //rows of the rotation are the camera axes, the camera looks down -z
+    Mat4 result;
+    result.columns[0] = Vec4Create(right.x, up.x, -forward.x, 0.f);
+    result.columns[1] = Vec4Create(right.y, up.y, -forward.y, 0.f);
+    result.columns[2] = Vec4Create(right.z, up.z, -forward.z, 0.f);
+    result.columns[3] = Vec4Create(-Vec3Dot(right, _eye), -Vec3Dot(up, _eye), Vec3Dot(forward, _eye), 1.f);
+    return result;
+}
+
+Mat4 Mat4Inverse(const Mat4* _m)
+{
+    const f32* m = _m->data;
+
+    //cofactor expansion through the 2x2 sub determinants of the lower and upper halves
+    f32 s0 = m[0] * m[5] - m[4] * m[1];
+    f32 s1 = m[0] * m[6] - m[4] * m[2];
+    f32 s2 = m[0] * m[7] - m[4] * m[3];
+    f32 s3 = m[1] * m[6] - m[5] * m[2];
+    f32 s4 = m[1] * m[7] - m[5] * m[3];
+    f32 s5 = m[2] * m[7] - m[6] * m[3];
+
+    f32 c5 = m[10] * m[15] - m[14] * m[11];
+    f32 c4 = m[9] * m[15] - m[13] * m[11];
+    f32 c3 = m[9] * m[14] - m[13] * m[10];
+    f32 c2 = m[8] * m[15] - m[12] * m[11];
+    f32 c1 = m[8] * m[14] - m[12] * m[10];
+    f32 c0 = m[8] * m[13] - m[12] * m[9];
+
+    f32 determinant = s0 * c5 - s1 * c4 + s2 * c3 + s3 * c2 - s4 * c1 + s5 * c0;
+    if(CAbs(determinant) < C_FLOAT_EPSILON)
+        return Mat4Identity();
+
+    f32 inverse = 1.f / determinant;
+
+    Mat4 result;
+    f32* o = result.data;
+    o[0] = (m[5] * c5 - m[6] * c4 + m[7] * c3) * inverse;
+    o[1] = (-m[1] * c5 + m[2] * c4 - m[3] * c3) * inverse;
+    o[2] = (m[13] * s5 - m[14] * s4 + m[15] * s3) * inverse;
+    o[3] = (-m[9] * s5 + m[10] * s4 - m[11] * s3) * inverse;
+
+    o[4] = (-m[4] * c5 + m[6] * c2 - m[7] * c1) * inverse;
+    o[5] = (m[0] * c5 - m[2] * c2 + m[3] * c1) * inverse;
+    o[6] = (-m[12] * s5 + m[14] * s2 - m[15] * s1) * inverse;
+    o[7] = (m[8] * s5 - m[10] * s2 + m[11] * s1) * inverse;
+
+    o[8] = (m[4] * c4 - m[5] * c2 + m[7] * c0) * inverse;
+    o[9] = (-m[0] * c4 + m[1] * c2 - m[3] * c0) * inverse;
+    o[10] = (m[12] * s4 - m[13] * s2 + m[15] * s0) * inverse;
+    o[11] = (-m[8] * s4 + m[9] * s2 - m[11] * s0) * inverse;
+
+    o[12] = (-m[4] * c3 + m[5] * c1 - m[6] * c0) * inverse;
+    o[13] = (m[0] * c3 - m[1] * c1 + m[2] * c0) * inverse;
+    o[14] = (-m[12] * s3 + m[13] * s1 - m[14] * s0) * inverse;
+    o[15] = (m[8] * s3 - m[9] * s1 + m[10] * s0) * inverse;
+    return result;
+}
+
+Mat4 Mat4InverseRigid(const Mat4* _m)
+{
+    //transposed rotation, translation rotated back and negated
+    Mat4 result = *_m;
+    result.columns[3] = Vec4Create(0.f, 0.f, 0.f, 1.f);
+    result = Mat4Transpose(&result);
+
+    Vec3 translation = Mat4TransformDirection(&result, Vec4ToVec3(_m->columns[3]));
+    result.columns[3] = Vec4Create(-translation.x, -translation.y, -translation.z, 1.f);
+    return result;
+}
+
+void Mat4TransformPoints(const Mat4* _m, const Vec3* _points, Vec3* _outPoints, u64 _count)
+{
+    u64 i = 0;
+
+#if defined(CMATH_SIMD_AVX2)
+    //two points per iteration, one in each 128 bit lane
+    __m256 c0 = _mm256_broadcast_ps(&_m->columns[0].simd);
+    __m256 c1 = _mm256_broadcast_ps(&_m->columns[1].simd);
+    __m256 c2 = _mm256_broadcast_ps(&_m->columns[2].simd);
+    __m256 c3 = _mm256_broadcast_ps(&_m->columns[3].simd);
+    for(; i + 2 <= _count; i += 2)
+    {
+        const Vec3* p = &_points[i];
+        __m256 x = _mm256_set_m128(_mm_set1_ps(p[1].x), _mm_set1_ps(p[0].x));
+        __m256 y = _mm256_set_m128(_mm_set1_ps(p[1].y), _mm_set1_ps(p[0].y));
+        __m256 z = _mm256_set_m128(_mm_set1_ps(p[1].z), _mm_set1_ps(p[0].z));
+
+#if defined(__FMA__)
+        __m256 r = _mm256_fmadd_ps(c0, x, c3);
+        r = _mm256_fmadd_ps(c1, y, r);
+        r = _mm256_fmadd_ps(c2, z, r);
+#else
+        __m256 r = _mm256_add_ps(_mm256_mul_ps(c0, x), c3);
+        r = _mm256_add_ps(_mm256_mul_ps(c1, y), r);
+        r = _mm256_add_ps(_mm256_mul_ps(c2, z), r);
+#endif
+
+        _Alignas(32) f32 lanes[8];
+        _mm256_store_ps(lanes, r);
+        _outPoints[i] = Vec3Create(lanes[0], lanes[1], lanes[2]);
+        _outPoints[i + 1] = Vec3Create(lanes[4], lanes[5], lanes[6]);
+    }
+#endif
+
+    //remainder, or everything without AVX2
+    for(; i < _count; ++i)
+        _outPoints[i] = Mat4TransformPoint(_m, _points[i]);
+}
+
+void Mat4TransformVec4s(const Mat4* _m, const Vec4* _vectors, Vec4* _out, u64 _count)
+{
+    u64 i = 0;
+
+#if defined(CMATH_SIMD_AVX2)
+    __m256 c0 = _mm256_broadcast_ps(&_m->columns[0].simd);
+    __m256 c1 = _mm256_broadcast_ps(&_m->columns[1].simd);
+    __m256 c2 = _mm256_broadcast_ps(&_m->columns[2].simd);
+    __m256 c3 = _mm256_broadcast_ps(&_m->columns[3].simd);
+    for(; i + 2 <= _count; i += 2)
+    {
+        //consecutive vectors fill both lanes, a permute broadcasts each component within its lane
+        __m256 v = _mm256_loadu_ps(_vectors[i].elements);
+        __m256 r = _mm256_mul_ps(c0, _mm256_permute_ps(v, 0x00));
+#if defined(__FMA__)
+        r = _mm256_fmadd_ps(c1, _mm256_permute_ps(v, 0x55), r);
+        r = _mm256_fmadd_ps(c2, _mm256_permute_ps(v, 0xAA), r);
+        r = _mm256_fmadd_ps(c3, _mm256_permute_ps(v, 0xFF), r);
+#else
+        r = _mm256_add_ps(_mm256_mul_ps(c1, _mm256_permute_ps(v, 0x55)), r);
+        r = _mm256_add_ps(_mm256_mul_ps(c2, _mm256_permute_ps(v, 0xAA)), r);
+        r = _mm256_add_ps(_mm256_mul_ps(c3, _mm256_permute_ps(v, 0xFF)), r);
+#endif
+        _mm256_storeu_ps(_out[i].elements, r);
+    }
+#endif
+
+    for(; i < _count; ++i)
+        _out[i] = Mat4MulVec4(_m, _vectors[i]);
+}
+
+void Mat4MulArray(const Mat4* _a, const Mat4* _b, Mat4* _out, u64 _count)
+{
+    for(u64 i = 0; i < _count; ++i)
+    {
+        //_b's columns are vectors transformed by _a, two at a time with AVX2
+        Mat4TransformVec4s(&_a[i], _b[i].columns, _out[i].columns, 4);
+    }
+}
+
+void Mat4MulArrayLeft(const Mat4* _m, const Mat4* _in, Mat4* _out, u64 _count)
+{
+    //every column of every matrix is transformed by the same _m, so the whole array is one vector batch
+    Mat4TransformVec4s(_m, &_in[0].columns[0], &_out[0].columns[0], _count * 4);
+}
\ No newline at end of file
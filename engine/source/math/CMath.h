@@ -0,0 +1,369 @@
+#pragma once
+
+#include "MathTypes.inl"
+
+#define C_PI 3.14159265358979323846f
+#define C_PI_2 (2.0f * C_PI)
+#define C_HALF_PI (0.5f * C_PI)
+#define C_DEG2RAD_MULTIPLIER (C_PI / 180.0f)
+#define C_RAD2DEG_MULTIPLIER (180.0f / C_PI)
+#define C_FLOAT_EPSILON 1.192092896e-07f
+
+#define CDEG2RAD(_degrees) ((_degrees) * C_DEG2RAD_MULTIPLIER)
+#define CRAD2DEG(_radians) ((_radians) * C_RAD2DEG_MULTIPLIER)
+
+//multiply add on SIMD registers, a * b + c. Fused when the target has FMA
+#if defined(CMATH_SIMD_SSE)
+#   if defined(__FMA__)
+#       define CMATH_MADD(_a, _b, _c) _mm_fmadd_ps(_a, _b, _c)
+#   else
+#       define CMATH_MADD(_a, _b, _c) _mm_add_ps(_mm_mul_ps(_a, _b), _c)
+#   endif
+#endif
+
+CAPI f32 CSin(f32 _x);
+CAPI f32 CCos(f32 _x);
+CAPI f32 CTan(f32 _x);
+CAPI f32 CAcos(f32 _x);
+CAPI f32 CSqrt(f32 _x);
+CAPI f32 CAbs(f32 _x);
+
+//name of the instruction set the math library was built for, "AVX2", "SSE", "NEON" or "scalar"
+CAPI const char* CMathSimdName();
+
+//vec2
+
+CINLINE Vec2 Vec2Create(f32 _x, f32 _y)
+{
+    Vec2 result = { { _x, _y } };
+    return result;
+}
+
+CINLINE Vec2 Vec2Add(Vec2 _a, Vec2 _b) { return Vec2Create(_a.x + _b.x, _a.y + _b.y); }
+CINLINE Vec2 Vec2Sub(Vec2 _a, Vec2 _b) { return Vec2Create(_a.x - _b.x, _a.y - _b.y); }
+CINLINE Vec2 Vec2Scale(Vec2 _v, f32 _s) { return Vec2Create(_v.x * _s, _v.y * _s); }
+CINLINE f32 Vec2Dot(Vec2 _a, Vec2 _b) { return _a.x * _b.x + _a.y * _b.y; }
+CINLINE f32 Vec2Length(Vec2 _v) { return CSqrt(Vec2Dot(_v, _v)); }
+
+//vec3
+
+CINLINE Vec3 Vec3Create(f32 _x, f32 _y, f32 _z)
+{
+    Vec3 result = { { _x, _y, _z } };
+    return result;
+}
+
+CINLINE Vec3 Vec3Zero() { return Vec3Create(0.f, 0.f, 0.f); }
+CINLINE Vec3 Vec3One() { return Vec3Create(1.f, 1.f, 1.f); }
+CINLINE Vec3 Vec3Up() { return Vec3Create(0.f, 1.f, 0.f); }
+CINLINE Vec3 Vec3Forward() { return Vec3Create(0.f, 0.f, -1.f); }
+
+CINLINE Vec3 Vec3Add(Vec3 _a, Vec3 _b) { return Vec3Create(_a.x + _b.x, _a.y + _b.y, _a.z + _b.z); }
+CINLINE Vec3 Vec3Sub(Vec3 _a, Vec3 _b) { return Vec3Create(_a.x - _b.x, _a.y - _b.y, _a.z - _b.z); }
+CINLINE Vec3 Vec3Mul(Vec3 _a, Vec3 _b) { return Vec3Create(_a.x * _b.x, _a.y * _b.y, _a.z * _b.z); }
+CINLINE Vec3 Vec3Scale(Vec3 _v, f32 _s) { return Vec3Create(_v.x * _s, _v.y * _s, _v.z * _s); }
+CINLINE f32 Vec3Dot(Vec3 _a, Vec3 _b) { return _a.x * _b.x + _a.y * _b.y + _a.z * _b.z; }
+CINLINE f32 Vec3LengthSquared(Vec3 _v) { return Vec3Dot(_v, _v); }
+CINLINE f32 Vec3Length(Vec3 _v) { return CSqrt(Vec3Dot(_v, _v)); }
+
+CINLINE Vec3 Vec3Cross(Vec3 _a, Vec3 _b)
+{
+    return Vec3Create(
+        _a.y * _b.z - _a.z * _b.y,
+        _a.z * _b.x - _a.x * _b.z,
+        _a.x * _b.y - _a.y * _b.x);
+}
+
+//zero length vectors are returned unchanged
+CINLINE Vec3 Vec3Normalize(Vec3 _v)
+{
+    f32 length = Vec3Length(_v);
+    return length > C_FLOAT_EPSILON ? Vec3Scale(_v, 1.f / length) : _v;
+}
+
+CINLINE Vec3 Vec3Lerp(Vec3 _a, Vec3 _b, f32 _t)
+{
+    return Vec3Add(_a, Vec3Scale(Vec3Sub(_b, _a), _t));
+}
+
+//vec4
+
+CINLINE Vec4 Vec4Create(f32 _x, f32 _y, f32 _z, f32 _w)
+{
+    Vec4 result;
+#if defined(CMATH_SIMD_SSE)
+    result.simd = _mm_setr_ps(_x, _y, _z, _w);
+#else
+    result.x = _x;
+    result.y = _y;
+    result.z = _z;
+    result.w = _w;
+#endif
+    return result;
+}
+
+CINLINE Vec4 Vec4FromVec3(Vec3 _v, f32 _w) { return Vec4Create(_v.x, _v.y, _v.z, _w); }
+CINLINE Vec3 Vec4ToVec3(Vec4 _v) { return Vec3Create(_v.x, _v.y, _v.z); }
+
+CINLINE Vec4 Vec4Add(Vec4 _a, Vec4 _b)
+{
+    Vec4 result;
+#if defined(CMATH_SIMD_SSE)
+    result.simd = _mm_add_ps(_a.simd, _b.simd);
+#elif defined(CMATH_SIMD_NEON)
+    result.simd = vaddq_f32(_a.simd, _b.simd);
+#else
+    for(u32 i = 0; i < 4; ++i)
+        result.elements[i] = _a.elements[i] + _b.elements[i];
+#endif
+    return result;
+}
+
+CINLINE Vec4 Vec4Sub(Vec4 _a, Vec4 _b)
+{
+    Vec4 result;
+#if defined(CMATH_SIMD_SSE)
+    result.simd = _mm_sub_ps(_a.simd, _b.simd);
+#elif defined(CMATH_SIMD_NEON)
+    result.simd = vsubq_f32(_a.simd, _b.simd);
+#else
+    for(u32 i = 0; i < 4; ++i)
+        result.elements[i] = _a.elements[i] - _b.elements[i];
+#endif
+    return result;
+}
+
+CINLINE Vec4 Vec4Mul(Vec4 _a, Vec4 _b)
+{
+    Vec4 result;
+#if defined(CMATH_SIMD_SSE)
+    result.simd = _mm_mul_ps(_a.simd, _b.simd);
+#elif defined(CMATH_SIMD_NEON)
+    result.simd = vmulq_f32(_a.simd, _b.simd);
+#else
+    for(u32 i = 0; i < 4; ++i)
+        result.elements[i] = _a.elements[i] * _b.elements[i];
+#endif
+    return result;
+}
+
+CINLINE Vec4 Vec4Scale(Vec4 _v, f32 _s)
+{
+    Vec4 result;
+#if defined(CMATH_SIMD_SSE)
+    result.simd = _mm_mul_ps(_v.simd, _mm_set1_ps(_s));
+#elif defined(CMATH_SIMD_NEON)
+    result.simd = vmulq_n_f32(_v.simd, _s);
+#else
+    for(u32 i = 0; i < 4; ++i)
+        result.elements[i] = _v.elements[i] * _s;
+#endif
+    return result;
+}
+
+CINLINE f32 Vec4Dot(Vec4 _a, Vec4 _b)
+{
+#if defined(CMATH_SIMD_SSE)
+    __m128 product = _mm_mul_ps(_a.simd, _b.simd);
+    __m128 shuffled = _mm_shuffle_ps(product, product, _MM_SHUFFLE(2, 3, 0, 1));
+    __m128 sums = _mm_add_ps(product, shuffled);
+    shuffled = _mm_movehl_ps(shuffled, sums);
+    return _mm_cvtss_f32(_mm_add_ss(sums, shuffled));
+#elif defined(CMATH_SIMD_NEON)
+    return vaddvq_f32(vmulq_f32(_a.simd, _b.simd));
+#else
+    return _a.x * _b.x + _a.y * _b.y + _a.z * _b.z + _a.w * _b.w;
+#endif
+}
+
+CINLINE f32 Vec4Length(Vec4 _v) { return CSqrt(Vec4Dot(_v, _v)); }
+
+CINLINE Vec4 Vec4Normalize(Vec4 _v)
+{
+    f32 length = Vec4Length(_v);
+    return length > C_FLOAT_EPSILON ? Vec4Scale(_v, 1.f / length) : _v;
+}
+
+//quat
+
+CINLINE Quat QuatIdentity() { return Vec4Create(0.f, 0.f, 0.f, 1.f); }
+CINLINE Quat QuatNormalize(Quat _q) { return Vec4Normalize(_q); }
+CINLINE f32 QuatDot(Quat _a, Quat _b) { return Vec4Dot(_a, _b); }
+CINLINE Quat QuatConjugate(Quat _q) { return Vec4Create(-_q.x, -_q.y, -_q.z, _q.w); }
+
+//_a * _b applies _b first, then _a
+CINLINE Quat QuatMul(Quat _a, Quat _b)
+{
+    return Vec4Create(
+        _a.w * _b.x + _a.x * _b.w + _a.y * _b.z - _a.z * _b.y,
+        _a.w * _b.y - _a.x * _b.z + _a.y * _b.w + _a.z * _b.x,
+        _a.w * _b.z + _a.x * _b.y - _a.y * _b.x + _a.z * _b.w,
+        _a.w * _b.w - _a.x * _b.x - _a.y * _b.y - _a.z * _b.z);
+}
+
+//_axis must be normalized
+CINLINE Quat QuatFromAxisAngle(Vec3 _axis, f32 _radians)
+{
+    f32 s = CSin(_radians * 0.5f);
+    return Vec4Create(_axis.x * s, _axis.y * s, _axis.z * s, CCos(_radians * 0.5f));
+}
+
+//rotates _v by the unit quaternion _q
+CINLINE Vec3 QuatRotateVec3(Quat _q, Vec3 _v)
+{
+    //v + 2w(u x v) + 2(u x (u x v)), u being the vector part
+    Vec3 u = Vec3Create(_q.x, _q.y, _q.z);
+    Vec3 t = Vec3Scale(Vec3Cross(u, _v), 2.f);
+    return Vec3Add(Vec3Add(_v, Vec3Scale(t, _q.w)), Vec3Cross(u, t));
+}
+
+//shortest path spherical interpolation between unit quaternions
+CAPI Quat QuatSlerp(Quat _a, Quat _b, f32 _t);
+
+//mat4
+
+CINLINE Mat4 Mat4Identity()
+{
+    Mat4 result;
+    result.columns[0] = Vec4Create(1.f, 0.f, 0.f, 0.f);
+    result.columns[1] = Vec4Create(0.f, 1.f, 0.f, 0.f);
+    result.columns[2] = Vec4Create(0.f, 0.f, 1.f, 0.f);
+    result.columns[3] = Vec4Create(0.f, 0.f, 0.f, 1.f);
+    return result;
+}
+
+CINLINE Vec4 Mat4MulVec4(const Mat4* _m, Vec4 _v)
+{
+    Vec4 result;
+#if defined(CMATH_SIMD_SSE)
+    __m128 r = _mm_mul_ps(_m->columns[0].simd, _mm_set1_ps(_v.x));
+    r = CMATH_MADD(_m->columns[1].simd, _mm_set1_ps(_v.y), r);
+    r = CMATH_MADD(_m->columns[2].simd, _mm_set1_ps(_v.z), r);
+    result.simd = CMATH_MADD(_m->columns[3].simd, _mm_set1_ps(_v.w), r);
+#elif defined(CMATH_SIMD_NEON)
+    float32x4_t r = vmulq_n_f32(_m->columns[0].simd, _v.x);
+    r = vmlaq_n_f32(r, _m->columns[1].simd, _v.y);
+    r = vmlaq_n_f32(r, _m->columns[2].simd, _v.z);
+    result.simd = vmlaq_n_f32(r, _m->columns[3].simd, _v.w);
+#else
+    for(u32 row = 0; row < 4; ++row)
+    {
+        result.elements[row] =
+            _m->data[row] * _v.x +
+            _m->data[4 + row] * _v.y +
+            _m->data[8 + row] * _v.z +
+            _m->data[12 + row] * _v.w;
+    }
+#endif
+    return result;
+}
+
+//_a * _b, transforms by _b first and then by _a
+CINLINE Mat4 Mat4Mul(const Mat4* _a, const Mat4* _b)
+{
+    Mat4 result;
+    for(u32 i = 0; i < 4; ++i)
+        result.columns[i] = Mat4MulVec4(_a, _b->columns[i]);
+    return result;
+}
+
+//point with w = 1, the result is not divided by w
+CINLINE Vec3 Mat4TransformPoint(const Mat4* _m, Vec3 _p)
+{
+    return Vec4ToVec3(Mat4MulVec4(_m, Vec4FromVec3(_p, 1.f)));
+}
+
+//direction with w = 0, translation does not apply
+CINLINE Vec3 Mat4TransformDirection(const Mat4* _m, Vec3 _d)
+{
+    return Vec4ToVec3(Mat4MulVec4(_m, Vec4FromVec3(_d, 0.f)));
+}
+
+CINLINE Mat4 Mat4Transpose(const Mat4* _m)
+{
+    Mat4 result = *_m;
+#if defined(CMATH_SIMD_SSE)
+    _MM_TRANSPOSE4_PS(result.columns[0].simd, result.columns[1].simd, result.columns[2].simd, result.columns[3].simd);
+#else
+    for(u32 column = 0; column < 4; ++column)
+    {
+        for(u32 row = 0; row < 4; ++row)
+            result.data[column * 4 + row] = _m->data[row * 4 + column];
+    }
+#endif
+    return result;
+}
+
+CINLINE Mat4 Mat4Translation(Vec3 _t)
+{
+    Mat4 result = Mat4Identity();
+    result.columns[3] = Vec4FromVec3(_t, 1.f);
+    return result;
+}
+
+CINLINE Mat4 Mat4Scale(Vec3 _s)
+{
+    Mat4 result = Mat4Identity();
+    result.data[0] = _s.x;
+    result.data[5] = _s.y;
+    result.data[10] = _s.z;
+    return result;
+}
+
+//rotation matrix of the unit quaternion _q
+CINLINE Mat4 Mat4FromQuat(Quat _q)
+{
+    f32 xx = _q.x * _q.x, yy = _q.y * _q.y, zz = _q.z * _q.z;
+    f32 xy = _q.x * _q.y, xz = _q.x * _q.z, yz = _q.y * _q.z;
+    f32 wx = _q.w * _q.x, wy = _q.w * _q.y, wz = _q.w * _q.z;
+
+    Mat4 result;
+    result.columns[0] = Vec4Create(1.f - 2.f * (yy + zz), 2.f * (xy + wz), 2.f * (xz - wy), 0.f);
+    result.columns[1] = Vec4Create(2.f * (xy - wz), 1.f - 2.f * (xx + zz), 2.f * (yz + wx), 0.f);
+    result.columns[2] = Vec4Create(2.f * (xz + wy), 2.f * (yz - wx), 1.f - 2.f * (xx + yy), 0.f);
+    result.columns[3] = Vec4Create(0.f, 0.f, 0.f, 1.f);
+    return result;
+}
+
+//translation * rotation * scale without the two matrix multiplies
+CINLINE Mat4 Mat4FromTRS(Vec3 _translation, Quat _rotation, Vec3 _scale)
+{
+    Mat4 result = Mat4FromQuat(_rotation);
+    result.columns[0] = Vec4Scale(result.columns[0], _scale.x);
+    result.columns[1] = Vec4Scale(result.columns[1], _scale.y);
+    result.columns[2] = Vec4Scale(result.columns[2], _scale.z);
+    result.columns[3] = Vec4FromVec3(_translation, 1.f);
+    return result;
+}
+
+/**
+ * Right handed perspective projection with a 0 to 1 depth range, as Vulkan expects.
+ * Y points up, the viewport is expected to be flipped.
+ */
+CAPI Mat4 Mat4Perspective(f32 _fovRadians, f32 _aspect, f32 _near, f32 _far);
+
+//right handed orthographic projection with a 0 to 1 depth range
+CAPI Mat4 Mat4Orthographic(f32 _left, f32 _right, f32 _bottom, f32 _top, f32 _near, f32 _far);
+
+//right handed view matrix looking from _eye at _target
+CAPI Mat4 Mat4LookAt(Vec3 _eye, Vec3 _target, Vec3 _up);
+
+//general inverse, returns identity for singular matrices
+CAPI Mat4 Mat4Inverse(const Mat4* _m);
+
+//inverse of a rotation and translation without scale, much cheaper than Mat4Inverse
+CAPI Mat4 Mat4InverseRigid(const Mat4* _m);
+
+//batches, the arrays may not overlap unless stated otherwise
+
+//_outPoints[i] = _m * (_points[i], 1), not divided by w. _points and _outPoints may be the same array
+CAPI void Mat4TransformPoints(const Mat4* _m, const Vec3* _points, Vec3* _outPoints, u64 _count);
+
+//_out[i] = _m * _vectors[i]. _vectors and _out may be the same array
+CAPI void Mat4TransformVec4s(const Mat4* _m, const Vec4* _vectors, Vec4* _out, u64 _count);
+
+//_out[i] = _a[i] * _b[i]
+CAPI void Mat4MulArray(const Mat4* _a, const Mat4* _b, Mat4* _out, u64 _count);
+
+//_out[i] = _m * _in[i], e.g. a parent or view projection applied to many locals. _in and _out may be the same array
+CAPI void Mat4MulArrayLeft(const Mat4* _m, const Mat4* _in, Mat4* _out, u64 _count);
\ No newline at end of file
@@ -0,0 +1,77 @@
+#pragma once
+
+#include "Defines.h"
+
+//instruction set, picked at compile time from the target flags, the build scripts add AVX2 and FMA
+//with CMATH_SIMD=avx2. Define CMATH_FORCE_SCALAR to build the plain C paths, e.g. to compare results
+//against a SIMD build
+#if defined(CMATH_FORCE_SCALAR)
+#   define CMATH_SIMD_SCALAR 1
+#elif defined(__AVX2__)
+#   define CMATH_SIMD_AVX2 1
+#   define CMATH_SIMD_SSE 1
+#elif defined(__SSE2__) || defined(_M_X64)
+#   define CMATH_SIMD_SSE 1
+#elif defined(__ARM_NEON) || defined(__ARM_NEON__)
+#   define CMATH_SIMD_NEON 1
+#else
+#   define CMATH_SIMD_SCALAR 1
+#endif
+
+//FMA intrinsics live in immintrin.h too, the target may have FMA without AVX2
+#if defined(CMATH_SIMD_AVX2) || (defined(CMATH_SIMD_SSE) && defined(__FMA__))
+#   include <immintrin.h>
+#elif defined(CMATH_SIMD_SSE)
+#   include <emmintrin.h>
+#elif defined(CMATH_SIMD_NEON)
+#   include <arm_neon.h>
+#endif
+
+typedef union Vec2
+{
+    f32 elements[2];
+    struct
+    {
+        union { f32 x, r, s, u; };
+        union { f32 y, g, t, v; };
+    };
+} Vec2;
+
+typedef union Vec3
+{
+    f32 elements[3];
+    struct
+    {
+        union { f32 x, r, s, u; };
+        union { f32 y, g, t, v; };
+        union { f32 z, b, p, w; };
+    };
+} Vec3;
+
+//16 byte aligned so it loads straight into a SIMD register
+typedef union Vec4
+{
+#if defined(CMATH_SIMD_SSE)
+    __m128 simd;
+#elif defined(CMATH_SIMD_NEON)
+    float32x4_t simd;
+#endif
+    _Alignas(16) f32 elements[4];
+    struct
+    {
+        union { f32 x, r, s; };
+        union { f32 y, g, t; };
+        union { f32 z, b, p; };
+        union { f32 w, a, q; };
+    };
+} Vec4;
+
+//x, y, z is the vector part and w the scalar part
+typedef Vec4 Quat;
+
+//column major like GLSL, data[column * 4 + row]
+typedef union Mat4
+{
+    _Alignas(16) f32 data[16];
+    Vec4 columns[4];
+} Mat4;
\ No newline at end of file
@@ -0,0 +1,241 @@
+#include "Filesystem.h"
+
+#include "core/Logger.h"
+
+#include <stdio.h>
+#include <string.h>
+#include <sys/stat.h>
+
+#if CPLATFORM_WINDOWS
+#   include <windows.h>
+#   include <io.h>
+#else
+#   include <fcntl.h>
+#   include <sys/mman.h>
+#   include <unistd.h>
+#endif
+
+b8 FilesystemExists(const char* _path)
+{
+#if CPLATFORM_WINDOWS
+    struct _stat buffer;
+    return _stat(_path, &buffer) == 0;
+#else
+    struct stat buffer;
+    return stat(_path, &buffer) == 0;
+#endif
+}
+
+b8 FilesystemOpen(const char* _path, FileModes _mode, b8 _binary, FileHandle* _outHandle)
+{
+    _outHandle->isValid = FALSE;
+    _outHandle->handle = 0;
+    const char* modeStr;
+
+    if((_mode & FILE_MODE_READ) != 0 && (_mode & FILE_MODE_WRITE) != 0)
+        modeStr = _binary ? "w+b" : "w+";
+    else if((_mode & FILE_MODE_READ) != 0 && (_mode & FILE_MODE_WRITE) == 0)
+        modeStr = _binary ? "rb" : "r";
+    else if((_mode & FILE_MODE_READ) == 0 && (_mode & FILE_MODE_WRITE) != 0)
+        modeStr = _binary ? "wb" : "w";
+    else
+    {
+        LOG_ERROR("Invalid mode passed while trying to open file: '%s'", _path);
+        return FALSE;
+    }
+
+    //attempt to open the file
+    FILE* file = fopen(_path, modeStr);
+    if(!file)
+        return FALSE;
+
+    _outHandle->handle = file;
+    _outHandle->isValid = TRUE;
+
+    return TRUE;
+}
+
+void FilesystemClose(FileHandle* _handle)
+{
+    if(_handle->handle)
+    {
+        fclose((FILE*)_handle->handle);
+        _handle->handle = 0;
+        _handle->isValid = FALSE;
+    }
+}
+
+b8 FilesystemSize(FileHandle* _handle, u64* _outSize)
+{
+    if(!_handle->handle)
+        return FALSE;
+
+    FILE* file = (FILE*)_handle->handle;
+    fseek(file, 0, SEEK_END);
+    long size = ftell(file);
+    rewind(file);
+
+    if(size < 0)
+        return FALSE;
+
+    *_outSize = (u64)size;
+    return TRUE;
+}
+
+b8 FilesystemReadAllBytes(FileHandle* _handle, u8* _outBytes, u64* _outBytesRead)
+{
+    if(!_handle->handle || !_outBytes || !_outBytesRead)
+        return FALSE;
+
+    u64 size = 0;
+    if(!FilesystemSize(_handle, &size))
+        return FALSE;
+
+    *_outBytesRead = fread(_outBytes, 1, size, (FILE*)_handle->handle);
+    return *_outBytesRead == size;
+}
+
+b8 FilesystemWrite(FileHandle* _handle, u64 _dataSize, const void* _data, u64* _outBytesWritten)
+{
+    if(!_handle->handle)
+        return FALSE;
+
+    *_outBytesWritten = fwrite(_data, 1, _dataSize, (FILE*)_handle->handle);
+    if(*_outBytesWritten != _dataSize)
+        return FALSE;
+
+    fflush((FILE*)_handle->handle);
+    return TRUE;
+}
+
+b8 FilesystemWriteAtomic(const char* _path, u64 _dataSize, const void* _data)
+{
+    char tempPath[512];
+    i32 length = snprintf(tempPath, sizeof(tempPath), "%s.tmp", _path);
+    if(length < 0 || length >= (i32)sizeof(tempPath))
+    {
+        LOG_ERROR("FilesystemWriteAtomic path too long: '%s'", _path);
+        return FALSE;
+    }
+
+    FileHandle handle;
+    if(!FilesystemOpen(tempPath, FILE_MODE_WRITE, TRUE, &handle))
+    {
+        LOG_ERROR("FilesystemWriteAtomic unable to open temporary file: '%s'", tempPath);
+        return FALSE;
+    }
+
+    u64 written = 0;
+    b8 result = FilesystemWrite(&handle, _dataSize, _data, &written);
+
+    //the data has to reach the disk before the rename does, otherwise a crash can leave an empty file in place
+    if(result)
+    {
+        FILE* file = (FILE*)handle.handle;
+#if CPLATFORM_WINDOWS
+        result = fflush(file) == 0 && FlushFileBuffers((HANDLE)_get_osfhandle(_fileno(file))) != 0;
+#else
+        result = fflush(file) == 0 && fsync(fileno(file)) == 0;
+#endif
+    }
+    FilesystemClose(&handle);
+
+    if(!result)
+    {
+        LOG_ERROR("FilesystemWriteAtomic failed to write or flush '%s' (%llu of %llu bytes).", tempPath, written, _dataSize);
+        remove(tempPath);
+        return FALSE;
+    }
+
+    //swap the complete file into place
+#if CPLATFORM_WINDOWS
+    result = MoveFileExA(tempPath, _path, MOVEFILE_REPLACE_EXISTING | MOVEFILE_WRITE_THROUGH) != 0;
+#else
+    result = rename(tempPath, _path) == 0;
+#endif
+
+    if(!result)
+    {
+        LOG_ERROR("FilesystemWriteAtomic failed to replace '%s'.", _path);
+        remove(tempPath);
+        return FALSE;
+    }
+
+    return TRUE;
+}
+
+b8 FilesystemMapRead(const char* _path, FileMapping* _outMapping)
+{
+    _outMapping->data = 0;
+    _outMapping->size = 0;
+    _outMapping->handle = 0;
+
+#if CPLATFORM_WINDOWS
+    HANDLE file = CreateFileA(_path, GENERIC_READ, FILE_SHARE_READ, 0, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, 0);
+    if(file == INVALID_HANDLE_VALUE)
+        return FALSE;
+
+    LARGE_INTEGER size;
+    if(!GetFileSizeEx(file, &size) || size.QuadPart == 0)
+    {
+        CloseHandle(file);
+        return FALSE;
+    }
+
+    //the mapping keeps the file open, the file handle is not needed past this point
+    HANDLE mapping = CreateFileMappingA(file, 0, PAGE_READONLY, 0, 0, 0);
+    CloseHandle(file);
+    if(!mapping)
+        return FALSE;
+
+    const void* data = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+    if(!data)
+    {
+        CloseHandle(mapping);
+        return FALSE;
+    }
+
+    _outMapping->data = data;
+    _outMapping->size = (u64)size.QuadPart;
+    _outMapping->handle = mapping;
+#else
+    i32 file = open(_path, O_RDONLY);
+    if(file < 0)
+        return FALSE;
+
+    struct stat status;
+    if(fstat(file, &status) != 0 || status.st_size == 0)
+    {
+        close(file);
+        return FALSE;
+    }
+
+    //the mapping stays valid after the descriptor is closed
+    void* data = mmap(0, (size_t)status.st_size, PROT_READ, MAP_PRIVATE, file, 0);
+    close(file);
+    if(data == MAP_FAILED)
+        return FALSE;
+
+    _outMapping->data = data;
+    _outMapping->size = (u64)status.st_size;
+#endif
+
+    return TRUE;
+}
+
+void FilesystemUnmap(FileMapping* _mapping)
+{
+    if(!_mapping->data)
+        return;
+
+#if CPLATFORM_WINDOWS
+    UnmapViewOfFile(_mapping->data);
+    CloseHandle((HANDLE)_mapping->handle);
+#else
+    munmap((void*)_mapping->data, (size_t)_mapping->size);
+#endif
+
+    _mapping->data = 0;
+    _mapping->size = 0;
+    _mapping->handle = 0;
+}
\ No newline at end of file
@@ -0,0 +1,101 @@
+#pragma once
+
+#include "Defines.h"
+
+//holds a handle to a file
+typedef struct FileHandle
+{
+    //opaque handle to internal file handle
+    void* handle;
+    b8 isValid;
+} FileHandle;
+
+//a read only view of a whole file, see FilesystemMapRead
+typedef struct FileMapping
+{
+    const void* data;
+    u64 size;
+
+    //opaque mapping object on platforms that need one
+    void* handle;
+} FileMapping;
+
+typedef enum FileModes
+{
+    FILE_MODE_READ = 0x1,
+    FILE_MODE_WRITE = 0x2
+} FileModes;
+
+/**
+ * Checks if a file with the given path exists.
+ * @param _path The path of the file to be checked.
+ * @returns TRUE if exists, otherwise FALSE.
+ */
+CAPI b8 FilesystemExists(const char* _path);
+
+/**
+ * Attempt to open file located at path.
+ * @param _path The path of the file to be opened.
+ * @param _mode Mode flags for the file when opened (read/write). See FileModes enum.
+ * @param _binary Indicates if the file should be opened in binary mode.
+ * @param _outHandle A pointer to a FileHandle structure which holds the handle information.
+ * @returns TRUE if opened successfully, otherwise FALSE.
+ */
+CAPI b8 FilesystemOpen(const char* _path, FileModes _mode, b8 _binary, FileHandle* _outHandle);
+
+/**
+ * Closes the provided handle to a file.
+ * @param _handle A pointer to a FileHandle structure which holds the handle to be closed.
+ */
+CAPI void FilesystemClose(FileHandle* _handle);
+
+/**
+ * Obtains the size of the file in bytes.
+ * @param _handle A pointer to a FileHandle structure.
+ * @param _outSize A pointer to hold the file size.
+ * @returns TRUE if successful, otherwise FALSE.
+ */
+CAPI b8 FilesystemSize(FileHandle* _handle, u64* _outSize);
+
+/**
+ * Reads all bytes of data into _outBytes, which must be at least FilesystemSize bytes.
+ * @param _handle A pointer to a FileHandle structure.
+ * @param _outBytes A byte array which will be populated by this method.
+ * @param _outBytesRead A pointer to a number which will be populated with the number of bytes actually read.
+ * @returns TRUE if successful, otherwise FALSE.
+ */
+CAPI b8 FilesystemReadAllBytes(FileHandle* _handle, u8* _outBytes, u64* _outBytesRead);
+
+/**
+ * Writes provided data to the file.
+ * @param _handle A pointer to a FileHandle structure.
+ * @param _dataSize The size of the data in bytes.
+ * @param _data The data to be written.
+ * @param _outBytesWritten A pointer to a number which will be populated with the number of bytes actually written.
+ * @returns TRUE if successful, otherwise FALSE.
+ */
+CAPI b8 FilesystemWrite(FileHandle* _handle, u64 _dataSize, const void* _data, u64* _outBytesWritten);
+
+/**
+ * Writes the data to a temporary file next to _path, flushes it to disk, then renames it over _path.
+ * Readers will either see the previous file or the complete new one, never a partial write.
+ * @param _path The path of the file to be replaced.
+ * @param _dataSize The size of the data in bytes.
+ * @param _data The data to be written.
+ * @returns TRUE if successful, otherwise FALSE.
+ */
+CAPI b8 FilesystemWriteAtomic(const char* _path, u64 _dataSize, const void* _data);
+
+/**
+ * Maps a whole file into memory read only. Pages are read on first access instead of copied up front.
+ * @param _path The path of the file to be mapped.
+ * @param _outMapping A pointer to a FileMapping structure, its data is page aligned.
+ * @returns TRUE if mapped successfully, otherwise FALSE. Empty files cannot be mapped.
+ */
+CAPI b8 FilesystemMapRead(const char* _path, FileMapping* _outMapping);
+
+/**
+ * Releases a mapping created by FilesystemMapRead, its data must not be accessed afterwards.
+ * @param _mapping A pointer to a FileMapping structure.
+ */
+CAPI void FilesystemUnmap(FileMapping* _mapping);
\ No newline at end of file
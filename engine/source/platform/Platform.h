@@ -24,6 +24,34 @@ void PlatformConsoleWriteError(const char* _msg, u8 _color);
 
 f64 PlatformGetAbsoluteTime();
 
+//number of logical processors, at least 1
+i32 PlatformGetProcessorCount();
+
+//directory of the running executable with a trailing separator, FALSE if it does not fit or cannot be queried
+b8 PlatformGetExecutableDirectory(char* _outPath, u64 _pathSize);
+
+typedef u32 (*PlatformThreadStart)(void* _params);
+
+typedef struct PlatformThread
+{
+    void* internalData;
+} PlatformThread;
+
+typedef struct PlatformSemaphore
+{
+    void* internalData;
+} PlatformSemaphore;
+
+b8 PlatformThreadCreate(PlatformThreadStart _start, void* _params, PlatformThread* _outThread);
+
+//blocks until the thread returns, then releases it
+void PlatformThreadJoin(PlatformThread* _thread);
+
+b8 PlatformSemaphoreCreate(u32 _initialCount, PlatformSemaphore* _outSemaphore);
+void PlatformSemaphoreDestroy(PlatformSemaphore* _semaphore);
+void PlatformSemaphoreSignal(PlatformSemaphore* _semaphore);
+void PlatformSemaphoreWait(PlatformSemaphore* _semaphore);
+
 //sleep on thread for provided ms, blocks main thread.
 //Should only be used for giving time back to the OS for unused update power, therefore not being exported
 void PlatformSleep(u64 _ms);
\ No newline at end of file
@@ -9,6 +9,7 @@
 #include "containers/DArray.h"
 
 #include <xcb/xcb.h>
+#include <xcb/xinput.h> //sudo apt-get install libxcb-xinput-dev
 #include <X11/keysym.h>
 #include <X11/XKBlib.h> //sudo apt-get install libx11-dev
 #include <X11/Xlib.h>
@@ -24,6 +25,9 @@
 #include <stdlib.h>
 #include <stdio.h>
 #include <string.h>
+#include <pthread.h>
+#include <semaphore.h>
+#include <unistd.h> //sysconf
 
 //for surface creation
 #define VK_USE_PLATFORM_XCB_KHR
@@ -39,11 +43,24 @@ typedef struct InternalState
     xcb_atom_t wmProtocols;
     xcb_atom_t wmDeleteWin;
     VkSurfaceKHR surface;
+
+    //XInput2 raw motion
+    b8 rawInputEnabled;
+    u8 xinputOpcode;
+    b8 hasFocus;
+
+    //sub-pixel raw motion carried over between pumps
+    f64 rawRemainderX;
+    f64 rawRemainderY;
 } InternalState;
 
 //key translation
 Keys TranslateKeycode(u32 _xKeycode);
 
+//XInput2 raw motion
+b8 RawInputInitialize(InternalState* _state);
+void RawInputAccumulate(xcb_input_raw_motion_event_t* _event, f64* _deltaX, f64* _deltaY);
+
 b8 PlatformStartup(PlatformState* _state, const char* _appName, i32 _x, i32 _y, i32 _width, i32 _height)
 {
     //create internal state
@@ -91,7 +108,7 @@ b8 PlatformStartup(PlatformState* _state, const char* _appName, i32 _x, i32 _y,
     u32 eventValues =   XCB_EVENT_MASK_BUTTON_PRESS | XCB_EVENT_MASK_BUTTON_RELEASE |
                         XCB_EVENT_MASK_KEY_PRESS | XCB_EVENT_MASK_KEY_RELEASE       |
                         XCB_EVENT_MASK_EXPOSURE | XCB_EVENT_MASK_POINTER_MOTION     |
-                        XCB_EVENT_MASK_STRUCTURE_NOTIFY;
+                        XCB_EVENT_MASK_STRUCTURE_NOTIFY | XCB_EVENT_MASK_FOCUS_CHANGE;
 
     u32 valueList[] = { state->screen->black_pixel, eventValues };
 
@@ -155,6 +172,12 @@ b8 PlatformStartup(PlatformState* _state, const char* _appName, i32 _x, i32 _y,
         1,
         &wmDeleteReply->atom);
 
+    //raw mouse motion, falls back to core pointer events only if unavailable
+    state->hasFocus = FALSE;
+    state->rawRemainderX = 0;
+    state->rawRemainderY = 0;
+    state->rawInputEnabled = RawInputInitialize(state);
+
     //map window to screen
     xcb_map_window(state->connection, state->window);
 
@@ -190,13 +213,19 @@ b8 PlatformPumpMessages(PlatformState* _state)
 
     b8 quitFlagged = FALSE;
 
+    //high rate mice can deliver dozens of motion events per pump, so motion and wheel
+    //are accumulated here and handed to the input subsystem once after the queue is drained
+    b8 motionPending = FALSE;
+    i16 motionX = 0;
+    i16 motionY = 0;
+    i32 wheelDelta = 0;
+    f64 rawDeltaX = state->rawRemainderX;
+    f64 rawDeltaY = state->rawRemainderY;
+
     //poll for events until null is returned
+    event = xcb_poll_for_event(state->connection);
     while(event != 0)
     {
-        event = xcb_poll_for_event(state->connection);
-        if(event == 0)
-            break;
-
         switch(event->response_type & ~0x80)
         {
             case XCB_KEY_PRESS:
@@ -221,7 +250,7 @@ b8 PlatformPumpMessages(PlatformState* _state)
             case XCB_BUTTON_RELEASE:
             {
                 xcb_button_press_event_t* mouseEvent = (xcb_button_press_event_t*)event;
-                b8 pressed = event->response_type == XCB_BUTTON_PRESS;
+                b8 pressed = (event->response_type & ~0x80) == XCB_BUTTON_PRESS;
                 Buttons mouseButton = BUTTON_MAX_BUTTONS;
                 switch(mouseEvent->detail)
                 {
@@ -234,6 +263,15 @@ b8 PlatformPumpMessages(PlatformState* _state)
                     case XCB_BUTTON_INDEX_3:
                         mouseButton = BUTTON_RIGHT;
                         break;
+                    //X reports the wheel as buttons 4 (up) and 5 (down), only the press is meaningful
+                    case XCB_BUTTON_INDEX_4:
+                        if(pressed)
+                            wheelDelta++;
+                        break;
+                    case XCB_BUTTON_INDEX_5:
+                        if(pressed)
+                            wheelDelta--;
+                        break;
                 }
 
                 //pass to input subsystem
@@ -242,12 +280,30 @@ b8 PlatformPumpMessages(PlatformState* _state)
             } break;
             case XCB_MOTION_NOTIFY:
             {
-                //mouse movement
+                //mouse movement, only the latest position matters
                 xcb_motion_notify_event_t* moveEvent = (xcb_motion_notify_event_t*)event;
-
-                //pass to input subsystem
-                InputProcessMouseMove(moveEvent->event_x, moveEvent->event_y);
+                motionPending = TRUE;
+                motionX = moveEvent->event_x;
+                motionY = moveEvent->event_y;
             } break;
+            case XCB_GE_GENERIC:
+            {
+                xcb_ge_generic_event_t* genericEvent = (xcb_ge_generic_event_t*)event;
+                if(state->rawInputEnabled &&
+                    genericEvent->extension == state->xinputOpcode &&
+                    genericEvent->event_type == XCB_INPUT_RAW_MOTION)
+                {
+                    //raw events are delivered on the root window regardless of focus
+                    if(state->hasFocus)
+                        RawInputAccumulate((xcb_input_raw_motion_event_t*)event, &rawDeltaX, &rawDeltaY);
+                }
+            } break;
+            case XCB_FOCUS_IN:
+                state->hasFocus = TRUE;
+                break;
+            case XCB_FOCUS_OUT:
+                state->hasFocus = FALSE;
+                break;
             case XCB_CONFIGURE_NOTIFY:
             {
                 // Resizing - note that this is also triggered by moving the window, but should be
@@ -278,6 +334,26 @@ b8 PlatformPumpMessages(PlatformState* _state)
         }
 
         free(event);
+        event = xcb_poll_for_event(state->connection);
+    }
+
+    //pass accumulated mouse state to input subsystem
+    if(motionPending)
+        InputProcessMouseMove(motionX, motionY);
+
+    //one OS independent (-1, 1) event per notch, like Win32 fires one per WM_MOUSEWHEEL
+    i8 wheelStep = (wheelDelta < 0) ? -1 : 1;
+    for(i32 i = wheelDelta < 0 ? -wheelDelta : wheelDelta; i > 0; --i)
+        InputProcessMouseWheel(wheelStep);
+
+    if(state->rawInputEnabled)
+    {
+        //whole units are reported, the fraction carries into the next pump
+        i32 wholeX = (i32)rawDeltaX;
+        i32 wholeY = (i32)rawDeltaY;
+        state->rawRemainderX = rawDeltaX - wholeX;
+        state->rawRemainderY = rawDeltaY - wholeY;
+        InputProcessMouseRawMotion(wholeX, wholeY);
     }
 
     return !quitFlagged;
@@ -329,6 +405,107 @@ f64 PlatformGetAbsoluteTime()
     return now.tv_sec + now.tv_nsec * 0.000000001;
 }
 
+i32 PlatformGetProcessorCount()
+{
+    long count = sysconf(_SC_NPROCESSORS_ONLN);
+    return count > 0 ? (i32)count : 1;
+}
+
+b8 PlatformGetExecutableDirectory(char* _outPath, u64 _pathSize)
+{
+    //readlink does not terminate the string
+    ssize_t length = readlink("/proc/self/exe", _outPath, _pathSize - 1);
+    if(length <= 0 || (u64)length >= _pathSize - 1)
+        return FALSE;
+
+    _outPath[length] = 0;
+    char* separator = strrchr(_outPath, '/');
+    if(!separator)
+        return FALSE;
+
+    separator[1] = 0;
+    return TRUE;
+}
+
+typedef struct LinuxThread
+{
+    pthread_t handle;
+    PlatformThreadStart start;
+    void* params;
+} LinuxThread;
+
+void* LinuxThreadEntry(void* _thread)
+{
+    LinuxThread* thread = (LinuxThread*)_thread;
+    thread->start(thread->params);
+    return 0;
+}
+
+b8 PlatformThreadCreate(PlatformThreadStart _start, void* _params, PlatformThread* _outThread)
+{
+    LinuxThread* thread = malloc(sizeof(LinuxThread));
+    thread->start = _start;
+    thread->params = _params;
+    if(pthread_create(&thread->handle, 0, LinuxThreadEntry, thread) != 0)
+    {
+        LOG_ERROR("pthread_create failed.");
+        free(thread);
+        _outThread->internalData = 0;
+        return FALSE;
+    }
+
+    _outThread->internalData = thread;
+    return TRUE;
+}
+
+void PlatformThreadJoin(PlatformThread* _thread)
+{
+    LinuxThread* thread = (LinuxThread*)_thread->internalData;
+    if(!thread)
+        return;
+
+    pthread_join(thread->handle, 0);
+    free(thread);
+    _thread->internalData = 0;
+}
+
+b8 PlatformSemaphoreCreate(u32 _initialCount, PlatformSemaphore* _outSemaphore)
+{
+    sem_t* semaphore = malloc(sizeof(sem_t));
+    if(sem_init(semaphore, 0, _initialCount) != 0)
+    {
+        LOG_ERROR("sem_init failed.");
+        free(semaphore);
+        _outSemaphore->internalData = 0;
+        return FALSE;
+    }
+
+    _outSemaphore->internalData = semaphore;
+    return TRUE;
+}
+
+void PlatformSemaphoreDestroy(PlatformSemaphore* _semaphore)
+{
+    if(!_semaphore->internalData)
+        return;
+
+    sem_destroy((sem_t*)_semaphore->internalData);
+    free(_semaphore->internalData);
+    _semaphore->internalData = 0;
+}
+
+void PlatformSemaphoreSignal(PlatformSemaphore* _semaphore)
+{
+    sem_post((sem_t*)_semaphore->internalData);
+}
+
+void PlatformSemaphoreWait(PlatformSemaphore* _semaphore)
+{
+    //retry when interrupted by a signal handler
+    while(sem_wait((sem_t*)_semaphore->internalData) != 0)
+        ;
+}
+
 void PlatformSleep(u64 _ms)
 {
 #if _POSIX_C_SOURCE >= 199309L
@@ -376,6 +553,77 @@ b8 PlatformCreateVulkanSurface(struct PlatformState* _state, struct VulkanContex
     return TRUE;
 }
 
+b8 RawInputInitialize(InternalState* _state)
+{
+    const xcb_query_extension_reply_t* extension = xcb_get_extension_data(_state->connection, &xcb_input_id);
+    if(!extension || !extension->present)
+    {
+        LOG_WARN("XInput extension not present, raw mouse motion disabled.");
+        return FALSE;
+    }
+
+    //raw events require XI 2.0, the server must be told which version is understood before selecting
+    xcb_input_xi_query_version_cookie_t versionCookie = xcb_input_xi_query_version(_state->connection, 2, 0);
+    xcb_input_xi_query_version_reply_t* versionReply = xcb_input_xi_query_version_reply(_state->connection, versionCookie, NULL);
+    if(!versionReply || versionReply->major_version < 2)
+    {
+        LOG_WARN("XInput2 not supported by the X server, raw mouse motion disabled.");
+        free(versionReply);
+        return FALSE;
+    }
+    free(versionReply);
+
+    //raw events can only be selected on the root window
+    struct
+    {
+        xcb_input_event_mask_t header;
+        u32 mask;
+    } rawMask;
+    rawMask.header.deviceid = XCB_INPUT_DEVICE_ALL_MASTER;
+    rawMask.header.mask_len = 1;
+    rawMask.mask = XCB_INPUT_XI_EVENT_MASK_RAW_MOTION;
+
+    xcb_generic_error_t* error = xcb_request_check(
+        _state->connection,
+        xcb_input_xi_select_events_checked(_state->connection, _state->screen->root, 1, &rawMask.header));
+    if(error)
+    {
+        LOG_WARN("Failed to select XInput2 raw motion events (error %d), raw mouse motion disabled.", error->error_code);
+        free(error);
+        return FALSE;
+    }
+
+    _state->xinputOpcode = extension->major_opcode;
+    LOG_INFO("XInput2 raw mouse motion enabled.");
+    return TRUE;
+}
+
+void RawInputAccumulate(xcb_input_raw_motion_event_t* _event, f64* _deltaX, f64* _deltaY)
+{
+    //values are only present for valuators whose bit is set in the mask, in mask order
+    u32* valuatorMask = xcb_input_raw_button_press_valuator_mask(_event);
+    xcb_input_fp3232_t* values = xcb_input_raw_button_press_axisvalues_raw(_event);
+    u32 valueIndex = 0;
+
+    u32 valuatorCount = _event->valuators_len * 32;
+    for(u32 i = 0; i < valuatorCount; ++i)
+    {
+        if(!(valuatorMask[i / 32] & (1u << (i % 32))))
+            continue;
+
+        f64 value = values[valueIndex].integral + values[valueIndex].frac / 4294967296.0;
+        valueIndex++;
+
+        //valuators 0 and 1 are the relative x and y axes of a pointer
+        if(i == 0)
+            *_deltaX += value;
+        else if(i == 1)
+            *_deltaY += value;
+        else
+            break;
+    }
+}
+
 Keys TranslateKeycode(u32 _xKeycode)
 {
     switch(_xKeycode)
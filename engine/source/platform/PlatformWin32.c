@@ -12,6 +12,7 @@
 #include <windows.h>
 #include <windowsx.h> //param input extraction
 #include <stdlib.h>
+#include <string.h>
 
 //for surface creation
 #include <vulkan/vulkan.h>
@@ -204,6 +205,102 @@ void PlatformSleep(u64 _ms)
     Sleep(_ms);
 }
 
+i32 PlatformGetProcessorCount()
+{
+    SYSTEM_INFO info;
+    GetSystemInfo(&info);
+    return info.dwNumberOfProcessors > 0 ? (i32)info.dwNumberOfProcessors : 1;
+}
+
+b8 PlatformGetExecutableDirectory(char* _outPath, u64 _pathSize)
+{
+    //a full buffer means the path was truncated
+    DWORD length = GetModuleFileNameA(0, _outPath, (DWORD)_pathSize);
+    if(length == 0 || length >= _pathSize)
+        return FALSE;
+
+    char* separator = strrchr(_outPath, '\\');
+    if(!separator)
+        return FALSE;
+
+    separator[1] = 0;
+    return TRUE;
+}
+
+typedef struct Win32Thread
+{
+    HANDLE handle;
+    PlatformThreadStart start;
+    void* params;
+} Win32Thread;
+
+DWORD WINAPI Win32ThreadEntry(LPVOID _thread)
+{
+    Win32Thread* thread = (Win32Thread*)_thread;
+    return thread->start(thread->params);
+}
+
+b8 PlatformThreadCreate(PlatformThreadStart _start, void* _params, PlatformThread* _outThread)
+{
+    Win32Thread* thread = malloc(sizeof(Win32Thread));
+    thread->start = _start;
+    thread->params = _params;
+    thread->handle = CreateThread(0, 0, Win32ThreadEntry, thread, 0, 0);
+    if(!thread->handle)
+    {
+        LOG_ERROR("CreateThread failed.");
+        free(thread);
+        _outThread->internalData = 0;
+        return FALSE;
+    }
+
+    _outThread->internalData = thread;
+    return TRUE;
+}
+
+void PlatformThreadJoin(PlatformThread* _thread)
+{
+    Win32Thread* thread = (Win32Thread*)_thread->internalData;
+    if(!thread)
+        return;
+
+    WaitForSingleObject(thread->handle, INFINITE);
+    CloseHandle(thread->handle);
+    free(thread);
+    _thread->internalData = 0;
+}
+
+b8 PlatformSemaphoreCreate(u32 _initialCount, PlatformSemaphore* _outSemaphore)
+{
+    _outSemaphore->internalData = CreateSemaphoreA(0, _initialCount, 0x7fffffff, 0);
+    if(!_outSemaphore->internalData)
+    {
+        LOG_ERROR("CreateSemaphoreA failed.");
+        return FALSE;
+    }
+
+    return TRUE;
+}
+
+void PlatformSemaphoreDestroy(PlatformSemaphore* _semaphore)
+{
+    if(!_semaphore->internalData)
+        return;
+
+    CloseHandle((HANDLE)_semaphore->internalData);
+    _semaphore->internalData = 0;
+}
+
+void PlatformSemaphoreSignal(PlatformSemaphore* _semaphore)
+{
+    ReleaseSemaphore((HANDLE)_semaphore->internalData, 1, 0);
+}
+
+void PlatformSemaphoreWait(PlatformSemaphore* _semaphore)
+{
+    WaitForSingleObject((HANDLE)_semaphore->internalData, INFINITE);
+}
+
 void PlatformGetRequiredExtensionNames(const char*** _namesDArray)
 {
     DArrayPush(*_namesDArray, &"VK_KHR_win32_surface");
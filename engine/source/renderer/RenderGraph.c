@@ -0,0 +1,418 @@
+#include "RenderGraph.h"
+
+#include "core/Logger.h"
+#include "core/CMemory.h"
+
+u32 AddResource(RenderGraph* _graph, const char* _name, const RenderGraphImageDesc* _desc, b8 _imported);
+void AddPassUse(RenderGraph* _graph, u32 _pass, u32 _resource, RenderGraphUsage _usage, b8 _write);
+b8 UsageIsAttachment(RenderGraphUsage _usage);
+void CullPasses(RenderGraph* _graph);
+b8 ComputeLifetimes(RenderGraph* _graph, u32* _outUsageMasks);
+void AliasResources(RenderGraph* _graph, const u32* _usageMasks);
+void ComputeBarriers(RenderGraph* _graph);
+
+void RenderGraphReset(RenderGraph* _graph)
+{
+    _graph->passCount = 0;
+    _graph->resourceCount = 0;
+    _graph->physicalCount = 0;
+    _graph->finalBarrierCount = 0;
+    _graph->compiled = FALSE;
+}
+
+u32 RenderGraphImportBackbuffer(RenderGraph* _graph, const RenderGraphImageDesc* _desc)
+{
+    if(_desc->format != RENDER_GRAPH_FORMAT_BACKBUFFER)
+    {
+        LOG_ERROR("RenderGraphImportBackbuffer requires RENDER_GRAPH_FORMAT_BACKBUFFER.");
+        return RENDER_GRAPH_INVALID_HANDLE;
+    }
+
+    u32 handle = AddResource(_graph, "backbuffer", _desc, TRUE);
+    if(handle != RENDER_GRAPH_INVALID_HANDLE)
+    {
+        _graph->resources[handle].desc.scale = 1.f;
+        _graph->resources[handle].finalUsage = RENDER_GRAPH_USAGE_PRESENT;
+    }
+
+    return handle;
+}
+
+u32 RenderGraphCreateImage(RenderGraph* _graph, const char* _name, const RenderGraphImageDesc* _desc)
+{
+    if(_desc->format == RENDER_GRAPH_FORMAT_BACKBUFFER)
+    {
+        LOG_ERROR("RenderGraphCreateImage: '%s' can not use the backbuffer format.", _name);
+        return RENDER_GRAPH_INVALID_HANDLE;
+    }
+
+    return AddResource(_graph, _name, _desc, FALSE);
+}
+
+u32 RenderGraphAddPass(RenderGraph* _graph, const char* _name, RenderGraphExecuteFn _execute, void* _userData)
+{
+    if(_graph->passCount == RENDER_GRAPH_MAX_PASSES)
+    {
+        LOG_ERROR("RenderGraphAddPass: too many passes, '%s' was not added.", _name);
+        return RENDER_GRAPH_INVALID_HANDLE;
+    }
+
+    u32 handle = _graph->passCount++;
+    RenderGraphPass* pass = &_graph->passes[handle];
+    cZeroMemory(pass, sizeof(RenderGraphPass));
+    pass->name = _name;
+    pass->Execute = _execute;
+    pass->userData = _userData;
+    _graph->compiled = FALSE;
+    return handle;
+}
+
+void RenderGraphPassRead(RenderGraph* _graph, u32 _pass, u32 _resource, RenderGraphUsage _usage)
+{
+    AddPassUse(_graph, _pass, _resource, _usage, FALSE);
+}
+
+void RenderGraphPassWrite(RenderGraph* _graph, u32 _pass, u32 _resource, RenderGraphUsage _usage)
+{
+    if(_usage != RENDER_GRAPH_USAGE_COLOR_ATTACHMENT && _usage != RENDER_GRAPH_USAGE_DEPTH_ATTACHMENT)
+    {
+        LOG_ERROR("RenderGraphPassWrite: only attachments can be written.");
+        return;
+    }
+
+    AddPassUse(_graph, _pass, _resource, _usage, TRUE);
+}
+
+void RenderGraphPassSetSideEffects(RenderGraph* _graph, u32 _pass)
+{
+    if(_pass < _graph->passCount)
+        _graph->passes[_pass].sideEffects = TRUE;
+}
+
+b8 RenderGraphCompile(RenderGraph* _graph)
+{
+    _graph->compiled = FALSE;
+    _graph->physicalCount = 0;
+    _graph->finalBarrierCount = 0;
+
+    CullPasses(_graph);
+
+    u32 usageMasks[RENDER_GRAPH_MAX_RESOURCES];
+    if(!ComputeLifetimes(_graph, usageMasks))
+        return FALSE;
+
+    AliasResources(_graph, usageMasks);
+    ComputeBarriers(_graph);
+
+    _graph->compiled = TRUE;
+    return TRUE;
+}
+
+b8 RenderGraphExecute(RenderGraph* _graph, RendererBackend* _backend)
+{
+    if(!_graph->compiled)
+    {
+        LOG_ERROR("RenderGraphExecute called on a graph that was not compiled.");
+        return FALSE;
+    }
+
+    //EndGraph runs regardless, imported resources have to reach their final usage
+    b8 result = _backend->BeginGraph(_backend, _graph);
+    for(u32 i = 0; result && i < _graph->passCount; ++i)
+    {
+        RenderGraphPass* pass = &_graph->passes[i];
+        if(pass->culled)
+            continue;
+
+        if(!_backend->BeginPass(_backend, _graph, i))
+        {
+            LOG_ERROR("RenderGraphExecute: pass '%s' failed to begin.", pass->name);
+            result = FALSE;
+            break;
+        }
+
+        if(pass->Execute)
+            pass->Execute(_graph, i, pass->userData);
+
+        _backend->EndPass(_backend, _graph, i);
+    }
+
+    _backend->EndGraph(_backend, _graph);
+    return result;
+}
+
+u32 AddResource(RenderGraph* _graph, const char* _name, const RenderGraphImageDesc* _desc, b8 _imported)
+{
+    if(_graph->resourceCount == RENDER_GRAPH_MAX_RESOURCES)
+    {
+        LOG_ERROR("RenderGraph: too many resources, '%s' was not added.", _name);
+        return RENDER_GRAPH_INVALID_HANDLE;
+    }
+
+    u32 handle = _graph->resourceCount++;
+    RenderGraphResource* resource = &_graph->resources[handle];
+    cZeroMemory(resource, sizeof(RenderGraphResource));
+    resource->name = _name;
+    resource->desc = *_desc;
+    if(resource->desc.scale <= 0.f)
+        resource->desc.scale = 1.f;
+    resource->imported = _imported;
+    resource->finalUsage = RENDER_GRAPH_USAGE_UNDEFINED;
+    resource->firstPass = RENDER_GRAPH_INVALID_HANDLE;
+    resource->lastPass = RENDER_GRAPH_INVALID_HANDLE;
+    resource->physicalIndex = RENDER_GRAPH_INVALID_HANDLE;
+    _graph->compiled = FALSE;
+    return handle;
+}
+
+void AddPassUse(RenderGraph* _graph, u32 _pass, u32 _resource, RenderGraphUsage _usage, b8 _write)
+{
+    if(_pass >= _graph->passCount || _resource >= _graph->resourceCount)
+    {
+        LOG_ERROR("RenderGraph: invalid pass or resource handle.");
+        return;
+    }
+
+    RenderGraphPass* pass = &_graph->passes[_pass];
+    for(u32 i = 0; i < pass->useCount; ++i)
+    {
+        //a resource is in one state per pass
+        if(pass->uses[i].resource == _resource)
+        {
+            LOG_ERROR("RenderGraph: pass '%s' uses '%s' twice.", pass->name, _graph->resources[_resource].name);
+            return;
+        }
+    }
+
+    if(pass->useCount == RENDER_GRAPH_MAX_PASS_USES)
+    {
+        LOG_ERROR("RenderGraph: pass '%s' uses too many resources.", pass->name);
+        return;
+    }
+
+    RenderGraphPassUse* use = &pass->uses[pass->useCount++];
+    cZeroMemory(use, sizeof(RenderGraphPassUse));
+    use->resource = _resource;
+    use->usage = _usage;
+    use->write = _write;
+    _graph->compiled = FALSE;
+}
+
+b8 UsageIsAttachment(RenderGraphUsage _usage)
+{
+    return _usage == RENDER_GRAPH_USAGE_COLOR_ATTACHMENT ||
+        _usage == RENDER_GRAPH_USAGE_DEPTH_ATTACHMENT ||
+        _usage == RENDER_GRAPH_USAGE_DEPTH_READ;
+}
+
+void CullPasses(RenderGraph* _graph)
+{
+    //walk backwards from what leaves the graph. attachments a pass writes are loaded when an
+    //earlier pass wrote them, so everything a live pass uses keeps its earlier writers alive
+    b8 needed[RENDER_GRAPH_MAX_RESOURCES];
+    for(u32 i = 0; i < _graph->resourceCount; ++i)
+        needed[i] = _graph->resources[i].imported;
+
+    for(u32 i = _graph->passCount; i > 0; --i)
+    {
+        RenderGraphPass* pass = &_graph->passes[i - 1];
+        b8 alive = pass->sideEffects;
+        for(u32 j = 0; j < pass->useCount && !alive; ++j)
+        {
+            if(pass->uses[j].write && needed[pass->uses[j].resource])
+                alive = TRUE;
+        }
+
+        pass->culled = !alive;
+        if(!alive)
+            continue;
+
+        for(u32 j = 0; j < pass->useCount; ++j)
+            needed[pass->uses[j].resource] = TRUE;
+    }
+}
+
+b8 ComputeLifetimes(RenderGraph* _graph, u32* _outUsageMasks)
+{
+    for(u32 i = 0; i < _graph->resourceCount; ++i)
+    {
+        RenderGraphResource* resource = &_graph->resources[i];
+        resource->firstPass = RENDER_GRAPH_INVALID_HANDLE;
+        resource->lastPass = RENDER_GRAPH_INVALID_HANDLE;
+        resource->physicalIndex = RENDER_GRAPH_INVALID_HANDLE;
+        _outUsageMasks[i] = 0;
+    }
+
+    for(u32 i = 0; i < _graph->passCount; ++i)
+    {
+        RenderGraphPass* pass = &_graph->passes[i];
+        if(pass->culled)
+            continue;
+
+        //attachments of a pass share one size
+        f32 attachmentScale = 0.f;
+        u32 colorCount = 0;
+        u32 depthCount = 0;
+        for(u32 j = 0; j < pass->useCount; ++j)
+        {
+            RenderGraphPassUse* use = &pass->uses[j];
+            RenderGraphResource* resource = &_graph->resources[use->resource];
+            if(resource->firstPass == RENDER_GRAPH_INVALID_HANDLE)
+                resource->firstPass = i;
+            resource->lastPass = i;
+            _outUsageMasks[use->resource] |= 1 << use->usage;
+
+            if(!UsageIsAttachment(use->usage))
+                continue;
+
+            if(use->usage == RENDER_GRAPH_USAGE_COLOR_ATTACHMENT)
+                colorCount++;
+            else
+                depthCount++;
+
+            if(attachmentScale == 0.f)
+                attachmentScale = resource->desc.scale;
+            else if(attachmentScale != resource->desc.scale)
+            {
+                LOG_ERROR("RenderGraphCompile: attachments of pass '%s' differ in size.", pass->name);
+                return FALSE;
+            }
+        }
+
+        if(colorCount > RENDER_GRAPH_MAX_COLOR_ATTACHMENTS || depthCount > 1)
+        {
+            LOG_ERROR("RenderGraphCompile: pass '%s' has too many attachments.", pass->name);
+            return FALSE;
+        }
+    }
+
+    //the first use clears the previous contents, uses before the last one store them
+    for(u32 i = 0; i < _graph->passCount; ++i)
+    {
+        RenderGraphPass* pass = &_graph->passes[i];
+        if(pass->culled)
+            continue;
+
+        for(u32 j = 0; j < pass->useCount; ++j)
+        {
+            RenderGraphPassUse* use = &pass->uses[j];
+            RenderGraphResource* resource = &_graph->resources[use->resource];
+            use->clear = use->write && resource->firstPass == i;
+            use->store = resource->imported || resource->lastPass != i;
+
+            if(!use->write && resource->firstPass == i)
+            {
+                LOG_WARN("RenderGraphCompile: pass '%s' reads '%s' before anything writes it.", pass->name, resource->name);
+            }
+        }
+    }
+
+    return TRUE;
+}
+
+void AliasResources(RenderGraph* _graph, const u32* _usageMasks)
+{
+    //resources are placed in order of first use, an image is reused once its previous resource is done with it
+    for(u32 i = 0; i < _graph->passCount; ++i)
+    {
+        RenderGraphPass* pass = &_graph->passes[i];
+        if(pass->culled)
+            continue;
+
+        for(u32 j = 0; j < pass->useCount; ++j)
+        {
+            u32 handle = pass->uses[j].resource;
+            RenderGraphResource* resource = &_graph->resources[handle];
+            if(resource->imported || resource->firstPass != i || resource->physicalIndex != RENDER_GRAPH_INVALID_HANDLE)
+                continue;
+
+            u32 physicalIndex = RENDER_GRAPH_INVALID_HANDLE;
+            for(u32 k = 0; k < _graph->physicalCount; ++k)
+            {
+                RenderGraphPhysical* physical = &_graph->physicals[k];
+                if(physical->format == resource->desc.format &&
+                    physical->scale == resource->desc.scale &&
+                    physical->lastPass < resource->firstPass)
+                {
+                    physicalIndex = k;
+                    break;
+                }
+            }
+
+            if(physicalIndex == RENDER_GRAPH_INVALID_HANDLE)
+            {
+                physicalIndex = _graph->physicalCount++;
+                RenderGraphPhysical* physical = &_graph->physicals[physicalIndex];
+                physical->format = resource->desc.format;
+                physical->scale = resource->desc.scale;
+                physical->usageMask = 0;
+            }
+
+            RenderGraphPhysical* physical = &_graph->physicals[physicalIndex];
+            physical->usageMask |= _usageMasks[handle];
+            physical->lastPass = resource->lastPass;
+            resource->physicalIndex = physicalIndex;
+        }
+    }
+}
+
+void ComputeBarriers(RenderGraph* _graph)
+{
+    //state of every transient image and imported resource as the passes run.
+    //indices below RENDER_GRAPH_MAX_RESOURCES are physical images, imported resources follow
+    RenderGraphUsage usages[RENDER_GRAPH_MAX_RESOURCES * 2];
+    u32 owners[RENDER_GRAPH_MAX_RESOURCES * 2];
+    b8 written[RENDER_GRAPH_MAX_RESOURCES * 2];
+    for(u32 i = 0; i < RENDER_GRAPH_MAX_RESOURCES * 2; ++i)
+    {
+        usages[i] = RENDER_GRAPH_USAGE_UNDEFINED;
+        owners[i] = RENDER_GRAPH_INVALID_HANDLE;
+        written[i] = FALSE;
+    }
+
+    for(u32 i = 0; i < _graph->passCount; ++i)
+    {
+        RenderGraphPass* pass = &_graph->passes[i];
+        pass->barrierCount = 0;
+        if(pass->culled)
+            continue;
+
+        for(u32 j = 0; j < pass->useCount; ++j)
+        {
+            RenderGraphPassUse* use = &pass->uses[j];
+            RenderGraphResource* resource = &_graph->resources[use->resource];
+            u32 state = resource->imported ? RENDER_GRAPH_MAX_RESOURCES + use->resource : resource->physicalIndex;
+
+            //a new resource in the image, the previous contents belong to someone else
+            b8 discard = owners[state] != use->resource;
+
+            //reads of a resource already in the right state need nothing
+            if(discard || usages[state] != use->usage || use->write || written[state])
+            {
+                RenderGraphBarrier* barrier = &pass->barriers[pass->barrierCount++];
+                barrier->resource = use->resource;
+                barrier->oldUsage = usages[state];
+                barrier->newUsage = use->usage;
+                barrier->discard = discard;
+            }
+
+            usages[state] = use->usage;
+            owners[state] = use->resource;
+            written[state] = use->write;
+        }
+    }
+
+    for(u32 i = 0; i < _graph->resourceCount; ++i)
+    {
+        RenderGraphResource* resource = &_graph->resources[i];
+        if(!resource->imported)
+            continue;
+
+        u32 state = RENDER_GRAPH_MAX_RESOURCES + i;
+        RenderGraphBarrier* barrier = &_graph->finalBarriers[_graph->finalBarrierCount++];
+        barrier->resource = i;
+        barrier->oldUsage = usages[state];
+        barrier->newUsage = resource->finalUsage;
+        barrier->discard = owners[state] != i;
+    }
+}
\ No newline at end of file
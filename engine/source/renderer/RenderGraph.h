@@ -0,0 +1,33 @@
+#pragma once
+
+#include "RendererTypes.inl"
+
+//clears every pass and resource, called at the start of each frame before the graph is declared
+void RenderGraphReset(RenderGraph* _graph);
+
+//imports the swapchain image, presented after the last pass
+u32 RenderGraphImportBackbuffer(RenderGraph* _graph, const RenderGraphImageDesc* _desc);
+
+//declares a transient image that only lives for the passes using it, _name is not copied
+u32 RenderGraphCreateImage(RenderGraph* _graph, const char* _name, const RenderGraphImageDesc* _desc);
+
+//adds a pass, passes run in the order they were added. _name is not copied
+u32 RenderGraphAddPass(RenderGraph* _graph, const char* _name, RenderGraphExecuteFn _execute, void* _userData);
+
+void RenderGraphPassRead(RenderGraph* _graph, u32 _pass, u32 _resource, RenderGraphUsage _usage);
+void RenderGraphPassWrite(RenderGraph* _graph, u32 _pass, u32 _resource, RenderGraphUsage _usage);
+
+//keeps the pass even when nothing reads its outputs
+void RenderGraphPassSetSideEffects(RenderGraph* _graph, u32 _pass);
+
+/**
+ * Culls the passes that neither write an imported resource, nor something a later live pass uses,
+ * nor have side effects. Then computes resource lifetimes, aliases transient images whose lifetimes
+ * do not overlap, picks clear and store operations and the barriers each pass needs. Passes that
+ * only read a resource in the state it is already in get no barrier.
+ * @returns FALSE if the graph is invalid.
+ */
+b8 RenderGraphCompile(RenderGraph* _graph);
+
+//runs the live passes of a compiled graph on the backend, between BeginFrame and EndFrame
+b8 RenderGraphExecute(RenderGraph* _graph, RendererBackend* _backend);
\ No newline at end of file
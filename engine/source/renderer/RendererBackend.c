@@ -13,6 +13,23 @@ b8 RendererBackendCreate(RendererBackendType _type, struct PlatformState* _platf
         _outBackend->BeginFrame = VulkanRendererBackendBeginFrame;
         _outBackend->EndFrame = VulkanRendererBackendEndFrame;
         _outBackend->Resize = VulkanRendererBackendOnResize;
+        _outBackend->BeginGraph = VulkanRendererBackendBeginGraph;
+        _outBackend->BeginPass = VulkanRendererBackendBeginPass;
+        _outBackend->EndPass = VulkanRendererBackendEndPass;
+        _outBackend->EndGraph = VulkanRendererBackendEndGraph;
+        _outBackend->RecordDraws = VulkanRendererBackendRecordDraws;
+        _outBackend->PaceFrame = VulkanRendererBackendPaceFrame;
+        _outBackend->WaitForFrame = VulkanRendererBackendWaitForFrame;
+        _outBackend->GetFrameLatency = VulkanRendererBackendGetFrameLatency;
+        _outBackend->GetGpuTimings = VulkanRendererBackendGetGpuTimings;
+        _outBackend->UploadIsComplete = VulkanRendererBackendUploadIsComplete;
+        _outBackend->CreateStaticMesh = VulkanRendererBackendCreateStaticMesh;
+        _outBackend->DestroyStaticMesh = VulkanRendererBackendDestroyStaticMesh;
+        _outBackend->PrepareFrame = VulkanRendererBackendPrepareFrame;
+        _outBackend->CreateGpuObject = VulkanRendererBackendCreateGpuObject;
+        _outBackend->SetGpuObjectTransform = VulkanRendererBackendSetGpuObjectTransform;
+        _outBackend->DestroyGpuObject = VulkanRendererBackendDestroyGpuObject;
+        _outBackend->RecordGpuScene = VulkanRendererBackendRecordGpuScene;
 
         return TRUE;
     }
@@ -27,4 +44,21 @@ void RendererBackendDestroy(RendererBackend* _backend)
     _backend->BeginFrame = 0;
     _backend->EndFrame = 0;
     _backend->Resize = 0;
+    _backend->BeginGraph = 0;
+    _backend->BeginPass = 0;
+    _backend->EndPass = 0;
+    _backend->EndGraph = 0;
+    _backend->RecordDraws = 0;
+    _backend->PaceFrame = 0;
+    _backend->WaitForFrame = 0;
+    _backend->GetFrameLatency = 0;
+    _backend->GetGpuTimings = 0;
+    _backend->UploadIsComplete = 0;
+    _backend->CreateStaticMesh = 0;
+    _backend->DestroyStaticMesh = 0;
+    _backend->PrepareFrame = 0;
+    _backend->CreateGpuObject = 0;
+    _backend->SetGpuObjectTransform = 0;
+    _backend->DestroyGpuObject = 0;
+    _backend->RecordGpuScene = 0;
 }
\ No newline at end of file
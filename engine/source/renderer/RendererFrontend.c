@@ -1,19 +1,67 @@
 #include "RendererFrontend.h"
 #include "RendererBackend.h"
+#include "RendererWorkers.h"
+#include "RenderGraph.h"
 
 #include "core/Logger.h"
 #include "core/CMemory.h"
+#include "core/Sort.h"
+
+#include "math/CMath.h"
+
+#include "containers/DArray.h"
 
 //backend render context
 static RendererBackend* backend = 0;
 
-b8 RendererInitialize(const char* _appName, struct PlatformState* _platform)
+//declared again every frame, passes only record what the packet asks for
+static RenderGraph frameGraph;
+
+//draws submitted for the frame being built, plus the storage to sort them. Released after every frame,
+//the memory is kept for the next one
+typedef struct RendererFrameDraws
+{
+    RenderDraw* submitted;
+    RenderDraw* sorted;
+    SortPair* pairs;
+    SortPair* scratch;
+    u32 count;
+    u32 capacity;
+} RendererFrameDraws;
+
+static RendererFrameDraws frameDraws;
+
+//per-instance transforms of the static mesh draws submitted for the frame being built, kept like the draws
+static Mat4* frameInstances = 0;
+static u32 frameInstanceCount = 0;
+static u32 frameInstanceCapacity = 0;
+
+static Mat4 viewProjection;
+
+//vertex format per static mesh handle, picks the mesh's pipeline. STATIC_MESH_VERTEX_FORMAT_COUNT
+//for handles that are not live, so draws of destroyed meshes are rejected. darray
+static StaticMeshVertexFormat* meshFormats = 0;
+
+void FrameDrawsReserve(u32 _capacity);
+void FrameDrawsFree();
+void FrameInstancesReserve(u32 _capacity);
+
+void SortPacketDraws(RenderPacket* _packet);
+b8 BuildFrameGraph(RenderPacket* _packet);
+void MainPassExecute(RenderGraph* _graph, u32 _passIndex, void* _userData);
+
+b8 RendererInitialize(const char* _appName, const RendererConfig* _config, struct PlatformState* _platform)
 {
     backend = cAllocate(sizeof(RendererBackend), MEMORY_TAG_RENDERER);
 
     //TODO: make configurable
     RendererBackendCreate(RENDERER_BACKEND_TYPE_VULKAN, _platform, backend);
     backend->frameNumber = 0;
+    backend->recordThreadCount = RendererWorkersGetDesiredThreadCount();
+    backend->config = *_config;
+
+    viewProjection = Mat4Identity();
+    meshFormats = DArrayCreate(StaticMeshVertexFormat);
 
     if(!backend->Initialize(backend, _appName, _platform))
     {
@@ -21,11 +69,28 @@ b8 RendererInitialize(const char* _appName, struct PlatformState* _platform)
         return FALSE;
     }
 
+    if(!RendererWorkersInitialize(backend, backend->recordThreadCount))
+    {
+        LOG_FATAL("Renderer workers failed to initialize. Shutting down,");
+        return FALSE;
+    }
+
     return TRUE;
 }
 
 void RendererShutdown()
 {
+    FrameDrawsFree();
+    if(frameInstanceCapacity)
+        cFree(frameInstances, sizeof(Mat4) * frameInstanceCapacity, MEMORY_TAG_RENDERER);
+    frameInstances = 0;
+    frameInstanceCount = frameInstanceCapacity = 0;
+
+    if(meshFormats)
+        DArrayDestroy(meshFormats);
+    meshFormats = 0;
+
+    RendererWorkersShutdown();
     backend->Shutdown(backend);
     cFree(backend, sizeof(RendererBackend), MEMORY_TAG_RENDERER);
 }
@@ -45,25 +110,303 @@ b8 RendererBeginFrame(f32 _deltaTime)
 
 b8 RendererEndFrame(f32 _deltaTime)
 {
+    //frame N signals N + 1 on the backend's timeline, a frame that was not submitted must not take a number
     b8 result = backend->EndFrame(backend, _deltaTime);
-    backend->frameNumber++;
+    if(result)
+        backend->frameNumber++;
     return result;
 }
 
+void RendererPreparePacket(RenderPacket* _outPacket, f32 _deltaTime)
+{
+    _outPacket->deltaTime = _deltaTime;
+    _outPacket->drawCount = frameDraws.count;
+    _outPacket->draws = frameDraws.submitted;
+    _outPacket->instanceCount = frameInstanceCount;
+    _outPacket->instances = frameInstances;
+    _outPacket->viewProjection = viewProjection;
+}
+
 b8 RendererDrawFrame(RenderPacket* _packet)
 {
+    b8 result = TRUE;
+
     //if the begin frame returned successfull mid frame ops can continue
     if(RendererBeginFrame(_packet->deltaTime))
     {
+        SortPacketDraws(_packet);
+
+        if(!backend->PrepareFrame(backend, _packet))
+        {
+            LOG_ERROR("Failed to prepare the frame's instance data.");
+        }
+
+        if(!BuildFrameGraph(_packet) || !RenderGraphExecute(&frameGraph, backend))
+        {
+            LOG_ERROR("Failed to record the frame graph.");
+        }
 
         //end frame, if this is fails it is likely unrecoverable
-        b8 result = RendererEndFrame(_packet->deltaTime);
+        result = RendererEndFrame(_packet->deltaTime);
         if(!result)
         {
             LOG_ERROR("RendererEndFrame failed, application shutting down...");
-            return FALSE;
         }
     }
 
+    //skipped frames drop their draws too, the game submits again next frame
+    frameDraws.count = 0;
+    frameInstanceCount = 0;
+    return result;
+}
+
+void RendererSubmitDraws(const RenderDraw* _draws, u32 _count)
+{
+    if(frameDraws.count + _count > frameDraws.capacity)
+    {
+        u32 capacity = frameDraws.capacity > 0 ? frameDraws.capacity : 256;
+        while(capacity < frameDraws.count + _count)
+            capacity *= 2;
+
+        FrameDrawsReserve(capacity);
+    }
+
+    //only static mesh pipelines can be bound, and only with the pipeline matching the mesh' vertex format
+    u32 rejected = 0;
+    for(u32 i = 0; i < _count; ++i)
+    {
+        const RenderDraw* draw = &_draws[i];
+        if(draw->mesh >= DArrayLength(meshFormats) || meshFormats[draw->mesh] == STATIC_MESH_VERTEX_FORMAT_COUNT ||
+            draw->pipeline != RENDER_PIPELINE_STATIC_MESH + meshFormats[draw->mesh])
+        {
+            rejected++;
+            continue;
+        }
+
+        frameDraws.submitted[frameDraws.count++] = *draw;
+    }
+
+    if(rejected)
+    {
+        LOG_WARN("RendererSubmitDraws rejected %u draws without a static mesh or with a pipeline that does not match it.", rejected);
+    }
+}
+
+u32 RendererStaticMeshCreate(const StaticMeshData* _data, u64* _outTicket)
+{
+    if(_data->format >= STATIC_MESH_VERTEX_FORMAT_COUNT || _data->vertexCount == 0 || _data->indexCount == 0)
+    {
+        LOG_ERROR("RendererStaticMeshCreate needs a known vertex format, vertices and indices.");
+        return RENDER_HANDLE_NONE;
+    }
+
+    u32 mesh = backend->CreateStaticMesh(backend, _data, _outTicket);
+    if(mesh == RENDER_HANDLE_NONE)
+        return RENDER_HANDLE_NONE;
+
+    //handles are dense, freed ones are handed out again
+    StaticMeshVertexFormat unused = STATIC_MESH_VERTEX_FORMAT_COUNT;
+    while(DArrayLength(meshFormats) <= mesh)
+        DArrayPush(meshFormats, unused);
+    meshFormats[mesh] = _data->format;
+    return mesh;
+}
+
+b8 RendererStaticMeshDestroy(u32 _mesh)
+{
+    if(_mesh == RENDER_HANDLE_NONE)
+        return FALSE;
+
+    if(!backend->DestroyStaticMesh(backend, _mesh))
+        return FALSE;
+
+    //the handle may be handed out again, until then its draws are rejected
+    if(_mesh < DArrayLength(meshFormats))
+        meshFormats[_mesh] = STATIC_MESH_VERTEX_FORMAT_COUNT;
     return TRUE;
+}
+
+void RendererDrawStaticMesh(u32 _mesh, u32 _material, const Mat4* _transforms, u32 _count, f32 _viewDepth)
+{
+    if(_count == 0 || _mesh >= DArrayLength(meshFormats))
+        return;
+
+    if(meshFormats[_mesh] == STATIC_MESH_VERTEX_FORMAT_COUNT)
+    {
+        LOG_WARN("RendererDrawStaticMesh called with destroyed mesh %u.", _mesh);
+        return;
+    }
+
+    if(frameInstanceCount + _count > frameInstanceCapacity)
+    {
+        u32 capacity = frameInstanceCapacity > 0 ? frameInstanceCapacity : 1024;
+        while(capacity < frameInstanceCount + _count)
+            capacity *= 2;
+
+        FrameInstancesReserve(capacity);
+    }
+
+    //one draw for all instances, the vertex shader fetches the transform with gl_InstanceIndex
+    RenderDraw draw = RenderDrawDefault();
+    draw.pipeline = RENDER_PIPELINE_STATIC_MESH + meshFormats[_mesh];
+    draw.material = _material;
+    draw.mesh = _mesh;
+    draw.instanceCount = _count;
+    draw.firstInstance = frameInstanceCount;
+    draw.sortKey = RenderSortKeyOpaque(RENDER_BUCKET_OPAQUE, draw.pipeline, _material, _viewDepth);
+
+    cCopyMemory(&frameInstances[frameInstanceCount], _transforms, sizeof(Mat4) * _count);
+    frameInstanceCount += _count;
+
+    RendererSubmitDraws(&draw, 1);
+}
+
+void RendererSetViewProjection(const Mat4* _viewProjection)
+{
+    viewProjection = *_viewProjection;
+}
+
+u32 RendererGpuObjectCreate(u32 _mesh, const Mat4* _transform)
+{
+    return backend->CreateGpuObject(backend, _mesh, _transform);
+}
+
+void RendererGpuObjectSetTransform(u32 _object, const Mat4* _transform)
+{
+    backend->SetGpuObjectTransform(backend, _object, _transform);
+}
+
+void RendererGpuObjectDestroy(u32 _object)
+{
+    if(_object != RENDER_HANDLE_NONE)
+        backend->DestroyGpuObject(backend, _object);
+}
+
+void RendererPaceFrame()
+{
+    backend->PaceFrame(backend);
+}
+
+u64 RendererGetFrameNumber()
+{
+    return backend->frameNumber;
+}
+
+b8 RendererWaitForFrame(u64 _frameNumber, u64 _timeoutNS)
+{
+    return backend->WaitForFrame(backend, _frameNumber, _timeoutNS);
+}
+
+u32 RendererGetFrameLatency()
+{
+    return backend->GetFrameLatency(backend);
+}
+
+u32 RendererGetGpuTimings(RendererGpuTiming* _outTimings, u32 _maxTimings)
+{
+    return backend->GetGpuTimings(backend, _outTimings, _maxTimings);
+}
+
+b8 RendererUploadIsComplete(u64 _ticket)
+{
+    return backend->UploadIsComplete(backend, _ticket);
+}
+
+void FrameDrawsReserve(u32 _capacity)
+{
+    RendererFrameDraws grown = {};
+    grown.submitted = cAllocate(sizeof(RenderDraw) * _capacity, MEMORY_TAG_RENDERER);
+    grown.sorted = cAllocate(sizeof(RenderDraw) * _capacity, MEMORY_TAG_RENDERER);
+    grown.pairs = cAllocate(sizeof(SortPair) * _capacity, MEMORY_TAG_RENDERER);
+    grown.scratch = cAllocate(sizeof(SortPair) * _capacity, MEMORY_TAG_RENDERER);
+    grown.count = frameDraws.count;
+    grown.capacity = _capacity;
+
+    //only submitted draws outlive a frame, the rest is rebuilt while sorting
+    if(frameDraws.count)
+        cCopyMemory(grown.submitted, frameDraws.submitted, sizeof(RenderDraw) * frameDraws.count);
+
+    FrameDrawsFree();
+    frameDraws = grown;
+}
+
+void FrameDrawsFree()
+{
+    u32 capacity = frameDraws.capacity;
+    if(capacity)
+    {
+        cFree(frameDraws.submitted, sizeof(RenderDraw) * capacity, MEMORY_TAG_RENDERER);
+        cFree(frameDraws.sorted, sizeof(RenderDraw) * capacity, MEMORY_TAG_RENDERER);
+        cFree(frameDraws.pairs, sizeof(SortPair) * capacity, MEMORY_TAG_RENDERER);
+        cFree(frameDraws.scratch, sizeof(SortPair) * capacity, MEMORY_TAG_RENDERER);
+    }
+
+    cZeroMemory(&frameDraws, sizeof(RendererFrameDraws));
+}
+
+void FrameInstancesReserve(u32 _capacity)
+{
+    Mat4* grown = cAllocate(sizeof(Mat4) * _capacity, MEMORY_TAG_RENDERER);
+    if(frameInstanceCapacity)
+    {
+        if(frameInstanceCount)
+            cCopyMemory(grown, frameInstances, sizeof(Mat4) * frameInstanceCount);
+        cFree(frameInstances, sizeof(Mat4) * frameInstanceCapacity, MEMORY_TAG_RENDERER);
+    }
+
+    frameInstances = grown;
+    frameInstanceCapacity = _capacity;
+}
+
+void SortPacketDraws(RenderPacket* _packet)
+{
+    u32 count = _packet->drawCount;
+    if(count < 2)
+        return;
+
+    //packets built by hand may hold more draws than were submitted
+    if(count > frameDraws.capacity)
+        FrameDrawsReserve(count);
+
+    //sorting key and index pairs moves 16 bytes per step instead of whole draws, they are gathered once at the end
+    const RenderDraw* draws = _packet->draws;
+    for(u32 i = 0; i < count; ++i)
+    {
+        frameDraws.pairs[i].key = draws[i].sortKey;
+        frameDraws.pairs[i].value = i;
+    }
+
+    RadixSortPairs(frameDraws.pairs, frameDraws.scratch, count);
+
+    for(u32 i = 0; i < count; ++i)
+        frameDraws.sorted[i] = draws[frameDraws.pairs[i].value];
+
+    _packet->draws = frameDraws.sorted;
+}
+
+b8 BuildFrameGraph(RenderPacket* _packet)
+{
+    RenderGraphReset(&frameGraph);
+
+    RenderGraphImageDesc backbufferDesc = { RENDER_GRAPH_FORMAT_BACKBUFFER, 1.f, { 0.f, 0.f, 0.2f, 1.f } };
+    u32 backbuffer = RenderGraphImportBackbuffer(&frameGraph, &backbufferDesc);
+
+    //only needed while the main pass runs, the graph decides what memory backs it
+    RenderGraphImageDesc depthDesc = { RENDER_GRAPH_FORMAT_DEPTH, 1.f, { 1.f, 0.f, 0.f, 0.f } };
+    u32 depth = RenderGraphCreateImage(&frameGraph, "depth", &depthDesc);
+
+    u32 mainPass = RenderGraphAddPass(&frameGraph, "main pass", MainPassExecute, _packet);
+    RenderGraphPassWrite(&frameGraph, mainPass, backbuffer, RENDER_GRAPH_USAGE_COLOR_ATTACHMENT);
+    RenderGraphPassWrite(&frameGraph, mainPass, depth, RENDER_GRAPH_USAGE_DEPTH_ATTACHMENT);
+
+    return RenderGraphCompile(&frameGraph);
+}
+
+void MainPassExecute(RenderGraph* _graph, u32 _passIndex, void* _userData)
+{
+    RenderPacket* packet = (RenderPacket*)_userData;
+    RendererWorkersRecord(packet->draws, packet->drawCount);
+
+    //gpu scene objects were culled in PrepareFrame, the main thread records their draws once the workers are done
+    backend->RecordGpuScene(backend, 0);
 }
\ No newline at end of file
@@ -2,12 +2,107 @@
 
 #include "RendererTypes.inl"
 
-struct StaticMeshData;
 struct PlatformState;
 
-b8 RendererInitialize(const char* _appName, struct PlatformState* _platform);
+b8 RendererInitialize(const char* _appName, const RendererConfig* _config, struct PlatformState* _platform);
 void RendererShutdown();
 
 void RendererOnResize(u16 _width, u16 _height);
 
-b8 RendererDrawFrame(RenderPacket* _packet);
\ No newline at end of file
+//fills _outPacket with the draws submitted since the last RendererDrawFrame
+void RendererPreparePacket(RenderPacket* _outPacket, f32 _deltaTime);
+
+//sorts the packet's draws by key and records the frame, the submitted draws are released afterwards
+b8 RendererDrawFrame(RenderPacket* _packet);
+
+//copies draws into the current frame's packet in any order, e.g. from Game.render. Draws are rejected
+//unless they use a static mesh and the RENDER_PIPELINE_STATIC_MESH pipeline of its vertex format
+CAPI void RendererSubmitDraws(const RenderDraw* _draws, u32 _count);
+
+/**
+ * Uploads a static mesh once. The copy runs asynchronously, *_outTicket can be polled with
+ * RendererUploadIsComplete and draws of the mesh are skipped until it finished. The data is
+ * copied, the caller may free it on return.
+ * @returns the mesh handle, RENDER_HANDLE_NONE on failure.
+ */
+CAPI u32 RendererStaticMeshCreate(const StaticMeshData* _data, u64* _outTicket);
+
+//the mesh must not be drawn afterwards, its buffers are released once the GPU is done with them.
+//Refused with FALSE while GPU objects of the mesh exist, they would draw whatever mesh reuses the handle
+CAPI b8 RendererStaticMeshDestroy(u32 _mesh);
+
+//draws _count instances of _mesh with a single instanced draw. _transforms are copied into the frame's
+//instance data, _viewDepth orders the draw against the others of its bucket
+CAPI void RendererDrawStaticMesh(u32 _mesh, u32 _material, const Mat4* _transforms, u32 _count, f32 _viewDepth);
+
+//camera of the frames being built, kept until it is set again
+CAPI void RendererSetViewProjection(const Mat4* _viewProjection);
+
+/**
+ * Adds a persistent instance of _mesh that is frustum culled and drawn on the GPU every frame until
+ * it is destroyed, with no per-frame CPU cost. Only changed objects are uploaded. Objects must be
+ * destroyed before their mesh, RendererStaticMeshDestroy refuses while any exist.
+ * @returns the object handle, RENDER_HANDLE_NONE on failure.
+ */
+CAPI u32 RendererGpuObjectCreate(u32 _mesh, const Mat4* _transform);
+
+CAPI void RendererGpuObjectSetTransform(u32 _object, const Mat4* _transform);
+
+CAPI void RendererGpuObjectDestroy(u32 _object);
+
+//every handle RENDER_HANDLE_NONE and no instances. Start draws from this rather than a zeroed RenderDraw,
+//0 is a valid mesh, pipeline and material handle
+CINLINE RenderDraw RenderDrawDefault()
+{
+    RenderDraw draw = {};
+    draw.pipeline = RENDER_HANDLE_NONE;
+    draw.material = RENDER_HANDLE_NONE;
+    draw.mesh = RENDER_HANDLE_NONE;
+    return draw;
+}
+
+//positive floats order like their bit patterns, depths behind the camera clamp to 0
+CINLINE u32 RenderSortDepthBits(f32 _viewDepth)
+{
+    union { f32 f; u32 u; } bits;
+    bits.f = _viewDepth > 0.f ? _viewDepth : 0.f;
+    return bits.u;
+}
+
+/**
+ * Bucket in bits 60-63, pipeline in 48-59, material in 32-47 and view depth in 0-31.
+ * Draws are grouped by state first and go front to back within a material, so pipeline and
+ * material binds only happen at group boundaries. Handles wider than their field still draw
+ * correctly, they only share a group with other handles.
+ */
+CINLINE u64 RenderSortKeyOpaque(RenderBucket _bucket, u32 _pipeline, u32 _material, f32 _viewDepth)
+{
+    return ((u64)(_bucket & 0xF) << 60) | ((u64)(_pipeline & 0xFFF) << 48) | ((u64)(_material & 0xFFFF) << 32) | RenderSortDepthBits(_viewDepth);
+}
+
+//bucket in bits 60-63, inverted view depth in 28-59, pipeline in 16-27 and material in 0-15.
+//blending needs back to front, state only breaks ties between draws at the same depth
+CINLINE u64 RenderSortKeyTransparent(RenderBucket _bucket, f32 _viewDepth, u32 _pipeline, u32 _material)
+{
+    u32 depth = ~RenderSortDepthBits(_viewDepth);
+    return ((u64)(_bucket & 0xF) << 60) | ((u64)depth << 28) | ((u64)(_pipeline & 0xFFF) << 16) | (_material & 0xFFFF);
+}
+
+//call once per loop before input is sampled, in low latency mode this waits for the previous frame to be presented
+CAPI void RendererPaceFrame();
+
+//number of the frame being built, counts frames handed to the backend
+CAPI u64 RendererGetFrameNumber();
+
+//blocks until the GPU finished _frameNumber, e.g. RendererGetFrameNumber() - 2. FALSE on timeout
+CAPI b8 RendererWaitForFrame(u64 _frameNumber, u64 _timeoutNS);
+
+//frames the CPU is ahead of the GPU at the start of the current frame
+CAPI u32 RendererGetFrameLatency();
+
+//GPU time per pass of the most recent frame the GPU finished, a few frames behind the current one.
+//returns the number of timings written to _outTimings
+CAPI u32 RendererGetGpuTimings(RendererGpuTiming* _outTimings, u32 _maxTimings);
+
+//TRUE once the async upload identified by _ticket has finished, safe to call every frame
+CAPI b8 RendererUploadIsComplete(u64 _ticket);
\ No newline at end of file
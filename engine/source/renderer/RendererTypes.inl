@@ -1,6 +1,7 @@
 #pragma once
 
 #include "Defines.h"
+#include "math/MathTypes.inl"
 
 typedef enum RendererBackendType
 {
@@ -9,11 +10,283 @@ typedef enum RendererBackendType
     RENDERER_BACKEND_TYPE_DIRECTX
 } RendererBackendType;
 
+typedef enum RendererPresentMode
+{
+    //low latency without tearing, falls back to FIFO when unsupported
+    RENDERER_PRESENT_MODE_MAILBOX,
+    //vsync, always supported
+    RENDERER_PRESENT_MODE_FIFO,
+    //no vsync, may tear
+    RENDERER_PRESENT_MODE_IMMEDIATE,
+    //vsync that tears instead of waiting when a frame is late
+    RENDERER_PRESENT_MODE_FIFO_RELAXED
+} RendererPresentMode;
+
+typedef struct RendererConfig
+{
+    RendererPresentMode presentMode;
+
+    //frames the CPU may record ahead of the GPU, 0 keeps the backend default of 2
+    u8 framesInFlight;
+
+    //swapchain images to request, 0 keeps the surface minimum plus one
+    u8 swapchainImageCount;
+
+    //waits for the previous frame to be presented before input is sampled, trading throughput for input latency
+    b8 lowLatency;
+
+    //records passes with dynamic rendering instead of render pass and framebuffer objects,
+    //falls back to render passes when the device does not support it
+    b8 dynamicRendering;
+
+    //renders into offscreen images without a window surface, for render farms and CI. Present support is
+    //not required from the device then, so CPU implementations without a display can be selected
+    b8 headless;
+
+    //forces a physical device, by a substring of its name or by its 1-based enumeration index.
+    //0 for both picks the highest scoring device, CPU implementations are only picked without a GPU
+    const char* deviceName;
+    u32 deviceIndex;
+} RendererConfig;
+
+//upper bound on threads recording draws in parallel, the main thread included
+#define RENDERER_MAX_RECORD_THREADS 16
+
+//the top 4 bits of a sort key, buckets are recorded in this order
+typedef enum RenderBucket
+{
+    RENDER_BUCKET_OPAQUE,
+    RENDER_BUCKET_ALPHA_TESTED,
+    RENDER_BUCKET_TRANSPARENT,
+    RENDER_BUCKET_OVERLAY
+} RenderBucket;
+
+//invalid handle, returned when a create fails and used by draws without a material
+#define RENDER_HANDLE_NONE 0xFFFFFFFF
+
+typedef enum StaticMeshVertexFormat
+{
+    //Vertex3D, 32 bytes
+    STATIC_MESH_VERTEX_FORMAT_INTERLEAVED,
+    //VertexQuantized, 16 bytes
+    STATIC_MESH_VERTEX_FORMAT_QUANTIZED,
+    STATIC_MESH_VERTEX_FORMAT_COUNT
+} StaticMeshVertexFormat;
+
+//pipelines the backend creates for static meshes, one per vertex format starting at this handle
+#define RENDER_PIPELINE_STATIC_MESH 0
+
+typedef struct Vertex3D
+{
+    Vec3 position;
+    Vec3 normal;
+    Vec2 texcoord;
+} Vertex3D;
+
+//positions are snorm relative to the mesh bounds, w is padding. Normals are octahedral snorm
+//and texcoords half floats, see StaticMeshQuantize
+typedef struct VertexQuantized
+{
+    i16 position[4];
+    i16 normal[2];
+    u16 texcoord[2];
+} VertexQuantized;
+
+typedef struct StaticMeshData
+{
+    StaticMeshVertexFormat format;
+
+    //Vertex3D or VertexQuantized depending on format, copied during the upload
+    u32 vertexCount;
+    const void* vertices;
+
+    //stored as 16 bit indices when every vertex can be reached with them
+    u32 indexCount;
+    const u32* indices;
+
+    //quantized meshes only, positions decode to position * boundsExtent + boundsCenter
+    Vec3 boundsCenter;
+    Vec3 boundsExtent;
+} StaticMeshData;
+
+//handles are 0 based, create draws with RenderDrawDefault so unset handles are RENDER_HANDLE_NONE
+typedef struct RenderDraw
+{
+    //draws are recorded in ascending key order, see RenderSortKeyOpaque and RenderSortKeyTransparent
+    u64 sortKey;
+    u32 pipeline;
+    //groups draws within a pipeline for the sort, the backend binds no per material state
+    u32 material;
+
+    //static mesh whose vertex and index buffers the draw uses, every draw needs one
+    u32 mesh;
+
+    //draws are always indexed, an indexCount of 0 draws the whole mesh
+    u32 indexCount;
+    u32 instanceCount;
+    u32 firstIndex;
+    i32 vertexOffset;
+    u32 firstInstance;
+} RenderDraw;
+
+#define RENDER_GRAPH_MAX_PASSES 32
+#define RENDER_GRAPH_MAX_RESOURCES 32
+#define RENDER_GRAPH_MAX_PASS_USES 8
+#define RENDER_GRAPH_MAX_COLOR_ATTACHMENTS 4
+#define RENDER_GRAPH_INVALID_HANDLE 0xFFFFFFFF
+
+typedef enum RenderGraphFormat
+{
+    //the swapchain's format, only for the imported backbuffer
+    RENDER_GRAPH_FORMAT_BACKBUFFER,
+    RENDER_GRAPH_FORMAT_RGBA8,
+    RENDER_GRAPH_FORMAT_RGBA16F,
+    //the device's depth format
+    RENDER_GRAPH_FORMAT_DEPTH
+} RenderGraphFormat;
+
+//how a pass uses a resource, which is also the state the resource is in during the pass
+typedef enum RenderGraphUsage
+{
+    RENDER_GRAPH_USAGE_UNDEFINED,
+    RENDER_GRAPH_USAGE_COLOR_ATTACHMENT,
+    RENDER_GRAPH_USAGE_DEPTH_ATTACHMENT,
+    //depth tested but not written
+    RENDER_GRAPH_USAGE_DEPTH_READ,
+    //sampled by fragment or compute shaders
+    RENDER_GRAPH_USAGE_SHADER_READ,
+    RENDER_GRAPH_USAGE_PRESENT,
+    RENDER_GRAPH_USAGE_COUNT
+} RenderGraphUsage;
+
+typedef struct RenderGraphImageDesc
+{
+    RenderGraphFormat format;
+
+    //size relative to the backbuffer
+    f32 scale;
+
+    //used by the first pass writing the image, depth uses the first component
+    f32 clearValue[4];
+} RenderGraphImageDesc;
+
+typedef struct RenderGraphResource
+{
+    //static string
+    const char* name;
+    RenderGraphImageDesc desc;
+
+    //owned outside the graph and kept alive, the backbuffer is the only one so far
+    b8 imported;
+    RenderGraphUsage finalUsage;
+
+    //set by RenderGraphCompile. first and last live pass using the resource
+    u32 firstPass;
+    u32 lastPass;
+
+    //transient image backing this resource, resources with disjoint lifetimes share one
+    u32 physicalIndex;
+} RenderGraphResource;
+
+//a transient image the backend allocates, shared by every resource aliased to it
+typedef struct RenderGraphPhysical
+{
+    RenderGraphFormat format;
+    f32 scale;
+
+    //bit per RenderGraphUsage of every resource aliased here
+    u32 usageMask;
+    u32 lastPass;
+} RenderGraphPhysical;
+
+typedef struct RenderGraphPassUse
+{
+    u32 resource;
+    RenderGraphUsage usage;
+    b8 write;
+
+    //set by RenderGraphCompile. clear when the previous contents are not needed, store when a later pass or the owner needs them
+    b8 clear;
+    b8 store;
+} RenderGraphPassUse;
+
+typedef struct RenderGraphBarrier
+{
+    u32 resource;
+    RenderGraphUsage oldUsage;
+    RenderGraphUsage newUsage;
+
+    //the previous contents are not needed, the old layout can be discarded
+    b8 discard;
+} RenderGraphBarrier;
+
+struct RenderGraph;
+
+//records the commands of a pass, called between the backend's BeginPass and EndPass
+typedef void (*RenderGraphExecuteFn)(struct RenderGraph* _graph, u32 _passIndex, void* _userData);
+
+typedef struct RenderGraphPass
+{
+    //static string, also names the pass' GPU timing
+    const char* name;
+    RenderGraphExecuteFn Execute;
+    void* userData;
+
+    //kept alive even when nothing reads what it writes
+    b8 sideEffects;
+
+    u32 useCount;
+    RenderGraphPassUse uses[RENDER_GRAPH_MAX_PASS_USES];
+
+    //set by RenderGraphCompile
+    b8 culled;
+    u32 barrierCount;
+    RenderGraphBarrier barriers[RENDER_GRAPH_MAX_PASS_USES];
+} RenderGraphPass;
+
+/**
+ * Passes declared for a frame with the resources they read and write. Passes run in
+ * declaration order, compiling culls the ones nothing depends on, aliases transient images
+ * with disjoint lifetimes and computes the transitions each pass needs.
+ */
+typedef struct RenderGraph
+{
+    u32 passCount;
+    RenderGraphPass passes[RENDER_GRAPH_MAX_PASSES];
+
+    u32 resourceCount;
+    RenderGraphResource resources[RENDER_GRAPH_MAX_RESOURCES];
+
+    //set by RenderGraphCompile
+    u32 physicalCount;
+    RenderGraphPhysical physicals[RENDER_GRAPH_MAX_RESOURCES];
+
+    //transitions of imported resources to their final usage after the last pass
+    u32 finalBarrierCount;
+    RenderGraphBarrier finalBarriers[RENDER_GRAPH_MAX_RESOURCES];
+    b8 compiled;
+} RenderGraph;
+
+typedef struct RendererGpuTiming
+{
+    //static string naming the pass or scope
+    const char* name;
+    f64 milliseconds;
+} RendererGpuTiming;
+
+struct RenderPacket;
+
 typedef struct RendererBackend
 {
     struct PlatformState* platform;
     u64 frameNumber;
 
+    //threads that may call RecordDraws concurrently, set by the frontend before Initialize
+    u32 recordThreadCount;
+
+    //set by the frontend before Initialize
+    RendererConfig config;
+
     b8 (*Initialize)(struct RendererBackend* _backend, const char* _appName, struct PlatformState* _platform);
     void (*Shutdown)(struct RendererBackend* _backend);
 
@@ -21,9 +294,64 @@ typedef struct RendererBackend
 
     b8 (*BeginFrame)(struct RendererBackend* _backend, f32 _deltaTime);
     b8 (*EndFrame)(struct RendererBackend* _backend, f32 _deltaTime);
+
+    //prepares the transient images of a compiled graph, called once per frame after BeginFrame
+    b8 (*BeginGraph)(struct RendererBackend* _backend, const RenderGraph* _graph);
+    //records the pass' barriers and begins rendering to its attachments
+    b8 (*BeginPass)(struct RendererBackend* _backend, const RenderGraph* _graph, u32 _passIndex);
+    void (*EndPass)(struct RendererBackend* _backend, const RenderGraph* _graph, u32 _passIndex);
+    //moves imported resources to their final usage
+    void (*EndGraph)(struct RendererBackend* _backend, const RenderGraph* _graph);
+
+    //records a chunk of draws into the current pass, calls with different _threadIndex may run concurrently on any
+    //thread between BeginPass and EndPass. Chunks are replayed by thread index, then in the order they were recorded
+    void (*RecordDraws)(struct RendererBackend* _backend, u32 _threadIndex, const RenderDraw* _draws, u32 _drawCount);
+
+    //called before input is sampled, blocks in low latency mode until the previous frame is presented
+    void (*PaceFrame)(struct RendererBackend* _backend);
+
+    //blocks until the device finished _frameNumber or the timeout expires, FALSE on timeout
+    b8 (*WaitForFrame)(struct RendererBackend* _backend, u64 _frameNumber, u64 _timeoutNS);
+
+    //frames the CPU is ahead of the device, measured at the start of the current frame
+    u32 (*GetFrameLatency)(struct RendererBackend* _backend);
+
+    //copies the GPU times of the most recent finished frame, returns the number written
+    u32 (*GetGpuTimings)(struct RendererBackend* _backend, RendererGpuTiming* _outTimings, u32 _maxTimings);
+
+    //polls an async upload ticket, never blocks
+    b8 (*UploadIsComplete)(struct RendererBackend* _backend, u64 _ticket);
+
+    //uploads a static mesh asynchronously, *_outTicket is its upload ticket. Returns the mesh handle, RENDER_HANDLE_NONE on failure
+    u32 (*CreateStaticMesh)(struct RendererBackend* _backend, const StaticMeshData* _data, u64* _outTicket);
+    //the mesh's buffers are released once the frames in flight are done with them.
+    //FALSE for invalid handles and for meshes GPU objects still reference, those stay alive
+    b8 (*DestroyStaticMesh)(struct RendererBackend* _backend, u32 _mesh);
+
+    //copies the packet's per-frame data the draws reference, called once per frame after BeginFrame
+    b8 (*PrepareFrame)(struct RendererBackend* _backend, const struct RenderPacket* _packet);
+
+    //persistent instances of a static mesh, culled and drawn on the device. Returns the object handle, RENDER_HANDLE_NONE on failure
+    u32 (*CreateGpuObject)(struct RendererBackend* _backend, u32 _mesh, const Mat4* _transform);
+    void (*SetGpuObjectTransform)(struct RendererBackend* _backend, u32 _object, const Mat4* _transform);
+    void (*DestroyGpuObject)(struct RendererBackend* _backend, u32 _object);
+
+    //records the draws of the objects that passed this frame's cull into the current pass
+    void (*RecordGpuScene)(struct RendererBackend* _backend, u32 _threadIndex);
 } RendererBackend;
 
 typedef struct RenderPacket
 {
     f32 deltaTime;
+
+    //every draw submitted this frame in any order, frame allocated by the frontend.
+    //RendererDrawFrame sorts them by key, then splits them into chunks recorded in parallel
+    u32 drawCount;
+    RenderDraw* draws;
+
+    //per-instance transforms of every static mesh draw, indexed by firstInstance. Frame allocated by the frontend
+    u32 instanceCount;
+    const Mat4* instances;
+
+    Mat4 viewProjection;
 } RenderPacket;
\ No newline at end of file
@@ -0,0 +1,82 @@
+#include "RendererWorkers.h"
+
+#include "core/Logger.h"
+#include "core/CMemory.h"
+#include "core/Job.h"
+
+//below this a chunk costs more to hand out than to record on the calling thread
+#define RENDERER_MIN_DRAWS_PER_CHUNK 128
+
+typedef struct RendererWorkersState
+{
+    RendererBackend* backend;
+    u32 threadCount;
+} RendererWorkersState;
+
+//the frame's draw list and the size of every chunk but the last, read by the record jobs
+typedef struct RendererRecordJob
+{
+    const RenderDraw* draws;
+    u32 drawCount;
+    u32 chunkSize;
+} RendererRecordJob;
+
+static RendererWorkersState workersState;
+
+void RendererRecordJobRun(void* _data, u32 _index, u32 _threadIndex);
+
+b8 RendererWorkersInitialize(RendererBackend* _backend, u32 _threadCount)
+{
+    cZeroMemory(&workersState, sizeof(RendererWorkersState));
+    workersState.backend = _backend;
+    workersState.threadCount = _threadCount > 0 ? _threadCount : 1;
+    if(workersState.threadCount > RENDERER_MAX_RECORD_THREADS)
+        workersState.threadCount = RENDERER_MAX_RECORD_THREADS;
+
+    LOG_INFO("Renderer recording on %u threads.", workersState.threadCount);
+    return TRUE;
+}
+
+void RendererWorkersShutdown()
+{
+    cZeroMemory(&workersState, sizeof(RendererWorkersState));
+}
+
+u32 RendererWorkersGetDesiredThreadCount()
+{
+    u32 count = JobSystemGetThreadCount();
+    if(count > RENDERER_MAX_RECORD_THREADS)
+        count = RENDERER_MAX_RECORD_THREADS;
+
+    return count;
+}
+
+void RendererWorkersRecord(const RenderDraw* _draws, u32 _drawCount)
+{
+    if(!_drawCount)
+        return;
+
+    u32 chunkCount = (_drawCount + RENDERER_MIN_DRAWS_PER_CHUNK - 1) / RENDERER_MIN_DRAWS_PER_CHUNK;
+    if(chunkCount > workersState.threadCount)
+        chunkCount = workersState.threadCount;
+
+    //contiguous chunks, the rounded up size can leave the last ones empty
+    RendererRecordJob job;
+    job.draws = _draws;
+    job.drawCount = _drawCount;
+    job.chunkSize = (_drawCount + chunkCount - 1) / chunkCount;
+    chunkCount = (_drawCount + job.chunkSize - 1) / job.chunkSize;
+
+    JobRunParallel(RendererRecordJobRun, &job, chunkCount);
+}
+
+void RendererRecordJobRun(void* _data, u32 _index, u32 _threadIndex)
+{
+    RendererRecordJob* job = (RendererRecordJob*)_data;
+    u32 start = _index * job->chunkSize;
+    u32 count = (job->drawCount - start) < job->chunkSize ? (job->drawCount - start) : job->chunkSize;
+
+    //the chunk index picks the backend's recording slot rather than the job thread, a thread may take
+    //several chunks and the slots are replayed in chunk order, which keeps the draw order
+    workersState.backend->RecordDraws(workersState.backend, _index, job->draws + start, count);
+}
\ No newline at end of file
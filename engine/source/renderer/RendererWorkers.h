@@ -0,0 +1,17 @@
+#pragma once
+
+#include "RendererTypes.inl"
+
+/**
+ * Records chunks of a frame's draw list in parallel through RendererBackend.RecordDraws, on the job system.
+ * Every chunk records into its own backend slot 0 .. threadCount - 1, in draw order.
+ */
+b8 RendererWorkersInitialize(RendererBackend* _backend, u32 _threadCount);
+void RendererWorkersShutdown();
+
+//the job system's thread count, clamped to RENDERER_MAX_RECORD_THREADS
+u32 RendererWorkersGetDesiredThreadCount();
+
+//splits _draws into contiguous chunks, at most one per thread, and blocks until all of them are recorded.
+//Must not be called from inside a job
+void RendererWorkersRecord(const RenderDraw* _draws, u32 _drawCount);
\ No newline at end of file
@@ -0,0 +1,130 @@
+#include "StaticMesh.h"
+
+#include "math/CMath.h"
+
+i16 QuantizeSnorm(f32 _value);
+void OctahedralEncode(Vec3 _normal, f32* _outX, f32* _outY);
+
+void StaticMeshQuantize(const Vertex3D* _vertices, u32 _count, VertexQuantized* _outVertices, Vec3* _outBoundsCenter, Vec3* _outBoundsExtent)
+{
+    Vec3 minimum = Vec3Zero();
+    Vec3 maximum = Vec3Zero();
+    if(_count > 0)
+        minimum = maximum = _vertices[0].position;
+
+    for(u32 i = 1; i < _count; ++i)
+    {
+        for(u32 axis = 0; axis < 3; ++axis)
+        {
+            f32 value = _vertices[i].position.elements[axis];
+            if(value < minimum.elements[axis])
+                minimum.elements[axis] = value;
+            if(value > maximum.elements[axis])
+                maximum.elements[axis] = value;
+        }
+    }
+
+    Vec3 center = Vec3Scale(Vec3Add(minimum, maximum), 0.5f);
+    Vec3 extent = Vec3Scale(Vec3Sub(maximum, minimum), 0.5f);
+
+    //flat axes would divide by zero, any extent decodes them back to the center
+    Vec3 inverseExtent;
+    for(u32 axis = 0; axis < 3; ++axis)
+    {
+        if(extent.elements[axis] <= C_FLOAT_EPSILON)
+            extent.elements[axis] = 1.f;
+        inverseExtent.elements[axis] = 1.f / extent.elements[axis];
+    }
+
+    for(u32 i = 0; i < _count; ++i)
+    {
+        const Vertex3D* vertex = &_vertices[i];
+        VertexQuantized* out = &_outVertices[i];
+
+        Vec3 local = Vec3Mul(Vec3Sub(vertex->position, center), inverseExtent);
+        out->position[0] = QuantizeSnorm(local.x);
+        out->position[1] = QuantizeSnorm(local.y);
+        out->position[2] = QuantizeSnorm(local.z);
+        out->position[3] = 0;
+
+        f32 octX, octY;
+        OctahedralEncode(vertex->normal, &octX, &octY);
+        out->normal[0] = QuantizeSnorm(octX);
+        out->normal[1] = QuantizeSnorm(octY);
+
+        out->texcoord[0] = StaticMeshFloatToHalf(vertex->texcoord.x);
+        out->texcoord[1] = StaticMeshFloatToHalf(vertex->texcoord.y);
+    }
+
+    *_outBoundsCenter = center;
+    *_outBoundsExtent = extent;
+}
+
+u16 StaticMeshFloatToHalf(f32 _value)
+{
+    union { f32 f; u32 u; } bits;
+    bits.f = _value;
+
+    u32 sign = (bits.u >> 16) & 0x8000;
+    i32 exponent = (i32)((bits.u >> 23) & 0xFF) - 127 + 15;
+    u32 mantissa = bits.u & 0x7FFFFF;
+
+    //nan keeps a mantissa bit, infinity and overflow become infinity
+    if(((bits.u >> 23) & 0xFF) == 0xFF)
+        return (u16)(sign | 0x7C00 | (mantissa ? 0x200 : 0));
+    if(exponent >= 31)
+        return (u16)(sign | 0x7C00);
+
+    //denormal or zero, the implicit bit is shifted into the mantissa
+    if(exponent <= 0)
+    {
+        if(exponent < -10)
+            return (u16)sign;
+
+        mantissa |= 0x800000;
+        u32 shift = (u32)(14 - exponent);
+        u32 half = mantissa >> shift;
+        u32 remainder = mantissa & ((1u << shift) - 1);
+        u32 midpoint = 1u << (shift - 1);
+        if(remainder > midpoint || (remainder == midpoint && (half & 1)))
+            ++half;
+        return (u16)(sign | half);
+    }
+
+    //round to nearest even, a mantissa carry correctly bumps the exponent
+    u32 half = sign | ((u32)exponent << 10) | (mantissa >> 13);
+    u32 remainder = mantissa & 0x1FFF;
+    if(remainder > 0x1000 || (remainder == 0x1000 && (half & 1)))
+        ++half;
+    return (u16)half;
+}
+
+i16 QuantizeSnorm(f32 _value)
+{
+    if(_value > 1.f)
+        _value = 1.f;
+    if(_value < -1.f)
+        _value = -1.f;
+
+    f32 scaled = _value * 32767.f;
+    return (i16)(scaled >= 0.f ? scaled + 0.5f : scaled - 0.5f);
+}
+
+void OctahedralEncode(Vec3 _normal, f32* _outX, f32* _outY)
+{
+    //project onto the octahedron, then fold the lower hemisphere over the diagonals
+    f32 sum = CAbs(_normal.x) + CAbs(_normal.y) + CAbs(_normal.z);
+    f32 x = sum > 0.f ? _normal.x / sum : 0.f;
+    f32 y = sum > 0.f ? _normal.y / sum : 0.f;
+
+    if(_normal.z < 0.f)
+    {
+        f32 foldedX = (1.f - CAbs(y)) * (x >= 0.f ? 1.f : -1.f);
+        f32 foldedY = (1.f - CAbs(x)) * (y >= 0.f ? 1.f : -1.f);
+        x = foldedX;
+        y = foldedY;
+    }
+
+    *_outX = x;
+    *_outY = y;
+}
\ No newline at end of file
@@ -0,0 +1,13 @@
+#pragma once
+
+#include "RendererTypes.inl"
+
+/**
+ * Converts interleaved vertices to the 16 byte quantized layout. Positions are stored relative
+ * to the bounds of all vertices, which are returned for the StaticMeshData of the quantized mesh.
+ * Normals are expected to be unit length.
+ */
+CAPI void StaticMeshQuantize(const Vertex3D* _vertices, u32 _count, VertexQuantized* _outVertices, Vec3* _outBoundsCenter, Vec3* _outBoundsExtent);
+
+//IEEE half float, rounded to nearest. Overflows become infinity
+CAPI u16 StaticMeshFloatToHalf(f32 _value);
\ No newline at end of file
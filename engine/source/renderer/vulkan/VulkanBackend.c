@@ -7,7 +7,21 @@
 #include "VulkanRenderpass.h"
 #include "VulkanCommandBuffer.h"
 #include "VulkanFramebuffer.h"
-#include "VulkanFence.h"
+#include "VulkanPipelineCache.h"
+#include "VulkanMemory.h"
+#include "VulkanStagingRing.h"
+#include "VulkanUploader.h"
+#include "VulkanHostAllocator.h"
+#include "VulkanFrameCommands.h"
+#include "VulkanTimeline.h"
+#include "VulkanTimestamps.h"
+#include "VulkanDeletionQueue.h"
+#include "VulkanRenderGraph.h"
+#include "VulkanCompute.h"
+#include "VulkanStaticMesh.h"
+#include "VulkanGpuScene.h"
+#include "VulkanShader.h"
+#include "VulkanDescriptors.h"
 #include "VulkanUtils.h"
 
 #include "core/Logger.h"
@@ -23,6 +37,9 @@ static VulkanContext context;
 static u32 cachedFramebufferWidth = 0;
 static u32 cachedFramebufferHeight = 0;
 
+//timestamp scope of the frame being recorded, passes open their own
+static i32 frameTimestampScope = -1;
+
 VKAPI_ATTR VkBool32 VKAPI_CALL VKDebugCallback(
     VkDebugUtilsMessageSeverityFlagBitsEXT message_severity,
     VkDebugUtilsMessageTypeFlagsEXT message_types,
@@ -31,17 +48,22 @@ VKAPI_ATTR VkBool32 VKAPI_CALL VKDebugCallback(
 
 i32 FindMemoryIndex(u32 _typeFilter, u32 _propertyFlags);
 
-void CreateCommandBuffers(RendererBackend* _backend);
-void RegenerateFramebuffers(RendererBackend* _backend, VulkanSwapchain* _swapchain, VulkanRenderpass* _renderpass);
 b8 RecreateSwapchain(RendererBackend* _backend);
+VkPresentModeKHR ToVulkanPresentMode(RendererPresentMode _mode);
+void SetFrameDynamicState(VulkanCommandBuffer* _commandBuffer, u32 _width, u32 _height);
 
 b8 VulkanRendererBackendInitialize(RendererBackend* _backend, const char* _appName, struct PlatformState* _platform)
 {
     //function pointers
     context.FindMemoryIndex = FindMemoryIndex;
 
-    //TODO: custom allocator
-    context.allocator = 0;
+    //driver host allocations go through the engine allocators, created before anything that takes context.allocator
+    if(!VulkanHostAllocatorCreate(&context.hostAllocator))
+    {
+        LOG_ERROR("Failed to create Vulkan host allocator.");
+        return FALSE;
+    }
+    context.allocator = &context.hostAllocator.callbacks;
 
     ApplicationGetFramebufferSize(&cachedFramebufferWidth, &cachedFramebufferHeight);
     context.framebufferWidth = (cachedFramebufferWidth != 0) ? cachedFramebufferWidth : 800;
@@ -62,8 +84,11 @@ b8 VulkanRendererBackendInitialize(RendererBackend* _backend, const char* _appNa
 
     //obtain list of required extensions
     const char** requiredExtensions = DArrayCreate(const char*);
-    DArrayPush(requiredExtensions, &VK_KHR_SURFACE_EXTENSION_NAME); //generic surface extension
-    PlatformGetRequiredExtensionNames(&requiredExtensions);         //get platform specific extension(s)
+    if(!_backend->config.headless)
+    {
+        DArrayPush(requiredExtensions, &VK_KHR_SURFACE_EXTENSION_NAME); //generic surface extension
+        PlatformGetRequiredExtensionNames(&requiredExtensions);         //get platform specific extension(s)
+    }
 #if defined(_DEBUG)
     DArrayPush(requiredExtensions, &VK_EXT_DEBUG_UTILS_EXTENSION_NAME); //debug utilities
 
@@ -150,47 +175,106 @@ b8 VulkanRendererBackendInitialize(RendererBackend* _backend, const char* _appNa
     LOG_DEBUG("Vulkan debugger created.");
 #endif
 
-    //surface creation
-    LOG_INFO("Creating Vulkan surface...");
-    if(!PlatformCreateVulkanSurface(_platform, &context))
+    //surface creation, headless renders offscreen and leaves the surface null. Device selection and the
+    //swapchain key off that
+    context.surface = 0;
+    if(_backend->config.headless)
     {
-        LOG_ERROR("Failed to create platform surface.");
-        return FALSE;
+        LOG_INFO("Headless, rendering offscreen without a surface.");
+    }
+    else
+    {
+        LOG_INFO("Creating Vulkan surface...");
+        if(!PlatformCreateVulkanSurface(_platform, &context))
+        {
+            LOG_ERROR("Failed to create platform surface.");
+            return FALSE;
+        }
+        LOG_INFO("Vulkan surface created");
     }
-    LOG_INFO("Vulkan surface created");
 
     //device creation
-    if(!VulkanDeviceCreate(&context))
+    if(!VulkanDeviceCreate(&context, _backend->config.deviceName, _backend->config.deviceIndex))
     {
         LOG_ERROR("Failed to create Vulkan device.");
         return FALSE;
     }
 
-    //swapchain creation
+    //depth attachments are transient render graph images in this format
+    if(!VulkanDeviceDetectDepthFormat(&context.device))
+    {
+        LOG_ERROR("Failed to find a supported depth format.");
+        return FALSE;
+    }
+
+    //device memory
+    if(!VulkanMemoryInitialize(&context))
+    {
+        LOG_ERROR("Failed to initialize Vulkan memory allocator.");
+        return FALSE;
+    }
+
+    //deferred destruction, anything released while frames are in flight goes through it
+    if(!VulkanDeletionQueueCreate(&context, &context.deletionQueue))
+    {
+        LOG_ERROR("Failed to create Vulkan deletion queue.");
+        return FALSE;
+    }
+
+    //pipeline cache
+    LOG_INFO("Creating Vulkan pipeline cache...");
+    VulkanPipelineCacheCreate(&context);
+
+    //swapchain creation, the requested settings are kept across recreation
     LOG_INFO("Creating Vulkan swapchain...");
+    context.swapchain.requestedPresentMode = ToVulkanPresentMode(_backend->config.presentMode);
+    context.swapchain.requestedImageCount = _backend->config.swapchainImageCount;
+    context.swapchain.maxFramesInFlight = _backend->config.framesInFlight;
+    context.lowLatency = _backend->config.lowLatency;
+
+    //dynamic rendering replaces the render pass and framebuffer objects of every pass
+    context.dynamicRendering = _backend->config.dynamicRendering && context.device.supportsDynamicRendering;
+    if(_backend->config.dynamicRendering && !context.dynamicRendering)
+    {
+        LOG_WARN("Dynamic rendering requested but not supported by the device, using render passes.");
+    }
     VulkanSwapchainCreate(&context, context.framebufferWidth, context.framebufferHeight, &context.swapchain);
 
-    //renderpass creation
-    LOG_INFO("Creating Vulkan renderpass...");
-    VulkanRenderpassCreate(&context, &context.mainRenderpass, 
-    0, 0, context.framebufferWidth, context.framebufferHeight,
-    0.f, 0.f, 0.2f, 1.f,
-    1.f, 0);
+    //render passes, framebuffers and transient attachments are created by the render graph on first use
+    VulkanRenderGraphCreate(&context, &context.renderGraph);
 
-    //create swapchain framebuffers
-    LOG_INFO("Creating Vulkan swapchain framebuffers...");
-    context.swapchain.framebuffers = DArrayReserve(VulkanFramebuffer, context.swapchain.imageCount);
-    RegenerateFramebuffers(_backend, &context.swapchain, &context.mainRenderpass);
-
-    //create command buffers
+    //create command pools and buffers, one set per frame in flight
     LOG_INFO("Creating Vulkan command buffers...");
-    CreateCommandBuffers(_backend);
+    u32 recordThreadCount = _backend->recordThreadCount ? _backend->recordThreadCount : 1;
+    context.frameCommands = DArrayReserve(VulkanFrameCommands, context.swapchain.maxFramesInFlight);
+    for(u8 i = 0; i < context.swapchain.maxFramesInFlight; ++i)
+    {
+        if(!VulkanFrameCommandsCreate(&context, recordThreadCount, &context.frameCommands[i]))
+        {
+            LOG_ERROR("Failed to create Vulkan frame command pools.");
+            return FALSE;
+        }
+    }
+
+    //async compute, one command buffer per frame in flight
+    if(!VulkanComputeCreate(&context, context.swapchain.maxFramesInFlight, &context.compute))
+    {
+        LOG_ERROR("Failed to create Vulkan async compute.");
+        return FALSE;
+    }
+
+    //gpu timings, one query pool per frame in flight
+    if(!VulkanTimestampsCreate(&context, context.swapchain.maxFramesInFlight, &context.timestamps))
+    {
+        LOG_ERROR("Failed to create Vulkan timestamp queries.");
+        return FALSE;
+    }
 
     //create sync objects
     LOG_INFO("Creating Vulkan sync objects...");
     context.imageAvailableSemaphores = DArrayReserve(VkSemaphore, context.swapchain.maxFramesInFlight);
     context.queueCompleteSemaphores = DArrayReserve(VkSemaphore, context.swapchain.maxFramesInFlight);
-    context.inFlightFences = DArrayReserve(VulkanFence, context.swapchain.maxFramesInFlight);
+    context.frameTimelineValues = DArrayReserve(u64, context.swapchain.maxFramesInFlight);
 
     for(u8 i = 0; i < context.swapchain.maxFramesInFlight; ++i)
     {
@@ -198,17 +282,76 @@ b8 VulkanRendererBackendInitialize(RendererBackend* _backend, const char* _appNa
         vkCreateSemaphore(context.device.logicalDevice, &semaphoreCreateInfo, context.allocator, &context.imageAvailableSemaphores[i]);
         vkCreateSemaphore(context.device.logicalDevice, &semaphoreCreateInfo, context.allocator, &context.queueCompleteSemaphores[i]);
 
-        //create the fence in a signaled state, indicating that the first frame has already been "rendered"
-        //this will prevent the application from waiting indefinitely for the first frame to render since it cannot render until the previous one is rendered.
-        VulkanFenceCreate(&context, TRUE, &context.inFlightFences[i]);
+        //value 0 is reached from the start, so the first frames never wait
+        context.frameTimelineValues[i] = 0;
     }
 
-    //in lfight fences should not exist at this time, clear the list, These are stored in pointers
-    //because the intial state should be 0, will be 0 when not in use, actual fences are not owned by the list
-    context.imagesInFlight = DArrayReserve(VulkanFence, context.swapchain.imageCount);
+    //a single timeline paces every frame, replacing the per-frame fences
+    if(!VulkanTimelineCreate(&context, &context.graphicsTimeline))
+    {
+        LOG_ERROR("Failed to create the graphics timeline.");
+        return FALSE;
+    }
+
+    //no image has been rendered to yet
+    context.imageTimelineValues = DArrayReserve(u64, context.swapchain.imageCount);
     for(u32 i = 0; i < context.swapchain.imageCount; ++i)
     {
-        context.imagesInFlight[i] = 0;
+        context.imageTimelineValues[i] = 0;
+    }
+
+    //staging ring for per-frame uploads
+    LOG_INFO("Creating Vulkan staging ring...");
+    if(!VulkanStagingRingCreate(&context, VULKAN_STAGING_RING_SIZE, &context.stagingRing))
+    {
+        LOG_ERROR("Failed to create Vulkan staging ring.");
+        return FALSE;
+    }
+
+    //async uploader
+    LOG_INFO("Creating Vulkan uploader...");
+    if(!VulkanUploaderCreate(&context, &context.uploader))
+    {
+        LOG_ERROR("Failed to create Vulkan uploader.");
+        return FALSE;
+    }
+
+    LOG_INFO("Creating Vulkan descriptor allocator...");
+    if(!VulkanDescriptorAllocatorCreate(&context, context.swapchain.maxFramesInFlight, &context.descriptorAllocator))
+    {
+        LOG_ERROR("Failed to create Vulkan descriptor allocator.");
+        return FALSE;
+    }
+
+    //shaders declaring a runtime sized texture array are given the table's set layout
+    LOG_INFO("Creating Vulkan bindless table...");
+    if(!VulkanBindlessTableCreate(&context, &context.bindlessTable))
+    {
+        LOG_ERROR("Failed to create Vulkan bindless table.");
+        return FALSE;
+    }
+
+    //shader modules and layouts shared by everything that builds pipelines below
+    LOG_INFO("Creating Vulkan shader library...");
+    if(!VulkanShaderLibraryCreate(&context.shaderLibrary))
+    {
+        LOG_ERROR("Failed to create Vulkan shader library.");
+        return FALSE;
+    }
+
+    //static meshes upload through the uploader, instance buffers follow the frames in flight
+    LOG_INFO("Creating Vulkan static meshes...");
+    if(!VulkanStaticMeshesCreate(&context, context.swapchain.maxFramesInFlight, &context.staticMeshes))
+    {
+        LOG_ERROR("Failed to create Vulkan static meshes.");
+        return FALSE;
+    }
+
+    LOG_INFO("Creating Vulkan gpu scene...");
+    if(!VulkanGpuSceneCreate(&context, context.swapchain.maxFramesInFlight, &context.gpuScene))
+    {
+        LOG_ERROR("Failed to create Vulkan gpu scene.");
+        return FALSE;
     }
 
     LOG_INFO("Vulkan renderer initialized successfully");
@@ -221,6 +364,34 @@ void VulkanRendererBackendShutdown(RendererBackend* _backend)
 
     //destroy in opposite order of creation
 
+    //gpu scene
+    LOG_DEBUG("Destroying Vulkan gpu scene...");
+    VulkanGpuSceneDestroy(&context, &context.gpuScene);
+
+    //static meshes
+    LOG_DEBUG("Destroying Vulkan static meshes...");
+    VulkanStaticMeshesDestroy(&context, &context.staticMeshes);
+
+    //shader library
+    LOG_DEBUG("Destroying Vulkan shader library...");
+    VulkanShaderLibraryDestroy(&context, &context.shaderLibrary);
+
+    //bindless table
+    LOG_DEBUG("Destroying Vulkan bindless table...");
+    VulkanBindlessTableDestroy(&context, &context.bindlessTable);
+
+    //descriptor allocator
+    LOG_DEBUG("Destroying Vulkan descriptor allocator...");
+    VulkanDescriptorAllocatorDestroy(&context, &context.descriptorAllocator);
+
+    //uploader
+    LOG_DEBUG("Destroying Vulkan uploader...");
+    VulkanUploaderDestroy(&context, &context.uploader);
+
+    //staging ring
+    LOG_DEBUG("Destroying Vulkan staging ring...");
+    VulkanStagingRingDestroy(&context, &context.stagingRing);
+
     //sync objects
     LOG_DEBUG("Destroying Vulkan sync objects...");
     for(u8 i = 0; i < context.swapchain.maxFramesInFlight; ++i)
@@ -235,8 +406,6 @@ void VulkanRendererBackendShutdown(RendererBackend* _backend)
             vkDestroySemaphore(context.device.logicalDevice, context.queueCompleteSemaphores[i], context.allocator);
             context.queueCompleteSemaphores[i] = 0;
         }
-
-        VulkanFenceDestroy(&context, &context.inFlightFences[i]);
     }
 
     DArrayDestroy(context.imageAvailableSemaphores);
@@ -245,39 +414,49 @@ void VulkanRendererBackendShutdown(RendererBackend* _backend)
     DArrayDestroy(context.queueCompleteSemaphores);
     context.queueCompleteSemaphores = 0;
 
-    DArrayDestroy(context.inFlightFences);
-    context.inFlightFences = 0;
+    VulkanTimelineDestroy(&context, &context.graphicsTimeline);
+
+    DArrayDestroy(context.frameTimelineValues);
+    context.frameTimelineValues = 0;
+
+    DArrayDestroy(context.imageTimelineValues);
+    context.imageTimelineValues = 0;
 
-    DArrayDestroy(context.imagesInFlight);
-    context.imagesInFlight = 0;
+    LOG_DEBUG("Destroying Vulkan async compute...");
+    VulkanComputeDestroy(&context, &context.compute);
+
+    LOG_DEBUG("Destroying Vulkan timestamp queries...");
+    VulkanTimestampsDestroy(&context, &context.timestamps);
 
     //command buffers
     LOG_DEBUG("Destroying Vulkan command buffers...");
-    for(u32 i = 0; i < context.swapchain.imageCount; ++i)
-    {
-        if(context.graphicsCommandBuffers[i].handle)
-        {
-            VulkanCommandBufferFree(&context, context.device.graphicsCommandPool, &context.graphicsCommandBuffers[i]);
-            context.graphicsCommandBuffers[i].handle = 0;
-        }
-    }
-
-    DArrayDestroy(context.graphicsCommandBuffers);
-    context.graphicsCommandBuffers = 0;
+    for(u8 i = 0; i < context.swapchain.maxFramesInFlight; ++i)
+        VulkanFrameCommandsDestroy(&context, &context.frameCommands[i]);
 
-    //destroy framebuffers
-    LOG_DEBUG("Destroying Vulkan framebuffers...");
-    for(u32 i = 0; i < context.swapchain.imageCount; ++i)
-        VulkanFramebufferDestroy(&context, &context.swapchain.framebuffers[i]);
+    DArrayDestroy(context.frameCommands);
+    context.frameCommands = 0;
 
-    //renderpass
-    LOG_DEBUG("Destroying Vulkan renderpass...");
-    VulkanRenderpassDestroy(&context, &context.mainRenderpass);
+    //render graph framebuffers, render passes and transient images
+    LOG_DEBUG("Destroying Vulkan render graph...");
+    VulkanRenderGraphDestroy(&context, &context.renderGraph);
 
     //swapchain
     LOG_DEBUG("Destroying Vulkan swapchain...");
     VulkanSwapchainDestroy(&context, &context.swapchain);
 
+    //the device is idle, flush whatever is still waiting
+    LOG_DEBUG("Destroying Vulkan deletion queue...");
+    VulkanDeletionQueueDestroy(&context, &context.deletionQueue);
+
+    LOG_DEBUG("Destroying Vulkan pipeline cache...");
+    VulkanPipelineCacheDestroy(&context);
+
+    LOG_DEBUG("Shutting down Vulkan memory allocator...");
+    char* usage = VulkanMemoryGetUsageStr(&context);
+    LOG_DEBUG("%s", usage);
+    cFree(usage, StringLength(usage) + 1, MEMORY_TAG_STRING);
+    VulkanMemoryShutdown(&context);
+
     LOG_DEBUG("Destroying Vulkan device...");
     VulkanDeviceDestroy(&context);
 
@@ -298,6 +477,13 @@ void VulkanRendererBackendShutdown(RendererBackend* _backend)
 
     LOG_DEBUG("Destroying Vulkan instance...");
     vkDestroyInstance(context.instance, context.allocator);
+
+    LOG_DEBUG("Destroying Vulkan host allocator...");
+    char* hostUsage = VulkanHostAllocatorGetUsageStr(&context.hostAllocator);
+    LOG_DEBUG("%s", hostUsage);
+    cFree(hostUsage, StringLength(hostUsage) + 1, MEMORY_TAG_STRING);
+    VulkanHostAllocatorDestroy(&context.hostAllocator);
+    context.allocator = 0;
 }
 
 void VulkanRendererBackendOnResize(RendererBackend* _backend, u16 _width, u16 _height)
@@ -312,49 +498,50 @@ void VulkanRendererBackendOnResize(RendererBackend* _backend, u16 _width, u16 _h
 
 b8 VulkanRendererBackendBeginFrame(RendererBackend* _backend, f32 _deltaTime)
 {
-    VulkanDevice* device = &context.device;
+    //logged when it happened, no frame can be started on the device anymore
+    if(context.deviceLost)
+        return FALSE;
 
     //check if resize happened and return out
     if(context.recreatingSwapchain)
     {
-        VkResult result = vkDeviceWaitIdle(device->logicalDevice);
-        if(!VulkanResultIsSuccess(result))
-        {
-            LOG_ERROR("VulkanRendererBackendBeginFrame vkDeviceWaitIdle (1) failed: '%s'", VulkanResultString(result, TRUE));
-            return FALSE;
-        }
-
         LOG_INFO("Recreating swapchain, returning.");
         return FALSE;
     }
 
-    //check to see if framebuffer has been resized, if so new swapchain needs to be created
+    //check to see if framebuffer has been resized, if so new swapchain needs to be created.
+    //frames in flight keep the old one, so the frame carries on with the new swapchain
     if(context.framebufferSizeGeneration != context.framebufferSizeLastGeneration)
     {
-        VkResult result = vkDeviceWaitIdle(device->logicalDevice);
-        if(!VulkanResultIsSuccess(result))
-        {
-            LOG_ERROR("VulkanRendererBackendBeginFrame vkDeviceWaitIdle (2) failed: '%s'", VulkanResultString(result, TRUE));
-            return FALSE;
-        }
-
         //if swapchain recreation failed because window was minimized, return out before unsetting flag
         if(!RecreateSwapchain(_backend))
         {
             return FALSE;
         }
-
-        LOG_INFO("Resizing, returning.");
-        return FALSE;
     }
 
-    //wait for the execution of the current frame to complete, the being free with allow to move on
-    if(!VulkanFenceWait(&context, &context.inFlightFences[context.currentFrame], UINT64_MAX))
+    //wait for the frame that last used this slot, maxFramesInFlight frames ago, to complete.
+    //the cached timeline value usually makes this free, the driver is only asked when the device is behind
+    if(!VulkanTimelineWait(&context, &context.graphicsTimeline, context.frameTimelineValues[context.currentFrame], UINT64_MAX))
     {
-        LOG_WARN("In-flight fence wait failure.");
+        LOG_WARN("In-flight frame wait failure.");
         return FALSE;
     }
 
+    context.frameLatency = (u32)(context.graphicsTimeline.pendingValue - context.graphicsTimeline.completedValue);
+
+    //resources released by earlier frames, once no frame in flight uses them anymore
+    VulkanDeletionQueueCollect(&context, &context.deletionQueue);
+    VulkanBindlessTableCollect(&context, &context.bindlessTable);
+
+    //command scope driver allocations from the previous frame are all gone by now
+    VulkanHostAllocatorResetFrame(&context.hostAllocator);
+
+    //the fence also covers every command buffer of this frame, recycle them all at once
+    VulkanFrameCommandsReset(&context, &context.frameCommands[context.currentFrame]);
+    VulkanComputeBeginFrame(&context, &context.compute, context.currentFrame);
+    VulkanDescriptorAllocatorBeginFrame(&context, &context.descriptorAllocator, context.currentFrame);
+
     //acquire the next image from the swapchain, pass along the semaphore that should be signaled when this completes.
     //This same semaphore will later be waited on by the queue submission to ensure this image is available
     if(!VulkanSwapchainAcquireNextImageIndex(&context, 
@@ -368,82 +555,125 @@ b8 VulkanRendererBackendBeginFrame(RendererBackend* _backend, f32 _deltaTime)
     }
 
     //begin recording commands
-    VulkanCommandBuffer* commandBuffer = &context.graphicsCommandBuffers[context.imageIndex];
-    VulkanCommandBufferReset(commandBuffer);
-    VulkanCommandBufferBegin(commandBuffer, FALSE, FALSE, FALSE);
+    VulkanCommandBuffer* commandBuffer = &context.frameCommands[context.currentFrame].primary;
+    VulkanCommandBufferBegin(commandBuffer, TRUE, FALSE, FALSE);
+    SetFrameDynamicState(commandBuffer, context.framebufferWidth, context.framebufferHeight);
 
-    //dynamic state
-    VkViewport viewport;
-    viewport.x = 0.f;
-    viewport.y = (f32)context.framebufferHeight;
-    viewport.width = (f32)context.framebufferWidth;
-    viewport.height = (f32)context.framebufferHeight;
-    viewport.minDepth = 0.f;
-    viewport.maxDepth = 1.f;
-
-    //scissor
-    VkRect2D scissor;
-    scissor.offset.x = scissor.offset.y = 0;
-    scissor.extent.width = context.framebufferWidth;
-    scissor.extent.height = context.framebufferHeight;
-
-    vkCmdSetViewport(commandBuffer->handle, 0 , 1, &viewport);
-    vkCmdSetScissor(commandBuffer->handle, 0, 1, &scissor);
-
-    context.mainRenderpass.w = context.framebufferWidth;
-    context.mainRenderpass.h = context.framebufferHeight;
-
-    //begin render pass
-    VulkanRenderpassBegin(commandBuffer, &context.mainRenderpass, context.swapchain.framebuffers[context.imageIndex].handle);
+    //the slot's previous frame has completed, its timings can be read without waiting
+    VulkanTimestampsBeginFrame(&context, &context.timestamps, commandBuffer, context.currentFrame);
+    frameTimestampScope = VulkanTimestampsBeginScope(&context.timestamps, commandBuffer, "frame");
 
+    //render passes are begun by the frontend's render graph
     return TRUE;
 }
 
 b8 VulkanRendererBackendEndFrame(RendererBackend* _backend, f32 _deltaTime)
 {
-    VulkanCommandBuffer* commandBuffer = &context.graphicsCommandBuffers[context.imageIndex];
-
-    //end renderpass
-    VulkanRenderpassEnd(commandBuffer, &context.mainRenderpass);
+    VulkanCommandBuffer* commandBuffer = &context.frameCommands[context.currentFrame].primary;
 
+    VulkanTimestampsEndScope(&context.timestamps, commandBuffer, frameTimestampScope);
     VulkanCommandBufferEnd(commandBuffer);
 
     //make sure the previous frame isnt using this image
-    if(context.imagesInFlight[context.imageIndex] != VK_NULL_HANDLE)
-        VulkanFenceWait(&context, context.imagesInFlight[context.imageIndex], UINT64_MAX);
+    VulkanTimelineWait(&context, &context.graphicsTimeline, context.imageTimelineValues[context.imageIndex], UINT64_MAX);
+
+    //the value this frame signals, the slot and the image are in use until it is reached
+    u64 frameValue = VulkanTimelineNextValue(&context.graphicsTimeline);
+    context.frameTimelineValues[context.currentFrame] = frameValue;
+    context.imageTimelineValues[context.imageIndex] = frameValue;
 
-    //mark the image fence as in use by this frame
-    context.imagesInFlight[context.imageIndex] = &context.inFlightFences[context.currentFrame];
+    //flush async uploads recorded this frame, and pick up the ones that completed
+    VulkanUploaderSubmit(&context, &context.uploader);
+    u64 uploadWaitValue = VulkanUploaderCollectAcquires(&context, &context.uploader, &context.stagingRing);
 
-    //reset the fence for use on next frame
-    VulkanFenceReset(&context, &context.inFlightFences[context.currentFrame]);
+    //flush compute work recorded this frame, its release barriers are paired with acquires in the ring
+    VulkanComputeSubmit(&context, &context.compute, 0, 0);
+
+    //submit this frame's uploads on the transfer queue, the graphics work waits on them
+    VkSemaphore transferSemaphore;
+    VkCommandBuffer acquireCommandBuffer;
+    VulkanStagingRingSubmit(&context, &context.stagingRing, &transferSemaphore, &acquireCommandBuffer);
 
     //submit the queue and wait for operation to complete
     //begin sumbission
     VkSubmitInfo submitInfo = { VK_STRUCTURE_TYPE_SUBMIT_INFO };
 
-    //command buffers to be executed
-    submitInfo.commandBufferCount = 1;
-    submitInfo.pCommandBuffers = &commandBuffer->handle;
-
-    //the semaphores to be signaled when the queue is complete
-    submitInfo.signalSemaphoreCount = 1;
-    submitInfo.pSignalSemaphores = &context.queueCompleteSemaphores[context.currentFrame];
+    //command buffers to be executed, ownership acquire barriers for uploaded buffers run first
+    VkCommandBuffer commandBuffers[2];
+    u32 commandBufferCount = 0;
+    if(acquireCommandBuffer)
+        commandBuffers[commandBufferCount++] = acquireCommandBuffer;
+    commandBuffers[commandBufferCount++] = commandBuffer->handle;
+    submitInfo.commandBufferCount = commandBufferCount;
+    submitInfo.pCommandBuffers = commandBuffers;
+
+    //the semaphores to be signaled when the queue is complete, the frame timeline and the binary one for present.
+    //headless frames are never presented, nothing would wait on the binary one
+    VkSemaphore signalSemaphores[2] = { context.graphicsTimeline.handle, context.queueCompleteSemaphores[context.currentFrame] };
+    uint64_t signalValues[2] = { frameValue, 0 };
+    u32 signalCount = context.surface ? 2 : 1;
+    submitInfo.signalSemaphoreCount = signalCount;
+    submitInfo.pSignalSemaphores = signalSemaphores;
 
     //wait semaphore ensures that the operation cannot beign until image is available
-    submitInfo.waitSemaphoreCount = 1;
-    submitInfo.pWaitSemaphores = &context.imageAvailableSemaphores[context.currentFrame];
-
     //each semaphore waits on the corresponding pipeline stage to complete 1:1 ratio.
     //VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT prevents subsequent color attachment.
-    //writes from executing until the semaphore signals
-    VkPipelineStageFlags flags[1] = { VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT };
+    //writes from executing until the semaphore signals, uploads only hold back the stages that read them
+    VkSemaphore waitSemaphores[4];
+    VkPipelineStageFlags flags[4];
+    uint64_t waitValues[4];
+    u32 waitCount = 0;
+
+    //headless images are acquired without a semaphore
+    if(context.surface)
+    {
+        waitSemaphores[waitCount] = context.imageAvailableSemaphores[context.currentFrame];
+        flags[waitCount] = VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT;
+        waitValues[waitCount++] = 0;
+    }
+
+    if(transferSemaphore)
+    {
+        waitSemaphores[waitCount] = transferSemaphore;
+        flags[waitCount] = VULKAN_STAGING_CONSUMER_STAGES;
+        waitValues[waitCount++] = 0;
+    }
+
+    //already reached on the host, orders the acquire barriers after the async transfer
+    if(uploadWaitValue)
+    {
+        waitSemaphores[waitCount] = context.uploader.timeline.handle;
+        flags[waitCount] = VULKAN_STAGING_CONSUMER_STAGES;
+        waitValues[waitCount++] = uploadWaitValue;
+    }
+
+    //graphics consumes what compute produced this frame, this also makes the frame value cover the compute work
+    if(context.compute.graphicsWaitValue)
+    {
+        waitSemaphores[waitCount] = context.compute.timeline.handle;
+        flags[waitCount] = VULKAN_STAGING_CONSUMER_STAGES | VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT;
+        waitValues[waitCount++] = context.compute.graphicsWaitValue;
+    }
+
+    submitInfo.waitSemaphoreCount = waitCount;
+    submitInfo.pWaitSemaphores = waitSemaphores;
     submitInfo.pWaitDstStageMask = flags;
 
-    VkResult result = vkQueueSubmit(context.device.graphicsQueue, 1, &submitInfo, context.inFlightFences[context.currentFrame].handle);
+    //binary semaphores ignore their value
+    VkTimelineSemaphoreSubmitInfo timelineInfo = { VK_STRUCTURE_TYPE_TIMELINE_SEMAPHORE_SUBMIT_INFO };
+    timelineInfo.waitSemaphoreValueCount = waitCount;
+    timelineInfo.pWaitSemaphoreValues = waitValues;
+    timelineInfo.signalSemaphoreValueCount = signalCount;
+    timelineInfo.pSignalSemaphoreValues = signalValues;
+    submitInfo.pNext = &timelineInfo;
+
+    VkResult result = vkQueueSubmit(context.device.graphicsQueue, 1, &submitInfo, 0);
     if(result != VK_SUCCESS)
     {
-        LOG_ERROR("vkQueueSubmit failed with result: %s", VulkanResultString(result, TRUE));
+        //the transfer, upload and compute submits of the frame went out and the acquired image's semaphore has a
+        //pending signal that nothing will wait on. Reusing those binary semaphores would be invalid, so is waiting on frameValue
+        LOG_FATAL("vkQueueSubmit failed with result: %s, the device is treated as lost and rendering stops.", VulkanResultString(result, TRUE));
+        context.deviceLost = TRUE;
         return FALSE;
     }
 
@@ -462,6 +692,191 @@ b8 VulkanRendererBackendEndFrame(RendererBackend* _backend, f32 _deltaTime)
     return TRUE;
 }
 
+b8 VulkanRendererBackendBeginGraph(RendererBackend* _backend, const RenderGraph* _graph)
+{
+    return VulkanRenderGraphBegin(&context, &context.renderGraph, _graph);
+}
+
+b8 VulkanRendererBackendBeginPass(RendererBackend* _backend, const RenderGraph* _graph, u32 _passIndex)
+{
+    if(!VulkanRenderGraphBeginPass(&context, &context.renderGraph, _graph, _passIndex, &context.frameCommands[context.currentFrame].primary))
+        return FALSE;
+
+    //pipelines depend on the pass' attachments, new layouts are compiled here rather than on the recording threads
+    VulkanStaticMeshPipelineCacheBeginPass(&context, &context.staticMeshes.pipelines, &context.renderGraph);
+    VulkanStaticMeshPipelineCacheBeginPass(&context, &context.gpuScene.pipelines, &context.renderGraph);
+    return TRUE;
+}
+
+void VulkanRendererBackendEndPass(RendererBackend* _backend, const RenderGraph* _graph, u32 _passIndex)
+{
+    VulkanStaticMeshPipelineCacheEndPass(&context.staticMeshes.pipelines);
+    VulkanStaticMeshPipelineCacheEndPass(&context.gpuScene.pipelines);
+
+    //replays the chunks recorded for the pass
+    VulkanRenderGraphEndPass(&context, &context.renderGraph, &context.frameCommands[context.currentFrame]);
+}
+
+void VulkanRendererBackendEndGraph(RendererBackend* _backend, const RenderGraph* _graph)
+{
+    VulkanRenderGraphEnd(&context, &context.renderGraph, _graph, &context.frameCommands[context.currentFrame].primary);
+}
+
+void VulkanRendererBackendRecordDraws(RendererBackend* _backend, u32 _threadIndex, const RenderDraw* _draws, u32 _drawCount)
+{
+    VulkanRenderGraph* graph = &context.renderGraph;
+    if(!graph->passActive)
+    {
+        LOG_ERROR("VulkanRendererBackendRecordDraws called outside of a render pass.");
+        return;
+    }
+
+    VulkanCommandBuffer* commandBuffer = VulkanFrameCommandsBeginSecondary(&context,
+        &context.frameCommands[context.currentFrame],
+        _threadIndex,
+        graph->passRenderpass ? graph->passRenderpass->handle : 0,
+        graph->passFramebuffer,
+        &graph->passDesc);
+    if(!commandBuffer)
+        return;
+
+    //dynamic state is not inherited from the primary
+    SetFrameDynamicState(commandBuffer, graph->passWidth, graph->passHeight);
+
+    //draws arrive sorted by key, so state only changes at group boundaries. Every chunk starts unbound
+    VulkanStaticMeshBinding meshBinding;
+    VulkanStaticMeshBindingReset(&meshBinding);
+    for(u32 i = 0; i < _drawCount; ++i)
+    {
+        const RenderDraw* draw = &_draws[i];
+
+        //the static mesh pipelines are the only ones the backend has and they need the mesh' buffers,
+        //anything else would draw with whatever happens to be bound. The frontend rejects such draws already
+        if(draw->mesh == RENDER_HANDLE_NONE)
+            continue;
+
+        //static meshes bind their own pipeline, buffers and instance data
+        VulkanStaticMeshesRecordDraw(&context, &context.staticMeshes, commandBuffer, draw, &meshBinding);
+    }
+
+    VulkanCommandBufferEnd(commandBuffer);
+}
+
+b8 VulkanRendererBackendWaitForFrame(RendererBackend* _backend, u64 _frameNumber, u64 _timeoutNS)
+{
+    //every EndFrame signals the next graphics timeline value, frame N completes at N + 1.
+    //the frame whose submit failed never signals its value
+    if(context.deviceLost)
+        return FALSE;
+
+    return VulkanTimelineWait(&context, &context.graphicsTimeline, _frameNumber + 1, _timeoutNS);
+}
+
+void VulkanRendererBackendPaceFrame(RendererBackend* _backend)
+{
+    if(!context.lowLatency || context.deviceLost)
+        return;
+
+    //block until the previous frame reached the display, or at least finished on the device,
+    //so the next frame samples input as late as possible
+    if(context.device.supportsPresentWait && context.swapchain.lastPresentId)
+    {
+        VkResult result = context.device.waitForPresent(context.device.logicalDevice, context.swapchain.handle, context.swapchain.lastPresentId, UINT64_MAX);
+        if(result != VK_SUCCESS && result != VK_TIMEOUT && result != VK_ERROR_OUT_OF_DATE_KHR && result != VK_SUBOPTIMAL_KHR)
+        {
+            LOG_WARN("vkWaitForPresentKHR failed with result: %s", VulkanResultString(result, TRUE));
+        }
+        return;
+    }
+
+    VulkanTimelineWait(&context, &context.graphicsTimeline, context.graphicsTimeline.pendingValue, UINT64_MAX);
+}
+
+u32 VulkanRendererBackendGetFrameLatency(RendererBackend* _backend)
+{
+    return context.frameLatency;
+}
+
+u32 VulkanRendererBackendGetGpuTimings(RendererBackend* _backend, RendererGpuTiming* _outTimings, u32 _maxTimings)
+{
+    u32 count = context.timestamps.resultCount < _maxTimings ? context.timestamps.resultCount : _maxTimings;
+    for(u32 i = 0; i < count; ++i)
+    {
+        _outTimings[i].name = context.timestamps.results[i].name;
+        _outTimings[i].milliseconds = context.timestamps.results[i].milliseconds;
+    }
+
+    return count;
+}
+
+b8 VulkanRendererBackendUploadIsComplete(RendererBackend* _backend, u64 _ticket)
+{
+    return VulkanUploaderIsComplete(&context, &context.uploader, _ticket);
+}
+
+u32 VulkanRendererBackendCreateStaticMesh(RendererBackend* _backend, const StaticMeshData* _data, u64* _outTicket)
+{
+    return VulkanStaticMeshCreate(&context, &context.staticMeshes, _data, _outTicket);
+}
+
+b8 VulkanRendererBackendDestroyStaticMesh(RendererBackend* _backend, u32 _mesh)
+{
+    //objects keep the handle as their batch and the mesh' bounds, a reused handle would draw them as another mesh
+    u32 objectCount = VulkanGpuSceneGetMeshObjectCount(&context.gpuScene, _mesh);
+    if(objectCount > 0)
+    {
+        LOG_ERROR("Static mesh %u is still used by %u gpu objects, destroy them before the mesh.", _mesh, objectCount);
+        return FALSE;
+    }
+
+    return VulkanStaticMeshDestroy(&context, &context.staticMeshes, _mesh);
+}
+
+b8 VulkanRendererBackendPrepareFrame(RendererBackend* _backend, const RenderPacket* _packet)
+{
+    if(!VulkanStaticMeshesPrepareFrame(&context, &context.staticMeshes, context.currentFrame, _packet))
+        return FALSE;
+
+    //the cull runs on the graphics queue ahead of the render graph, so the draws need no queue ownership transfers
+    return VulkanGpuScenePrepareFrame(&context, &context.gpuScene, &context.staticMeshes, context.currentFrame,
+        &context.frameCommands[context.currentFrame].primary, &_packet->viewProjection);
+}
+
+u32 VulkanRendererBackendCreateGpuObject(RendererBackend* _backend, u32 _mesh, const Mat4* _transform)
+{
+    return VulkanGpuSceneObjectCreate(&context.gpuScene, &context.staticMeshes, _mesh, _transform);
+}
+
+void VulkanRendererBackendSetGpuObjectTransform(RendererBackend* _backend, u32 _object, const Mat4* _transform)
+{
+    VulkanGpuSceneObjectSetTransform(&context.gpuScene, _object, _transform);
+}
+
+void VulkanRendererBackendDestroyGpuObject(RendererBackend* _backend, u32 _object)
+{
+    VulkanGpuSceneObjectDestroy(&context.gpuScene, _object);
+}
+
+void VulkanRendererBackendRecordGpuScene(RendererBackend* _backend, u32 _threadIndex)
+{
+    VulkanRenderGraph* graph = &context.renderGraph;
+    if(!graph->passActive || context.gpuScene.frameBatchCount == 0)
+        return;
+
+    VulkanCommandBuffer* commandBuffer = VulkanFrameCommandsBeginSecondary(&context,
+        &context.frameCommands[context.currentFrame],
+        _threadIndex,
+        graph->passRenderpass ? graph->passRenderpass->handle : 0,
+        graph->passFramebuffer,
+        &graph->passDesc);
+    if(!commandBuffer)
+        return;
+
+    SetFrameDynamicState(commandBuffer, graph->passWidth, graph->passHeight);
+    VulkanGpuSceneRecordDraws(&context, &context.gpuScene, &context.staticMeshes, commandBuffer);
+    VulkanCommandBufferEnd(commandBuffer);
+}
+
 VKAPI_ATTR VkBool32 VKAPI_CALL VKDebugCallback(
     VkDebugUtilsMessageSeverityFlagBitsEXT message_severity,
     VkDebugUtilsMessageTypeFlagsEXT message_types,
@@ -497,51 +912,32 @@ i32 FindMemoryIndex(u32 _typeFilter, u32 _propertyFlags)
     {
         //check each memory type to see if its bit is set to 1
         if(_typeFilter & (1 << i) && (memoryProperties.memoryTypes[i].propertyFlags & _propertyFlags) == _propertyFlags)
-            return 1;
+            return i;
     }
 
     LOG_WARN("Unable to find suitable memory type.");
     return -1;
 }
 
-void CreateCommandBuffers(RendererBackend* _backend)
+void SetFrameDynamicState(VulkanCommandBuffer* _commandBuffer, u32 _width, u32 _height)
 {
-    if(!context.graphicsCommandBuffers)
-    {
-        context.graphicsCommandBuffers = DArrayReserve(VulkanCommandBuffer, context.swapchain.imageCount);
-        for(u32 i = 0; i < context.swapchain.imageCount; ++i)
-            cZeroMemory(&context.graphicsCommandBuffers[i], sizeof(VulkanCommandBuffer));
-    }
-
-    for(u32 i = 0; i < context.swapchain.imageCount; ++i)
-    {
-        if(context.graphicsCommandBuffers[i].handle)
-            VulkanCommandBufferFree(&context, context.device.graphicsCommandPool, &context.graphicsCommandBuffers[i]);
-
-        cZeroMemory(&context.graphicsCommandBuffers[i], sizeof(VulkanCommandBuffer));
-        VulkanCommandBufferAllocate(&context, context.device.graphicsCommandPool, TRUE, &context.graphicsCommandBuffers[i]);
-    }
-
-    LOG_INFO("Vulkan command buffers created.");
-}
-
-void RegenerateFramebuffers(RendererBackend* _backend, VulkanSwapchain* _swapchain, VulkanRenderpass* _renderpass)
-{
-    for(u32 i = 0; i < _swapchain->imageCount; ++i)
-    {
-        //TODO: make this dynamic based on the currently configured attachments
-        u32 attachmentCount = 2;
-        VkImageView attachments[] = { _swapchain->views[i], _swapchain->depthAttachment.view };
+    //dynamic state, flipped with a negative height so clip space y points up
+    VkViewport viewport;
+    viewport.x = 0.f;
+    viewport.y = (f32)_height;
+    viewport.width = (f32)_width;
+    viewport.height = -(f32)_height;
+    viewport.minDepth = 0.f;
+    viewport.maxDepth = 1.f;
 
-        VulkanFramebufferCreate(&context,
-            _renderpass,
-            context.framebufferWidth, context.framebufferHeight,
-            attachmentCount,
-            attachments,
-            &context.swapchain.framebuffers[i]);
-    }
+    //scissor
+    VkRect2D scissor;
+    scissor.offset.x = scissor.offset.y = 0;
+    scissor.extent.width = _width;
+    scissor.extent.height = _height;
 
-    LOG_INFO("Vulkan framebuffers created.");
+    vkCmdSetViewport(_commandBuffer->handle, 0 , 1, &viewport);
+    vkCmdSetScissor(_commandBuffer->handle, 0, 1, &scissor);
 }
 
 b8 RecreateSwapchain(RendererBackend* _backend)
@@ -560,52 +956,64 @@ b8 RecreateSwapchain(RendererBackend* _backend)
         return FALSE;
     }
 
+    //requery support, a minimized window reports a zero extent until it is restored
+    if(context.surface)
+    {
+        VulkanDeviceQuerySwapchainSupport(context.device.physicalDevice, context.surface, &context.device.swapchainSupport);
+        VkExtent2D currentExtent = context.device.swapchainSupport.capabilities.currentExtent;
+        if(currentExtent.width == 0 || currentExtent.height == 0)
+        {
+            LOG_DEBUG("RecreateSwapchain called while the surface has no extent, returning.");
+            return FALSE;
+        }
+    }
+
     //mark as recreating swapchain
     context.recreatingSwapchain = TRUE;
 
-    //wait for operations to complete
-    vkDeviceWaitIdle(context.device.logicalDevice);
-
-    //clear out images in flight in case
-    for(u32 i = 0; i < context.swapchain.imageCount; ++i)
-        context.imagesInFlight[i] = 0;
+    //out of date swapchains recreate without a resize event, keep the current size then
+    u32 width = cachedFramebufferWidth ? cachedFramebufferWidth : context.framebufferWidth;
+    u32 height = cachedFramebufferHeight ? cachedFramebufferHeight : context.framebufferHeight;
 
-    //requery support
-    VulkanDeviceQuerySwapchainSupport(context.device.physicalDevice, context.surface, &context.device.swapchainSupport);
-    VulkanDeviceDetectDepthFormat(&context.device);
+    //no device wait, the framebuffers using the old views and then the old swapchain go to the deletion queue
+    VulkanRenderGraphInvalidateFramebuffers(&context, &context.renderGraph);
+    VulkanSwapchainRecreate(&context, width, height, &context.swapchain);
 
-    VulkanSwapchainRecreate(&context, cachedFramebufferWidth, cachedFramebufferHeight, &context.swapchain);
+    //the new images have not been rendered to yet, their count may differ
+    DArrayDestroy(context.imageTimelineValues);
+    context.imageTimelineValues = DArrayReserve(u64, context.swapchain.imageCount);
+    for(u32 i = 0; i < context.swapchain.imageCount; ++i)
+        context.imageTimelineValues[i] = 0;
 
-    //sync the framebuffer size with the cached sizes
-    context.framebufferWidth = cachedFramebufferWidth;
-    context.framebufferHeight = cachedFramebufferHeight;
-    context.mainRenderpass.w = context.framebufferWidth;
-    context.mainRenderpass.h = context.framebufferHeight;
+    //sync the framebuffer size with the extent the surface actually gave us
+    context.framebufferWidth = context.swapchain.extent.width;
+    context.framebufferHeight = context.swapchain.extent.height;
     cachedFramebufferWidth = 0;
     cachedFramebufferHeight = 0;
 
     //update framebuffer size generation
     context.framebufferSizeLastGeneration = context.framebufferSizeGeneration;
 
-    //cleanup swapchain
-    for(u32 i = 0; i < context.swapchain.imageCount; ++i)
-        VulkanCommandBufferFree(&context, context.device.graphicsCommandPool, &context.graphicsCommandBuffers[i]);
-    
-    //framebuffers
-    for(u32 i = 0; i < context.swapchain.imageCount; ++i)
-        VulkanFramebufferDestroy(&context, &context.swapchain.framebuffers[i]);
-
-    context.mainRenderpass.x = 0;
-    context.mainRenderpass.y = 0;
-    context.mainRenderpass.w = context.framebufferWidth;
-    context.mainRenderpass.h = context.framebufferHeight;
-
-    RegenerateFramebuffers(_backend, &context.swapchain, &context.mainRenderpass);
-
-    CreateCommandBuffers(_backend);
+    //framebuffers and attachments follow the new size on the next graph execution
 
     //clear recreating flag
     context.recreatingSwapchain = FALSE;
 
     return TRUE;
+}
+
+VkPresentModeKHR ToVulkanPresentMode(RendererPresentMode _mode)
+{
+    switch(_mode)
+    {
+        case RENDERER_PRESENT_MODE_FIFO:
+            return VK_PRESENT_MODE_FIFO_KHR;
+        case RENDERER_PRESENT_MODE_IMMEDIATE:
+            return VK_PRESENT_MODE_IMMEDIATE_KHR;
+        case RENDERER_PRESENT_MODE_FIFO_RELAXED:
+            return VK_PRESENT_MODE_FIFO_RELAXED_KHR;
+        case RENDERER_PRESENT_MODE_MAILBOX:
+        default:
+            return VK_PRESENT_MODE_MAILBOX_KHR;
+    }
 }
\ No newline at end of file
@@ -8,4 +8,29 @@ void VulkanRendererBackendShutdown(RendererBackend* _backend);
 void VulkanRendererBackendOnResize(RendererBackend* _backend, u16 _width, u16 _height);
 
 b8 VulkanRendererBackendBeginFrame(RendererBackend* _backend, f32 _deltaTime);
-b8 VulkanRendererBackendEndFrame(RendererBackend* _backend, f32 _deltaTime);
\ No newline at end of file
+b8 VulkanRendererBackendEndFrame(RendererBackend* _backend, f32 _deltaTime);
+
+b8 VulkanRendererBackendBeginGraph(RendererBackend* _backend, const RenderGraph* _graph);
+b8 VulkanRendererBackendBeginPass(RendererBackend* _backend, const RenderGraph* _graph, u32 _passIndex);
+void VulkanRendererBackendEndPass(RendererBackend* _backend, const RenderGraph* _graph, u32 _passIndex);
+void VulkanRendererBackendEndGraph(RendererBackend* _backend, const RenderGraph* _graph);
+
+void VulkanRendererBackendRecordDraws(RendererBackend* _backend, u32 _threadIndex, const RenderDraw* _draws, u32 _drawCount);
+
+void VulkanRendererBackendPaceFrame(RendererBackend* _backend);
+b8 VulkanRendererBackendWaitForFrame(RendererBackend* _backend, u64 _frameNumber, u64 _timeoutNS);
+u32 VulkanRendererBackendGetFrameLatency(RendererBackend* _backend);
+
+u32 VulkanRendererBackendGetGpuTimings(RendererBackend* _backend, RendererGpuTiming* _outTimings, u32 _maxTimings);
+
+b8 VulkanRendererBackendUploadIsComplete(RendererBackend* _backend, u64 _ticket);
+
+u32 VulkanRendererBackendCreateStaticMesh(RendererBackend* _backend, const StaticMeshData* _data, u64* _outTicket);
+b8 VulkanRendererBackendDestroyStaticMesh(RendererBackend* _backend, u32 _mesh);
+
+b8 VulkanRendererBackendPrepareFrame(RendererBackend* _backend, const RenderPacket* _packet);
+
+u32 VulkanRendererBackendCreateGpuObject(RendererBackend* _backend, u32 _mesh, const Mat4* _transform);
+void VulkanRendererBackendSetGpuObjectTransform(RendererBackend* _backend, u32 _object, const Mat4* _transform);
+void VulkanRendererBackendDestroyGpuObject(RendererBackend* _backend, u32 _object);
+void VulkanRendererBackendRecordGpuScene(RendererBackend* _backend, u32 _threadIndex);
\ No newline at end of file
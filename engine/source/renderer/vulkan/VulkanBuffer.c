@@ -0,0 +1,247 @@
+#include "VulkanBuffer.h"
+
+#include "VulkanDevice.h"
+#include "VulkanCommandBuffer.h"
+#include "VulkanMemory.h"
+#include "VulkanStagingRing.h"
+#include "VulkanDeletionQueue.h"
+
+#include "core/Logger.h"
+#include "core/CMemory.h"
+
+#include "containers/DArray.h"
+
+b8 VulkanBufferCreate(
+    VulkanContext* _context,
+    u64 _size,
+    VkBufferUsageFlags _usage,
+    VkMemoryPropertyFlags _memoryPropertyFlags,
+    b8 _bindOnCreate,
+    VulkanBuffer* _outBuffer)
+{
+    cZeroMemory(_outBuffer, sizeof(VulkanBuffer));
+    _outBuffer->totalSize = _size;
+    _outBuffer->usage = _usage;
+    _outBuffer->memoryPropertyFlags = _memoryPropertyFlags;
+
+    VkBufferCreateInfo bufferInfo = { VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO };
+    bufferInfo.size = _size;
+    bufferInfo.usage = _usage;
+    //NOTE: only used by one queue at a time, uploads transfer ownership explicitly
+    bufferInfo.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
+
+    VK_CHECK(vkCreateBuffer(_context->device.logicalDevice, &bufferInfo, _context->allocator, &_outBuffer->handle));
+
+    //gather memory requirements
+    VkMemoryRequirements requirements;
+    vkGetBufferMemoryRequirements(_context->device.logicalDevice, _outBuffer->handle, &requirements);
+
+    //allocate memory
+    if(!VulkanMemoryAllocate(_context, &requirements, _memoryPropertyFlags, FALSE, &_outBuffer->allocation))
+    {
+        LOG_ERROR("Unable to create Vulkan buffer because memory allocation failed.");
+        vkDestroyBuffer(_context->device.logicalDevice, _outBuffer->handle, _context->allocator);
+        _outBuffer->handle = 0;
+        return FALSE;
+    }
+
+    if(_bindOnCreate)
+        VulkanBufferBind(_context, _outBuffer, 0);
+
+    return TRUE;
+}
+
+void VulkanBufferDestroy(VulkanContext* _context, VulkanBuffer* _buffer)
+{
+    if(_buffer->handle)
+    {
+        vkDestroyBuffer(_context->device.logicalDevice, _buffer->handle, _context->allocator);
+        _buffer->handle = 0;
+    }
+    if(_buffer->allocation.memory)
+        VulkanMemoryFree(_context, &_buffer->allocation);
+
+    _buffer->totalSize = 0;
+    _buffer->usage = 0;
+    _buffer->isLocked = FALSE;
+}
+
+b8 VulkanBufferResize(
+    VulkanContext* _context,
+    u64 _newSize,
+    VulkanBuffer* _buffer,
+    VkQueue _queue,
+    VkCommandPool _pool)
+{
+    VulkanBuffer newBuffer;
+    if(!VulkanBufferCreate(_context, _newSize, _buffer->usage, _buffer->memoryPropertyFlags, TRUE, &newBuffer))
+    {
+        LOG_ERROR("VulkanBufferResize failed to create the new buffer.");
+        return FALSE;
+    }
+
+    //copy over the data
+    u64 copySize = _buffer->totalSize < _newSize ? _buffer->totalSize : _newSize;
+    VulkanBufferCopyTo(_context, _pool, _queue, _buffer->handle, 0, newBuffer.handle, 0, copySize);
+
+    //frames in flight may still read the old buffer, it is destroyed once they complete
+    VulkanDeletionQueueRetireBuffer(_context, &_context->deletionQueue, _buffer);
+    *_buffer = newBuffer;
+
+    return TRUE;
+}
+
+void VulkanBufferBind(VulkanContext* _context, VulkanBuffer* _buffer, u64 _offset)
+{
+    VK_CHECK(vkBindBufferMemory(
+        _context->device.logicalDevice,
+        _buffer->handle,
+        _buffer->allocation.memory,
+        _buffer->allocation.offset + _offset));
+}
+
+void* VulkanBufferLockMemory(VulkanContext* _context, VulkanBuffer* _buffer, u64 _offset, u64 _size)
+{
+    if(!_buffer->allocation.mappedData)
+    {
+        LOG_ERROR("VulkanBufferLockMemory called on a buffer that is not host visible.");
+        return 0;
+    }
+
+    _buffer->isLocked = TRUE;
+    return (u8*)_buffer->allocation.mappedData + _offset;
+}
+
+void VulkanBufferUnlockMemory(VulkanContext* _context, VulkanBuffer* _buffer)
+{
+    if(!_buffer->isLocked)
+        return;
+
+    //writes to non coherent memory have to be made visible to the device explicitly.
+    //allocations are power of two sized nodes of at least 256 bytes, which keeps the range nonCoherentAtomSize aligned
+    if(!(_buffer->memoryPropertyFlags & VK_MEMORY_PROPERTY_HOST_COHERENT_BIT))
+    {
+        VkMappedMemoryRange range = { VK_STRUCTURE_TYPE_MAPPED_MEMORY_RANGE };
+        range.memory = _buffer->allocation.memory;
+        range.offset = _buffer->allocation.offset;
+        range.size = _buffer->allocation.blockIndex == VULKAN_MEMORY_DEDICATED_BLOCK ? VK_WHOLE_SIZE : _buffer->allocation.size;
+        VK_CHECK(vkFlushMappedMemoryRanges(_context->device.logicalDevice, 1, &range));
+    }
+
+    _buffer->isLocked = FALSE;
+}
+
+void VulkanBufferLoadData(VulkanContext* _context, VulkanBuffer* _buffer, u64 _offset, u64 _size, const void* _data)
+{
+    void* data = VulkanBufferLockMemory(_context, _buffer, _offset, _size);
+    if(!data)
+        return;
+
+    cCopyMemory(data, _data, _size);
+    VulkanBufferUnlockMemory(_context, _buffer);
+}
+
+void VulkanBufferCopyTo(
+    VulkanContext* _context,
+    VkCommandPool _pool,
+    VkQueue _queue,
+    VkBuffer _source,
+    u64 _sourceOffset,
+    VkBuffer _dest,
+    u64 _destOffset,
+    u64 _size)
+{
+    //create a one time use command buffer
+    VulkanCommandBuffer tempCommandBuffer;
+    VulkanCommandBufferAllocateAndBeginSingleUse(_context, _pool, &tempCommandBuffer);
+
+    //prepare the copy command and add it to the command buffer
+    VkBufferCopy copyRegion;
+    copyRegion.srcOffset = _sourceOffset;
+    copyRegion.dstOffset = _destOffset;
+    copyRegion.size = _size;
+
+    vkCmdCopyBuffer(tempCommandBuffer.handle, _source, _dest, 1, &copyRegion);
+
+    //submit the buffer for execution and wait for it to complete
+    VulkanCommandBufferEndSingleUse(_context, _pool, &tempCommandBuffer, _queue);
+}
+
+b8 VulkanBufferUpload(VulkanContext* _context, VulkanBuffer* _buffer, u64 _offset, u64 _size, const void* _data)
+{
+    VulkanStagingRing* ring = &_context->stagingRing;
+
+    u64 stagingOffset = 0;
+    void* staging = VulkanStagingRingAllocate(_context, ring, _size, &stagingOffset);
+    if(!staging)
+    {
+        //ring is exhausted, fall back to a temporary staging buffer and a blocking copy on the graphics queue
+        LOG_WARN("Staging ring full, uploading %llu bytes synchronously.", _size);
+
+        VulkanBuffer temp;
+        if(!VulkanBufferCreate(
+            _context,
+            _size,
+            VK_BUFFER_USAGE_TRANSFER_SRC_BIT,
+            VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT,
+            TRUE,
+            &temp))
+        {
+            return FALSE;
+        }
+
+        VulkanBufferLoadData(_context, &temp, 0, _size, _data);
+        VulkanBufferCopyTo(
+            _context,
+            _context->device.graphicsCommandPool,
+            _context->device.graphicsQueue,
+            temp.handle,
+            0,
+            _buffer->handle,
+            _offset,
+            _size);
+
+        VulkanBufferDestroy(_context, &temp);
+        return TRUE;
+    }
+
+    cCopyMemory(staging, _data, _size);
+
+    VulkanCommandBuffer* commandBuffer = VulkanStagingRingGetCommandBuffer(_context, ring);
+
+    VkBufferCopy copyRegion;
+    copyRegion.srcOffset = stagingOffset;
+    copyRegion.dstOffset = _offset;
+    copyRegion.size = _size;
+    vkCmdCopyBuffer(commandBuffer->handle, ring->buffer.handle, _buffer->handle, 1, &copyRegion);
+
+    //with a shared queue family the semaphore between the submissions is enough
+    if(_context->device.transferQueueIndex == _context->device.graphicsQueueIndex)
+        return TRUE;
+
+    //release from the transfer family, the matching acquire runs on the graphics queue before the frame.
+    //the destination is only written, so no acquire is needed on the transfer side
+    VkBufferMemoryBarrier barrier = { VK_STRUCTURE_TYPE_BUFFER_MEMORY_BARRIER };
+    barrier.srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+    barrier.dstAccessMask = 0;
+    barrier.srcQueueFamilyIndex = _context->device.transferQueueIndex;
+    barrier.dstQueueFamilyIndex = _context->device.graphicsQueueIndex;
+    barrier.buffer = _buffer->handle;
+    barrier.offset = _offset;
+    barrier.size = _size;
+
+    vkCmdPipelineBarrier(
+        commandBuffer->handle,
+        VK_PIPELINE_STAGE_TRANSFER_BIT,
+        VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT,
+        0,
+        0, 0,
+        1, &barrier,
+        0, 0);
+
+    barrier.srcAccessMask = 0;
+    barrier.dstAccessMask = VULKAN_STAGING_CONSUMER_ACCESS;
+    DArrayPush(ring->pendingAcquires, barrier);
+
+    return TRUE;
+}
\ No newline at end of file
@@ -0,0 +1,53 @@
+#pragma once
+
+#include "VulkanTypes.inl"
+
+b8 VulkanBufferCreate(
+    VulkanContext* _context,
+    u64 _size,
+    VkBufferUsageFlags _usage,
+    VkMemoryPropertyFlags _memoryPropertyFlags,
+    b8 _bindOnCreate,
+    VulkanBuffer* _outBuffer);
+
+void VulkanBufferDestroy(VulkanContext* _context, VulkanBuffer* _buffer);
+
+//creates a buffer of _newSize, copies the old contents over and retires the old buffer to the deletion queue. Blocks on _queue.
+b8 VulkanBufferResize(
+    VulkanContext* _context,
+    u64 _newSize,
+    VulkanBuffer* _buffer,
+    VkQueue _queue,
+    VkCommandPool _pool);
+
+void VulkanBufferBind(VulkanContext* _context, VulkanBuffer* _buffer, u64 _offset);
+
+//host visible buffers only, memory is persistently mapped so this does not call vkMapMemory
+void* VulkanBufferLockMemory(VulkanContext* _context, VulkanBuffer* _buffer, u64 _offset, u64 _size);
+
+//flushes the buffer if its memory is not host coherent
+void VulkanBufferUnlockMemory(VulkanContext* _context, VulkanBuffer* _buffer);
+
+//copies _data directly into a host visible buffer
+void VulkanBufferLoadData(VulkanContext* _context, VulkanBuffer* _buffer, u64 _offset, u64 _size, const void* _data);
+
+//records and submits a copy on _queue and waits for the queue to go idle. A synchronous slow path
+//for resizes and a full staging ring, regular uploads go through VulkanBufferUpload
+void VulkanBufferCopyTo(
+    VulkanContext* _context,
+    VkCommandPool _pool,
+    VkQueue _queue,
+    VkBuffer _source,
+    u64 _sourceOffset,
+    VkBuffer _dest,
+    u64 _destOffset,
+    u64 _size);
+
+/**
+ * Uploads _data into a device local buffer through the staging ring. The copy is recorded on the
+ * transfer queue and submitted with the current frame, ownership is handed to the graphics queue
+ * before the frame's commands execute. Nothing waits on the CPU unless the ring is full.
+ * The destination range must not be in use by a frame still in flight.
+ * @returns TRUE if the copy was queued or, when the ring is full, completed synchronously.
+ */
+b8 VulkanBufferUpload(VulkanContext* _context, VulkanBuffer* _buffer, u64 _offset, u64 _size, const void* _data);
\ No newline at end of file
@@ -39,6 +39,42 @@ void VulkanCommandBufferBegin(VulkanCommandBuffer* _commandBuffer, b8 _isSingleU
     _commandBuffer->state = COMMAND_BUFFER_STATE_RECORDING;
 }
 
+void VulkanCommandBufferBeginSecondary(VulkanCommandBuffer* _commandBuffer, VkRenderPass _renderpass, u32 _subpass, VkFramebuffer _framebuffer)
+{
+    VkCommandBufferInheritanceInfo inheritanceInfo = { VK_STRUCTURE_TYPE_COMMAND_BUFFER_INHERITANCE_INFO };
+    inheritanceInfo.renderPass = _renderpass;
+    inheritanceInfo.subpass = _subpass;
+    inheritanceInfo.framebuffer = _framebuffer;
+
+    VkCommandBufferBeginInfo beginInfo = { VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO };
+    beginInfo.flags = VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT | VK_COMMAND_BUFFER_USAGE_RENDER_PASS_CONTINUE_BIT;
+    beginInfo.pInheritanceInfo = &inheritanceInfo;
+
+    VK_CHECK(vkBeginCommandBuffer(_commandBuffer->handle, &beginInfo));
+    _commandBuffer->state = COMMAND_BUFFER_STATE_IN_RENDER_PASS;
+}
+
+void VulkanCommandBufferBeginSecondaryRendering(VulkanCommandBuffer* _commandBuffer, const VulkanRenderpassDesc* _desc)
+{
+    //formats must match the instance begun on the primary, stencil is never attached there
+    VkCommandBufferInheritanceRenderingInfo renderingInfo = { VK_STRUCTURE_TYPE_COMMAND_BUFFER_INHERITANCE_RENDERING_INFO };
+    renderingInfo.colorAttachmentCount = _desc->colorCount;
+    renderingInfo.pColorAttachmentFormats = _desc->colorFormats;
+    renderingInfo.depthAttachmentFormat = _desc->depthFormat;
+    renderingInfo.stencilAttachmentFormat = VK_FORMAT_UNDEFINED;
+    renderingInfo.rasterizationSamples = VK_SAMPLE_COUNT_1_BIT;
+
+    VkCommandBufferInheritanceInfo inheritanceInfo = { VK_STRUCTURE_TYPE_COMMAND_BUFFER_INHERITANCE_INFO };
+    inheritanceInfo.pNext = &renderingInfo;
+
+    VkCommandBufferBeginInfo beginInfo = { VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO };
+    beginInfo.flags = VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT | VK_COMMAND_BUFFER_USAGE_RENDER_PASS_CONTINUE_BIT;
+    beginInfo.pInheritanceInfo = &inheritanceInfo;
+
+    VK_CHECK(vkBeginCommandBuffer(_commandBuffer->handle, &beginInfo));
+    _commandBuffer->state = COMMAND_BUFFER_STATE_IN_RENDER_PASS;
+}
+
 void VulkanCommandBufferEnd(VulkanCommandBuffer* _commandBuffer) 
 {
     VK_CHECK(vkEndCommandBuffer(_commandBuffer->handle));
@@ -19,6 +19,18 @@ void VulkanCommandBufferBegin(
     b8 _isRenderpassContinue,
     b8 _isSimultaneousUse);
 
+//begins a secondary command buffer that continues _renderpass inside _framebuffer, the framebuffer may be 0
+void VulkanCommandBufferBeginSecondary(
+    VulkanCommandBuffer* _commandBuffer,
+    VkRenderPass _renderpass,
+    u32 _subpass,
+    VkFramebuffer _framebuffer);
+
+//begins a secondary command buffer that continues a dynamic rendering instance with the attachments of _desc
+void VulkanCommandBufferBeginSecondaryRendering(
+    VulkanCommandBuffer* _commandBuffer,
+    const VulkanRenderpassDesc* _desc);
+
 void VulkanCommandBufferEnd(VulkanCommandBuffer* _commandBuffer);
 
 void VulkanCommandBufferUpdateSubmitted(VulkanCommandBuffer* _commandBuffer);
@@ -0,0 +1,160 @@
+#include "VulkanCompute.h"
+
+#include "VulkanCommandBuffer.h"
+#include "VulkanStagingRing.h"
+#include "VulkanTimeline.h"
+#include "VulkanUtils.h"
+
+#include "core/Logger.h"
+#include "core/CMemory.h"
+
+#include "containers/DArray.h"
+
+b8 VulkanComputeCreate(VulkanContext* _context, u32 _frameCount, VulkanCompute* _outCompute)
+{
+    cZeroMemory(_outCompute, sizeof(VulkanCompute));
+
+    if(!VulkanTimelineCreate(_context, &_outCompute->timeline))
+        return FALSE;
+
+    _outCompute->commandBuffers = DArrayReserve(VulkanCommandBuffer, _frameCount);
+    _outCompute->frameValues = DArrayReserve(u64, _frameCount);
+    for(u32 i = 0; i < _frameCount; ++i)
+    {
+        cZeroMemory(&_outCompute->commandBuffers[i], sizeof(VulkanCommandBuffer));
+        VulkanCommandBufferAllocate(_context, _context->device.computeCommandPool, TRUE, &_outCompute->commandBuffers[i]);
+        _outCompute->frameValues[i] = 0;
+    }
+    DArrayLengthSet(_outCompute->commandBuffers, _frameCount);
+
+    return TRUE;
+}
+
+void VulkanComputeDestroy(VulkanContext* _context, VulkanCompute* _compute)
+{
+    if(_compute->commandBuffers)
+    {
+        u32 count = DArrayLength(_compute->commandBuffers);
+        for(u32 i = 0; i < count; ++i)
+        {
+            if(_compute->commandBuffers[i].handle)
+                VulkanCommandBufferFree(_context, _context->device.computeCommandPool, &_compute->commandBuffers[i]);
+        }
+
+        DArrayDestroy(_compute->commandBuffers);
+        DArrayDestroy(_compute->frameValues);
+    }
+
+    VulkanTimelineDestroy(_context, &_compute->timeline);
+    cZeroMemory(_compute, sizeof(VulkanCompute));
+}
+
+void VulkanComputeBeginFrame(VulkanContext* _context, VulkanCompute* _compute, u32 _frameIndex)
+{
+    _compute->frame = _frameIndex;
+    _compute->recording = FALSE;
+    _compute->graphicsWaitValue = 0;
+
+    VulkanTimelineWait(_context, &_compute->timeline, _compute->frameValues[_frameIndex], UINT64_MAX);
+}
+
+VulkanCommandBuffer* VulkanComputeGetCommandBuffer(VulkanContext* _context, VulkanCompute* _compute)
+{
+    VulkanCommandBuffer* commandBuffer = &_compute->commandBuffers[_compute->frame];
+    if(_compute->recording)
+        return commandBuffer;
+
+    //a second submit in the same frame reuses the buffer, so wait for the first one
+    VulkanTimelineWait(_context, &_compute->timeline, _compute->frameValues[_compute->frame], UINT64_MAX);
+
+    VK_CHECK(vkResetCommandBuffer(commandBuffer->handle, 0));
+    VulkanCommandBufferReset(commandBuffer);
+    VulkanCommandBufferBegin(commandBuffer, TRUE, FALSE, FALSE);
+    _compute->recording = TRUE;
+    return commandBuffer;
+}
+
+void VulkanComputeReleaseBuffer(
+    VulkanContext* _context,
+    VulkanCompute* _compute,
+    VulkanStagingRing* _ring,
+    VulkanBuffer* _buffer,
+    VkAccessFlags _srcAccess)
+{
+    if(_context->device.computeQueueIndex == _context->device.graphicsQueueIndex)
+        return;
+
+    VkBufferMemoryBarrier barrier = { VK_STRUCTURE_TYPE_BUFFER_MEMORY_BARRIER };
+    barrier.srcQueueFamilyIndex = _context->device.computeQueueIndex;
+    barrier.dstQueueFamilyIndex = _context->device.graphicsQueueIndex;
+    barrier.buffer = _buffer->handle;
+    barrier.offset = 0;
+    barrier.size = VK_WHOLE_SIZE;
+
+    //release, the destination half is ignored on this queue
+    barrier.srcAccessMask = _srcAccess;
+    barrier.dstAccessMask = 0;
+    VulkanCommandBuffer* commandBuffer = VulkanComputeGetCommandBuffer(_context, _compute);
+    vkCmdPipelineBarrier(
+        commandBuffer->handle,
+        VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT,
+        VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT,
+        0,
+        0, 0,
+        1, &barrier,
+        0, 0);
+
+    //acquire, recorded by the ring on the graphics queue, which is opened for this frame if needed
+    barrier.srcAccessMask = 0;
+    barrier.dstAccessMask = VULKAN_STAGING_CONSUMER_ACCESS;
+    VulkanStagingRingGetCommandBuffer(_context, _ring);
+    DArrayPush(_ring->pendingAcquires, barrier);
+}
+
+u64 VulkanComputeSubmit(VulkanContext* _context, VulkanCompute* _compute, u64 _graphicsWaitValue, VkPipelineStageFlags _waitStages)
+{
+    if(!_compute->recording)
+        return 0;
+
+    VulkanCommandBuffer* commandBuffer = &_compute->commandBuffers[_compute->frame];
+    VulkanCommandBufferEnd(commandBuffer);
+
+    uint64_t signalValue = VulkanTimelineNextValue(&_compute->timeline);
+    uint64_t waitValue = _graphicsWaitValue;
+
+    VkTimelineSemaphoreSubmitInfo timelineInfo = { VK_STRUCTURE_TYPE_TIMELINE_SEMAPHORE_SUBMIT_INFO };
+    timelineInfo.signalSemaphoreValueCount = 1;
+    timelineInfo.pSignalSemaphoreValues = &signalValue;
+
+    VkSubmitInfo submitInfo = { VK_STRUCTURE_TYPE_SUBMIT_INFO };
+    submitInfo.pNext = &timelineInfo;
+    submitInfo.commandBufferCount = 1;
+    submitInfo.pCommandBuffers = &commandBuffer->handle;
+    submitInfo.signalSemaphoreCount = 1;
+    submitInfo.pSignalSemaphores = &_compute->timeline.handle;
+
+    //cross queue dependency on graphics work, e.g. a depth buffer rendered by an earlier frame
+    if(_graphicsWaitValue)
+    {
+        timelineInfo.waitSemaphoreValueCount = 1;
+        timelineInfo.pWaitSemaphoreValues = &waitValue;
+        submitInfo.waitSemaphoreCount = 1;
+        submitInfo.pWaitSemaphores = &_context->graphicsTimeline.handle;
+        submitInfo.pWaitDstStageMask = &_waitStages;
+    }
+
+    VkResult result = vkQueueSubmit(_context->device.computeQueue, 1, &submitInfo, 0);
+    if(!VulkanResultIsSuccess(result))
+    {
+        LOG_ERROR("Compute vkQueueSubmit failed with result: %s", VulkanResultString(result, TRUE));
+        _compute->timeline.pendingValue--;
+        _compute->recording = FALSE;
+        return 0;
+    }
+
+    VulkanCommandBufferUpdateSubmitted(commandBuffer);
+    _compute->recording = FALSE;
+    _compute->frameValues[_compute->frame] = signalValue;
+    _compute->graphicsWaitValue = signalValue;
+    return signalValue;
+}
\ No newline at end of file
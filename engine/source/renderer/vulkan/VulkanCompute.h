@@ -0,0 +1,41 @@
+#pragma once
+
+#include "VulkanTypes.inl"
+
+/**
+ * Async compute on the device's compute queue. Work is recorded into one command buffer per frame
+ * in flight and submitted with a timeline semaphore, the graphics submission of the same frame waits
+ * on the last value. Graphics timeline values therefore cover compute work too, which keeps frame
+ * pacing and the deletion queue unaware of the second queue.
+ */
+b8 VulkanComputeCreate(VulkanContext* _context, u32 _frameCount, VulkanCompute* _outCompute);
+
+void VulkanComputeDestroy(VulkanContext* _context, VulkanCompute* _compute);
+
+//waits for the slot's previous compute work, normally already done since graphics waited on it
+void VulkanComputeBeginFrame(VulkanContext* _context, VulkanCompute* _compute, u32 _frameIndex);
+
+//returns the compute command buffer of the current frame, starting it on first use
+VulkanCommandBuffer* VulkanComputeGetCommandBuffer(VulkanContext* _context, VulkanCompute* _compute);
+
+/**
+ * Records the release half of an ownership transfer of _buffer to the graphics family, the acquire
+ * half is handed to _ring and runs on the graphics queue ahead of this frame's commands.
+ * Nothing is recorded when both queues share a family.
+ * @param _srcAccess accesses of the compute work that wrote the buffer.
+ */
+void VulkanComputeReleaseBuffer(
+    VulkanContext* _context,
+    VulkanCompute* _compute,
+    VulkanStagingRing* _ring,
+    VulkanBuffer* _buffer,
+    VkAccessFlags _srcAccess);
+
+/**
+ * Submits the work recorded since the last submit, if any.
+ * @param _graphicsWaitValue graphics timeline value the compute work waits on, 0 for none. Used when
+ * compute reads what an earlier frame rendered.
+ * @param _waitStages compute stages that wait on _graphicsWaitValue.
+ * @returns the compute timeline value signaled by the submission, 0 if nothing was recorded.
+ */
+u64 VulkanComputeSubmit(VulkanContext* _context, VulkanCompute* _compute, u64 _graphicsWaitValue, VkPipelineStageFlags _waitStages);
\ No newline at end of file
@@ -0,0 +1,136 @@
+#include "VulkanDeletionQueue.h"
+#include "VulkanBuffer.h"
+#include "VulkanImage.h"
+#include "VulkanFramebuffer.h"
+#include "VulkanTimeline.h"
+
+#include "core/Logger.h"
+#include "core/CMemory.h"
+
+#include "containers/DArray.h"
+
+void PushDeletion(VulkanContext* _context, VulkanDeletionQueue* _queue, VulkanDeletion* _deletion);
+void DestroyDeletion(VulkanContext* _context, VulkanDeletion* _deletion);
+
+b8 VulkanDeletionQueueCreate(VulkanContext* _context, VulkanDeletionQueue* _outQueue)
+{
+    _outQueue->entries = DArrayReserve(VulkanDeletion, 64);
+    return _outQueue->entries != 0;
+}
+
+void VulkanDeletionQueueDestroy(VulkanContext* _context, VulkanDeletionQueue* _queue)
+{
+    if(!_queue->entries)
+        return;
+
+    u64 count = DArrayLength(_queue->entries);
+    if(count)
+    {
+        LOG_DEBUG("Destroying %llu deferred Vulkan resources.", count);
+    }
+
+    for(u64 i = 0; i < count; ++i)
+        DestroyDeletion(_context, &_queue->entries[i]);
+
+    DArrayDestroy(_queue->entries);
+    _queue->entries = 0;
+}
+
+void VulkanDeletionQueueRetireBuffer(VulkanContext* _context, VulkanDeletionQueue* _queue, VulkanBuffer* _buffer)
+{
+    VulkanDeletion deletion;
+    cZeroMemory(&deletion, sizeof(VulkanDeletion));
+    deletion.type = VULKAN_DELETION_BUFFER;
+    deletion.resource.buffer = *_buffer;
+    PushDeletion(_context, _queue, &deletion);
+    cZeroMemory(_buffer, sizeof(VulkanBuffer));
+}
+
+void VulkanDeletionQueueRetireImage(VulkanContext* _context, VulkanDeletionQueue* _queue, VulkanImage* _image)
+{
+    VulkanDeletion deletion;
+    cZeroMemory(&deletion, sizeof(VulkanDeletion));
+    deletion.type = VULKAN_DELETION_IMAGE;
+    deletion.resource.image = *_image;
+    PushDeletion(_context, _queue, &deletion);
+    cZeroMemory(_image, sizeof(VulkanImage));
+}
+
+void VulkanDeletionQueueRetireImageView(VulkanContext* _context, VulkanDeletionQueue* _queue, VkImageView* _view)
+{
+    VulkanDeletion deletion;
+    cZeroMemory(&deletion, sizeof(VulkanDeletion));
+    deletion.type = VULKAN_DELETION_IMAGE_VIEW;
+    deletion.resource.view = *_view;
+    PushDeletion(_context, _queue, &deletion);
+    *_view = 0;
+}
+
+void VulkanDeletionQueueRetireFramebuffer(VulkanContext* _context, VulkanDeletionQueue* _queue, VulkanFramebuffer* _framebuffer)
+{
+    VulkanDeletion deletion;
+    cZeroMemory(&deletion, sizeof(VulkanDeletion));
+    deletion.type = VULKAN_DELETION_FRAMEBUFFER;
+    deletion.resource.framebuffer = *_framebuffer;
+    PushDeletion(_context, _queue, &deletion);
+    cZeroMemory(_framebuffer, sizeof(VulkanFramebuffer));
+}
+
+void VulkanDeletionQueueRetireSwapchain(VulkanContext* _context, VulkanDeletionQueue* _queue, VkSwapchainKHR* _swapchain)
+{
+    VulkanDeletion deletion;
+    cZeroMemory(&deletion, sizeof(VulkanDeletion));
+    deletion.type = VULKAN_DELETION_SWAPCHAIN;
+    deletion.resource.swapchain = *_swapchain;
+    PushDeletion(_context, _queue, &deletion);
+    *_swapchain = 0;
+}
+
+void VulkanDeletionQueueCollect(VulkanContext* _context, VulkanDeletionQueue* _queue)
+{
+    //retire values never decrease, stop at the first one that was not reached
+    u64 count = DArrayLength(_queue->entries);
+    u64 collected = 0;
+    while(collected < count && VulkanTimelineIsReached(_context, &_context->graphicsTimeline, _queue->entries[collected].retireValue))
+    {
+        DestroyDeletion(_context, &_queue->entries[collected]);
+        ++collected;
+    }
+
+    if(collected == 0)
+        return;
+
+    //move the remaining entries to the front
+    for(u64 i = collected; i < count; ++i)
+        _queue->entries[i - collected] = _queue->entries[i];
+    DArrayLengthSet(_queue->entries, count - collected);
+}
+
+void PushDeletion(VulkanContext* _context, VulkanDeletionQueue* _queue, VulkanDeletion* _deletion)
+{
+    //the frame being recorded signals the next value, anything recorded so far is covered by it
+    _deletion->retireValue = _context->graphicsTimeline.pendingValue + 1;
+    DArrayPush(_queue->entries, *_deletion);
+}
+
+void DestroyDeletion(VulkanContext* _context, VulkanDeletion* _deletion)
+{
+    switch(_deletion->type)
+    {
+        case VULKAN_DELETION_BUFFER:
+            VulkanBufferDestroy(_context, &_deletion->resource.buffer);
+            break;
+        case VULKAN_DELETION_IMAGE:
+            VulkanImageDestroy(_context, &_deletion->resource.image);
+            break;
+        case VULKAN_DELETION_IMAGE_VIEW:
+            vkDestroyImageView(_context->device.logicalDevice, _deletion->resource.view, _context->allocator);
+            break;
+        case VULKAN_DELETION_FRAMEBUFFER:
+            VulkanFramebufferDestroy(_context, &_deletion->resource.framebuffer);
+            break;
+        case VULKAN_DELETION_SWAPCHAIN:
+            vkDestroySwapchainKHR(_context->device.logicalDevice, _deletion->resource.swapchain, _context->allocator);
+            break;
+    }
+}
\ No newline at end of file
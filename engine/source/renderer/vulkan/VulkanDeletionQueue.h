@@ -0,0 +1,28 @@
+#pragma once
+
+#include "VulkanTypes.inl"
+
+/**
+ * Defers the destruction of Vulkan objects until the device is done with them. Retired resources
+ * are tagged with the graphics timeline value of the frame being recorded, so everything submitted
+ * so far and the current frame may still reference them, and are destroyed by
+ * VulkanDeletionQueueCollect once that value was reached. Render thread only.
+ */
+b8 VulkanDeletionQueueCreate(VulkanContext* _context, VulkanDeletionQueue* _outQueue);
+
+//destroys every remaining resource, the device must be idle
+void VulkanDeletionQueueDestroy(VulkanContext* _context, VulkanDeletionQueue* _queue);
+
+//the retire functions take ownership of the resource and zero the caller's copy
+void VulkanDeletionQueueRetireBuffer(VulkanContext* _context, VulkanDeletionQueue* _queue, VulkanBuffer* _buffer);
+
+void VulkanDeletionQueueRetireImage(VulkanContext* _context, VulkanDeletionQueue* _queue, VulkanImage* _image);
+
+void VulkanDeletionQueueRetireImageView(VulkanContext* _context, VulkanDeletionQueue* _queue, VkImageView* _view);
+
+void VulkanDeletionQueueRetireFramebuffer(VulkanContext* _context, VulkanDeletionQueue* _queue, VulkanFramebuffer* _framebuffer);
+
+void VulkanDeletionQueueRetireSwapchain(VulkanContext* _context, VulkanDeletionQueue* _queue, VkSwapchainKHR* _swapchain);
+
+//destroys the resources whose frames completed, in the order they were retired. Called once per frame
+void VulkanDeletionQueueCollect(VulkanContext* _context, VulkanDeletionQueue* _queue);
\ No newline at end of file
@@ -0,0 +1,413 @@
+#include "VulkanDescriptors.h"
+#include "VulkanCommandBuffer.h"
+#include "VulkanImage.h"
+#include "VulkanTimeline.h"
+#include "VulkanUtils.h"
+
+#include "core/Logger.h"
+#include "core/CMemory.h"
+
+#include "containers/DArray.h"
+
+//descriptors of each type per set in a transient pool
+static const VkDescriptorPoolSize descriptorPoolRatios[] = {
+    { VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER, 2 },
+    { VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER_DYNAMIC, 1 },
+    { VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, 2 },
+    { VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER, 4 },
+    { VK_DESCRIPTOR_TYPE_SAMPLED_IMAGE, 2 },
+    { VK_DESCRIPTOR_TYPE_STORAGE_IMAGE, 1 },
+};
+
+#define DESCRIPTOR_POOL_RATIO_COUNT (sizeof(descriptorPoolRatios) / sizeof(descriptorPoolRatios[0]))
+
+VkDescriptorPool DescriptorPoolCreate(VulkanContext* _context);
+b8 BindlessSamplerCreate(VulkanContext* _context, VkFilter _filter, VkSamplerAddressMode _addressMode, VkSampler* _outSampler);
+b8 BindlessDefaultTextureCreate(VulkanContext* _context, VulkanImage* _outImage);
+
+b8 VulkanDescriptorAllocatorCreate(VulkanContext* _context, u32 _frameCount, VulkanDescriptorAllocator* _outAllocator)
+{
+    cZeroMemory(_outAllocator, sizeof(VulkanDescriptorAllocator));
+    _outAllocator->frameCount = _frameCount;
+
+    //one pool per frame up front, most frames never need a second
+    for(u32 i = 0; i < _frameCount; ++i)
+    {
+        _outAllocator->frames[i].pools = DArrayCreate(VkDescriptorPool);
+        VkDescriptorPool pool = DescriptorPoolCreate(_context);
+        if(!pool)
+            return FALSE;
+
+        DArrayPush(_outAllocator->frames[i].pools, pool);
+    }
+
+    return TRUE;
+}
+
+void VulkanDescriptorAllocatorDestroy(VulkanContext* _context, VulkanDescriptorAllocator* _allocator)
+{
+    for(u32 i = 0; i < _allocator->frameCount; ++i)
+    {
+        VulkanDescriptorFramePools* frame = &_allocator->frames[i];
+        if(!frame->pools)
+            continue;
+
+        for(u64 j = 0; j < DArrayLength(frame->pools); ++j)
+            vkDestroyDescriptorPool(_context->device.logicalDevice, frame->pools[j], _context->allocator);
+
+        DArrayDestroy(frame->pools);
+    }
+
+    cZeroMemory(_allocator, sizeof(VulkanDescriptorAllocator));
+}
+
+void VulkanDescriptorAllocatorBeginFrame(VulkanContext* _context, VulkanDescriptorAllocator* _allocator, u32 _frameIndex)
+{
+    _allocator->frameIndex = _frameIndex;
+
+    //pools past current were not touched last time around
+    VulkanDescriptorFramePools* frame = &_allocator->frames[_frameIndex];
+    for(u32 i = 0; i <= frame->current; ++i)
+        vkResetDescriptorPool(_context->device.logicalDevice, frame->pools[i], 0);
+
+    frame->current = 0;
+}
+
+VkDescriptorSet VulkanDescriptorAllocatorAllocate(VulkanContext* _context, VulkanDescriptorAllocator* _allocator, VkDescriptorSetLayout _layout)
+{
+    VulkanDescriptorFramePools* frame = &_allocator->frames[_allocator->frameIndex];
+
+    VkDescriptorSetAllocateInfo allocateInfo = { VK_STRUCTURE_TYPE_DESCRIPTOR_SET_ALLOCATE_INFO };
+    allocateInfo.descriptorSetCount = 1;
+    allocateInfo.pSetLayouts = &_layout;
+
+    //a full pool moves on to the next one, created on first use. Pools past current are empty
+    b8 emptyPool = FALSE;
+    while(TRUE)
+    {
+        allocateInfo.descriptorPool = frame->pools[frame->current];
+
+        VkDescriptorSet set;
+        VkResult result = vkAllocateDescriptorSets(_context->device.logicalDevice, &allocateInfo, &set);
+        if(result == VK_SUCCESS)
+            return set;
+
+        if(result != VK_ERROR_OUT_OF_POOL_MEMORY && result != VK_ERROR_FRAGMENTED_POOL)
+        {
+            LOG_ERROR("Failed to allocate a transient descriptor set: %s", VulkanResultString(result, TRUE));
+            return 0;
+        }
+
+        //a set that does not fit an empty pool never will
+        if(emptyPool)
+        {
+            LOG_ERROR("Transient descriptor set does not fit an empty pool, the layout exceeds the pool ratios.");
+            return 0;
+        }
+
+        if(frame->current + 1 == DArrayLength(frame->pools))
+        {
+            VkDescriptorPool pool = DescriptorPoolCreate(_context);
+            if(!pool)
+                return 0;
+
+            DArrayPush(frame->pools, pool);
+        }
+
+        ++frame->current;
+        emptyPool = TRUE;
+    }
+}
+
+b8 VulkanBindlessTableCreate(VulkanContext* _context, VulkanBindlessTable* _outTable)
+{
+    cZeroMemory(_outTable, sizeof(VulkanBindlessTable));
+    _outTable->freeIndices = DArrayCreate(u32);
+    _outTable->releases = DArrayCreate(VulkanBindlessRelease);
+
+    if(!_context->device.supportsDescriptorIndexing)
+    {
+        LOG_WARN("Descriptor indexing is not supported, the bindless texture table is disabled.");
+        return TRUE;
+    }
+
+    VkDevice device = _context->device.logicalDevice;
+
+    //sized by the sampled image limits alone, the immutable samplers count against the separate sampler limits
+    _outTable->capacity = _context->device.maxBindlessTextures;
+    if(_outTable->capacity > VULKAN_BINDLESS_MAX_TEXTURES)
+        _outTable->capacity = VULKAN_BINDLESS_MAX_TEXTURES;
+
+    if(!BindlessSamplerCreate(_context, VK_FILTER_LINEAR, VK_SAMPLER_ADDRESS_MODE_REPEAT, &_outTable->samplers[VULKAN_BINDLESS_SAMPLER_LINEAR_REPEAT]) ||
+        !BindlessSamplerCreate(_context, VK_FILTER_LINEAR, VK_SAMPLER_ADDRESS_MODE_CLAMP_TO_EDGE, &_outTable->samplers[VULKAN_BINDLESS_SAMPLER_LINEAR_CLAMP]) ||
+        !BindlessSamplerCreate(_context, VK_FILTER_NEAREST, VK_SAMPLER_ADDRESS_MODE_CLAMP_TO_EDGE, &_outTable->samplers[VULKAN_BINDLESS_SAMPLER_NEAREST_CLAMP]))
+        return FALSE;
+
+    VkDescriptorSetLayoutBinding bindings[2] = {};
+    bindings[0].binding = 0;
+    bindings[0].descriptorType = VK_DESCRIPTOR_TYPE_SAMPLED_IMAGE;
+    bindings[0].descriptorCount = _outTable->capacity;
+    bindings[0].stageFlags = VK_SHADER_STAGE_ALL;
+    bindings[1].binding = 1;
+    bindings[1].descriptorType = VK_DESCRIPTOR_TYPE_SAMPLER;
+    bindings[1].descriptorCount = VULKAN_BINDLESS_SAMPLER_COUNT;
+    bindings[1].stageFlags = VK_SHADER_STAGE_ALL;
+    bindings[1].pImmutableSamplers = _outTable->samplers;
+
+    //slots are written while frames reading other slots are in flight, unwritten slots are never read
+    VkDescriptorBindingFlags bindingFlags[2] = {
+        VK_DESCRIPTOR_BINDING_UPDATE_AFTER_BIND_BIT | VK_DESCRIPTOR_BINDING_UPDATE_UNUSED_WHILE_PENDING_BIT | VK_DESCRIPTOR_BINDING_PARTIALLY_BOUND_BIT,
+        0
+    };
+
+    VkDescriptorSetLayoutBindingFlagsCreateInfo flagsInfo = { VK_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_BINDING_FLAGS_CREATE_INFO };
+    flagsInfo.bindingCount = 2;
+    flagsInfo.pBindingFlags = bindingFlags;
+
+    VkDescriptorSetLayoutCreateInfo layoutInfo = { VK_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_CREATE_INFO };
+    layoutInfo.pNext = &flagsInfo;
+    layoutInfo.flags = VK_DESCRIPTOR_SET_LAYOUT_CREATE_UPDATE_AFTER_BIND_POOL_BIT;
+    layoutInfo.bindingCount = 2;
+    layoutInfo.pBindings = bindings;
+    VK_CHECK(vkCreateDescriptorSetLayout(device, &layoutInfo, _context->allocator, &_outTable->setLayout));
+
+    VkDescriptorPoolSize poolSizes[2];
+    poolSizes[0].type = VK_DESCRIPTOR_TYPE_SAMPLED_IMAGE;
+    poolSizes[0].descriptorCount = _outTable->capacity;
+    poolSizes[1].type = VK_DESCRIPTOR_TYPE_SAMPLER;
+    poolSizes[1].descriptorCount = VULKAN_BINDLESS_SAMPLER_COUNT;
+
+    VkDescriptorPoolCreateInfo poolInfo = { VK_STRUCTURE_TYPE_DESCRIPTOR_POOL_CREATE_INFO };
+    poolInfo.flags = VK_DESCRIPTOR_POOL_CREATE_UPDATE_AFTER_BIND_BIT;
+    poolInfo.maxSets = 1;
+    poolInfo.poolSizeCount = 2;
+    poolInfo.pPoolSizes = poolSizes;
+    VK_CHECK(vkCreateDescriptorPool(device, &poolInfo, _context->allocator, &_outTable->pool));
+
+    VkDescriptorSetAllocateInfo allocateInfo = { VK_STRUCTURE_TYPE_DESCRIPTOR_SET_ALLOCATE_INFO };
+    allocateInfo.descriptorPool = _outTable->pool;
+    allocateInfo.descriptorSetCount = 1;
+    allocateInfo.pSetLayouts = &_outTable->setLayout;
+    VK_CHECK(vkAllocateDescriptorSets(device, &allocateInfo, &_outTable->set));
+
+    //the first add of a fresh table always lands in slot 0
+    if(!BindlessDefaultTextureCreate(_context, &_outTable->defaultTexture) ||
+        VulkanBindlessTableAdd(_context, _outTable, _outTable->defaultTexture.view, VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL) != 0)
+        return FALSE;
+
+    LOG_INFO("Bindless texture table holds %u textures.", _outTable->capacity);
+    return TRUE;
+}
+
+void VulkanBindlessTableDestroy(VulkanContext* _context, VulkanBindlessTable* _table)
+{
+    if(!_table->freeIndices)
+        return;
+
+    VkDevice device = _context->device.logicalDevice;
+
+    VulkanImageDestroy(_context, &_table->defaultTexture);
+
+    //the set is freed with the pool
+    if(_table->pool)
+        vkDestroyDescriptorPool(device, _table->pool, _context->allocator);
+    if(_table->setLayout)
+        vkDestroyDescriptorSetLayout(device, _table->setLayout, _context->allocator);
+
+    for(u32 i = 0; i < VULKAN_BINDLESS_SAMPLER_COUNT; ++i)
+    {
+        if(_table->samplers[i])
+            vkDestroySampler(device, _table->samplers[i], _context->allocator);
+    }
+
+    DArrayDestroy(_table->freeIndices);
+    DArrayDestroy(_table->releases);
+    cZeroMemory(_table, sizeof(VulkanBindlessTable));
+}
+
+b8 BindlessDefaultTextureCreate(VulkanContext* _context, VulkanImage* _outImage)
+{
+    //images are created with 4 mip levels, 8x8 is the smallest size that has all of them
+    VulkanImageCreate(
+        _context,
+        VK_IMAGE_TYPE_2D,
+        8, 8,
+        VK_FORMAT_R8G8B8A8_UNORM,
+        VK_IMAGE_TILING_OPTIMAL,
+        VK_IMAGE_USAGE_SAMPLED_BIT | VK_IMAGE_USAGE_TRANSFER_DST_BIT,
+        VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT,
+        TRUE,
+        VK_IMAGE_ASPECT_COLOR_BIT,
+        _outImage);
+
+    if(!_outImage->handle || !_outImage->view)
+    {
+        LOG_ERROR("Failed to create the default bindless texture.");
+        return FALSE;
+    }
+
+    VkImageSubresourceRange range;
+    range.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
+    range.baseMipLevel = 0;
+    range.levelCount = VK_REMAINING_MIP_LEVELS;
+    range.baseArrayLayer = 0;
+    range.layerCount = 1;
+
+    VulkanCommandBuffer commandBuffer;
+    VulkanCommandBufferAllocateAndBeginSingleUse(_context, _context->device.graphicsCommandPool, &commandBuffer);
+
+    VkImageMemoryBarrier barrier = { VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER };
+    barrier.srcAccessMask = 0;
+    barrier.dstAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+    barrier.oldLayout = VK_IMAGE_LAYOUT_UNDEFINED;
+    barrier.newLayout = VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL;
+    barrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+    barrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+    barrier.image = _outImage->handle;
+    barrier.subresourceRange = range;
+    vkCmdPipelineBarrier(
+        commandBuffer.handle,
+        VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT,
+        VK_PIPELINE_STAGE_TRANSFER_BIT,
+        0,
+        0, 0,
+        0, 0,
+        1, &barrier);
+
+    VkClearColorValue white = { { 1.0f, 1.0f, 1.0f, 1.0f } };
+    vkCmdClearColorImage(commandBuffer.handle, _outImage->handle, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, &white, 1, &range);
+
+    barrier.srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+    barrier.dstAccessMask = VK_ACCESS_SHADER_READ_BIT;
+    barrier.oldLayout = VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL;
+    barrier.newLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
+    vkCmdPipelineBarrier(
+        commandBuffer.handle,
+        VK_PIPELINE_STAGE_TRANSFER_BIT,
+        VK_PIPELINE_STAGE_ALL_COMMANDS_BIT,
+        0,
+        0, 0,
+        0, 0,
+        1, &barrier);
+
+    VulkanCommandBufferEndSingleUse(_context, _context->device.graphicsCommandPool, &commandBuffer, _context->device.graphicsQueue);
+    return TRUE;
+}
+
+u32 VulkanBindlessTableAdd(VulkanContext* _context, VulkanBindlessTable* _table, VkImageView _view, VkImageLayout _layout)
+{
+    if(!_table->setLayout)
+        return RENDER_HANDLE_NONE;
+
+    u32 index;
+    if(DArrayLength(_table->freeIndices) > 0)
+        DArrayPop(_table->freeIndices, &index);
+    else if(_table->highWater < _table->capacity)
+        index = _table->highWater++;
+    else
+    {
+        LOG_ERROR("Bindless texture table is full (%u textures).", _table->capacity);
+        return RENDER_HANDLE_NONE;
+    }
+
+    VkDescriptorImageInfo imageInfo;
+    imageInfo.sampler = 0;
+    imageInfo.imageView = _view;
+    imageInfo.imageLayout = _layout;
+
+    //the slot is unused by every pending frame, writing it does not disturb them
+    VkWriteDescriptorSet write = { VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET };
+    write.dstSet = _table->set;
+    write.dstBinding = 0;
+    write.dstArrayElement = index;
+    write.descriptorCount = 1;
+    write.descriptorType = VK_DESCRIPTOR_TYPE_SAMPLED_IMAGE;
+    write.pImageInfo = &imageInfo;
+    vkUpdateDescriptorSets(_context->device.logicalDevice, 1, &write, 0, 0);
+    return index;
+}
+
+void VulkanBindlessTableRemove(VulkanContext* _context, VulkanBindlessTable* _table, u32 _index)
+{
+    if(_index >= _table->highWater)
+        return;
+
+    //same retire value as the deletion queue, the frame being recorded may still read the slot
+    VulkanBindlessRelease release;
+    release.index = _index;
+    release.retireValue = _context->graphicsTimeline.pendingValue + 1;
+    DArrayPush(_table->releases, release);
+}
+
+void VulkanBindlessTableCollect(VulkanContext* _context, VulkanBindlessTable* _table)
+{
+    //retire values never decrease, stop at the first one that was not reached
+    u64 count = DArrayLength(_table->releases);
+    u64 collected = 0;
+    while(collected < count && VulkanTimelineIsReached(_context, &_context->graphicsTimeline, _table->releases[collected].retireValue))
+    {
+        DArrayPush(_table->freeIndices, _table->releases[collected].index);
+        ++collected;
+    }
+
+    if(collected == 0)
+        return;
+
+    for(u64 i = collected; i < count; ++i)
+        _table->releases[i - collected] = _table->releases[i];
+    DArrayLengthSet(_table->releases, count - collected);
+}
+
+VkDescriptorPool DescriptorPoolCreate(VulkanContext* _context)
+{
+    VkDescriptorPoolSize poolSizes[DESCRIPTOR_POOL_RATIO_COUNT];
+    for(u32 i = 0; i < DESCRIPTOR_POOL_RATIO_COUNT; ++i)
+    {
+        poolSizes[i].type = descriptorPoolRatios[i].type;
+        poolSizes[i].descriptorCount = descriptorPoolRatios[i].descriptorCount * VULKAN_DESCRIPTOR_POOL_SETS;
+    }
+
+    //no free flag, sets only go away when the whole pool is reset
+    VkDescriptorPoolCreateInfo poolInfo = { VK_STRUCTURE_TYPE_DESCRIPTOR_POOL_CREATE_INFO };
+    poolInfo.maxSets = VULKAN_DESCRIPTOR_POOL_SETS;
+    poolInfo.poolSizeCount = DESCRIPTOR_POOL_RATIO_COUNT;
+    poolInfo.pPoolSizes = poolSizes;
+
+    VkDescriptorPool pool;
+    VkResult result = vkCreateDescriptorPool(_context->device.logicalDevice, &poolInfo, _context->allocator, &pool);
+    if(result != VK_SUCCESS)
+    {
+        LOG_ERROR("Failed to create a transient descriptor pool: %s", VulkanResultString(result, TRUE));
+        return 0;
+    }
+
+    return pool;
+}
+
+b8 BindlessSamplerCreate(VulkanContext* _context, VkFilter _filter, VkSamplerAddressMode _addressMode, VkSampler* _outSampler)
+{
+    VkSamplerCreateInfo createInfo = { VK_STRUCTURE_TYPE_SAMPLER_CREATE_INFO };
+    createInfo.magFilter = _filter;
+    createInfo.minFilter = _filter;
+    createInfo.mipmapMode = _filter == VK_FILTER_LINEAR ? VK_SAMPLER_MIPMAP_MODE_LINEAR : VK_SAMPLER_MIPMAP_MODE_NEAREST;
+    createInfo.addressModeU = _addressMode;
+    createInfo.addressModeV = _addressMode;
+    createInfo.addressModeW = _addressMode;
+    createInfo.maxLod = VK_LOD_CLAMP_NONE;
+    createInfo.borderColor = VK_BORDER_COLOR_INT_OPAQUE_BLACK;
+
+    //the device feature was requested whenever it is available
+    if(_filter == VK_FILTER_LINEAR && _context->device.features.samplerAnisotropy)
+    {
+        createInfo.anisotropyEnable = VK_TRUE;
+        createInfo.maxAnisotropy = _context->device.properties.limits.maxSamplerAnisotropy;
+    }
+
+    if(vkCreateSampler(_context->device.logicalDevice, &createInfo, _context->allocator, _outSampler) != VK_SUCCESS)
+    {
+        LOG_ERROR("Failed to create a bindless sampler.");
+        return FALSE;
+    }
+
+    return TRUE;
+}
\ No newline at end of file
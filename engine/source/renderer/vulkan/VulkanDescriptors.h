@@ -0,0 +1,42 @@
+#pragma once
+
+#include "VulkanTypes.inl"
+
+/**
+ * Transient descriptor sets. Each frame in flight owns a list of pools that are reset as a whole in
+ * VulkanDescriptorAllocatorBeginFrame, once the frame's previous work completed, so sets are
+ * allocated without ever being freed and only live until the frame is reused. A new pool is
+ * created when the current ones run out and kept for later frames. Render thread only.
+ */
+b8 VulkanDescriptorAllocatorCreate(VulkanContext* _context, u32 _frameCount, VulkanDescriptorAllocator* _outAllocator);
+
+void VulkanDescriptorAllocatorDestroy(VulkanContext* _context, VulkanDescriptorAllocator* _allocator);
+
+//resets the pools of _frameIndex, the frame's previous submission must have completed
+void VulkanDescriptorAllocatorBeginFrame(VulkanContext* _context, VulkanDescriptorAllocator* _allocator, u32 _frameIndex);
+
+//allocates a set valid until the current frame in flight comes around again, 0 on failure
+VkDescriptorSet VulkanDescriptorAllocatorAllocate(VulkanContext* _context, VulkanDescriptorAllocator* _allocator, VkDescriptorSetLayout _layout);
+
+/**
+ * Persistent table of sampled images, one descriptor set bound once per recorded command buffer of a
+ * pass in which materials reference textures by index. Binding 0 is a partially bound array of
+ * VulkanBindlessTable.capacity sampled images with a white default texture in slot 0, binding 1 holds
+ * the VulkanBindlessSampler samplers. Slots are written with update
+ * after bind, so adding a texture never touches command buffers already recorded, and removed slots
+ * are reused only after every frame that could read them completed.
+ * Shaders declare the table as a runtime sized array, the shader library then uses setLayout for
+ * that set. Without descriptor indexing the table stays empty and setLayout is 0.
+ */
+b8 VulkanBindlessTableCreate(VulkanContext* _context, VulkanBindlessTable* _outTable);
+
+void VulkanBindlessTableDestroy(VulkanContext* _context, VulkanBindlessTable* _table);
+
+//writes _view into a free slot, RENDER_HANDLE_NONE when the table is full or unsupported
+u32 VulkanBindlessTableAdd(VulkanContext* _context, VulkanBindlessTable* _table, VkImageView _view, VkImageLayout _layout);
+
+//the view must stay alive until the frames recorded so far completed, retire it through the deletion queue
+void VulkanBindlessTableRemove(VulkanContext* _context, VulkanBindlessTable* _table, u32 _index);
+
+//returns the slots of completed frames for reuse. Called once per frame
+void VulkanBindlessTableCollect(VulkanContext* _context, VulkanBindlessTable* _table);
\ No newline at end of file
@@ -13,7 +13,6 @@ typedef struct VulkanPhysicalDeviceRequirements
     //darray
     const char** deviceExtensionNames;
     b8 samplerAnisotropy;
-    b8 discreteGPU;
 } VulkanPhysicalDeviceRequirements;
 
 typedef struct VulkanPhysicalDeviceQueueFamilyInfo
@@ -24,7 +23,14 @@ typedef struct VulkanPhysicalDeviceQueueFamilyInfo
     u32 transferFamilyIndex;
 } VulkanPhysicalDeviceQueueFamilyInfo;
 
-b8 SelectPhysicalDevice(VulkanContext* _context);
+b8 SelectPhysicalDevice(VulkanContext* _context, const char* _deviceName, u32 _deviceIndex);
+u64 PhysicalDeviceScore(
+    const VkPhysicalDeviceProperties* _props,
+    const VkPhysicalDeviceFeatures* _features,
+    const VkPhysicalDeviceMemoryProperties* _memory,
+    const VulkanPhysicalDeviceQueueFamilyInfo* _queueInfo);
+void FreeSwapchainSupport(VulkanSwapchainSupportInfo* _supportInfo);
+b8 DeviceExtensionAvailable(VkPhysicalDevice _device, const char* _name);
 b8 PhysicalDeviceMeetsRequirements(
     VkPhysicalDevice _device,
     VkSurfaceKHR _surface,
@@ -34,31 +40,30 @@ b8 PhysicalDeviceMeetsRequirements(
     VulkanPhysicalDeviceQueueFamilyInfo* _outQueueInfo,
     VulkanSwapchainSupportInfo* _outSwapchainSupport);
 
-b8 VulkanDeviceCreate(VulkanContext* _context)
+b8 VulkanDeviceCreate(VulkanContext* _context, const char* _deviceName, u32 _deviceIndex)
 {
-    if(!SelectPhysicalDevice(_context))
+    if(!SelectPhysicalDevice(_context, _deviceName, _deviceIndex))
         return FALSE;
 
     LOG_INFO("Creating logical device...");
 
     //NOTE: Do not create additional queues for shared indices.
-    b8 presentSharesGraphicsQueue = _context->device.graphicsQueueIndex == _context->device.presentQueueIndex;
-    b8 transferSharesGraphicsQueue = _context->device.graphicsQueueIndex == _context->device.transferQueueIndex;
-    u32 indexCount = 1;
-    if(!presentSharesGraphicsQueue)
-        indexCount++;
-
-    if(!transferSharesGraphicsQueue)
-        indexCount++;
-    
-    u32 indices[indexCount];
-    u8 index = 0;
-    indices[index++] = _context->device.graphicsQueueIndex;
-    if(!presentSharesGraphicsQueue)
-        indices[index++] = _context->device.presentQueueIndex;
-    
-    if(!transferSharesGraphicsQueue)
-        indices[index++] = _context->device.transferQueueIndex;
+    i32 familyIndices[4] = {
+        _context->device.graphicsQueueIndex,
+        _context->device.presentQueueIndex,
+        _context->device.transferQueueIndex,
+        _context->device.computeQueueIndex };
+    u32 indices[4];
+    u32 indexCount = 0;
+    for(u32 i = 0; i < 4; ++i)
+    {
+        b8 shared = FALSE;
+        for(u32 j = 0; j < indexCount; ++j)
+            shared |= indices[j] == (u32)familyIndices[i];
+
+        if(!shared)
+            indices[indexCount++] = familyIndices[i];
+    }
 
     VkDeviceQueueCreateInfo queueCreateInfos[indexCount];
     for (u32 i = 0; i < indexCount; ++i) 
@@ -80,15 +85,100 @@ b8 VulkanDeviceCreate(VulkanContext* _context)
     //request device features
     //TODO: this should be config driven
     VkPhysicalDeviceFeatures deviceFeatures = {};
-    deviceFeatures.samplerAnisotropy = VK_TRUE; //request anistrophy
+    deviceFeatures.samplerAnisotropy = _context->device.features.samplerAnisotropy; //request anistrophy, CPU implementations may lack it
+
+    //timeline semaphores track async uploads, core since 1.2
+    VkPhysicalDeviceVulkan12Features features12 = { VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_VULKAN_1_2_FEATURES };
+    features12.timelineSemaphore = VK_TRUE;
+
+    //the bindless texture table indexes sampled images freely and writes new slots while frames are in
+    //flight. Optional, materials fall back to per-draw sets without it
+    _context->device.supportsDescriptorIndexing = FALSE;
+    _context->device.maxBindlessTextures = 0;
+    {
+        VkPhysicalDeviceVulkan12Features supported12 = { VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_VULKAN_1_2_FEATURES };
+        VkPhysicalDeviceFeatures2 features2 = { VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_FEATURES_2 };
+        features2.pNext = &supported12;
+        vkGetPhysicalDeviceFeatures2(_context->device.physicalDevice, &features2);
+
+        if(supported12.runtimeDescriptorArray && supported12.descriptorBindingPartiallyBound &&
+            supported12.descriptorBindingSampledImageUpdateAfterBind && supported12.descriptorBindingUpdateUnusedWhilePending &&
+            supported12.shaderSampledImageArrayNonUniformIndexing)
+        {
+            features12.runtimeDescriptorArray = VK_TRUE;
+            features12.descriptorBindingPartiallyBound = VK_TRUE;
+            features12.descriptorBindingSampledImageUpdateAfterBind = VK_TRUE;
+            features12.descriptorBindingUpdateUnusedWhilePending = VK_TRUE;
+            features12.shaderSampledImageArrayNonUniformIndexing = VK_TRUE;
+
+            VkPhysicalDeviceDescriptorIndexingProperties indexingProperties = { VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_DESCRIPTOR_INDEXING_PROPERTIES };
+            VkPhysicalDeviceProperties2 properties2 = { VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_PROPERTIES_2 };
+            properties2.pNext = &indexingProperties;
+            vkGetPhysicalDeviceProperties2(_context->device.physicalDevice, &properties2);
+
+            u32 perStage = indexingProperties.maxPerStageDescriptorUpdateAfterBindSampledImages;
+            u32 perSet = indexingProperties.maxDescriptorSetUpdateAfterBindSampledImages;
+            _context->device.maxBindlessTextures = perStage < perSet ? perStage : perSet;
+            _context->device.supportsDescriptorIndexing = TRUE;
+        }
+    }
+
+    //render passes without render pass and framebuffer objects, core since 1.3. Enabled whenever
+    //available, the backend decides whether to use it
+    VkPhysicalDeviceVulkan13Features features13 = { VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_VULKAN_1_3_FEATURES };
+    _context->device.supportsDynamicRendering = FALSE;
+    if(_context->device.properties.apiVersion >= VK_API_VERSION_1_3)
+    {
+        VkPhysicalDeviceFeatures2 features2 = { VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_FEATURES_2 };
+        features2.pNext = &features13;
+        vkGetPhysicalDeviceFeatures2(_context->device.physicalDevice, &features2);
+
+        if(features13.dynamicRendering)
+        {
+            cZeroMemory(&features13, sizeof(VkPhysicalDeviceVulkan13Features));
+            features13.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_VULKAN_1_3_FEATURES;
+            features13.dynamicRendering = VK_TRUE;
+            features12.pNext = &features13;
+            _context->device.supportsDynamicRendering = TRUE;
+        }
+    }
+
+    //headless devices are not required to support the swapchain
+    const char* extensionNames[3];
+    u32 extensionCount = 0;
+    if(_context->surface)
+        extensionNames[extensionCount++] = VK_KHR_SWAPCHAIN_EXTENSION_NAME;
+
+    //optional, lets the low latency mode wait for frames to reach the display
+    VkPhysicalDevicePresentIdFeaturesKHR presentIdFeatures = { VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_PRESENT_ID_FEATURES_KHR };
+    VkPhysicalDevicePresentWaitFeaturesKHR presentWaitFeatures = { VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_PRESENT_WAIT_FEATURES_KHR };
+    _context->device.supportsPresentWait = FALSE;
+    if(_context->surface &&
+        DeviceExtensionAvailable(_context->device.physicalDevice, VK_KHR_PRESENT_ID_EXTENSION_NAME) &&
+        DeviceExtensionAvailable(_context->device.physicalDevice, VK_KHR_PRESENT_WAIT_EXTENSION_NAME))
+    {
+        presentIdFeatures.pNext = &presentWaitFeatures;
+        VkPhysicalDeviceFeatures2 features2 = { VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_FEATURES_2 };
+        features2.pNext = &presentIdFeatures;
+        vkGetPhysicalDeviceFeatures2(_context->device.physicalDevice, &features2);
+
+        if(presentIdFeatures.presentId && presentWaitFeatures.presentWait)
+        {
+            extensionNames[extensionCount++] = VK_KHR_PRESENT_ID_EXTENSION_NAME;
+            extensionNames[extensionCount++] = VK_KHR_PRESENT_WAIT_EXTENSION_NAME;
+            presentWaitFeatures.pNext = features12.pNext;
+            features12.pNext = &presentIdFeatures;
+            _context->device.supportsPresentWait = TRUE;
+        }
+    }
 
     VkDeviceCreateInfo deviceCreateInfo = { VK_STRUCTURE_TYPE_DEVICE_CREATE_INFO };
+    deviceCreateInfo.pNext = &features12;
     deviceCreateInfo.queueCreateInfoCount = indexCount;
     deviceCreateInfo.pQueueCreateInfos = queueCreateInfos;
     deviceCreateInfo.pEnabledFeatures = &deviceFeatures;
-    deviceCreateInfo.enabledExtensionCount = 1;
-    const char* extensionNames = VK_KHR_SWAPCHAIN_EXTENSION_NAME;
-    deviceCreateInfo.ppEnabledExtensionNames = &extensionNames;
+    deviceCreateInfo.enabledExtensionCount = extensionCount;
+    deviceCreateInfo.ppEnabledExtensionNames = extensionNames;
 
     //deprecated and ignored so pass nothing
     deviceCreateInfo.enabledLayerCount = 0;
@@ -103,6 +193,14 @@ b8 VulkanDeviceCreate(VulkanContext* _context)
 
     LOG_INFO("Logical device created.");
 
+    _context->device.waitForPresent = 0;
+    if(_context->device.supportsPresentWait)
+    {
+        _context->device.waitForPresent = (PFN_vkWaitForPresentKHR)vkGetDeviceProcAddr(_context->device.logicalDevice, "vkWaitForPresentKHR");
+        _context->device.supportsPresentWait = _context->device.waitForPresent != 0;
+        LOG_INFO("Present wait supported.");
+    }
+
     //get queues
     LOG_INFO("Getting queues...");
     vkGetDeviceQueue(
@@ -122,7 +220,17 @@ b8 VulkanDeviceCreate(VulkanContext* _context)
         _context->device.transferQueueIndex,
         0,
         &_context->device.transferQueue);
+
+    vkGetDeviceQueue(
+        _context->device.logicalDevice,
+        _context->device.computeQueueIndex,
+        0,
+        &_context->device.computeQueue);
     LOG_INFO("Queues obtained.");
+    if(_context->device.computeQueueIndex != _context->device.graphicsQueueIndex)
+    {
+        LOG_INFO("Async compute uses queue family %i.", _context->device.computeQueueIndex);
+    }
 
     //create command pool for graphics queue
     VkCommandPoolCreateInfo poolCreateInfo = { VK_STRUCTURE_TYPE_COMMAND_POOL_CREATE_INFO };
@@ -132,6 +240,16 @@ b8 VulkanDeviceCreate(VulkanContext* _context)
     VK_CHECK(vkCreateCommandPool(_context->device.logicalDevice, &poolCreateInfo, _context->allocator, &_context->device.graphicsCommandPool));
     LOG_INFO("Graphics command pool created.");
 
+    //create command pool for transfer queue
+    poolCreateInfo.queueFamilyIndex = _context->device.transferQueueIndex;
+    VK_CHECK(vkCreateCommandPool(_context->device.logicalDevice, &poolCreateInfo, _context->allocator, &_context->device.transferCommandPool));
+    LOG_INFO("Transfer command pool created.");
+
+    //create command pool for compute queue
+    poolCreateInfo.queueFamilyIndex = _context->device.computeQueueIndex;
+    VK_CHECK(vkCreateCommandPool(_context->device.logicalDevice, &poolCreateInfo, _context->allocator, &_context->device.computeCommandPool));
+    LOG_INFO("Compute command pool created.");
+
     return TRUE;
 }
 
@@ -141,9 +259,12 @@ void VulkanDeviceDestroy(VulkanContext* _context)
     _context->device.graphicsQueue = 0;
     _context->device.presentQueue = 0;
     _context->device.transferQueue = 0;
+    _context->device.computeQueue = 0;
 
     LOG_INFO("Destroying command pools...");
     vkDestroyCommandPool(_context->device.logicalDevice, _context->device.graphicsCommandPool, _context->allocator);
+    vkDestroyCommandPool(_context->device.logicalDevice, _context->device.transferCommandPool, _context->allocator);
+    vkDestroyCommandPool(_context->device.logicalDevice, _context->device.computeCommandPool, _context->allocator);
 
     //destroy logical device
     LOG_INFO("Destroying logical device...");
@@ -160,21 +281,23 @@ void VulkanDeviceDestroy(VulkanContext* _context)
     if(_context->device.swapchainSupport.formats)
     {
         cFree(_context->device.swapchainSupport.formats,
-        sizeof(VkSurfaceFormatKHR) * _context->device.swapchainSupport.formatCount,
+        sizeof(VkSurfaceFormatKHR) * _context->device.swapchainSupport.formatCapacity,
         MEMORY_TAG_RENDERER);
 
         _context->device.swapchainSupport.formats = 0;
         _context->device.swapchainSupport.formatCount = 0;
+        _context->device.swapchainSupport.formatCapacity = 0;
     }
 
     if(_context->device.swapchainSupport.presentModes)
     {
         cFree(_context->device.swapchainSupport.presentModes,
-        sizeof(VkPresentModeKHR) * _context->device.swapchainSupport.presentModeCount,
+        sizeof(VkPresentModeKHR) * _context->device.swapchainSupport.presentModeCapacity,
         MEMORY_TAG_RENDERER);
 
         _context->device.swapchainSupport.presentModes = 0;
         _context->device.swapchainSupport.presentModeCount = 0;
+        _context->device.swapchainSupport.presentModeCapacity = 0;
     }
 
     cZeroMemory(&_context->device.swapchainSupport.capabilities, sizeof(_context->device.swapchainSupport.capabilities));
@@ -182,6 +305,7 @@ void VulkanDeviceDestroy(VulkanContext* _context)
     _context->device.graphicsQueueIndex = -1;
     _context->device.presentQueueIndex = -1;
     _context->device.transferQueueIndex = -1;
+    _context->device.computeQueueIndex = -1;
 }
 
 void VulkanDeviceQuerySwapchainSupport(
@@ -196,8 +320,15 @@ void VulkanDeviceQuerySwapchainSupport(
     VK_CHECK(vkGetPhysicalDeviceSurfaceFormatsKHR(_physicalDevice, _surface, &_outSupportInfo->formatCount, 0));
     if(_outSupportInfo->formatCount != 0)
     {
-        if(!_outSupportInfo->formats)
-            _outSupportInfo->formats = cAllocate(sizeof(VkSurfaceFormatKHR) * _outSupportInfo->formatCount, MEMORY_TAG_RENDERER);
+        //the count can change between queries, e.g. when the window moves to another monitor
+        if(_outSupportInfo->formatCount > _outSupportInfo->formatCapacity)
+        {
+            if(_outSupportInfo->formats)
+                cFree(_outSupportInfo->formats, sizeof(VkSurfaceFormatKHR) * _outSupportInfo->formatCapacity, MEMORY_TAG_RENDERER);
+
+            _outSupportInfo->formatCapacity = _outSupportInfo->formatCount;
+            _outSupportInfo->formats = cAllocate(sizeof(VkSurfaceFormatKHR) * _outSupportInfo->formatCapacity, MEMORY_TAG_RENDERER);
+        }
 
         VK_CHECK(vkGetPhysicalDeviceSurfaceFormatsKHR(_physicalDevice, _surface, &_outSupportInfo->formatCount, _outSupportInfo->formats));
     }
@@ -206,8 +337,14 @@ void VulkanDeviceQuerySwapchainSupport(
     VK_CHECK(vkGetPhysicalDeviceSurfacePresentModesKHR(_physicalDevice, _surface, &_outSupportInfo->presentModeCount, 0));
     if(_outSupportInfo->presentModeCount != 0)
     {
-        if(!_outSupportInfo->presentModes)
-            _outSupportInfo->presentModes = cAllocate(sizeof(VkPresentModeKHR) * _outSupportInfo->presentModeCount, MEMORY_TAG_RENDERER);
+        if(_outSupportInfo->presentModeCount > _outSupportInfo->presentModeCapacity)
+        {
+            if(_outSupportInfo->presentModes)
+                cFree(_outSupportInfo->presentModes, sizeof(VkPresentModeKHR) * _outSupportInfo->presentModeCapacity, MEMORY_TAG_RENDERER);
+
+            _outSupportInfo->presentModeCapacity = _outSupportInfo->presentModeCount;
+            _outSupportInfo->presentModes = cAllocate(sizeof(VkPresentModeKHR) * _outSupportInfo->presentModeCapacity, MEMORY_TAG_RENDERER);
+        }
 
         VK_CHECK(vkGetPhysicalDeviceSurfacePresentModesKHR(_physicalDevice, _surface, &_outSupportInfo->presentModeCount, _outSupportInfo->presentModes));
     }
@@ -240,7 +377,7 @@ b8 VulkanDeviceDetectDepthFormat(VulkanDevice* _device)
     return FALSE;
 }
 
-b8 SelectPhysicalDevice(VulkanContext* _context)
+b8 SelectPhysicalDevice(VulkanContext* _context, const char* _deviceName, u32 _deviceIndex)
 {
     u32 physicalDeviceCount = 0;
     VK_CHECK(vkEnumeratePhysicalDevices(_context->instance, &physicalDeviceCount, 0));
@@ -252,117 +389,224 @@ b8 SelectPhysicalDevice(VulkanContext* _context)
 
     VkPhysicalDevice physicalDevices[physicalDeviceCount];
     VK_CHECK(vkEnumeratePhysicalDevices(_context->instance, &physicalDeviceCount, physicalDevices));
+
+    //anything not required here is scored instead, so integrated and CPU devices remain candidates.
+    //present and swapchain support are only required with a surface, headless configurations have none
+    b8 headless = _context->surface == 0;
+    VulkanPhysicalDeviceRequirements requirements = {};
+    requirements.graphics = TRUE;
+    requirements.present = !headless;
+    requirements.transfer = TRUE;
+    requirements.compute = TRUE;
+    requirements.deviceExtensionNames = DArrayCreate(const char*);
+    if(!headless)
+        DArrayPush(requirements.deviceExtensionNames, &VK_KHR_SWAPCHAIN_EXTENSION_NAME);
+
+    i32 selected = -1;
+    u64 selectedScore = 0;
+    b8 selectedOverride = FALSE;
+    VkPhysicalDeviceProperties properties;
+    VkPhysicalDeviceFeatures features;
+    VkPhysicalDeviceMemoryProperties memory;
+    VulkanPhysicalDeviceQueueFamilyInfo queueInfo = {};
+
     for(u32 i = 0; i < physicalDeviceCount; ++i)
     {
-        VkPhysicalDeviceProperties properties;
-        vkGetPhysicalDeviceProperties(physicalDevices[i], &properties);
-
-        VkPhysicalDeviceFeatures features;
-        vkGetPhysicalDeviceFeatures(physicalDevices[i], &features);
-
-        VkPhysicalDeviceMemoryProperties memory;
-        vkGetPhysicalDeviceMemoryProperties(physicalDevices[i], &memory);
-
-        //TODO: requirements should be driven by engine configuration
-        VulkanPhysicalDeviceRequirements requirements = {};
-        requirements.graphics = TRUE;
-        requirements.present = TRUE;
-        requirements.transfer = TRUE;
-        //NOTE: enable this is compute will be required
-        //requirements.compute = TRUE;
-        requirements.samplerAnisotropy = TRUE;
-        requirements.discreteGPU = TRUE;
-        requirements.deviceExtensionNames = DArrayCreate(const char*);
-        DArrayPush(requirements.deviceExtensionNames, &VK_KHR_SWAPCHAIN_EXTENSION_NAME);
+        VkPhysicalDeviceProperties candidateProperties;
+        vkGetPhysicalDeviceProperties(physicalDevices[i], &candidateProperties);
+
+        VkPhysicalDeviceFeatures candidateFeatures;
+        vkGetPhysicalDeviceFeatures(physicalDevices[i], &candidateFeatures);
 
-        VulkanPhysicalDeviceQueueFamilyInfo queueInfo = {};
+        VkPhysicalDeviceMemoryProperties candidateMemory;
+        vkGetPhysicalDeviceMemoryProperties(physicalDevices[i], &candidateMemory);
+
+        //swapchain support is queried again for the selected device only
+        VulkanPhysicalDeviceQueueFamilyInfo candidateQueueInfo = {};
+        VulkanSwapchainSupportInfo candidateSwapchainSupport = {};
         b8 result = PhysicalDeviceMeetsRequirements(
             physicalDevices[i],
             _context->surface,
-            &properties,
-            &features,
+            &candidateProperties,
+            &candidateFeatures,
             &requirements,
-            &queueInfo,
-            &_context->device.swapchainSupport);
+            &candidateQueueInfo,
+            &candidateSwapchainSupport);
+        FreeSwapchainSupport(&candidateSwapchainSupport);
+
+        if(!result)
+            continue;
+
+        u64 score = PhysicalDeviceScore(&candidateProperties, &candidateFeatures, &candidateMemory, &candidateQueueInfo);
+        LOG_INFO("Device %u '%s' scored %llu.", i + 1, candidateProperties.deviceName, score);
+
+        //an override wins over any score, the first matching device is kept
+        b8 isOverride = (_deviceIndex != 0 && _deviceIndex == i + 1) ||
+            (_deviceName && StringContains(candidateProperties.deviceName, _deviceName));
+        if(selectedOverride || (!isOverride && selected != -1 && score <= selectedScore))
+            continue;
+
+        selected = i;
+        selectedScore = score;
+        selectedOverride = isOverride;
+        properties = candidateProperties;
+        features = candidateFeatures;
+        memory = candidateMemory;
+        queueInfo = candidateQueueInfo;
+    }
 
-        if(result)
-        {
-            LOG_INFO("Selected device: '%s'.", properties.deviceName);
-            // GPU type, etc.
-            switch (properties.deviceType) 
-            {
-                default:
-                case VK_PHYSICAL_DEVICE_TYPE_OTHER:
-                    LOG_INFO("GPU type is Unknown.");
-                    break;
-                case VK_PHYSICAL_DEVICE_TYPE_INTEGRATED_GPU:
-                    LOG_INFO("GPU type is Integrated.");
-                    break;
-                case VK_PHYSICAL_DEVICE_TYPE_DISCRETE_GPU:
-                    LOG_INFO("GPU type is Discrete.");
-                    break;
-                case VK_PHYSICAL_DEVICE_TYPE_VIRTUAL_GPU:
-                    LOG_INFO("GPU type is Virtual.");
-                    break;
-                case VK_PHYSICAL_DEVICE_TYPE_CPU:
-                    LOG_INFO("GPU type is CPU.");
-                    break;
-            }
+    DArrayDestroy(requirements.deviceExtensionNames);
 
-            //driver info
-            LOG_INFO(
-                "GPU Driver version: %d.%d.%d",
-                VK_VERSION_MAJOR(properties.driverVersion),
-                VK_VERSION_MINOR(properties.driverVersion),
-                VK_VERSION_PATCH(properties.driverVersion));
-
-            //vulkan API version
-            LOG_INFO(
-                "Vulkan API version: %d.%d.%d",
-                VK_VERSION_MAJOR(properties.apiVersion),
-                VK_VERSION_MINOR(properties.apiVersion),
-                VK_VERSION_PATCH(properties.apiVersion));
-
-            //memory information
-            for(u32 j = 0; j < memory.memoryHeapCount; ++j)
-            {
-                f32 memorySizeGiB = (((f32)memory.memoryHeaps[j].size) / 1024.0f / 1024.0f / 1024.0f);
-                if(memory.memoryHeaps[j].flags & VK_MEMORY_HEAP_DEVICE_LOCAL_BIT)
-                {
-                    LOG_INFO("Local GPU memory: %.2f GiB", memorySizeGiB);
-                }
-                else
-                {
-                    LOG_INFO("Shared System memory: %.2f GiB", memorySizeGiB);
-                }
-            }
-
-            _context->device.physicalDevice = physicalDevices[i];
-            _context->device.graphicsQueueIndex = queueInfo.graphicsFamilyIndex;
-            _context->device.presentQueueIndex = queueInfo.presentFamilyIndex;
-            _context->device.transferQueueIndex = queueInfo.transferFamilyIndex;
-            //NOTE: set compute index here if needed.
+    //ensure a device was selected
+    if(selected == -1)
+    {
+        LOG_ERROR("No physical devices were found which meet the requirements.");
+        return FALSE;
+    }
 
-            //keep a copy of properties, features and memory for later use
-            _context->device.properties = properties;
-            _context->device.features = features;
-            _context->device.memory = memory;
+    if((_deviceName || _deviceIndex != 0) && !selectedOverride)
+    {
+        LOG_WARN("No suitable device matches the requested override, selecting by score.");
+    }
 
+    LOG_INFO("Selected device: '%s'.", properties.deviceName);
+    // GPU type, etc.
+    switch (properties.deviceType) 
+    {
+        default:
+        case VK_PHYSICAL_DEVICE_TYPE_OTHER:
+            LOG_INFO("GPU type is Unknown.");
+            break;
+        case VK_PHYSICAL_DEVICE_TYPE_INTEGRATED_GPU:
+            LOG_INFO("GPU type is Integrated.");
+            break;
+        case VK_PHYSICAL_DEVICE_TYPE_DISCRETE_GPU:
+            LOG_INFO("GPU type is Discrete.");
+            break;
+        case VK_PHYSICAL_DEVICE_TYPE_VIRTUAL_GPU:
+            LOG_INFO("GPU type is Virtual.");
+            break;
+        case VK_PHYSICAL_DEVICE_TYPE_CPU:
+            LOG_INFO("GPU type is CPU.");
             break;
-        }
     }
 
-    //ensure a device was selected
-    if(!_context->device.physicalDevice)
+    //driver info
+    LOG_INFO(
+        "GPU Driver version: %d.%d.%d",
+        VK_VERSION_MAJOR(properties.driverVersion),
+        VK_VERSION_MINOR(properties.driverVersion),
+        VK_VERSION_PATCH(properties.driverVersion));
+
+    //vulkan API version
+    LOG_INFO(
+        "Vulkan API version: %d.%d.%d",
+        VK_VERSION_MAJOR(properties.apiVersion),
+        VK_VERSION_MINOR(properties.apiVersion),
+        VK_VERSION_PATCH(properties.apiVersion));
+
+    //memory information
+    for(u32 j = 0; j < memory.memoryHeapCount; ++j)
     {
-        LOG_ERROR("No physical devices were found which meet the requirements.");
-        return FALSE;
+        f32 memorySizeGiB = (((f32)memory.memoryHeaps[j].size) / 1024.0f / 1024.0f / 1024.0f);
+        if(memory.memoryHeaps[j].flags & VK_MEMORY_HEAP_DEVICE_LOCAL_BIT)
+        {
+            LOG_INFO("Local GPU memory: %.2f GiB", memorySizeGiB);
+        }
+        else
+        {
+            LOG_INFO("Shared System memory: %.2f GiB", memorySizeGiB);
+        }
     }
 
+    _context->device.physicalDevice = physicalDevices[selected];
+    _context->device.graphicsQueueIndex = queueInfo.graphicsFamilyIndex;
+    _context->device.presentQueueIndex = queueInfo.presentFamilyIndex;
+    _context->device.transferQueueIndex = queueInfo.transferFamilyIndex;
+    _context->device.computeQueueIndex = queueInfo.computeFamilyIndex;
+
+    //keep a copy of properties, features and memory for later use
+    _context->device.properties = properties;
+    _context->device.features = features;
+    _context->device.memory = memory;
+    if(!headless)
+        VulkanDeviceQuerySwapchainSupport(_context->device.physicalDevice, _context->surface, &_context->device.swapchainSupport);
+
     LOG_INFO("Physical device was selected.");
     return TRUE;
 }
 
+u64 PhysicalDeviceScore(
+    const VkPhysicalDeviceProperties* _props,
+    const VkPhysicalDeviceFeatures* _features,
+    const VkPhysicalDeviceMemoryProperties* _memory,
+    const VulkanPhysicalDeviceQueueFamilyInfo* _queueInfo)
+{
+    //device type dominates, the gaps are larger than everything below combined.
+    //CPU implementations score nothing here and are only picked when no GPU is usable
+    u64 score = 0;
+    switch(_props->deviceType)
+    {
+        case VK_PHYSICAL_DEVICE_TYPE_DISCRETE_GPU:
+            score = 1000000;
+            break;
+        case VK_PHYSICAL_DEVICE_TYPE_INTEGRATED_GPU:
+            score = 500000;
+            break;
+        case VK_PHYSICAL_DEVICE_TYPE_VIRTUAL_GPU:
+            score = 200000;
+            break;
+        case VK_PHYSICAL_DEVICE_TYPE_OTHER:
+            score = 100000;
+            break;
+        case VK_PHYSICAL_DEVICE_TYPE_CPU:
+        default:
+            score = 0;
+            break;
+    }
+
+    //largest device local heap in MiB, capped at 64 GiB
+    VkDeviceSize largestHeap = 0;
+    for(u32 i = 0; i < _memory->memoryHeapCount; ++i)
+    {
+        if((_memory->memoryHeaps[i].flags & VK_MEMORY_HEAP_DEVICE_LOCAL_BIT) && _memory->memoryHeaps[i].size > largestHeap)
+            largestHeap = _memory->memoryHeaps[i].size;
+    }
+    u64 heapMiB = largestHeap / (1024 * 1024);
+    score += heapMiB < 65536 ? heapMiB : 65536;
+
+    //queue layout, uploads overlap rendering on a dedicated transfer family
+    if(_queueInfo->transferFamilyIndex != _queueInfo->graphicsFamilyIndex)
+        score += 4000;
+    if(_queueInfo->presentFamilyIndex == _queueInfo->graphicsFamilyIndex)
+        score += 2000;
+    if(_queueInfo->computeFamilyIndex != (u32)-1 && _queueInfo->computeFamilyIndex != _queueInfo->graphicsFamilyIndex)
+        score += 1000;
+
+    //optional features the backend uses when present
+    if(_features->samplerAnisotropy)
+        score += 1000;
+    if(_props->apiVersion >= VK_API_VERSION_1_3)
+        score += 1000;
+
+    return score;
+}
+
+void FreeSwapchainSupport(VulkanSwapchainSupportInfo* _supportInfo)
+{
+    if(_supportInfo->formats)
+        cFree(_supportInfo->formats, sizeof(VkSurfaceFormatKHR) * _supportInfo->formatCapacity, MEMORY_TAG_RENDERER);
+    if(_supportInfo->presentModes)
+        cFree(_supportInfo->presentModes, sizeof(VkPresentModeKHR) * _supportInfo->presentModeCapacity, MEMORY_TAG_RENDERER);
+
+    _supportInfo->formats = 0;
+    _supportInfo->formatCount = 0;
+    _supportInfo->formatCapacity = 0;
+    _supportInfo->presentModes = 0;
+    _supportInfo->presentModeCount = 0;
+    _supportInfo->presentModeCapacity = 0;
+}
+
 b8 PhysicalDeviceMeetsRequirements(
     VkPhysicalDevice _device,
     VkSurfaceKHR _surface,
@@ -378,14 +622,11 @@ b8 PhysicalDeviceMeetsRequirements(
     _outQueueInfo->computeFamilyIndex = -1;
     _outQueueInfo->transferFamilyIndex = -1;
 
-    //discrete gpu?
-    if(_requirements->discreteGPU)
+    //timeline semaphores and the other 1.2 core features are relied on
+    if(_props->apiVersion < VK_API_VERSION_1_2)
     {
-        if(_props->deviceType != VK_PHYSICAL_DEVICE_TYPE_DISCRETE_GPU)
-        {
-            LOG_INFO("Device is not a discrete GPU, and one is required skipping.");
-            return FALSE;
-        }
+        LOG_INFO("Device does not support Vulkan 1.2, skipping.");
+        return FALSE;
     }
 
     u32 queueFamilyCount = 0;
@@ -407,10 +648,11 @@ b8 PhysicalDeviceMeetsRequirements(
             ++currentTransferScore;
         }
 
-        //compute queue?
+        //compute queue? a family without graphics runs alongside the graphics queue, prefer it for async compute
         if(queueFamilies[i].queueFlags & VK_QUEUE_COMPUTE_BIT)
         {
-            _outQueueInfo->computeFamilyIndex = i;
+            if(_outQueueInfo->computeFamilyIndex == (u32)-1 || !(queueFamilies[i].queueFlags & VK_QUEUE_GRAPHICS_BIT))
+                _outQueueInfo->computeFamilyIndex = i;
             ++currentTransferScore;
         }
 
@@ -427,13 +669,18 @@ b8 PhysicalDeviceMeetsRequirements(
 
         //present queue?
         VkBool32 supportsPresent = VK_FALSE;
-        VK_CHECK(vkGetPhysicalDeviceSurfaceSupportKHR(_device, i, _surface, &supportsPresent));
+        if(_surface)
+            VK_CHECK(vkGetPhysicalDeviceSurfaceSupportKHR(_device, i, _surface, &supportsPresent));
         if(supportsPresent)
         {
             _outQueueInfo->presentFamilyIndex = i;
         }
     }
 
+    //headless, nothing is presented. The graphics family stands in so the present queue is still valid
+    if(!_surface)
+        _outQueueInfo->presentFamilyIndex = _outQueueInfo->graphicsFamilyIndex;
+
     LOG_INFO("       %d |       %d |       %d |        %d | %s",
             _outQueueInfo->graphicsFamilyIndex != -1,
             _outQueueInfo->presentFamilyIndex != 1,
@@ -454,21 +701,16 @@ b8 PhysicalDeviceMeetsRequirements(
         LOG_TRACE("Compute Family Index:  %i", _outQueueInfo->computeFamilyIndex);
 
         //query swapchain support
-        VulkanDeviceQuerySwapchainSupport(_device, _surface, _outSwapchainSupport);
-
-        if(_outSwapchainSupport->formatCount < 1 || _outSwapchainSupport->presentModeCount < 1)
+        if(_requirements->present)
         {
-            if(_outSwapchainSupport->formats)
-            {
-                cFree(_outSwapchainSupport->formats, sizeof(VkSurfaceFormatKHR) * _outSwapchainSupport->formatCount, MEMORY_TAG_RENDERER);
-            }
-            if(_outSwapchainSupport->presentModes)
+            VulkanDeviceQuerySwapchainSupport(_device, _surface, _outSwapchainSupport);
+
+            //the caller frees the support info either way
+            if(_outSwapchainSupport->formatCount < 1 || _outSwapchainSupport->presentModeCount < 1)
             {
-                cFree(_outSwapchainSupport->presentModes, sizeof(VkPresentModeKHR) * _outSwapchainSupport->presentModeCount, MEMORY_TAG_RENDERER);
+                LOG_INFO("Required swapchain support not present skipping device.");
+                return FALSE;
             }
-
-            LOG_INFO("Required swapchain support not present skipping device.");
-            return FALSE;
         }
 
         //device extensions
@@ -521,4 +763,28 @@ b8 PhysicalDeviceMeetsRequirements(
     }
 
     return FALSE;
+}
+
+b8 DeviceExtensionAvailable(VkPhysicalDevice _device, const char* _name)
+{
+    u32 availableExtensionCount = 0;
+    VK_CHECK(vkEnumerateDeviceExtensionProperties(_device, 0, &availableExtensionCount, 0));
+    if(availableExtensionCount == 0)
+        return FALSE;
+
+    VkExtensionProperties* availableExtensions = cAllocate(sizeof(VkExtensionProperties) * availableExtensionCount, MEMORY_TAG_RENDERER);
+    VK_CHECK(vkEnumerateDeviceExtensionProperties(_device, 0, &availableExtensionCount, availableExtensions));
+
+    b8 found = FALSE;
+    for(u32 i = 0; i < availableExtensionCount; ++i)
+    {
+        if(StringsEqual(_name, availableExtensions[i].extensionName))
+        {
+            found = TRUE;
+            break;
+        }
+    }
+
+    cFree(availableExtensions, sizeof(VkExtensionProperties) * availableExtensionCount, MEMORY_TAG_RENDERER);
+    return found;
 }
\ No newline at end of file
@@ -2,7 +2,8 @@
 
 #include "VulkanTypes.inl"
 
-b8 VulkanDeviceCreate(VulkanContext* _context);
+//selects the highest scoring physical device, or the one matching _deviceName or the 1-based _deviceIndex when given
+b8 VulkanDeviceCreate(VulkanContext* _context, const char* _deviceName, u32 _deviceIndex);
 
 void VulkanDeviceDestroy(VulkanContext* _context);
 
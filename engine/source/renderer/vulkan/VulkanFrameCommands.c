@@ -0,0 +1,142 @@
+#include "VulkanFrameCommands.h"
+#include "VulkanCommandBuffer.h"
+
+#include "core/Logger.h"
+#include "core/CMemory.h"
+
+#include "containers/DArray.h"
+
+VkCommandPool CreateFrameCommandPool(VulkanContext* _context);
+
+b8 VulkanFrameCommandsCreate(VulkanContext* _context, u32 _threadCount, VulkanFrameCommands* _outCommands)
+{
+    cZeroMemory(_outCommands, sizeof(VulkanFrameCommands));
+
+    if(_threadCount > VULKAN_MAX_RECORD_THREADS)
+    {
+        LOG_WARN("VulkanFrameCommandsCreate requested %u recording threads, clamping to %u.", _threadCount, VULKAN_MAX_RECORD_THREADS);
+        _threadCount = VULKAN_MAX_RECORD_THREADS;
+    }
+
+    _outCommands->pool = CreateFrameCommandPool(_context);
+    VulkanCommandBufferAllocate(_context, _outCommands->pool, TRUE, &_outCommands->primary);
+
+    _outCommands->threadCount = _threadCount;
+    for(u32 i = 0; i < _threadCount; ++i)
+    {
+        _outCommands->threads[i].pool = CreateFrameCommandPool(_context);
+        _outCommands->threads[i].secondaries = DArrayCreate(VulkanCommandBuffer);
+    }
+
+    return TRUE;
+}
+
+void VulkanFrameCommandsDestroy(VulkanContext* _context, VulkanFrameCommands* _commands)
+{
+    //destroying a pool frees every buffer allocated from it
+    for(u32 i = 0; i < _commands->threadCount; ++i)
+    {
+        vkDestroyCommandPool(_context->device.logicalDevice, _commands->threads[i].pool, _context->allocator);
+        DArrayDestroy(_commands->threads[i].secondaries);
+    }
+
+    vkDestroyCommandPool(_context->device.logicalDevice, _commands->pool, _context->allocator);
+    cZeroMemory(_commands, sizeof(VulkanFrameCommands));
+}
+
+void VulkanFrameCommandsReset(VulkanContext* _context, VulkanFrameCommands* _commands)
+{
+    VK_CHECK(vkResetCommandPool(_context->device.logicalDevice, _commands->pool, 0));
+    _commands->primary.state = COMMAND_BUFFER_STATE_READY;
+
+    for(u32 i = 0; i < _commands->threadCount; ++i)
+    {
+        VulkanThreadCommands* thread = &_commands->threads[i];
+        if(!thread->usedCount)
+            continue;
+
+        VK_CHECK(vkResetCommandPool(_context->device.logicalDevice, thread->pool, 0));
+        for(u32 j = 0; j < thread->usedCount; ++j)
+            thread->secondaries[j].state = COMMAND_BUFFER_STATE_READY;
+
+        thread->usedCount = 0;
+        thread->executedCount = 0;
+    }
+}
+
+VulkanCommandBuffer* VulkanFrameCommandsBeginSecondary(
+    VulkanContext* _context,
+    VulkanFrameCommands* _commands,
+    u32 _threadIndex,
+    VkRenderPass _renderpass,
+    VkFramebuffer _framebuffer,
+    const VulkanRenderpassDesc* _renderingDesc)
+{
+    if(_threadIndex >= _commands->threadCount)
+    {
+        LOG_ERROR("VulkanFrameCommandsBeginSecondary called with thread index %u, only %u threads exist.", _threadIndex, _commands->threadCount);
+        return 0;
+    }
+
+    VulkanThreadCommands* thread = &_commands->threads[_threadIndex];
+    if(thread->usedCount == DArrayLength(thread->secondaries))
+    {
+        VulkanCommandBuffer secondary;
+        VulkanCommandBufferAllocate(_context, thread->pool, FALSE, &secondary);
+        DArrayPush(thread->secondaries, secondary);
+    }
+
+    VulkanCommandBuffer* commandBuffer = &thread->secondaries[thread->usedCount++];
+    if(_renderpass)
+        VulkanCommandBufferBeginSecondary(commandBuffer, _renderpass, 0, _framebuffer);
+    else
+        VulkanCommandBufferBeginSecondaryRendering(commandBuffer, _renderingDesc);
+    return commandBuffer;
+}
+
+u32 VulkanFrameCommandsExecuteSecondaries(VulkanFrameCommands* _commands)
+{
+    VkCommandBuffer handles[64];
+    u32 count = 0;
+    u32 executed = 0;
+
+    for(u32 i = 0; i < _commands->threadCount; ++i)
+    {
+        VulkanThreadCommands* thread = &_commands->threads[i];
+        for(u32 j = thread->executedCount; j < thread->usedCount; ++j)
+        {
+            handles[count++] = thread->secondaries[j].handle;
+            thread->secondaries[j].state = COMMAND_BUFFER_STATE_SUBMITTED;
+
+            //flush in batches so any number of secondaries can be executed
+            if(count == 64)
+            {
+                vkCmdExecuteCommands(_commands->primary.handle, count, handles);
+                executed += count;
+                count = 0;
+            }
+        }
+
+        thread->executedCount = thread->usedCount;
+    }
+
+    if(count)
+    {
+        vkCmdExecuteCommands(_commands->primary.handle, count, handles);
+        executed += count;
+    }
+
+    return executed;
+}
+
+VkCommandPool CreateFrameCommandPool(VulkanContext* _context)
+{
+    //buffers are short lived and never reset individually
+    VkCommandPoolCreateInfo poolCreateInfo = { VK_STRUCTURE_TYPE_COMMAND_POOL_CREATE_INFO };
+    poolCreateInfo.queueFamilyIndex = _context->device.graphicsQueueIndex;
+    poolCreateInfo.flags = VK_COMMAND_POOL_CREATE_TRANSIENT_BIT;
+
+    VkCommandPool pool;
+    VK_CHECK(vkCreateCommandPool(_context->device.logicalDevice, &poolCreateInfo, _context->allocator, &pool));
+    return pool;
+}
\ No newline at end of file
@@ -0,0 +1,35 @@
+#pragma once
+
+#include "VulkanTypes.inl"
+
+/**
+ * Command pools for a single frame in flight. The primary buffer and every secondary come from
+ * pools owned by the frame, so the whole frame is recycled with one vkResetCommandPool per pool
+ * instead of resetting buffers individually. Each recording thread has its own pool.
+ */
+b8 VulkanFrameCommandsCreate(VulkanContext* _context, u32 _threadCount, VulkanFrameCommands* _outCommands);
+
+void VulkanFrameCommandsDestroy(VulkanContext* _context, VulkanFrameCommands* _commands);
+
+//resets every pool of the frame, must only be called once the frame's in-flight fence has signaled
+void VulkanFrameCommandsReset(VulkanContext* _context, VulkanFrameCommands* _commands);
+
+/**
+ * Returns a secondary command buffer from _threadIndex's pool, begun to continue _renderpass.
+ * With a 0 _renderpass it continues a dynamic rendering instance with the attachments of _renderingDesc instead.
+ * Only the thread owning _threadIndex may call this for a given frame, different threads may call it concurrently.
+ */
+VulkanCommandBuffer* VulkanFrameCommandsBeginSecondary(
+    VulkanContext* _context,
+    VulkanFrameCommands* _commands,
+    u32 _threadIndex,
+    VkRenderPass _renderpass,
+    VkFramebuffer _framebuffer,
+    const VulkanRenderpassDesc* _renderingDesc);
+
+/**
+ * Executes the secondaries recorded since the last call on the primary buffer, by thread index and
+ * then in the order they were begun. All of them must have ended recording.
+ * @returns the number of secondaries executed.
+ */
+u32 VulkanFrameCommandsExecuteSecondaries(VulkanFrameCommands* _commands);
\ No newline at end of file
@@ -0,0 +1,591 @@
+#include "VulkanGpuScene.h"
+
+#include "VulkanBuffer.h"
+#include "VulkanShader.h"
+#include "VulkanStaticMesh.h"
+#include "VulkanPipelineCache.h"
+#include "VulkanDeletionQueue.h"
+
+#include "core/Logger.h"
+#include "core/CMemory.h"
+
+#include "math/CMath.h"
+
+#include "containers/DArray.h"
+
+#include <stddef.h>
+
+//layout of the GpuCull.comp push constant block
+typedef struct VulkanGpuCullPushConstants
+{
+    //world space, normals pointing inside
+    Vec4 planes[6];
+    u32 objectCount;
+} VulkanGpuCullPushConstants;
+
+//the block ends at objectCount, the struct's tail padding is outside the reflected range
+#define GPU_CULL_PUSH_CONSTANT_SIZE (offsetof(VulkanGpuCullPushConstants, objectCount) + sizeof(u32))
+
+b8 GpuSceneCreateObjectBuffers(VulkanContext* _context, VulkanGpuScene* _scene, u32 _capacity);
+b8 GpuSceneCreateDrawBuffer(VulkanContext* _context, VulkanGpuScene* _scene, u32 _capacity);
+b8 GpuSceneCreateCullPipeline(VulkanContext* _context, VulkanGpuScene* _scene);
+void GpuSceneWriteSets(VulkanContext* _context, VulkanGpuScene* _scene, u32 _frameIndex);
+void GpuSceneMarkDirty(VulkanGpuScene* _scene, u32 _object);
+void GpuSceneExtractPlanes(const Mat4* _viewProjection, Vec4* _outPlanes);
+
+b8 VulkanGpuSceneCreate(VulkanContext* _context, u32 _frameCount, VulkanGpuScene* _outScene)
+{
+    cZeroMemory(_outScene, sizeof(VulkanGpuScene));
+    _outScene->transforms = DArrayCreate(Mat4);
+    _outScene->objects = DArrayCreate(VulkanGpuCullObject);
+    _outScene->freeHandles = DArrayCreate(u32);
+    _outScene->dirtyObjects = DArrayCreate(u32);
+    _outScene->dirtyFlags = DArrayCreate(b8);
+    _outScene->batchObjectCounts = DArrayCreate(u32);
+    _outScene->transformCopies = DArrayCreate(VkBufferCopy);
+    _outScene->objectCopies = DArrayCreate(VkBufferCopy);
+    _outScene->viewProjection = Mat4Identity();
+
+    VkDevice device = _context->device.logicalDevice;
+
+    //the cull reads transforms and objects and writes the draw commands and visible object indices
+    VkDescriptorSetLayoutBinding cullBindings[4] = {};
+    for(u32 i = 0; i < 4; ++i)
+    {
+        cullBindings[i].binding = i;
+        cullBindings[i].descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
+        cullBindings[i].descriptorCount = 1;
+        cullBindings[i].stageFlags = VK_SHADER_STAGE_COMPUTE_BIT;
+    }
+
+    //owned by the shader library, equal to the layouts reflected from the shaders
+    _outScene->cullSetLayout = VulkanShaderLibraryGetSetLayout(_context, &_context->shaderLibrary, cullBindings, 4);
+
+    //the vertex shader reads the transform of visible[gl_InstanceIndex]
+    VkDescriptorSetLayoutBinding drawBindings[2] = {};
+    for(u32 i = 0; i < 2; ++i)
+    {
+        drawBindings[i].binding = i;
+        drawBindings[i].descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
+        drawBindings[i].descriptorCount = 1;
+        drawBindings[i].stageFlags = VK_SHADER_STAGE_VERTEX_BIT;
+    }
+
+    _outScene->drawSetLayout = VulkanShaderLibraryGetSetLayout(_context, &_context->shaderLibrary, drawBindings, 2);
+    if(!_outScene->cullSetLayout || !_outScene->drawSetLayout)
+        return FALSE;
+
+    VkDescriptorPoolSize poolSize;
+    poolSize.type = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
+    poolSize.descriptorCount = _frameCount * 6;
+
+    VkDescriptorPoolCreateInfo poolInfo = { VK_STRUCTURE_TYPE_DESCRIPTOR_POOL_CREATE_INFO };
+    poolInfo.maxSets = _frameCount * 2;
+    poolInfo.poolSizeCount = 1;
+    poolInfo.pPoolSizes = &poolSize;
+    VK_CHECK(vkCreateDescriptorPool(device, &poolInfo, _context->allocator, &_outScene->descriptorPool));
+
+    VkDescriptorSetLayout setLayouts[VULKAN_MAX_FRAMES_IN_FLIGHT];
+    VkDescriptorSetAllocateInfo allocateInfo = { VK_STRUCTURE_TYPE_DESCRIPTOR_SET_ALLOCATE_INFO };
+    allocateInfo.descriptorPool = _outScene->descriptorPool;
+    allocateInfo.descriptorSetCount = _frameCount;
+    allocateInfo.pSetLayouts = setLayouts;
+
+    for(u32 i = 0; i < _frameCount; ++i)
+        setLayouts[i] = _outScene->cullSetLayout;
+    VK_CHECK(vkAllocateDescriptorSets(device, &allocateInfo, _outScene->cullSets));
+
+    for(u32 i = 0; i < _frameCount; ++i)
+        setLayouts[i] = _outScene->drawSetLayout;
+    VK_CHECK(vkAllocateDescriptorSets(device, &allocateInfo, _outScene->drawSets));
+
+    if(!GpuSceneCreateObjectBuffers(_context, _outScene, VULKAN_GPU_SCENE_MIN_OBJECTS) ||
+       !GpuSceneCreateDrawBuffer(_context, _outScene, VULKAN_GPU_SCENE_MIN_BATCHES))
+    {
+        LOG_ERROR("Failed to create the gpu scene buffers.");
+        return FALSE;
+    }
+
+    //the scene stays empty without its shaders, static meshes drawn per frame are unaffected
+    if(!GpuSceneCreateCullPipeline(_context, _outScene) ||
+       !VulkanStaticMeshPipelineCacheCreate(_context, "StaticMeshIndirect.vert.spv", &_outScene->pipelines))
+    {
+        LOG_WARN("Gpu scene shaders are missing, gpu scene objects will not be drawn.");
+    }
+
+    return TRUE;
+}
+
+void VulkanGpuSceneDestroy(VulkanContext* _context, VulkanGpuScene* _scene)
+{
+    if(!_scene->transforms)
+        return;
+
+    VkDevice device = _context->device.logicalDevice;
+
+    DArrayDestroy(_scene->transforms);
+    DArrayDestroy(_scene->objects);
+    DArrayDestroy(_scene->freeHandles);
+    DArrayDestroy(_scene->dirtyObjects);
+    DArrayDestroy(_scene->dirtyFlags);
+    DArrayDestroy(_scene->batchObjectCounts);
+    DArrayDestroy(_scene->transformCopies);
+    DArrayDestroy(_scene->objectCopies);
+
+    //layouts belong to the shader library
+    VulkanStaticMeshPipelineCacheDestroy(_context, &_scene->pipelines);
+    if(_scene->cullPipeline)
+        vkDestroyPipeline(device, _scene->cullPipeline, _context->allocator);
+
+    VulkanBuffer* buffers[4] = { &_scene->transformBuffer, &_scene->objectBuffer, &_scene->visibleBuffer, &_scene->drawBuffer };
+    for(u32 i = 0; i < 4; ++i)
+    {
+        if(buffers[i]->handle)
+            VulkanBufferDestroy(_context, buffers[i]);
+    }
+
+    for(u32 i = 0; i < VULKAN_MAX_FRAMES_IN_FLIGHT; ++i)
+    {
+        if(_scene->uploadBuffers[i].handle)
+            VulkanBufferDestroy(_context, &_scene->uploadBuffers[i]);
+    }
+
+    //sets are freed with the pool
+    vkDestroyDescriptorPool(device, _scene->descriptorPool, _context->allocator);
+
+    cZeroMemory(_scene, sizeof(VulkanGpuScene));
+}
+
+u32 VulkanGpuSceneObjectCreate(VulkanGpuScene* _scene, const VulkanStaticMeshes* _meshes, u32 _mesh, const Mat4* _transform)
+{
+    if(_mesh >= DArrayLength(_meshes->meshes) || !_meshes->meshes[_mesh].live)
+    {
+        LOG_WARN("VulkanGpuSceneObjectCreate called with an invalid mesh handle %u.", _mesh);
+        return RENDER_HANDLE_NONE;
+    }
+
+    VulkanGpuCullObject object = {};
+    object.boundingSphere = _meshes->meshes[_mesh].boundingSphere;
+    object.batch = _mesh;
+    object.live = 1;
+
+    u32 handle;
+    if(DArrayLength(_scene->freeHandles) > 0)
+    {
+        DArrayPop(_scene->freeHandles, &handle);
+        _scene->transforms[handle] = *_transform;
+        _scene->objects[handle] = object;
+    }
+    else
+    {
+        handle = (u32)DArrayLength(_scene->objects);
+        DArrayPush(_scene->transforms, *_transform);
+        DArrayPush(_scene->objects, object);
+        DArrayPush(_scene->dirtyFlags, FALSE);
+    }
+
+    while(DArrayLength(_scene->batchObjectCounts) <= _mesh)
+        DArrayPush(_scene->batchObjectCounts, 0);
+    _scene->batchObjectCounts[_mesh]++;
+
+    GpuSceneMarkDirty(_scene, handle);
+    return handle;
+}
+
+void VulkanGpuSceneObjectSetTransform(VulkanGpuScene* _scene, u32 _object, const Mat4* _transform)
+{
+    if(_object >= DArrayLength(_scene->objects) || !_scene->objects[_object].live)
+    {
+        LOG_WARN("VulkanGpuSceneObjectSetTransform called with an invalid object handle %u.", _object);
+        return;
+    }
+
+    _scene->transforms[_object] = *_transform;
+    GpuSceneMarkDirty(_scene, _object);
+}
+
+void VulkanGpuSceneObjectDestroy(VulkanGpuScene* _scene, u32 _object)
+{
+    if(_object >= DArrayLength(_scene->objects) || !_scene->objects[_object].live)
+    {
+        LOG_WARN("VulkanGpuSceneObjectDestroy called with an invalid object handle %u.", _object);
+        return;
+    }
+
+    //the record stays on the device with live cleared until the handle is reused
+    VulkanGpuCullObject* object = &_scene->objects[_object];
+    _scene->batchObjectCounts[object->batch]--;
+    object->live = 0;
+
+    GpuSceneMarkDirty(_scene, _object);
+    DArrayPush(_scene->freeHandles, _object);
+}
+
+u32 VulkanGpuSceneGetMeshObjectCount(const VulkanGpuScene* _scene, u32 _mesh)
+{
+    if(!_scene->batchObjectCounts || _mesh >= DArrayLength(_scene->batchObjectCounts))
+        return 0;
+
+    return _scene->batchObjectCounts[_mesh];
+}
+
+b8 VulkanGpuScenePrepareFrame(
+    VulkanContext* _context,
+    VulkanGpuScene* _scene,
+    const VulkanStaticMeshes* _meshes,
+    u32 _frameIndex,
+    VulkanCommandBuffer* _commandBuffer,
+    const Mat4* _viewProjection)
+{
+    _scene->frameBatchCount = 0;
+    _scene->viewProjection = *_viewProjection;
+
+    u32 objectCount = (u32)DArrayLength(_scene->objects);
+    u32 batchCount = (u32)DArrayLength(_scene->batchObjectCounts);
+    if(!_scene->cullPipeline || !_scene->pipelines.layout || objectCount == 0)
+        return TRUE;
+
+    //grown buffers start empty, the whole mirror goes up again. The old ones stay alive for frames in flight
+    if(objectCount > _scene->objectCapacity)
+    {
+        u32 capacity = _scene->objectCapacity;
+        while(capacity < objectCount)
+            capacity *= 2;
+
+        if(!GpuSceneCreateObjectBuffers(_context, _scene, capacity))
+        {
+            LOG_ERROR("Failed to grow the gpu scene to %u objects.", capacity);
+            return FALSE;
+        }
+    }
+
+    if(batchCount > _scene->batchCapacity)
+    {
+        u32 capacity = _scene->batchCapacity;
+        while(capacity < batchCount)
+            capacity *= 2;
+
+        if(!GpuSceneCreateDrawBuffer(_context, _scene, capacity))
+        {
+            LOG_ERROR("Failed to grow the gpu scene draw buffer to %u batches.", capacity);
+            return FALSE;
+        }
+    }
+
+    //the slot's previous frame has completed, its sets and upload buffer can be rewritten
+    if(_scene->setGenerations[_frameIndex] != _scene->generation)
+        GpuSceneWriteSets(_context, _scene, _frameIndex);
+
+    //upload layout: the batch templates, then the dirty transforms, then the dirty objects
+    u32 dirtyCount = _scene->uploadAll ? objectCount : (u32)DArrayLength(_scene->dirtyObjects);
+    u64 templateSize = sizeof(VkDrawIndexedIndirectCommand) * batchCount;
+    u64 transformOffset = (templateSize + 15) & ~15ull;
+    u64 objectOffset = transformOffset + sizeof(Mat4) * dirtyCount;
+    u64 uploadSize = objectOffset + sizeof(VulkanGpuCullObject) * dirtyCount;
+
+    VulkanBuffer* upload = &_scene->uploadBuffers[_frameIndex];
+    if(uploadSize > upload->totalSize)
+    {
+        u64 capacity = upload->totalSize > 0 ? upload->totalSize : 64 * 1024;
+        while(capacity < uploadSize)
+            capacity *= 2;
+
+        if(upload->handle)
+            VulkanDeletionQueueRetireBuffer(_context, &_context->deletionQueue, upload);
+        if(!VulkanBufferCreate(_context, capacity, VK_BUFFER_USAGE_TRANSFER_SRC_BIT,
+            VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT, TRUE, upload))
+        {
+            LOG_ERROR("Failed to create the gpu scene upload buffer.");
+            return FALSE;
+        }
+    }
+
+    u8* mapped = VulkanBufferLockMemory(_context, upload, 0, uploadSize);
+
+    //instance counts restart at 0 every frame, each batch owns the range of its possible instances
+    VkDrawIndexedIndirectCommand* templates = (VkDrawIndexedIndirectCommand*)mapped;
+    u32 firstInstance = 0;
+    for(u32 i = 0; i < batchCount; ++i)
+    {
+        b8 drawable = i < DArrayLength(_meshes->meshes) && _meshes->meshes[i].live;
+        templates[i].indexCount = drawable ? _meshes->meshes[i].indexCount : 0;
+        templates[i].instanceCount = 0;
+        templates[i].firstIndex = 0;
+        templates[i].vertexOffset = 0;
+        templates[i].firstInstance = firstInstance;
+        firstInstance += _scene->batchObjectCounts[i];
+    }
+
+    DArrayClear(_scene->transformCopies);
+    DArrayClear(_scene->objectCopies);
+    if(_scene->uploadAll)
+    {
+        cCopyMemory(mapped + transformOffset, _scene->transforms, sizeof(Mat4) * objectCount);
+        cCopyMemory(mapped + objectOffset, _scene->objects, sizeof(VulkanGpuCullObject) * objectCount);
+
+        VkBufferCopy copy = { transformOffset, 0, sizeof(Mat4) * objectCount };
+        DArrayPush(_scene->transformCopies, copy);
+        copy = (VkBufferCopy){ objectOffset, 0, sizeof(VulkanGpuCullObject) * objectCount };
+        DArrayPush(_scene->objectCopies, copy);
+    }
+    else
+    {
+        Mat4* transforms = (Mat4*)(mapped + transformOffset);
+        VulkanGpuCullObject* objects = (VulkanGpuCullObject*)(mapped + objectOffset);
+        for(u32 i = 0; i < dirtyCount; ++i)
+        {
+            u32 handle = _scene->dirtyObjects[i];
+            transforms[i] = _scene->transforms[handle];
+            objects[i] = _scene->objects[handle];
+
+            VkBufferCopy copy = { transformOffset + sizeof(Mat4) * i, sizeof(Mat4) * handle, sizeof(Mat4) };
+            DArrayPush(_scene->transformCopies, copy);
+            copy = (VkBufferCopy){ objectOffset + sizeof(VulkanGpuCullObject) * i, sizeof(VulkanGpuCullObject) * handle, sizeof(VulkanGpuCullObject) };
+            DArrayPush(_scene->objectCopies, copy);
+        }
+    }
+
+    VulkanBufferUnlockMemory(_context, upload);
+
+    for(u32 i = 0; i < DArrayLength(_scene->dirtyObjects); ++i)
+        _scene->dirtyFlags[_scene->dirtyObjects[i]] = FALSE;
+    DArrayClear(_scene->dirtyObjects);
+    _scene->uploadAll = FALSE;
+
+    VkCommandBuffer commandBuffer = _commandBuffer->handle;
+
+    //the previous frame's cull and draws are done with the buffers before they are overwritten
+    VkMemoryBarrier barrier = { VK_STRUCTURE_TYPE_MEMORY_BARRIER };
+    barrier.srcAccessMask = VK_ACCESS_SHADER_WRITE_BIT;
+    barrier.dstAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+    vkCmdPipelineBarrier(commandBuffer,
+        VK_PIPELINE_STAGE_DRAW_INDIRECT_BIT | VK_PIPELINE_STAGE_VERTEX_SHADER_BIT | VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT,
+        VK_PIPELINE_STAGE_TRANSFER_BIT,
+        0, 1, &barrier, 0, 0, 0, 0);
+
+    VkBufferCopy templateCopy = { 0, 0, templateSize };
+    vkCmdCopyBuffer(commandBuffer, upload->handle, _scene->drawBuffer.handle, 1, &templateCopy);
+    if(dirtyCount > 0)
+    {
+        vkCmdCopyBuffer(commandBuffer, upload->handle, _scene->transformBuffer.handle,
+            (u32)DArrayLength(_scene->transformCopies), _scene->transformCopies);
+        vkCmdCopyBuffer(commandBuffer, upload->handle, _scene->objectBuffer.handle,
+            (u32)DArrayLength(_scene->objectCopies), _scene->objectCopies);
+    }
+
+    //transforms are read by the cull and by the draws
+    barrier.srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+    barrier.dstAccessMask = VK_ACCESS_SHADER_READ_BIT | VK_ACCESS_SHADER_WRITE_BIT;
+    vkCmdPipelineBarrier(commandBuffer,
+        VK_PIPELINE_STAGE_TRANSFER_BIT,
+        VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT | VK_PIPELINE_STAGE_VERTEX_SHADER_BIT,
+        0, 1, &barrier, 0, 0, 0, 0);
+
+    VulkanGpuCullPushConstants constants = {};
+    GpuSceneExtractPlanes(_viewProjection, constants.planes);
+    constants.objectCount = objectCount;
+
+    vkCmdBindPipeline(commandBuffer, VK_PIPELINE_BIND_POINT_COMPUTE, _scene->cullPipeline);
+    vkCmdBindDescriptorSets(commandBuffer, VK_PIPELINE_BIND_POINT_COMPUTE, _scene->cullLayout, 0, 1, &_scene->cullSets[_frameIndex], 0, 0);
+    vkCmdPushConstants(commandBuffer, _scene->cullLayout, VK_SHADER_STAGE_COMPUTE_BIT, 0, GPU_CULL_PUSH_CONSTANT_SIZE, &constants);
+    vkCmdDispatch(commandBuffer, (objectCount + VULKAN_GPU_SCENE_CULL_GROUP_SIZE - 1) / VULKAN_GPU_SCENE_CULL_GROUP_SIZE, 1, 1);
+
+    barrier.srcAccessMask = VK_ACCESS_SHADER_WRITE_BIT;
+    barrier.dstAccessMask = VK_ACCESS_INDIRECT_COMMAND_READ_BIT | VK_ACCESS_SHADER_READ_BIT;
+    vkCmdPipelineBarrier(commandBuffer,
+        VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT,
+        VK_PIPELINE_STAGE_DRAW_INDIRECT_BIT | VK_PIPELINE_STAGE_VERTEX_SHADER_BIT,
+        0, 1, &barrier, 0, 0, 0, 0);
+
+    _scene->frameBatchCount = batchCount;
+    return TRUE;
+}
+
+void VulkanGpuSceneRecordDraws(
+    VulkanContext* _context,
+    const VulkanGpuScene* _scene,
+    const VulkanStaticMeshes* _meshes,
+    VulkanCommandBuffer* _commandBuffer)
+{
+    const VulkanStaticMeshPipelines* pipelines = _scene->pipelines.pass;
+    if(!pipelines || _scene->frameBatchCount == 0)
+        return;
+
+    VkPipelineLayout layout = _scene->pipelines.layout;
+    VkPipeline boundPipeline = 0;
+    u32 meshCount = (u32)DArrayLength(_meshes->meshes);
+    for(u32 i = 0; i < _scene->frameBatchCount && i < meshCount; ++i)
+    {
+        //culled batches still draw, with an instance count of 0, only empty ones are skipped
+        const VulkanStaticMesh* mesh = &_meshes->meshes[i];
+        if(_scene->batchObjectCounts[i] == 0 || !mesh->ready)
+            continue;
+
+        VkPipeline pipeline = pipelines->pipelines[mesh->format];
+        if(!pipeline)
+            continue;
+
+        if(pipeline != boundPipeline)
+        {
+            vkCmdBindPipeline(_commandBuffer->handle, VK_PIPELINE_BIND_POINT_GRAPHICS, pipeline);
+
+            //every format shares the layout, the sets and the camera are bound once
+            if(!boundPipeline)
+            {
+                VkDescriptorSet sets[2] = { _scene->drawSets[_context->currentFrame], _scene->pipelines.bindlessSet };
+                vkCmdBindDescriptorSets(_commandBuffer->handle, VK_PIPELINE_BIND_POINT_GRAPHICS, layout,
+                    0, sets[1] ? 2 : 1, sets, 0, 0);
+                vkCmdPushConstants(_commandBuffer->handle, layout, VK_SHADER_STAGE_VERTEX_BIT,
+                    offsetof(VulkanStaticMeshPushConstants, viewProjection), sizeof(Mat4), &_scene->viewProjection);
+            }
+            boundPipeline = pipeline;
+        }
+
+        VulkanStaticMeshBindGeometry(_commandBuffer, layout, mesh);
+        vkCmdDrawIndexedIndirect(_commandBuffer->handle, _scene->drawBuffer.handle,
+            sizeof(VkDrawIndexedIndirectCommand) * i, 1, sizeof(VkDrawIndexedIndirectCommand));
+    }
+}
+
+b8 GpuSceneCreateObjectBuffers(VulkanContext* _context, VulkanGpuScene* _scene, u32 _capacity)
+{
+    VulkanBuffer* buffers[3] = { &_scene->transformBuffer, &_scene->objectBuffer, &_scene->visibleBuffer };
+    u64 strides[3] = { sizeof(Mat4), sizeof(VulkanGpuCullObject), sizeof(u32) };
+    for(u32 i = 0; i < 3; ++i)
+    {
+        if(buffers[i]->handle)
+            VulkanDeletionQueueRetireBuffer(_context, &_context->deletionQueue, buffers[i]);
+
+        if(!VulkanBufferCreate(_context, strides[i] * _capacity,
+            VK_BUFFER_USAGE_STORAGE_BUFFER_BIT | VK_BUFFER_USAGE_TRANSFER_DST_BIT,
+            VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT, TRUE, buffers[i]))
+            return FALSE;
+    }
+
+    _scene->objectCapacity = _capacity;
+    _scene->uploadAll = TRUE;
+    _scene->generation++;
+    return TRUE;
+}
+
+b8 GpuSceneCreateDrawBuffer(VulkanContext* _context, VulkanGpuScene* _scene, u32 _capacity)
+{
+    //the commands are rewritten every frame, nothing is carried over
+    if(_scene->drawBuffer.handle)
+        VulkanDeletionQueueRetireBuffer(_context, &_context->deletionQueue, &_scene->drawBuffer);
+
+    if(!VulkanBufferCreate(_context, sizeof(VkDrawIndexedIndirectCommand) * _capacity,
+        VK_BUFFER_USAGE_INDIRECT_BUFFER_BIT | VK_BUFFER_USAGE_STORAGE_BUFFER_BIT | VK_BUFFER_USAGE_TRANSFER_DST_BIT,
+        VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT, TRUE, &_scene->drawBuffer))
+        return FALSE;
+
+    _scene->batchCapacity = _capacity;
+    _scene->generation++;
+    return TRUE;
+}
+
+b8 GpuSceneCreateCullPipeline(VulkanContext* _context, VulkanGpuScene* _scene)
+{
+    VulkanShaderLibrary* library = &_context->shaderLibrary;
+    u32 shader = VulkanShaderLibraryLoad(_context, library, VULKAN_SHADER_PATH "GpuCull.comp.spv");
+    if(shader == RENDER_HANDLE_NONE)
+        return FALSE;
+
+    _scene->cullLayout = VulkanShaderLibraryGetPipelineLayout(_context, library, &shader, 1);
+    if(!_scene->cullLayout)
+    {
+        VulkanShaderLibraryRelease(_context, library, &shader);
+        return FALSE;
+    }
+
+    VkComputePipelineCreateInfo createInfo = { VK_STRUCTURE_TYPE_COMPUTE_PIPELINE_CREATE_INFO };
+    createInfo.stage.sType = VK_STRUCTURE_TYPE_PIPELINE_SHADER_STAGE_CREATE_INFO;
+    createInfo.stage.stage = VK_SHADER_STAGE_COMPUTE_BIT;
+    createInfo.stage.module = VulkanShaderLibraryGetModule(library, shader);
+    createInfo.stage.pName = "main";
+    createInfo.layout = _scene->cullLayout;
+    createInfo.basePipelineIndex = -1;
+
+    //the pipeline keeps its own copy of the code
+    VkResult result = VulkanPipelineCacheCreateComputePipelines(_context, 1, &createInfo, &_scene->cullPipeline);
+    VulkanShaderLibraryRelease(_context, library, &shader);
+    if(result != VK_SUCCESS)
+    {
+        LOG_ERROR("Failed to create the gpu cull pipeline.");
+        return FALSE;
+    }
+
+    return TRUE;
+}
+
+void GpuSceneWriteSets(VulkanContext* _context, VulkanGpuScene* _scene, u32 _frameIndex)
+{
+    //cull bindings: transforms, objects, draws, visible. Draw bindings: transforms, visible
+    VkDescriptorBufferInfo bufferInfos[4];
+    const VulkanBuffer* buffers[4] = { &_scene->transformBuffer, &_scene->objectBuffer, &_scene->drawBuffer, &_scene->visibleBuffer };
+    for(u32 i = 0; i < 4; ++i)
+    {
+        bufferInfos[i].buffer = buffers[i]->handle;
+        bufferInfos[i].offset = 0;
+        bufferInfos[i].range = VK_WHOLE_SIZE;
+    }
+
+    VkWriteDescriptorSet writes[6];
+    for(u32 i = 0; i < 6; ++i)
+    {
+        VkWriteDescriptorSet write = { VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET };
+        write.descriptorCount = 1;
+        write.descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
+        writes[i] = write;
+    }
+
+    for(u32 i = 0; i < 4; ++i)
+    {
+        writes[i].dstSet = _scene->cullSets[_frameIndex];
+        writes[i].dstBinding = i;
+        writes[i].pBufferInfo = &bufferInfos[i];
+    }
+
+    writes[4].dstSet = _scene->drawSets[_frameIndex];
+    writes[4].dstBinding = 0;
+    writes[4].pBufferInfo = &bufferInfos[0];
+    writes[5].dstSet = _scene->drawSets[_frameIndex];
+    writes[5].dstBinding = 1;
+    writes[5].pBufferInfo = &bufferInfos[3];
+
+    vkUpdateDescriptorSets(_context->device.logicalDevice, 6, writes, 0, 0);
+    _scene->setGenerations[_frameIndex] = _scene->generation;
+}
+
+void GpuSceneMarkDirty(VulkanGpuScene* _scene, u32 _object)
+{
+    if(_scene->dirtyFlags[_object])
+        return;
+
+    _scene->dirtyFlags[_object] = TRUE;
+    DArrayPush(_scene->dirtyObjects, _object);
+}
+
+void GpuSceneExtractPlanes(const Mat4* _viewProjection, Vec4* _outPlanes)
+{
+    //rows of the column major matrix, clip space depth is [0, 1] in Vulkan
+    const f32* m = _viewProjection->data;
+    Vec4 rows[4];
+    for(u32 i = 0; i < 4; ++i)
+        rows[i] = Vec4Create(m[i], m[4 + i], m[8 + i], m[12 + i]);
+
+    _outPlanes[0] = Vec4Add(rows[3], rows[0]);
+    _outPlanes[1] = Vec4Sub(rows[3], rows[0]);
+    _outPlanes[2] = Vec4Add(rows[3], rows[1]);
+    _outPlanes[3] = Vec4Sub(rows[3], rows[1]);
+    _outPlanes[4] = rows[2];
+    _outPlanes[5] = Vec4Sub(rows[3], rows[2]);
+
+    //normalized so the distance to the plane compares against the sphere radius
+    for(u32 i = 0; i < 6; ++i)
+    {
+        f32 length = Vec3Length(Vec4ToVec3(_outPlanes[i]));
+        if(length > C_FLOAT_EPSILON)
+            _outPlanes[i] = Vec4Scale(_outPlanes[i], 1.f / length);
+    }
+}
\ No newline at end of file
@@ -0,0 +1,45 @@
+#pragma once
+
+#include "VulkanTypes.inl"
+
+/**
+ * Creates the scene's device buffers, descriptor sets and the cull and draw pipelines. Missing shaders
+ * only disable the scene, objects can still be created.
+ */
+b8 VulkanGpuSceneCreate(VulkanContext* _context, u32 _frameCount, VulkanGpuScene* _outScene);
+
+//the device must be idle
+void VulkanGpuSceneDestroy(VulkanContext* _context, VulkanGpuScene* _scene);
+
+/**
+ * Adds an instance of _mesh, a live static mesh. Objects must be destroyed before their mesh.
+ * @returns the object handle, RENDER_HANDLE_NONE on failure.
+ */
+u32 VulkanGpuSceneObjectCreate(VulkanGpuScene* _scene, const VulkanStaticMeshes* _meshes, u32 _mesh, const Mat4* _transform);
+
+void VulkanGpuSceneObjectSetTransform(VulkanGpuScene* _scene, u32 _object, const Mat4* _transform);
+
+void VulkanGpuSceneObjectDestroy(VulkanGpuScene* _scene, u32 _object);
+
+//live objects drawing _mesh, a mesh can only be destroyed once this is 0
+u32 VulkanGpuSceneGetMeshObjectCount(const VulkanGpuScene* _scene, u32 _mesh);
+
+/**
+ * Uploads the objects changed since the last frame and records the cull into _commandBuffer, which
+ * must be outside of a render pass. The draws recorded by VulkanGpuSceneRecordDraws later in the
+ * same submission read its results. Render thread, after the slot's previous frame completed.
+ */
+b8 VulkanGpuScenePrepareFrame(
+    VulkanContext* _context,
+    VulkanGpuScene* _scene,
+    const VulkanStaticMeshes* _meshes,
+    u32 _frameIndex,
+    VulkanCommandBuffer* _commandBuffer,
+    const Mat4* _viewProjection);
+
+//records one indirect draw per mesh with culled objects into a command buffer inside the current pass
+void VulkanGpuSceneRecordDraws(
+    VulkanContext* _context,
+    const VulkanGpuScene* _scene,
+    const VulkanStaticMeshes* _meshes,
+    VulkanCommandBuffer* _commandBuffer);
\ No newline at end of file
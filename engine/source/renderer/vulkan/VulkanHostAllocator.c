@@ -0,0 +1,340 @@
+#include "VulkanHostAllocator.h"
+
+#include "core/Logger.h"
+#include "core/CMemory.h"
+#include "core/CString.h"
+
+#include "containers/DArray.h"
+
+#include <stdio.h>
+
+//sits in front of every pointer handed to the driver, keeps the returned pointer 16 byte aligned
+#define VULKAN_HOST_HEADER_SIZE 32
+#define VULKAN_HOST_MIN_ALIGNMENT 16
+#define VULKAN_HOST_POOL_MIN_SHIFT 6
+
+typedef enum VulkanHostAllocationKind
+{
+    VULKAN_HOST_KIND_ARENA,
+    VULKAN_HOST_KIND_POOL,
+    VULKAN_HOST_KIND_HEAP
+} VulkanHostAllocationKind;
+
+typedef struct VulkanHostHeader
+{
+    //requested size
+    u64 size;
+
+    //bytes backing the allocation starting at the base pointer
+    u64 reserved;
+
+    //distance from the base pointer to the pointer returned to the driver
+    u32 offset;
+    u8 kind;
+    u8 scope;
+    u8 poolClass;
+} VulkanHostHeader;
+
+STATIC_ASSERT(sizeof(VulkanHostHeader) <= VULKAN_HOST_HEADER_SIZE, "VulkanHostHeader must fit in VULKAN_HOST_HEADER_SIZE.");
+
+void HostAllocatorLock(VulkanHostAllocator* _allocator);
+void HostAllocatorUnlock(VulkanHostAllocator* _allocator);
+u64 HostAlignUp(u64 _value, u64 _alignment);
+void* HostAllocateLocked(VulkanHostAllocator* _allocator, u64 _size, u64 _alignment, VkSystemAllocationScope _scope);
+void HostFreeLocked(VulkanHostAllocator* _allocator, void* _memory);
+void* HostPoolAllocate(VulkanHostPool* _pool);
+
+void* VKAPI_CALL HostAllocationCallback(void* _userData, size_t _size, size_t _alignment, VkSystemAllocationScope _scope);
+void* VKAPI_CALL HostReallocationCallback(void* _userData, void* _original, size_t _size, size_t _alignment, VkSystemAllocationScope _scope);
+void VKAPI_CALL HostFreeCallback(void* _userData, void* _memory);
+void VKAPI_CALL HostInternalAllocationCallback(void* _userData, size_t _size, VkInternalAllocationType _type, VkSystemAllocationScope _scope);
+void VKAPI_CALL HostInternalFreeCallback(void* _userData, size_t _size, VkInternalAllocationType _type, VkSystemAllocationScope _scope);
+
+b8 VulkanHostAllocatorCreate(VulkanHostAllocator* _outAllocator)
+{
+    cZeroMemory(_outAllocator, sizeof(VulkanHostAllocator));
+
+    _outAllocator->arena = cAllocate(VULKAN_HOST_ARENA_SIZE, MEMORY_TAG_RENDERER);
+    for(u32 i = 0; i < VULKAN_HOST_POOL_CLASS_COUNT; ++i)
+    {
+        _outAllocator->pools[i].blockSize = 1ull << (VULKAN_HOST_POOL_MIN_SHIFT + i);
+        _outAllocator->pools[i].pages = DArrayCreate(void*);
+    }
+
+    VkAllocationCallbacks* callbacks = &_outAllocator->callbacks;
+    callbacks->pUserData = _outAllocator;
+    callbacks->pfnAllocation = HostAllocationCallback;
+    callbacks->pfnReallocation = HostReallocationCallback;
+    callbacks->pfnFree = HostFreeCallback;
+    callbacks->pfnInternalAllocation = HostInternalAllocationCallback;
+    callbacks->pfnInternalFree = HostInternalFreeCallback;
+
+    return TRUE;
+}
+
+void VulkanHostAllocatorDestroy(VulkanHostAllocator* _allocator)
+{
+    for(u32 i = 0; i < VULKAN_HOST_SCOPE_COUNT; ++i)
+    {
+        //command scope is allowed to leak into the arena
+        if(i != VK_SYSTEM_ALLOCATION_SCOPE_COMMAND && _allocator->scopeLive[i])
+        {
+            LOG_WARN("Vulkan host allocator destroyed with %llu bytes live in scope %u.", _allocator->scopeLive[i], i);
+        }
+    }
+
+    for(u32 i = 0; i < VULKAN_HOST_POOL_CLASS_COUNT; ++i)
+    {
+        VulkanHostPool* pool = &_allocator->pools[i];
+        u64 pageCount = DArrayLength(pool->pages);
+        for(u64 j = 0; j < pageCount; ++j)
+            cFree(pool->pages[j], VULKAN_HOST_POOL_PAGE_SIZE, MEMORY_TAG_RENDERER);
+
+        DArrayDestroy(pool->pages);
+    }
+
+    cFree(_allocator->arena, VULKAN_HOST_ARENA_SIZE, MEMORY_TAG_RENDERER);
+    cZeroMemory(_allocator, sizeof(VulkanHostAllocator));
+}
+
+void VulkanHostAllocatorResetFrame(VulkanHostAllocator* _allocator)
+{
+    HostAllocatorLock(_allocator);
+    _allocator->arenaOffset = 0;
+    HostAllocatorUnlock(_allocator);
+}
+
+char* VulkanHostAllocatorGetUsageStr(VulkanHostAllocator* _allocator)
+{
+    static const char* scopeStrings[VULKAN_HOST_SCOPE_COUNT] = {
+        "COMMAND ",
+        "OBJECT  ",
+        "CACHE   ",
+        "DEVICE  ",
+        "INSTANCE"};
+
+    char buffer[8000] = "Vulkan host memory use (scope, live/peak):\n";
+    u64 offset = StringLength(buffer);
+    for(u32 i = 0; i < VULKAN_HOST_SCOPE_COUNT; ++i)
+    {
+        char units[2][4];
+        f32 amounts[2];
+        FormatMemorySize(_allocator->scopeLive[i], &amounts[0], units[0]);
+        FormatMemorySize(_allocator->scopePeak[i], &amounts[1], units[1]);
+
+        i32 length = snprintf(buffer + offset, 8000 - offset, "  %s: %.2f%s / %.2f%s (%llu allocations)\n",
+            scopeStrings[i], amounts[0], units[0], amounts[1], units[1], _allocator->scopeAllocationCount[i]);
+        offset += length;
+    }
+
+    char unit[4];
+    f32 amount;
+    FormatMemorySize(_allocator->arenaPeak, &amount, unit);
+    i32 length = snprintf(buffer + offset, 8000 - offset, "  Command arena peak: %.2f%s of %lluKiB (%u overflows)\n",
+        amount, unit, VULKAN_HOST_ARENA_SIZE / 1024, _allocator->arenaOverflowCount);
+    offset += length;
+
+    FormatMemorySize(_allocator->internalLive, &amount, unit);
+    snprintf(buffer + offset, 8000 - offset, "  Driver internal: %.2f%s\n", amount, unit);
+
+    return StringDuplicate(buffer);
+}
+
+void HostAllocatorLock(VulkanHostAllocator* _allocator)
+{
+    while(__atomic_exchange_n(&_allocator->lock, 1, __ATOMIC_ACQUIRE))
+    {
+        while(__atomic_load_n(&_allocator->lock, __ATOMIC_RELAXED))
+            ;
+    }
+}
+
+void HostAllocatorUnlock(VulkanHostAllocator* _allocator)
+{
+    __atomic_store_n(&_allocator->lock, 0, __ATOMIC_RELEASE);
+}
+
+u64 HostAlignUp(u64 _value, u64 _alignment)
+{
+    return (_value + _alignment - 1) & ~(_alignment - 1);
+}
+
+void* HostAllocateLocked(VulkanHostAllocator* _allocator, u64 _size, u64 _alignment, VkSystemAllocationScope _scope)
+{
+    if(_alignment < VULKAN_HOST_MIN_ALIGNMENT)
+        _alignment = VULKAN_HOST_MIN_ALIGNMENT;
+
+    u8* base = 0;
+    u64 reserved = 0;
+    u8 kind = VULKAN_HOST_KIND_HEAP;
+    u8 poolClass = 0;
+    u64 userOffset = VULKAN_HOST_HEADER_SIZE;
+
+    if(_scope == VK_SYSTEM_ALLOCATION_SCOPE_COMMAND)
+    {
+        //align the absolute address, alignments above the arena base alignment are allowed
+        u64 arenaBase = (u64)_allocator->arena;
+        u64 start = HostAlignUp(arenaBase + _allocator->arenaOffset + VULKAN_HOST_HEADER_SIZE, _alignment) - arenaBase;
+        if(start + _size <= VULKAN_HOST_ARENA_SIZE)
+        {
+            base = _allocator->arena + _allocator->arenaOffset;
+            userOffset = start - _allocator->arenaOffset;
+            reserved = userOffset + _size;
+            kind = VULKAN_HOST_KIND_ARENA;
+
+            _allocator->arenaOffset = start + _size;
+            if(_allocator->arenaOffset > _allocator->arenaPeak)
+                _allocator->arenaPeak = _allocator->arenaOffset;
+        }
+        else
+        {
+            _allocator->arenaOverflowCount++;
+        }
+    }
+
+    if(!base && _alignment <= VULKAN_HOST_MIN_ALIGNMENT)
+    {
+        u64 needed = _size + VULKAN_HOST_HEADER_SIZE;
+        for(u8 i = 0; i < VULKAN_HOST_POOL_CLASS_COUNT; ++i)
+        {
+            if(needed <= _allocator->pools[i].blockSize)
+            {
+                base = HostPoolAllocate(&_allocator->pools[i]);
+                reserved = _allocator->pools[i].blockSize;
+                kind = VULKAN_HOST_KIND_POOL;
+                poolClass = i;
+                break;
+            }
+        }
+    }
+
+    if(!base)
+    {
+        //over allocate so the header and the user pointer can both be aligned
+        reserved = _size + _alignment + VULKAN_HOST_HEADER_SIZE;
+        base = cAllocate(reserved, MEMORY_TAG_RENDERER);
+        userOffset = HostAlignUp((u64)base + VULKAN_HOST_HEADER_SIZE, _alignment) - (u64)base;
+        kind = VULKAN_HOST_KIND_HEAP;
+    }
+
+    u8* memory = base + userOffset;
+    VulkanHostHeader* header = (VulkanHostHeader*)(memory - VULKAN_HOST_HEADER_SIZE);
+    header->size = _size;
+    header->reserved = reserved;
+    header->offset = (u32)userOffset;
+    header->kind = kind;
+    header->scope = (u8)_scope;
+    header->poolClass = poolClass;
+
+    _allocator->scopeLive[_scope] += _size;
+    _allocator->scopeAllocationCount[_scope]++;
+    if(_allocator->scopeLive[_scope] > _allocator->scopePeak[_scope])
+        _allocator->scopePeak[_scope] = _allocator->scopeLive[_scope];
+
+    return memory;
+}
+
+void HostFreeLocked(VulkanHostAllocator* _allocator, void* _memory)
+{
+    VulkanHostHeader* header = (VulkanHostHeader*)((u8*)_memory - VULKAN_HOST_HEADER_SIZE);
+    _allocator->scopeLive[header->scope] -= header->size;
+
+    u8* base = (u8*)_memory - header->offset;
+    switch(header->kind)
+    {
+        case VULKAN_HOST_KIND_ARENA:
+            //reclaimed by VulkanHostAllocatorResetFrame
+            break;
+        case VULKAN_HOST_KIND_POOL:
+        {
+            VulkanHostPool* pool = &_allocator->pools[header->poolClass];
+            *(void**)base = pool->freeList;
+            pool->freeList = base;
+            break;
+        }
+        default:
+            cFree(base, header->reserved, MEMORY_TAG_RENDERER);
+            break;
+    }
+}
+
+void* HostPoolAllocate(VulkanHostPool* _pool)
+{
+    if(!_pool->freeList)
+    {
+        u8* page = cAllocate(VULKAN_HOST_POOL_PAGE_SIZE, MEMORY_TAG_RENDERER);
+        DArrayPush(_pool->pages, page);
+
+        //thread the new blocks back to front so they are handed out in address order
+        u64 blockCount = VULKAN_HOST_POOL_PAGE_SIZE / _pool->blockSize;
+        for(u64 i = blockCount; i > 0; --i)
+        {
+            u8* block = page + (i - 1) * _pool->blockSize;
+            *(void**)block = _pool->freeList;
+            _pool->freeList = block;
+        }
+    }
+
+    void* block = _pool->freeList;
+    _pool->freeList = *(void**)block;
+    return block;
+}
+
+
+void* VKAPI_CALL HostAllocationCallback(void* _userData, size_t _size, size_t _alignment, VkSystemAllocationScope _scope)
+{
+    if(_size == 0)
+        return 0;
+
+    VulkanHostAllocator* allocator = (VulkanHostAllocator*)_userData;
+    HostAllocatorLock(allocator);
+    void* memory = HostAllocateLocked(allocator, _size, _alignment, _scope);
+    HostAllocatorUnlock(allocator);
+    return memory;
+}
+
+void* VKAPI_CALL HostReallocationCallback(void* _userData, void* _original, size_t _size, size_t _alignment, VkSystemAllocationScope _scope)
+{
+    VulkanHostAllocator* allocator = (VulkanHostAllocator*)_userData;
+    if(!_original)
+        return HostAllocationCallback(_userData, _size, _alignment, _scope);
+
+    if(_size == 0)
+    {
+        HostFreeCallback(_userData, _original);
+        return 0;
+    }
+
+    VulkanHostHeader* header = (VulkanHostHeader*)((u8*)_original - VULKAN_HOST_HEADER_SIZE);
+
+    HostAllocatorLock(allocator);
+    void* memory = HostAllocateLocked(allocator, _size, _alignment, _scope);
+    cCopyMemory(memory, _original, header->size < _size ? header->size : _size);
+    HostFreeLocked(allocator, _original);
+    HostAllocatorUnlock(allocator);
+
+    return memory;
+}
+
+void VKAPI_CALL HostFreeCallback(void* _userData, void* _memory)
+{
+    if(!_memory)
+        return;
+
+    VulkanHostAllocator* allocator = (VulkanHostAllocator*)_userData;
+    HostAllocatorLock(allocator);
+    HostFreeLocked(allocator, _memory);
+    HostAllocatorUnlock(allocator);
+}
+
+void VKAPI_CALL HostInternalAllocationCallback(void* _userData, size_t _size, VkInternalAllocationType _type, VkSystemAllocationScope _scope)
+{
+    VulkanHostAllocator* allocator = (VulkanHostAllocator*)_userData;
+    __atomic_fetch_add(&allocator->internalLive, (u64)_size, __ATOMIC_RELAXED);
+}
+
+void VKAPI_CALL HostInternalFreeCallback(void* _userData, size_t _size, VkInternalAllocationType _type, VkSystemAllocationScope _scope)
+{
+    VulkanHostAllocator* allocator = (VulkanHostAllocator*)_userData;
+    __atomic_fetch_sub(&allocator->internalLive, (u64)_size, __ATOMIC_RELAXED);
+}
\ No newline at end of file
@@ -0,0 +1,26 @@
+#pragma once
+
+#include "VulkanTypes.inl"
+
+/**
+ * Host allocator handed to the driver through VkAllocationCallbacks. Command scope allocations
+ * are bump allocated from a per-frame arena, small object/cache/device/instance scope allocations
+ * come from size class pools and everything else from cAllocate. All backing memory is tagged
+ * MEMORY_TAG_RENDERER, so driver host memory shows up in GetMemoryUsageStr.
+ * Must be created before the instance and destroyed after it.
+ */
+b8 VulkanHostAllocatorCreate(VulkanHostAllocator* _outAllocator);
+
+void VulkanHostAllocatorDestroy(VulkanHostAllocator* _allocator);
+
+/**
+ * Rewinds the command scope arena. Command scope allocations only live for the duration of a
+ * vulkan call, so this is safe whenever no other thread is inside one, e.g. at the start of a frame.
+ */
+void VulkanHostAllocatorResetFrame(VulkanHostAllocator* _allocator);
+
+/**
+ * Returns a string describing driver host memory use per allocation scope, in the same format as GetMemoryUsageStr.
+ * The string is allocated with MEMORY_TAG_STRING and must be freed by the caller.
+ */
+char* VulkanHostAllocatorGetUsageStr(VulkanHostAllocator* _allocator);
\ No newline at end of file
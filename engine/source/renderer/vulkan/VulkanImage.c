@@ -1,6 +1,7 @@
 #include "VulkanImage.h"
 
 #include "VulkanDevice.h"
+#include "VulkanMemory.h"
 
 #include "core/CMemory.h"
 #include "core/Logger.h"
@@ -43,18 +44,12 @@ void VulkanImageCreate(
     VkMemoryRequirements memoryRequirements;
     vkGetImageMemoryRequirements(_context->device.logicalDevice, _outImage->handle, &memoryRequirements);
 
-    i32 memoryType = _context->FindMemoryIndex(memoryRequirements.memoryTypeBits, _memoryFlags);
-    if(memoryType == -1)
-        LOG_ERROR("Required memory type not found. Image not vaild.");
-
     //allocate memory
-    VkMemoryAllocateInfo memoryAllocateInfo = { VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_INFO };
-    memoryAllocateInfo.allocationSize = memoryRequirements.size;
-    memoryAllocateInfo.memoryTypeIndex = memoryType;
-    VK_CHECK(vkAllocateMemory(_context->device.logicalDevice, &memoryAllocateInfo, _context->allocator, &_outImage->memory));
+    if(!VulkanMemoryAllocate(_context, &memoryRequirements, _memoryFlags, _tiling == VK_IMAGE_TILING_OPTIMAL, &_outImage->allocation))
+        LOG_ERROR("Failed to allocate image memory. Image not vaild.");
 
     //Bind the memory
-    VK_CHECK(vkBindImageMemory(_context->device.logicalDevice, _outImage->handle, _outImage->memory, 0)); //TODO: configurable memory offset.
+    VK_CHECK(vkBindImageMemory(_context->device.logicalDevice, _outImage->handle, _outImage->allocation.memory, _outImage->allocation.offset));
 
     //create view
     if(_createView)
@@ -92,11 +87,8 @@ void VulkanImageDestroy(VulkanContext* _context, VulkanImage* _image)
         vkDestroyImageView(_context->device.logicalDevice, _image->view, _context->allocator);
         _image->view = 0;
     }
-    if(_image->memory)
-    {
-        vkFreeMemory(_context->device.logicalDevice, _image->memory, _context->allocator);
-        _image->memory = 0;
-    }
+    if(_image->allocation.memory)
+        VulkanMemoryFree(_context, &_image->allocation);
     if(_image->handle)
     {
         vkDestroyImage(_context->device.logicalDevice, _image->handle, _context->allocator);
@@ -0,0 +1,408 @@
+#include "VulkanMemory.h"
+
+#include "core/Logger.h"
+#include "core/CMemory.h"
+#include "core/CString.h"
+
+#include "containers/DArray.h"
+
+#include <stdio.h>
+
+//preferred size of the blocks reserved from the driver
+#define VULKAN_MEMORY_DEFAULT_BLOCK_SIZE (64ull * 1024 * 1024)
+
+u64 BuddyRoundUp(u64 _value);
+u8 BuddyLog2(u64 _value);
+b8 BuddyAllocate(VulkanMemoryBlock* _block, u8 _order, u8 _orderCount, VkDeviceSize* _outOffset);
+void BuddyFree(VulkanMemoryBlock* _block, VkDeviceSize _offset, u8 _order, u8 _orderCount);
+b8 CreateMemoryBlock(VulkanContext* _context, u32 _memoryTypeIndex, b8 _optimal, i32* _outBlockIndex);
+void DestroyMemoryBlock(VulkanContext* _context, u32 _memoryTypeIndex, VulkanMemoryBlock* _block);
+b8 AllocateDedicated(VulkanContext* _context, VkDeviceSize _size, u32 _memoryTypeIndex, VulkanMemoryAllocation* _outAllocation);
+
+b8 VulkanMemoryInitialize(VulkanContext* _context)
+{
+    VulkanMemoryAllocator* allocator = &_context->memoryAllocator;
+    cZeroMemory(allocator, sizeof(VulkanMemoryAllocator));
+
+    allocator->bufferImageGranularity = _context->device.properties.limits.bufferImageGranularity;
+
+    const VkPhysicalDeviceMemoryProperties* memory = &_context->device.memory;
+    for(u32 i = 0; i < memory->memoryTypeCount; ++i)
+    {
+        //small heaps (e.g. 256MiB device local host visible windows) get proportionally smaller blocks
+        VkDeviceSize heapSize = memory->memoryHeaps[memory->memoryTypes[i].heapIndex].size;
+        VkDeviceSize blockSize = VULKAN_MEMORY_DEFAULT_BLOCK_SIZE;
+        while(blockSize > heapSize / 8 && blockSize > (1ull << 20))
+            blockSize >>= 1;
+
+        allocator->blockSize[i] = blockSize;
+        allocator->orderCount[i] = BuddyLog2(blockSize) - VULKAN_MEMORY_MIN_NODE_SHIFT + 1;
+        allocator->blocks[i] = DArrayCreate(VulkanMemoryBlock);
+    }
+
+    LOG_INFO("Vulkan device memory allocator initialized (granularity %llu bytes, allocation limit %u).",
+        (u64)allocator->bufferImageGranularity,
+        _context->device.properties.limits.maxMemoryAllocationCount);
+    return TRUE;
+}
+
+void VulkanMemoryShutdown(VulkanContext* _context)
+{
+    VulkanMemoryAllocator* allocator = &_context->memoryAllocator;
+
+    for(u32 i = 0; i < VK_MAX_MEMORY_TYPES; ++i)
+    {
+        if(!allocator->blocks[i])
+            continue;
+
+        u64 blockCount = DArrayLength(allocator->blocks[i]);
+        for(u64 j = 0; j < blockCount; ++j)
+        {
+            VulkanMemoryBlock* block = &allocator->blocks[i][j];
+            if(!block->memory)
+                continue;
+
+            if(block->used != 0)
+            {
+                LOG_WARN("Vulkan memory block (type %u) still has %llu bytes in use at shutdown.", i, (u64)block->used);
+            }
+
+            DestroyMemoryBlock(_context, i, block);
+        }
+
+        DArrayDestroy(allocator->blocks[i]);
+        allocator->blocks[i] = 0;
+    }
+
+    if(allocator->deviceAllocationCount != 0)
+    {
+        LOG_WARN("%u dedicated Vulkan allocations were not freed before shutdown.", allocator->deviceAllocationCount);
+    }
+}
+
+b8 VulkanMemoryAllocate(
+    VulkanContext* _context,
+    const VkMemoryRequirements* _requirements,
+    VkMemoryPropertyFlags _propertyFlags,
+    b8 _optimal,
+    VulkanMemoryAllocation* _outAllocation)
+{
+    VulkanMemoryAllocator* allocator = &_context->memoryAllocator;
+    cZeroMemory(_outAllocation, sizeof(VulkanMemoryAllocation));
+
+    i32 memoryType = _context->FindMemoryIndex(_requirements->memoryTypeBits, _propertyFlags);
+    if(memoryType == -1)
+    {
+        LOG_ERROR("Required memory type not found.");
+        return FALSE;
+    }
+
+    //large resources get their own allocation, a buddy node that size would waste too much of a block
+    VkDeviceSize blockSize = allocator->blockSize[memoryType];
+    if(_requirements->size > blockSize / 2)
+        return AllocateDedicated(_context, _requirements->size, memoryType, _outAllocation);
+
+    //buddy nodes are aligned to their own size, so rounding the request up to a power of two covers the alignment
+    VkDeviceSize nodeSize = _requirements->size;
+    if(nodeSize < _requirements->alignment)
+        nodeSize = _requirements->alignment;
+    if(nodeSize < (1ull << VULKAN_MEMORY_MIN_NODE_SHIFT))
+        nodeSize = 1ull << VULKAN_MEMORY_MIN_NODE_SHIFT;
+    nodeSize = BuddyRoundUp(nodeSize);
+
+    u8 order = BuddyLog2(nodeSize) - VULKAN_MEMORY_MIN_NODE_SHIFT;
+    u8 orderCount = allocator->orderCount[memoryType];
+
+    //linear and optimal resources must not share a granularity page. Nodes never share a page smaller than
+    //the minimum node, larger granularities keep the two kinds in separate blocks
+    if(allocator->bufferImageGranularity <= (1ull << VULKAN_MEMORY_MIN_NODE_SHIFT))
+        _optimal = FALSE;
+
+    //first fit over the existing blocks of the same kind
+    VkDeviceSize offset = 0;
+    i32 blockIndex = -1;
+    u64 blockCount = DArrayLength(allocator->blocks[memoryType]);
+    for(u64 i = 0; i < blockCount; ++i)
+    {
+        VulkanMemoryBlock* block = &allocator->blocks[memoryType][i];
+        if(block->memory && block->optimal == _optimal && BuddyAllocate(block, order, orderCount, &offset))
+        {
+            blockIndex = (i32)i;
+            break;
+        }
+    }
+
+    //no room, reserve another block
+    if(blockIndex == -1)
+    {
+        if(!CreateMemoryBlock(_context, memoryType, _optimal, &blockIndex))
+            return FALSE;
+
+        if(!BuddyAllocate(&allocator->blocks[memoryType][blockIndex], order, orderCount, &offset))
+        {
+            LOG_ERROR("Vulkan memory allocation of %llu bytes failed on a fresh block.", (u64)nodeSize);
+            return FALSE;
+        }
+    }
+
+    VulkanMemoryBlock* block = &allocator->blocks[memoryType][blockIndex];
+    block->used += nodeSize;
+
+    u32 heapIndex = _context->device.memory.memoryTypes[memoryType].heapIndex;
+    allocator->heapUsed[heapIndex] += nodeSize;
+    allocator->heapAllocationCount[heapIndex]++;
+
+    _outAllocation->memory = block->memory;
+    _outAllocation->offset = offset;
+    _outAllocation->size = nodeSize;
+    _outAllocation->memoryTypeIndex = memoryType;
+    _outAllocation->blockIndex = blockIndex;
+    _outAllocation->order = order;
+    _outAllocation->mappedData = block->mapped ? (u8*)block->mapped + offset : 0;
+
+    return TRUE;
+}
+
+void VulkanMemoryFree(VulkanContext* _context, VulkanMemoryAllocation* _allocation)
+{
+    if(!_allocation->memory)
+        return;
+
+    VulkanMemoryAllocator* allocator = &_context->memoryAllocator;
+    u32 memoryType = _allocation->memoryTypeIndex;
+    u32 heapIndex = _context->device.memory.memoryTypes[memoryType].heapIndex;
+
+    allocator->heapUsed[heapIndex] -= _allocation->size;
+    allocator->heapAllocationCount[heapIndex]--;
+
+    if(_allocation->blockIndex == VULKAN_MEMORY_DEDICATED_BLOCK)
+    {
+        //mapping is implicitly released with the memory
+        vkFreeMemory(_context->device.logicalDevice, _allocation->memory, _context->allocator);
+        allocator->heapReserved[heapIndex] -= _allocation->size;
+        allocator->deviceAllocationCount--;
+    }
+    else
+    {
+        VulkanMemoryBlock* block = &allocator->blocks[memoryType][_allocation->blockIndex];
+        BuddyFree(block, _allocation->offset, _allocation->order, allocator->orderCount[memoryType]);
+        block->used -= _allocation->size;
+
+        //keep the first block of each type around to avoid churn when a single resource is recreated
+        if(block->used == 0 && _allocation->blockIndex != 0)
+            DestroyMemoryBlock(_context, memoryType, block);
+    }
+
+    cZeroMemory(_allocation, sizeof(VulkanMemoryAllocation));
+}
+
+char* VulkanMemoryGetUsageStr(VulkanContext* _context)
+{
+    VulkanMemoryAllocator* allocator = &_context->memoryAllocator;
+    const VkPhysicalDeviceMemoryProperties* memory = &_context->device.memory;
+
+    char buffer[8000] = "Device memory use (heap, used/reserved):\n";
+    u64 offset = StringLength(buffer);
+    for(u32 i = 0; i < memory->memoryHeapCount; ++i)
+    {
+        VkDeviceSize values[2] = { allocator->heapUsed[i], allocator->heapReserved[i] };
+        char units[2][4];
+        f32 amounts[2];
+        for(u32 j = 0; j < 2; ++j)
+            FormatMemorySize(values[j], &amounts[j], units[j]);
+
+        const char* heapType = (memory->memoryHeaps[i].flags & VK_MEMORY_HEAP_DEVICE_LOCAL_BIT) ? "DEVICE_LOCAL" : "HOST        ";
+        i32 length = snprintf(buffer + offset, 8000 - offset, "  HEAP %u %s: %.2f%s / %.2f%s (%u allocations)\n",
+            i, heapType, amounts[0], units[0], amounts[1], units[1], allocator->heapAllocationCount[i]);
+        offset += length;
+    }
+
+    snprintf(buffer + offset, 8000 - offset, "  vkAllocateMemory calls live: %u / %u\n",
+        allocator->deviceAllocationCount,
+        _context->device.properties.limits.maxMemoryAllocationCount);
+
+    return StringDuplicate(buffer);
+}
+
+u64 BuddyRoundUp(u64 _value)
+{
+    u64 result = 1;
+    while(result < _value)
+        result <<= 1;
+
+    return result;
+}
+
+u8 BuddyLog2(u64 _value)
+{
+    u8 result = 0;
+    while(_value > 1)
+    {
+        _value >>= 1;
+        result++;
+    }
+
+    return result;
+}
+
+b8 BuddyAllocate(VulkanMemoryBlock* _block, u8 _order, u8 _orderCount, VkDeviceSize* _outOffset)
+{
+    //find the smallest free node that fits
+    u8 current = _order;
+    while(current < _orderCount && DArrayLength(_block->freeLists[current]) == 0)
+        current++;
+
+    if(current >= _orderCount)
+        return FALSE;
+
+    VkDeviceSize offset;
+    DArrayPop(_block->freeLists[current], &offset);
+
+    //split down to the requested order, the upper halves become free buddies
+    while(current > _order)
+    {
+        current--;
+        VkDeviceSize buddy = offset + (1ull << (current + VULKAN_MEMORY_MIN_NODE_SHIFT));
+        DArrayPush(_block->freeLists[current], buddy);
+    }
+
+    *_outOffset = offset;
+    return TRUE;
+}
+
+void BuddyFree(VulkanMemoryBlock* _block, VkDeviceSize _offset, u8 _order, u8 _orderCount)
+{
+    //merge with the buddy for as long as it is also free
+    while(_order + 1 < _orderCount)
+    {
+        VkDeviceSize buddy = _offset ^ (1ull << (_order + VULKAN_MEMORY_MIN_NODE_SHIFT));
+        VkDeviceSize* list = _block->freeLists[_order];
+        u64 length = DArrayLength(list);
+
+        b8 found = FALSE;
+        for(u64 i = 0; i < length; ++i)
+        {
+            if(list[i] == buddy)
+            {
+                //order within a free list does not matter, swap remove
+                list[i] = list[length - 1];
+                DArrayLengthSet(list, length - 1);
+                found = TRUE;
+                break;
+            }
+        }
+
+        if(!found)
+            break;
+
+        _offset = _offset < buddy ? _offset : buddy;
+        _order++;
+    }
+
+    DArrayPush(_block->freeLists[_order], _offset);
+}
+
+b8 CreateMemoryBlock(VulkanContext* _context, u32 _memoryTypeIndex, b8 _optimal, i32* _outBlockIndex)
+{
+    VulkanMemoryAllocator* allocator = &_context->memoryAllocator;
+    VkDeviceSize blockSize = allocator->blockSize[_memoryTypeIndex];
+
+    VulkanMemoryBlock block;
+    cZeroMemory(&block, sizeof(VulkanMemoryBlock));
+    block.optimal = _optimal;
+
+    VkMemoryAllocateInfo allocateInfo = { VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_INFO };
+    allocateInfo.allocationSize = blockSize;
+    allocateInfo.memoryTypeIndex = _memoryTypeIndex;
+    VkResult result = vkAllocateMemory(_context->device.logicalDevice, &allocateInfo, _context->allocator, &block.memory);
+    if(result != VK_SUCCESS)
+    {
+        LOG_ERROR("Failed to reserve a %llu byte Vulkan memory block for type %u.", (u64)blockSize, _memoryTypeIndex);
+        return FALSE;
+    }
+
+    //a VkDeviceMemory may only be mapped once, so host visible blocks are mapped for their whole lifetime
+    if(_context->device.memory.memoryTypes[_memoryTypeIndex].propertyFlags & VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT)
+        VK_CHECK(vkMapMemory(_context->device.logicalDevice, block.memory, 0, VK_WHOLE_SIZE, 0, &block.mapped));
+
+    u8 orderCount = allocator->orderCount[_memoryTypeIndex];
+    for(u8 i = 0; i < orderCount; ++i)
+        block.freeLists[i] = DArrayCreate(VkDeviceSize);
+
+    //the whole block starts as one free node of the highest order
+    VkDeviceSize zero = 0;
+    DArrayPush(block.freeLists[orderCount - 1], zero);
+
+    u32 heapIndex = _context->device.memory.memoryTypes[_memoryTypeIndex].heapIndex;
+    allocator->heapReserved[heapIndex] += blockSize;
+    allocator->deviceAllocationCount++;
+
+    //reuse a released slot so existing block indices stay valid
+    u64 blockCount = DArrayLength(allocator->blocks[_memoryTypeIndex]);
+    for(u64 i = 0; i < blockCount; ++i)
+    {
+        if(!allocator->blocks[_memoryTypeIndex][i].memory)
+        {
+            allocator->blocks[_memoryTypeIndex][i] = block;
+            *_outBlockIndex = (i32)i;
+            return TRUE;
+        }
+    }
+
+    DArrayPush(allocator->blocks[_memoryTypeIndex], block);
+    *_outBlockIndex = (i32)blockCount;
+
+    LOG_DEBUG("Reserved Vulkan memory block %llu for type %u (%llu bytes).", blockCount, _memoryTypeIndex, (u64)blockSize);
+    return TRUE;
+}
+
+void DestroyMemoryBlock(VulkanContext* _context, u32 _memoryTypeIndex, VulkanMemoryBlock* _block)
+{
+    VulkanMemoryAllocator* allocator = &_context->memoryAllocator;
+
+    vkFreeMemory(_context->device.logicalDevice, _block->memory, _context->allocator);
+
+    for(u32 i = 0; i < VULKAN_MEMORY_MAX_ORDERS; ++i)
+    {
+        if(_block->freeLists[i])
+            DArrayDestroy(_block->freeLists[i]);
+    }
+
+    u32 heapIndex = _context->device.memory.memoryTypes[_memoryTypeIndex].heapIndex;
+    allocator->heapReserved[heapIndex] -= allocator->blockSize[_memoryTypeIndex];
+    allocator->deviceAllocationCount--;
+
+    cZeroMemory(_block, sizeof(VulkanMemoryBlock));
+}
+
+b8 AllocateDedicated(VulkanContext* _context, VkDeviceSize _size, u32 _memoryTypeIndex, VulkanMemoryAllocation* _outAllocation)
+{
+    VulkanMemoryAllocator* allocator = &_context->memoryAllocator;
+
+    VkMemoryAllocateInfo allocateInfo = { VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_INFO };
+    allocateInfo.allocationSize = _size;
+    allocateInfo.memoryTypeIndex = _memoryTypeIndex;
+    VkResult result = vkAllocateMemory(_context->device.logicalDevice, &allocateInfo, _context->allocator, &_outAllocation->memory);
+    if(result != VK_SUCCESS)
+    {
+        LOG_ERROR("Dedicated Vulkan allocation of %llu bytes failed.", (u64)_size);
+        return FALSE;
+    }
+
+    if(_context->device.memory.memoryTypes[_memoryTypeIndex].propertyFlags & VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT)
+        VK_CHECK(vkMapMemory(_context->device.logicalDevice, _outAllocation->memory, 0, VK_WHOLE_SIZE, 0, &_outAllocation->mappedData));
+
+    _outAllocation->offset = 0;
+    _outAllocation->size = _size;
+    _outAllocation->memoryTypeIndex = _memoryTypeIndex;
+    _outAllocation->blockIndex = VULKAN_MEMORY_DEDICATED_BLOCK;
+    _outAllocation->order = 0;
+
+    u32 heapIndex = _context->device.memory.memoryTypes[_memoryTypeIndex].heapIndex;
+    allocator->heapUsed[heapIndex] += _size;
+    allocator->heapReserved[heapIndex] += _size;
+    allocator->heapAllocationCount[heapIndex]++;
+    allocator->deviceAllocationCount++;
+
+    return TRUE;
+}
\ No newline at end of file
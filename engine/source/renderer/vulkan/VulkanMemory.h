@@ -0,0 +1,35 @@
+#pragma once
+
+#include "VulkanTypes.inl"
+
+/**
+ * Device memory sub-allocator. Memory is reserved from the driver in large blocks per memory type
+ * and handed out with a buddy scheme, keeping the vkAllocateMemory count far below
+ * maxMemoryAllocationCount. Requests larger than half a block get a dedicated allocation.
+ * Host visible blocks are persistently mapped, see VulkanMemoryAllocation.mappedData.
+ */
+b8 VulkanMemoryInitialize(VulkanContext* _context);
+
+void VulkanMemoryShutdown(VulkanContext* _context);
+
+/**
+ * Allocates memory satisfying the given requirements from a memory type with _propertyFlags.
+ * _optimal is TRUE for optimally tiled images and FALSE for buffers and linear images. When
+ * bufferImageGranularity is coarser than the smallest node the two kinds come from separate
+ * blocks, so small buffers are not padded to the granularity.
+ * @returns TRUE on success, otherwise FALSE.
+ */
+b8 VulkanMemoryAllocate(
+    VulkanContext* _context,
+    const VkMemoryRequirements* _requirements,
+    VkMemoryPropertyFlags _propertyFlags,
+    b8 _optimal,
+    VulkanMemoryAllocation* _outAllocation);
+
+void VulkanMemoryFree(VulkanContext* _context, VulkanMemoryAllocation* _allocation);
+
+/**
+ * Returns a string describing device memory use per heap, in the same format as GetMemoryUsageStr.
+ * The string is allocated with MEMORY_TAG_STRING and must be freed by the caller.
+ */
+char* VulkanMemoryGetUsageStr(VulkanContext* _context);
\ No newline at end of file
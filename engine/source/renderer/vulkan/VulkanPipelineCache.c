@@ -0,0 +1,289 @@
+#include "VulkanPipelineCache.h"
+#include "VulkanUtils.h"
+
+#include "core/Logger.h"
+#include "core/CMemory.h"
+#include "core/Job.h"
+#include "platform/Filesystem.h"
+#include "platform/Platform.h"
+
+#include <stdio.h>
+
+//"CPLC" little endian
+#define PIPELINE_CACHE_FILE_MAGIC 0x434C5043
+#define PIPELINE_CACHE_FILE_VERSION 1
+
+//engine side header, written in front of the driver blob to catch truncated or corrupted files
+//before they are handed to the driver
+typedef struct VulkanPipelineCacheFileHeader
+{
+    u32 magic;
+    u32 version;
+    u64 dataSize;
+    u64 dataHash;
+} VulkanPipelineCacheFileHeader;
+
+//shared by the jobs of one batch, exactly one of the create info arrays is set
+typedef struct VulkanPipelineCreateJob
+{
+    VulkanContext* context;
+    const VkGraphicsPipelineCreateInfo* graphicsInfos;
+    const VkComputePipelineCreateInfo* computeInfos;
+    VkPipeline* pipelines;
+    VkResult result;
+} VulkanPipelineCreateJob;
+
+void BuildCachePath(VulkanContext* _context, char* _outPath, u64 _pathSize);
+VkResult PipelineCreateBatch(VulkanPipelineCreateJob* _job, u32 _count);
+void PipelineCreateJobRun(void* _data, u32 _index, u32 _threadIndex);
+b8 ValidateDriverHeader(VulkanContext* _context, const u8* _data, u64 _size);
+
+void VulkanPipelineCacheCreate(VulkanContext* _context)
+{
+    f64 startTime = PlatformGetAbsoluteTime();
+    cZeroMemory(&_context->pipelineCacheStats, sizeof(VulkanPipelineCacheStats));
+
+    char path[512];
+    BuildCachePath(_context, path, sizeof(path));
+
+    u8* fileData = 0;
+    u64 fileSize = 0;
+    const u8* initialData = 0;
+    u64 initialDataSize = 0;
+
+    FileHandle handle;
+    if(FilesystemExists(path) && FilesystemOpen(path, FILE_MODE_READ, TRUE, &handle))
+    {
+        if(FilesystemSize(&handle, &fileSize) && fileSize > sizeof(VulkanPipelineCacheFileHeader))
+        {
+            fileData = cAllocate(fileSize, MEMORY_TAG_RENDERER);
+            u64 bytesRead = 0;
+            if(!FilesystemReadAllBytes(&handle, fileData, &bytesRead))
+            {
+                LOG_WARN("Failed to read pipeline cache '%s', starting cold.", path);
+            }
+            else
+            {
+                VulkanPipelineCacheFileHeader* header = (VulkanPipelineCacheFileHeader*)fileData;
+                const u8* blob = fileData + sizeof(VulkanPipelineCacheFileHeader);
+                u64 blobSize = fileSize - sizeof(VulkanPipelineCacheFileHeader);
+
+                if(header->magic != PIPELINE_CACHE_FILE_MAGIC || header->version != PIPELINE_CACHE_FILE_VERSION)
+                {
+                    LOG_WARN("Pipeline cache '%s' has an unknown format, starting cold.", path);
+                }
+                else if(header->dataSize != blobSize || header->dataHash != VulkanHashBytes(blob, blobSize, VULKAN_HASH_SEED))
+                {
+                    LOG_WARN("Pipeline cache '%s' is truncated or corrupt, starting cold.", path);
+                }
+                else if(ValidateDriverHeader(_context, blob, blobSize))
+                {
+                    initialData = blob;
+                    initialDataSize = blobSize;
+                }
+            }
+        }
+
+        FilesystemClose(&handle);
+    }
+
+    VkPipelineCacheCreateInfo createInfo = { VK_STRUCTURE_TYPE_PIPELINE_CACHE_CREATE_INFO };
+    createInfo.initialDataSize = initialDataSize;
+    createInfo.pInitialData = initialData;
+
+    VkResult result = vkCreatePipelineCache(_context->device.logicalDevice, &createInfo, _context->allocator, &_context->pipelineCache);
+    if(result != VK_SUCCESS && initialData)
+    {
+        //the driver is the final judge of the blob, retry empty if it was rejected
+        LOG_WARN("Driver rejected pipeline cache data, starting cold.");
+        initialData = 0;
+        initialDataSize = 0;
+        createInfo.initialDataSize = 0;
+        createInfo.pInitialData = 0;
+        result = vkCreatePipelineCache(_context->device.logicalDevice, &createInfo, _context->allocator, &_context->pipelineCache);
+    }
+    VK_CHECK(result);
+
+    if(fileData)
+        cFree(fileData, fileSize, MEMORY_TAG_RENDERER);
+
+    _context->pipelineCacheStats.warm = initialData != 0;
+    _context->pipelineCacheStats.loadedBytes = initialDataSize;
+    _context->pipelineCacheStats.loadSeconds = PlatformGetAbsoluteTime() - startTime;
+
+    LOG_INFO("Vulkan pipeline cache created (%s, %llu bytes, %.3f ms).",
+        _context->pipelineCacheStats.warm ? "warm" : "cold",
+        _context->pipelineCacheStats.loadedBytes,
+        _context->pipelineCacheStats.loadSeconds * 1000.0);
+}
+
+void VulkanPipelineCacheDestroy(VulkanContext* _context)
+{
+    if(!_context->pipelineCache)
+        return;
+
+    VulkanPipelineCacheStats* stats = &_context->pipelineCacheStats;
+    LOG_INFO("Pipeline cache (%s): %u pipelines created in %.3f ms.",
+        stats->warm ? "warm" : "cold",
+        stats->pipelineCount,
+        stats->pipelineCreateSeconds * 1000.0);
+
+    VulkanPipelineCacheSave(_context);
+
+    vkDestroyPipelineCache(_context->device.logicalDevice, _context->pipelineCache, _context->allocator);
+    _context->pipelineCache = 0;
+}
+
+b8 VulkanPipelineCacheSave(VulkanContext* _context)
+{
+    if(!_context->pipelineCache)
+        return FALSE;
+
+    size_t dataSize = 0;
+    VK_CHECK(vkGetPipelineCacheData(_context->device.logicalDevice, _context->pipelineCache, &dataSize, 0));
+    if(dataSize == 0)
+        return FALSE;
+
+    u64 fileSize = sizeof(VulkanPipelineCacheFileHeader) + dataSize;
+    u8* fileData = cAllocate(fileSize, MEMORY_TAG_RENDERER);
+    u8* blob = fileData + sizeof(VulkanPipelineCacheFileHeader);
+
+    //the size may shrink between the two calls, never grow
+    VkResult result = vkGetPipelineCacheData(_context->device.logicalDevice, _context->pipelineCache, &dataSize, blob);
+    if(result != VK_SUCCESS)
+    {
+        LOG_WARN("vkGetPipelineCacheData failed, pipeline cache not saved.");
+        cFree(fileData, fileSize, MEMORY_TAG_RENDERER);
+        return FALSE;
+    }
+
+    VulkanPipelineCacheFileHeader* header = (VulkanPipelineCacheFileHeader*)fileData;
+    header->magic = PIPELINE_CACHE_FILE_MAGIC;
+    header->version = PIPELINE_CACHE_FILE_VERSION;
+    header->dataSize = dataSize;
+    header->dataHash = VulkanHashBytes(blob, dataSize, VULKAN_HASH_SEED);
+
+    char path[512];
+    BuildCachePath(_context, path, sizeof(path));
+    b8 saved = FilesystemWriteAtomic(path, sizeof(VulkanPipelineCacheFileHeader) + dataSize, fileData);
+    if(saved)
+    {
+        LOG_DEBUG("Pipeline cache saved to '%s' (%llu bytes).", path, (u64)dataSize);
+    }
+
+    cFree(fileData, fileSize, MEMORY_TAG_RENDERER);
+    return saved;
+}
+
+VkResult VulkanPipelineCacheCreateGraphicsPipelines(
+    VulkanContext* _context,
+    u32 _count,
+    const VkGraphicsPipelineCreateInfo* _createInfos,
+    VkPipeline* _outPipelines)
+{
+    VulkanPipelineCreateJob job = {};
+    job.context = _context;
+    job.graphicsInfos = _createInfos;
+    job.pipelines = _outPipelines;
+    return PipelineCreateBatch(&job, _count);
+}
+
+VkResult VulkanPipelineCacheCreateComputePipelines(
+    VulkanContext* _context,
+    u32 _count,
+    const VkComputePipelineCreateInfo* _createInfos,
+    VkPipeline* _outPipelines)
+{
+    VulkanPipelineCreateJob job = {};
+    job.context = _context;
+    job.computeInfos = _createInfos;
+    job.pipelines = _outPipelines;
+    return PipelineCreateBatch(&job, _count);
+}
+
+VkResult PipelineCreateBatch(VulkanPipelineCreateJob* _job, u32 _count)
+{
+    f64 startTime = PlatformGetAbsoluteTime();
+
+    _job->result = VK_SUCCESS;
+    JobRunParallel(PipelineCreateJobRun, _job, _count);
+
+    //wall time of the batch, so a warm cache still shows up against a cold one
+    _job->context->pipelineCacheStats.pipelineCount += _count;
+    _job->context->pipelineCacheStats.pipelineCreateSeconds += PlatformGetAbsoluteTime() - startTime;
+    return _job->result;
+}
+
+void PipelineCreateJobRun(void* _data, u32 _index, u32 _threadIndex)
+{
+    //the pipeline cache and the host allocator are internally synchronized
+    VulkanPipelineCreateJob* job = (VulkanPipelineCreateJob*)_data;
+    VulkanContext* context = job->context;
+    VkResult result;
+    if(job->graphicsInfos)
+        result = vkCreateGraphicsPipelines(context->device.logicalDevice, context->pipelineCache,
+            1, &job->graphicsInfos[_index], context->allocator, &job->pipelines[_index]);
+    else
+        result = vkCreateComputePipelines(context->device.logicalDevice, context->pipelineCache,
+            1, &job->computeInfos[_index], context->allocator, &job->pipelines[_index]);
+    if(result != VK_SUCCESS)
+    {
+        job->pipelines[_index] = 0;
+        __atomic_store_n(&job->result, result, __ATOMIC_RELAXED);
+    }
+}
+
+void BuildCachePath(VulkanContext* _context, char* _outPath, u64 _pathSize)
+{
+    //next to the binary so the cache does not depend on the working directory, relative if that cannot be queried
+    char directory[448];
+    if(!PlatformGetExecutableDirectory(directory, sizeof(directory)))
+    {
+        LOG_WARN("Executable directory unavailable, the pipeline cache is kept in the working directory.");
+        directory[0] = 0;
+    }
+
+    //one file per vendor/device pair so switching gpus does not thrash a single file
+    snprintf(_outPath, _pathSize, "%spipeline_cache_%04x_%04x.bin", directory,
+        _context->device.properties.vendorID,
+        _context->device.properties.deviceID);
+}
+
+b8 ValidateDriverHeader(VulkanContext* _context, const u8* _data, u64 _size)
+{
+    if(_size < sizeof(VkPipelineCacheHeaderVersionOne))
+    {
+        LOG_WARN("Pipeline cache blob too small, starting cold.");
+        return FALSE;
+    }
+
+    VkPipelineCacheHeaderVersionOne header;
+    cCopyMemory(&header, _data, sizeof(VkPipelineCacheHeaderVersionOne));
+
+    if(header.headerSize < sizeof(VkPipelineCacheHeaderVersionOne) || header.headerVersion != VK_PIPELINE_CACHE_HEADER_VERSION_ONE)
+    {
+        LOG_WARN("Pipeline cache has an unsupported header version, starting cold.");
+        return FALSE;
+    }
+
+    const VkPhysicalDeviceProperties* properties = &_context->device.properties;
+    if(header.vendorID != properties->vendorID || header.deviceID != properties->deviceID)
+    {
+        LOG_WARN("Pipeline cache was created for a different device, starting cold.");
+        return FALSE;
+    }
+
+    //driver updates change the uuid, old pipelines are useless to the new driver
+    const u8* a = header.pipelineCacheUUID;
+    const u8* b = properties->pipelineCacheUUID;
+    for(u32 i = 0; i < VK_UUID_SIZE; ++i)
+    {
+        if(a[i] != b[i])
+        {
+            LOG_INFO("Pipeline cache was created by a different driver version, starting cold.");
+            return FALSE;
+        }
+    }
+
+    return TRUE;
+}
\ No newline at end of file
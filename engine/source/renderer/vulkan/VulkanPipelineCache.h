@@ -0,0 +1,43 @@
+#pragma once
+
+#include "VulkanTypes.inl"
+
+/**
+ * Creates the context's pipeline cache, seeding it from the cache file on disk when that file
+ * was written by the same vendor, device and driver (pipelineCacheUUID). Invalid or stale files
+ * are ignored and an empty cache is created instead.
+ */
+void VulkanPipelineCacheCreate(VulkanContext* _context);
+
+/**
+ * Saves the pipeline cache to disk and destroys it.
+ */
+void VulkanPipelineCacheDestroy(VulkanContext* _context);
+
+/**
+ * Writes the current contents of the pipeline cache to disk. The file is replaced atomically
+ * so a crash mid-write never leaves a truncated cache behind.
+ * @returns TRUE if the cache was saved, otherwise FALSE.
+ */
+b8 VulkanPipelineCacheSave(VulkanContext* _context);
+
+/**
+ * Creates graphics pipelines through the context's cache, one job per pipeline on the job system so a
+ * batch compiles across every thread rather than serializing on the caller. Blocks until all are
+ * created, failed ones are 0. Must not be called from inside a job. Every pipeline of the backend is
+ * created through here or VulkanPipelineCacheCreateComputePipelines, so the cold and warm startup
+ * statistics time each batch the same way.
+ * @returns VK_SUCCESS, or the failure of one of the pipelines.
+ */
+VkResult VulkanPipelineCacheCreateGraphicsPipelines(
+    VulkanContext* _context,
+    u32 _count,
+    const VkGraphicsPipelineCreateInfo* _createInfos,
+    VkPipeline* _outPipelines);
+
+//compute counterpart of VulkanPipelineCacheCreateGraphicsPipelines
+VkResult VulkanPipelineCacheCreateComputePipelines(
+    VulkanContext* _context,
+    u32 _count,
+    const VkComputePipelineCreateInfo* _createInfos,
+    VkPipeline* _outPipelines);
\ No newline at end of file
@@ -0,0 +1,444 @@
+#include "VulkanRenderGraph.h"
+#include "VulkanImage.h"
+#include "VulkanRenderpass.h"
+#include "VulkanFramebuffer.h"
+#include "VulkanFrameCommands.h"
+#include "VulkanDeletionQueue.h"
+#include "VulkanTimestamps.h"
+
+#include "core/Logger.h"
+#include "core/CMemory.h"
+
+typedef struct VulkanGraphUsageInfo
+{
+    VkImageLayout layout;
+    VkPipelineStageFlags stages;
+    VkAccessFlags access;
+} VulkanGraphUsageInfo;
+
+VulkanGraphUsageInfo GraphUsageInfo(VulkanContext* _context, RenderGraphUsage _usage);
+VkFormat GraphFormat(VulkanContext* _context, RenderGraphFormat _format);
+void GraphExtent(VulkanContext* _context, f32 _scale, u32* _outWidth, u32* _outHeight);
+VulkanRenderpass* GraphAcquireRenderpass(VulkanContext* _context, VulkanRenderGraph* _graph, const VulkanRenderpassDesc* _desc);
+VkFramebuffer GraphAcquireFramebuffer(VulkanContext* _context, VulkanRenderGraph* _graph, VulkanRenderpass* _renderpass, u32 _width, u32 _height, u32 _attachmentCount, const VkImageView* _attachments);
+void GraphRecordBarriers(VulkanContext* _context, VulkanRenderGraph* _graph, const RenderGraph* _renderGraph, const RenderGraphBarrier* _barriers, u32 _barrierCount, VulkanCommandBuffer* _commandBuffer);
+
+b8 VulkanRenderGraphCreate(VulkanContext* _context, VulkanRenderGraph* _outGraph)
+{
+    cZeroMemory(_outGraph, sizeof(VulkanRenderGraph));
+    _outGraph->passTimestampScope = -1;
+    return TRUE;
+}
+
+void VulkanRenderGraphDestroy(VulkanContext* _context, VulkanRenderGraph* _graph)
+{
+    for(u32 i = 0; i < _graph->framebufferCount; ++i)
+        VulkanFramebufferDestroy(_context, &_graph->framebuffers[i].framebuffer);
+
+    for(u32 i = 0; i < _graph->renderpassCount; ++i)
+        VulkanRenderpassDestroy(_context, &_graph->renderpasses[i]);
+
+    for(u32 i = 0; i < RENDER_GRAPH_MAX_RESOURCES; ++i)
+    {
+        if(_graph->images[i].image.handle)
+            VulkanImageDestroy(_context, &_graph->images[i].image);
+    }
+
+    cZeroMemory(_graph, sizeof(VulkanRenderGraph));
+}
+
+void VulkanRenderGraphInvalidateFramebuffers(VulkanContext* _context, VulkanRenderGraph* _graph)
+{
+    for(u32 i = 0; i < _graph->framebufferCount; ++i)
+        VulkanDeletionQueueRetireFramebuffer(_context, &_context->deletionQueue, &_graph->framebuffers[i].framebuffer);
+
+    _graph->framebufferCount = 0;
+}
+
+b8 VulkanRenderGraphBegin(VulkanContext* _context, VulkanRenderGraph* _graph, const RenderGraph* _renderGraph)
+{
+    //the acquired image has no defined contents
+    _graph->backbufferUsage = RENDER_GRAPH_USAGE_UNDEFINED;
+    _graph->passActive = FALSE;
+    _graph->passRenderpass = 0;
+    _graph->passFramebuffer = 0;
+
+    for(u32 i = 0; i < _renderGraph->physicalCount; ++i)
+    {
+        const RenderGraphPhysical* physical = &_renderGraph->physicals[i];
+        VulkanGraphImage* image = &_graph->images[i];
+
+        VkFormat format = GraphFormat(_context, physical->format);
+        b8 isDepth = physical->format == RENDER_GRAPH_FORMAT_DEPTH;
+        u32 width, height;
+        GraphExtent(_context, physical->scale, &width, &height);
+
+        VkImageUsageFlags usage = 0;
+        if(physical->usageMask & (1 << RENDER_GRAPH_USAGE_COLOR_ATTACHMENT))
+            usage |= VK_IMAGE_USAGE_COLOR_ATTACHMENT_BIT;
+        if(physical->usageMask & ((1 << RENDER_GRAPH_USAGE_DEPTH_ATTACHMENT) | (1 << RENDER_GRAPH_USAGE_DEPTH_READ)))
+            usage |= VK_IMAGE_USAGE_DEPTH_STENCIL_ATTACHMENT_BIT;
+        if(physical->usageMask & (1 << RENDER_GRAPH_USAGE_SHADER_READ))
+            usage |= VK_IMAGE_USAGE_SAMPLED_BIT;
+
+        //attachments only ever cover the render area, so an image that is never sampled can stay
+        //larger than needed, shrinking the window does not reallocate it
+        b8 sampled = (usage & VK_IMAGE_USAGE_SAMPLED_BIT) != 0;
+        if(image->image.handle && image->format == format && (image->usage & usage) == usage)
+        {
+            if(image->image.width == width && image->image.height == height)
+                continue;
+            if(!sampled && width <= image->image.width && height <= image->image.height)
+                continue;
+        }
+
+        //frames in flight may still use the old image
+        if(image->image.handle)
+        {
+            VulkanDeletionQueueRetireImage(_context, &_context->deletionQueue, &image->image);
+            VulkanRenderGraphInvalidateFramebuffers(_context, _graph);
+        }
+
+        VulkanImageCreate(
+            _context,
+            VK_IMAGE_TYPE_2D,
+            width,
+            height,
+            format,
+            VK_IMAGE_TILING_OPTIMAL,
+            usage,
+            VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT,
+            TRUE,
+            isDepth ? VK_IMAGE_ASPECT_DEPTH_BIT : VK_IMAGE_ASPECT_COLOR_BIT,
+            &image->image);
+
+        if(!image->image.handle)
+        {
+            LOG_ERROR("Failed to create render graph image %ux%u.", width, height);
+            return FALSE;
+        }
+
+        image->format = format;
+        image->usage = usage;
+        image->lastUsage = RENDER_GRAPH_USAGE_UNDEFINED;
+        image->barrierAspect = VK_IMAGE_ASPECT_COLOR_BIT;
+        if(isDepth)
+        {
+            image->barrierAspect = VK_IMAGE_ASPECT_DEPTH_BIT;
+            if(format == VK_FORMAT_D32_SFLOAT_S8_UINT || format == VK_FORMAT_D24_UNORM_S8_UINT)
+                image->barrierAspect |= VK_IMAGE_ASPECT_STENCIL_BIT;
+        }
+    }
+
+    return TRUE;
+}
+
+b8 VulkanRenderGraphBeginPass(VulkanContext* _context, VulkanRenderGraph* _graph, const RenderGraph* _renderGraph, u32 _passIndex, VulkanCommandBuffer* _commandBuffer)
+{
+    const RenderGraphPass* pass = &_renderGraph->passes[_passIndex];
+    GraphRecordBarriers(_context, _graph, _renderGraph, pass->barriers, pass->barrierCount, _commandBuffer);
+
+    _graph->passTimestampScope = VulkanTimestampsBeginScope(&_context->timestamps, _commandBuffer, pass->name);
+    _graph->passActive = FALSE;
+    _graph->passRenderpass = 0;
+    _graph->passFramebuffer = 0;
+
+    //attachments in render pass order, colors first then depth
+    VulkanRenderpassDesc desc;
+    cZeroMemory(&desc, sizeof(VulkanRenderpassDesc));
+    desc.depthFormat = VK_FORMAT_UNDEFINED;
+    VkImageView views[RENDER_GRAPH_MAX_COLOR_ATTACHMENTS + 1];
+    VkClearValue clearValues[RENDER_GRAPH_MAX_COLOR_ATTACHMENTS + 1];
+    cZeroMemory(clearValues, sizeof(clearValues));
+    const RenderGraphPassUse* depthUse = 0;
+    f32 scale = 1.f;
+
+    for(u32 i = 0; i < pass->useCount; ++i)
+    {
+        const RenderGraphPassUse* use = &pass->uses[i];
+        const RenderGraphResource* resource = &_renderGraph->resources[use->resource];
+        if(use->usage == RENDER_GRAPH_USAGE_DEPTH_ATTACHMENT || use->usage == RENDER_GRAPH_USAGE_DEPTH_READ)
+        {
+            depthUse = use;
+            scale = resource->desc.scale;
+            continue;
+        }
+        if(use->usage != RENDER_GRAPH_USAGE_COLOR_ATTACHMENT)
+            continue;
+
+        u32 index = desc.colorCount++;
+        if(resource->imported)
+        {
+            desc.colorFormats[index] = _context->swapchain.imageFormat.format;
+            views[index] = _context->swapchain.views[_context->imageIndex];
+        }
+        else
+        {
+            desc.colorFormats[index] = _graph->images[resource->physicalIndex].format;
+            views[index] = _graph->images[resource->physicalIndex].image.view;
+        }
+
+        if(use->clear)
+            desc.clearMask |= 1 << index;
+        if(use->store)
+            desc.storeMask |= 1 << index;
+        for(u32 j = 0; j < 4; ++j)
+            clearValues[index].color.float32[j] = resource->desc.clearValue[j];
+        scale = resource->desc.scale;
+    }
+
+    u32 attachmentCount = desc.colorCount;
+    if(depthUse)
+    {
+        const RenderGraphResource* resource = &_renderGraph->resources[depthUse->resource];
+        VulkanGraphImage* image = &_graph->images[resource->physicalIndex];
+        desc.depthFormat = image->format;
+        desc.depthReadOnly = depthUse->usage == RENDER_GRAPH_USAGE_DEPTH_READ;
+        if(depthUse->clear)
+            desc.clearMask |= 1 << attachmentCount;
+        if(depthUse->store)
+            desc.storeMask |= 1 << attachmentCount;
+        clearValues[attachmentCount].depthStencil.depth = resource->desc.clearValue[0];
+        clearValues[attachmentCount].depthStencil.stencil = 0;
+        views[attachmentCount++] = image->image.view;
+    }
+
+    //no attachments, barriers only
+    if(attachmentCount == 0)
+        return TRUE;
+
+    u32 width, height;
+    GraphExtent(_context, scale, &width, &height);
+
+    _graph->passDesc = desc;
+    _graph->passWidth = width;
+    _graph->passHeight = height;
+
+    //attachments are referenced directly, nothing to create or look up
+    if(_context->dynamicRendering)
+    {
+        VulkanRenderpassBeginRendering(_commandBuffer, &desc, views, width, height, clearValues, TRUE);
+        _graph->passActive = TRUE;
+        return TRUE;
+    }
+
+    VulkanRenderpass* renderpass = GraphAcquireRenderpass(_context, _graph, &desc);
+    if(!renderpass)
+        return FALSE;
+
+    VkFramebuffer framebuffer = GraphAcquireFramebuffer(_context, _graph, renderpass, width, height, attachmentCount, views);
+    if(!framebuffer)
+        return FALSE;
+
+    _graph->passActive = TRUE;
+    _graph->passRenderpass = renderpass;
+    _graph->passFramebuffer = framebuffer;
+
+    //everything inside the pass is recorded into secondaries by RecordDraws
+    VulkanRenderpassBegin(_commandBuffer, renderpass, framebuffer, width, height, clearValues, VK_SUBPASS_CONTENTS_SECONDARY_COMMAND_BUFFERS);
+    return TRUE;
+}
+
+void VulkanRenderGraphEndPass(VulkanContext* _context, VulkanRenderGraph* _graph, VulkanFrameCommands* _commands)
+{
+    if(_graph->passActive)
+    {
+        VulkanFrameCommandsExecuteSecondaries(_commands);
+        if(_graph->passRenderpass)
+            VulkanRenderpassEnd(&_commands->primary, _graph->passRenderpass);
+        else
+            VulkanRenderpassEndRendering(&_commands->primary);
+    }
+
+    VulkanTimestampsEndScope(&_context->timestamps, &_commands->primary, _graph->passTimestampScope);
+    _graph->passTimestampScope = -1;
+    _graph->passActive = FALSE;
+    _graph->passRenderpass = 0;
+    _graph->passFramebuffer = 0;
+}
+
+void VulkanRenderGraphEnd(VulkanContext* _context, VulkanRenderGraph* _graph, const RenderGraph* _renderGraph, VulkanCommandBuffer* _commandBuffer)
+{
+    GraphRecordBarriers(_context, _graph, _renderGraph, _renderGraph->finalBarriers, _renderGraph->finalBarrierCount, _commandBuffer);
+}
+
+VulkanGraphUsageInfo GraphUsageInfo(VulkanContext* _context, RenderGraphUsage _usage)
+{
+    VulkanGraphUsageInfo info;
+    switch(_usage)
+    {
+        case RENDER_GRAPH_USAGE_COLOR_ATTACHMENT:
+            info.layout = VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL;
+            info.stages = VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT;
+            info.access = VK_ACCESS_COLOR_ATTACHMENT_READ_BIT | VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT;
+            break;
+        case RENDER_GRAPH_USAGE_DEPTH_ATTACHMENT:
+            info.layout = VK_IMAGE_LAYOUT_DEPTH_STENCIL_ATTACHMENT_OPTIMAL;
+            info.stages = VK_PIPELINE_STAGE_EARLY_FRAGMENT_TESTS_BIT | VK_PIPELINE_STAGE_LATE_FRAGMENT_TESTS_BIT;
+            info.access = VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_READ_BIT | VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_WRITE_BIT;
+            break;
+        case RENDER_GRAPH_USAGE_DEPTH_READ:
+            info.layout = VK_IMAGE_LAYOUT_DEPTH_STENCIL_READ_ONLY_OPTIMAL;
+            info.stages = VK_PIPELINE_STAGE_EARLY_FRAGMENT_TESTS_BIT | VK_PIPELINE_STAGE_LATE_FRAGMENT_TESTS_BIT | VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT;
+            info.access = VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_READ_BIT | VK_ACCESS_SHADER_READ_BIT;
+            break;
+        case RENDER_GRAPH_USAGE_SHADER_READ:
+            info.layout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
+            info.stages = VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT | VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT;
+            info.access = VK_ACCESS_SHADER_READ_BIT;
+            break;
+        case RENDER_GRAPH_USAGE_PRESENT:
+            //the present layout needs the swapchain extension, headless images are left ready to be copied out
+            info.layout = _context->surface ? VK_IMAGE_LAYOUT_PRESENT_SRC_KHR : VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL;
+            info.stages = VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT;
+            info.access = 0;
+            break;
+        case RENDER_GRAPH_USAGE_UNDEFINED:
+        default:
+            info.layout = VK_IMAGE_LAYOUT_UNDEFINED;
+            info.stages = VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT;
+            info.access = 0;
+            break;
+    }
+
+    return info;
+}
+
+VkFormat GraphFormat(VulkanContext* _context, RenderGraphFormat _format)
+{
+    switch(_format)
+    {
+        case RENDER_GRAPH_FORMAT_RGBA8:
+            return VK_FORMAT_R8G8B8A8_UNORM;
+        case RENDER_GRAPH_FORMAT_RGBA16F:
+            return VK_FORMAT_R16G16B16A16_SFLOAT;
+        case RENDER_GRAPH_FORMAT_DEPTH:
+            return _context->device.depthFormat;
+        case RENDER_GRAPH_FORMAT_BACKBUFFER:
+        default:
+            return _context->swapchain.imageFormat.format;
+    }
+}
+
+void GraphExtent(VulkanContext* _context, f32 _scale, u32* _outWidth, u32* _outHeight)
+{
+    u32 width = (u32)((f32)_context->swapchain.extent.width * _scale);
+    u32 height = (u32)((f32)_context->swapchain.extent.height * _scale);
+    *_outWidth = width ? width : 1;
+    *_outHeight = height ? height : 1;
+}
+
+VulkanRenderpass* GraphAcquireRenderpass(VulkanContext* _context, VulkanRenderGraph* _graph, const VulkanRenderpassDesc* _desc)
+{
+    for(u32 i = 0; i < _graph->renderpassCount; ++i)
+    {
+        if(VulkanRenderpassDescEqual(&_graph->renderpasses[i].desc, _desc))
+            return &_graph->renderpasses[i];
+    }
+
+    if(_graph->renderpassCount == VULKAN_MAX_GRAPH_RENDERPASSES)
+    {
+        LOG_ERROR("Render graph render pass cache is full.");
+        return 0;
+    }
+
+    VulkanRenderpass* renderpass = &_graph->renderpasses[_graph->renderpassCount++];
+    VulkanRenderpassCreate(_context, _desc, renderpass);
+    return renderpass;
+}
+
+VkFramebuffer GraphAcquireFramebuffer(VulkanContext* _context, VulkanRenderGraph* _graph, VulkanRenderpass* _renderpass, u32 _width, u32 _height, u32 _attachmentCount, const VkImageView* _attachments)
+{
+    for(u32 i = 0; i < _graph->framebufferCount; ++i)
+    {
+        VulkanGraphFramebuffer* cached = &_graph->framebuffers[i];
+        if(cached->renderpass != _renderpass->handle || cached->width != _width || cached->height != _height || cached->attachmentCount != _attachmentCount)
+            continue;
+
+        b8 match = TRUE;
+        for(u32 j = 0; j < _attachmentCount && match; ++j)
+            match = cached->attachments[j] == _attachments[j];
+
+        if(match)
+            return cached->framebuffer.handle;
+    }
+
+    //one framebuffer per swapchain image and pass is typical, starting over only happens after unusual graph churn
+    if(_graph->framebufferCount == VULKAN_MAX_GRAPH_FRAMEBUFFERS)
+        VulkanRenderGraphInvalidateFramebuffers(_context, _graph);
+
+    VulkanGraphFramebuffer* cached = &_graph->framebuffers[_graph->framebufferCount++];
+    cached->renderpass = _renderpass->handle;
+    cached->width = _width;
+    cached->height = _height;
+    cached->attachmentCount = _attachmentCount;
+    for(u32 i = 0; i < _attachmentCount; ++i)
+        cached->attachments[i] = _attachments[i];
+
+    VulkanFramebufferCreate(_context, _renderpass, _width, _height, _attachmentCount, cached->attachments, &cached->framebuffer);
+    return cached->framebuffer.handle;
+}
+
+void GraphRecordBarriers(VulkanContext* _context, VulkanRenderGraph* _graph, const RenderGraph* _renderGraph, const RenderGraphBarrier* _barriers, u32 _barrierCount, VulkanCommandBuffer* _commandBuffer)
+{
+    if(_barrierCount == 0)
+        return;
+
+    VkImageMemoryBarrier imageBarriers[RENDER_GRAPH_MAX_RESOURCES];
+    VkPipelineStageFlags srcStages = 0;
+    VkPipelineStageFlags dstStages = 0;
+    u32 count = 0;
+
+    for(u32 i = 0; i < _barrierCount; ++i)
+    {
+        const RenderGraphBarrier* barrier = &_barriers[i];
+        const RenderGraphResource* resource = &_renderGraph->resources[barrier->resource];
+
+        //the state tracked here also knows what earlier frames left the image in
+        VkImage handle;
+        VkImageAspectFlags aspect;
+        RenderGraphUsage* lastUsage;
+        if(resource->imported)
+        {
+            handle = _context->swapchain.images[_context->imageIndex];
+            aspect = VK_IMAGE_ASPECT_COLOR_BIT;
+            lastUsage = &_graph->backbufferUsage;
+        }
+        else
+        {
+            VulkanGraphImage* image = &_graph->images[resource->physicalIndex];
+            handle = image->image.handle;
+            aspect = image->barrierAspect;
+            lastUsage = &image->lastUsage;
+        }
+
+        VulkanGraphUsageInfo src = GraphUsageInfo(_context, *lastUsage);
+        VulkanGraphUsageInfo dst = GraphUsageInfo(_context, barrier->newUsage);
+
+        //a fresh swapchain image chains with the acquire semaphore, waited on at color attachment output
+        if(resource->imported && *lastUsage == RENDER_GRAPH_USAGE_UNDEFINED)
+            src.stages = VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT;
+
+        VkImageMemoryBarrier* imageBarrier = &imageBarriers[count++];
+        cZeroMemory(imageBarrier, sizeof(VkImageMemoryBarrier));
+        imageBarrier->sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER;
+        imageBarrier->srcAccessMask = src.access;
+        imageBarrier->dstAccessMask = dst.access;
+        imageBarrier->oldLayout = barrier->discard ? VK_IMAGE_LAYOUT_UNDEFINED : src.layout;
+        imageBarrier->newLayout = dst.layout;
+        imageBarrier->srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+        imageBarrier->dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+        imageBarrier->image = handle;
+        imageBarrier->subresourceRange.aspectMask = aspect;
+        imageBarrier->subresourceRange.baseMipLevel = 0;
+        imageBarrier->subresourceRange.levelCount = 1;
+        imageBarrier->subresourceRange.baseArrayLayer = 0;
+        imageBarrier->subresourceRange.layerCount = 1;
+
+        srcStages |= src.stages;
+        dstStages |= dst.stages;
+        *lastUsage = barrier->newUsage;
+    }
+
+    vkCmdPipelineBarrier(_commandBuffer->handle, srcStages, dstStages, 0, 0, 0, 0, 0, count, imageBarriers);
+}
\ No newline at end of file
@@ -0,0 +1,29 @@
+#pragma once
+
+#include "VulkanTypes.inl"
+
+/**
+ * Executes the frontend's RenderGraph. Transient images are allocated per aliasing slot and kept
+ * across frames, render passes and framebuffers are cached. Every pass records its barriers on the
+ * primary command buffer, then begins a render pass whose contents are recorded into secondaries.
+ * With _context->dynamicRendering passes begin dynamic rendering instead and nothing is cached
+ * besides the images.
+ */
+b8 VulkanRenderGraphCreate(VulkanContext* _context, VulkanRenderGraph* _outGraph);
+
+//destroys everything immediately, the device must be idle
+void VulkanRenderGraphDestroy(VulkanContext* _context, VulkanRenderGraph* _graph);
+
+//hands every cached framebuffer to the deletion queue, called when views they reference go away
+void VulkanRenderGraphInvalidateFramebuffers(VulkanContext* _context, VulkanRenderGraph* _graph);
+
+//makes sure every transient image of _graph exists with the current backbuffer size
+b8 VulkanRenderGraphBegin(VulkanContext* _context, VulkanRenderGraph* _graph, const RenderGraph* _renderGraph);
+
+b8 VulkanRenderGraphBeginPass(VulkanContext* _context, VulkanRenderGraph* _graph, const RenderGraph* _renderGraph, u32 _passIndex, VulkanCommandBuffer* _commandBuffer);
+
+//executes the secondaries recorded for the pass and ends its render pass
+void VulkanRenderGraphEndPass(VulkanContext* _context, VulkanRenderGraph* _graph, VulkanFrameCommands* _commands);
+
+//moves imported resources to their final usage, the backbuffer to present
+void VulkanRenderGraphEnd(VulkanContext* _context, VulkanRenderGraph* _graph, const RenderGraph* _renderGraph, VulkanCommandBuffer* _commandBuffer);
\ No newline at end of file
@@ -4,79 +4,77 @@
 #include "core/Logger.h"
 
 void VulkanRenderpassCreate(VulkanContext* _context, 
-    VulkanRenderpass* _outRenderpass, 
-    f32 _x, f32 _y, f32 _w, f32 _h, 
-    f32 _r, f32 _g, f32 _b, f32 _a, 
-    f32 _depth, u32 _stencil) 
+    const VulkanRenderpassDesc* _desc,
+    VulkanRenderpass* _outRenderpass) 
 {
     LOG_INFO("Creating Vulkan render pass...");
 
-    _outRenderpass->x = _x;
-    _outRenderpass->y = _y;
-    _outRenderpass->w = _w;
-    _outRenderpass->h = _h;
-
-    _outRenderpass->r = _r;
-    _outRenderpass->g = _g;
-    _outRenderpass->b = _b;
-    _outRenderpass->a = _a;
-
-    _outRenderpass->depth = _depth;
-    _outRenderpass->stencil = _stencil;
+    _outRenderpass->desc = *_desc;
 
     //create main subpass
     VkSubpassDescription subpass = {};
     subpass.pipelineBindPoint = VK_PIPELINE_BIND_POINT_GRAPHICS;
 
-    //attachments TODO: make configurable
-    u32 attachmentDescriptionCount = 2;
-    VkAttachmentDescription attachmentDescriptions[attachmentDescriptionCount];
-
-    //color attachment
-    VkAttachmentDescription colorAttachment;
-    colorAttachment.format = _context->swapchain.imageFormat.format; //TODO: make configurable
-    colorAttachment.samples = VK_SAMPLE_COUNT_1_BIT;
-    colorAttachment.loadOp = VK_ATTACHMENT_LOAD_OP_CLEAR;
-    colorAttachment.storeOp = VK_ATTACHMENT_STORE_OP_STORE;
-    colorAttachment.stencilLoadOp = VK_ATTACHMENT_LOAD_OP_DONT_CARE;
-    colorAttachment.stencilStoreOp = VK_ATTACHMENT_STORE_OP_DONT_CARE;
-    colorAttachment.initialLayout = VK_IMAGE_LAYOUT_UNDEFINED; //do not expect a particular layout before starting render pass.
-    colorAttachment.finalLayout = VK_IMAGE_LAYOUT_PRESENT_SRC_KHR; //transitioned to after the render pass.
-    colorAttachment.flags = 0;
-
-    attachmentDescriptions[0] = colorAttachment;
+    //color attachments first, then depth
+    VkAttachmentDescription attachmentDescriptions[RENDER_GRAPH_MAX_COLOR_ATTACHMENTS + 1];
+    VkAttachmentReference colorAttachmentReferences[RENDER_GRAPH_MAX_COLOR_ATTACHMENTS];
+    u32 attachmentDescriptionCount = 0;
 
-    //color attachment reference
-    VkAttachmentReference colorAttachmentReference;
-    colorAttachmentReference.attachment = 0; //attachment description array index
-    colorAttachmentReference.layout = VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL;
+    for(u32 i = 0; i < _desc->colorCount; ++i)
+    {
+        //barriers outside the render pass move the image into the attachment layout and out of it
+        VkAttachmentDescription colorAttachment = {};
+        colorAttachment.format = _desc->colorFormats[i];
+        colorAttachment.samples = VK_SAMPLE_COUNT_1_BIT;
+        colorAttachment.loadOp = (_desc->clearMask & (1 << i)) ? VK_ATTACHMENT_LOAD_OP_CLEAR : VK_ATTACHMENT_LOAD_OP_LOAD;
+        colorAttachment.storeOp = (_desc->storeMask & (1 << i)) ? VK_ATTACHMENT_STORE_OP_STORE : VK_ATTACHMENT_STORE_OP_DONT_CARE;
+        colorAttachment.stencilLoadOp = VK_ATTACHMENT_LOAD_OP_DONT_CARE;
+        colorAttachment.stencilStoreOp = VK_ATTACHMENT_STORE_OP_DONT_CARE;
+        colorAttachment.initialLayout = VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL;
+        colorAttachment.finalLayout = VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL;
+        colorAttachment.flags = 0;
+        attachmentDescriptions[attachmentDescriptionCount] = colorAttachment;
+
+        //color attachment reference
+        colorAttachmentReferences[i].attachment = attachmentDescriptionCount; //attachment description array index
+        colorAttachmentReferences[i].layout = VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL;
+        attachmentDescriptionCount++;
+    }
 
-    subpass.colorAttachmentCount = 1;
-    subpass.pColorAttachments = &colorAttachmentReference;
+    subpass.colorAttachmentCount = _desc->colorCount;
+    subpass.pColorAttachments = colorAttachmentReferences;
 
     //depth attachment, if there is one
-    VkAttachmentDescription depthAttachment = {};
-    depthAttachment.format = _context->device.depthFormat;
-    depthAttachment.samples = VK_SAMPLE_COUNT_1_BIT;
-    depthAttachment.loadOp = VK_ATTACHMENT_LOAD_OP_CLEAR;
-    depthAttachment.storeOp = VK_ATTACHMENT_STORE_OP_DONT_CARE;
-    depthAttachment.stencilLoadOp = VK_ATTACHMENT_LOAD_OP_DONT_CARE;
-    depthAttachment.stencilStoreOp = VK_ATTACHMENT_STORE_OP_DONT_CARE;
-    depthAttachment.initialLayout = VK_IMAGE_LAYOUT_UNDEFINED;
-    depthAttachment.finalLayout = VK_IMAGE_LAYOUT_DEPTH_STENCIL_ATTACHMENT_OPTIMAL;
-
-    attachmentDescriptions[1] = depthAttachment;
-
-    //depth attachment reference
     VkAttachmentReference depthAttachmentReference;
-    depthAttachmentReference.attachment = 1; //attachment description array index
-    depthAttachmentReference.layout = VK_IMAGE_LAYOUT_DEPTH_STENCIL_ATTACHMENT_OPTIMAL;
+    if(_desc->depthFormat != VK_FORMAT_UNDEFINED)
+    {
+        u32 bit = 1 << attachmentDescriptionCount;
+        VkImageLayout layout = _desc->depthReadOnly ? VK_IMAGE_LAYOUT_DEPTH_STENCIL_READ_ONLY_OPTIMAL : VK_IMAGE_LAYOUT_DEPTH_STENCIL_ATTACHMENT_OPTIMAL;
+
+        VkAttachmentDescription depthAttachment = {};
+        depthAttachment.format = _desc->depthFormat;
+        depthAttachment.samples = VK_SAMPLE_COUNT_1_BIT;
+        depthAttachment.loadOp = (_desc->clearMask & bit) ? VK_ATTACHMENT_LOAD_OP_CLEAR : VK_ATTACHMENT_LOAD_OP_LOAD;
+        depthAttachment.storeOp = (_desc->storeMask & bit) ? VK_ATTACHMENT_STORE_OP_STORE : VK_ATTACHMENT_STORE_OP_DONT_CARE;
+        depthAttachment.stencilLoadOp = VK_ATTACHMENT_LOAD_OP_DONT_CARE;
+        depthAttachment.stencilStoreOp = VK_ATTACHMENT_STORE_OP_DONT_CARE;
+        depthAttachment.initialLayout = layout;
+        depthAttachment.finalLayout = layout;
+        attachmentDescriptions[attachmentDescriptionCount] = depthAttachment;
+
+        //depth attachment reference
+        depthAttachmentReference.attachment = attachmentDescriptionCount; //attachment description array index
+        depthAttachmentReference.layout = layout;
+        attachmentDescriptionCount++;
+
+        //depth stencil data
+        subpass.pDepthStencilAttachment = &depthAttachmentReference;
+    }
+    else
+        subpass.pDepthStencilAttachment = 0;
 
     //TODO: other attachment types (input, resolve, preserve)
 
-    //depth stencil data
-    subpass.pDepthStencilAttachment = &depthAttachmentReference;
-
     //input from a shader
     subpass.inputAttachmentCount = 0;
     subpass.pInputAttachments = 0;
@@ -88,24 +86,14 @@ void VulkanRenderpassCreate(VulkanContext* _context,
     subpass.preserveAttachmentCount = 0;
     subpass.pPreserveAttachments = 0;
 
-    //render pass dependenices. TODO: make this configurable
-    VkSubpassDependency dependency;
-    dependency.srcSubpass = VK_SUBPASS_EXTERNAL;
-    dependency.dstSubpass = 0;
-    dependency.srcStageMask = VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT;
-    dependency.srcAccessMask = 0;
-    dependency.dstStageMask = VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT;
-    dependency.dstAccessMask = VK_ACCESS_COLOR_ATTACHMENT_READ_BIT | VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT;
-    dependency.dependencyFlags = 0;
-
-    //renderpass create
+    //renderpass create, no dependencies since the pipeline barriers recorded before the pass cover them
     VkRenderPassCreateInfo renderpassCreateInfo = { VK_STRUCTURE_TYPE_RENDER_PASS_CREATE_INFO };
     renderpassCreateInfo.attachmentCount = attachmentDescriptionCount;
     renderpassCreateInfo.pAttachments = attachmentDescriptions;
     renderpassCreateInfo.subpassCount = 1;
     renderpassCreateInfo.pSubpasses = &subpass;
-    renderpassCreateInfo.dependencyCount = 1;
-    renderpassCreateInfo.pDependencies = &dependency;
+    renderpassCreateInfo.dependencyCount = 0;
+    renderpassCreateInfo.pDependencies = 0;
     renderpassCreateInfo.pNext = 0;
     renderpassCreateInfo.flags = 0;
 
@@ -123,29 +111,43 @@ void VulkanRenderpassDestroy(VulkanContext* _context, VulkanRenderpass* _renderp
     }
 }
 
-void VulkanRenderpassBegin(VulkanCommandBuffer* _commandBuffer, VulkanRenderpass* _renderpass, VkFramebuffer _framebuffer) 
+b8 VulkanRenderpassDescEqual(const VulkanRenderpassDesc* _a, const VulkanRenderpassDesc* _b)
+{
+    if(_a->colorCount != _b->colorCount ||
+        _a->depthFormat != _b->depthFormat ||
+        _a->depthReadOnly != _b->depthReadOnly ||
+        _a->clearMask != _b->clearMask ||
+        _a->storeMask != _b->storeMask)
+        return FALSE;
+
+    for(u32 i = 0; i < _a->colorCount; ++i)
+    {
+        if(_a->colorFormats[i] != _b->colorFormats[i])
+            return FALSE;
+    }
+
+    return TRUE;
+}
+
+void VulkanRenderpassBegin(VulkanCommandBuffer* _commandBuffer, 
+    VulkanRenderpass* _renderpass, 
+    VkFramebuffer _framebuffer, 
+    u32 _width, u32 _height,
+    const VkClearValue* _clearValues,
+    VkSubpassContents _contents) 
 {
     VkRenderPassBeginInfo beginInfo = { VK_STRUCTURE_TYPE_RENDER_PASS_BEGIN_INFO };
     beginInfo.renderPass = _renderpass->handle;
     beginInfo.framebuffer = _framebuffer;
-    beginInfo.renderArea.offset.x = _renderpass->x;
-    beginInfo.renderArea.offset.y = _renderpass->y;
-    beginInfo.renderArea.extent.width = _renderpass->w;
-    beginInfo.renderArea.extent.height = _renderpass->h;
-
-    VkClearValue clearValues[2];
-    cZeroMemory(clearValues, sizeof(VkClearValue) * 2);
-    clearValues[0].color.float32[0] = _renderpass->r;
-    clearValues[0].color.float32[1] = _renderpass->g;
-    clearValues[0].color.float32[2] = _renderpass->b;
-    clearValues[0].color.float32[3] = _renderpass->a;
-    clearValues[1].depthStencil.depth = _renderpass->depth;
-    clearValues[1].depthStencil.stencil = _renderpass->stencil;
-
-    beginInfo.clearValueCount = 2;
-    beginInfo.pClearValues = clearValues;
-
-    vkCmdBeginRenderPass(_commandBuffer->handle, &beginInfo, VK_SUBPASS_CONTENTS_INLINE);
+    beginInfo.renderArea.offset.x = 0;
+    beginInfo.renderArea.offset.y = 0;
+    beginInfo.renderArea.extent.width = _width;
+    beginInfo.renderArea.extent.height = _height;
+
+    beginInfo.clearValueCount = _renderpass->desc.colorCount + (_renderpass->desc.depthFormat != VK_FORMAT_UNDEFINED ? 1 : 0);
+    beginInfo.pClearValues = _clearValues;
+
+    vkCmdBeginRenderPass(_commandBuffer->handle, &beginInfo, _contents);
     _commandBuffer->state = COMMAND_BUFFER_STATE_IN_RENDER_PASS;
 }
 
@@ -153,4 +155,58 @@ void VulkanRenderpassEnd(VulkanCommandBuffer* _commandBuffer, VulkanRenderpass*
 {
     vkCmdEndRenderPass(_commandBuffer->handle);
     _commandBuffer->state = COMMAND_BUFFER_STATE_RECORDING;
+}
+
+void VulkanRenderpassBeginRendering(VulkanCommandBuffer* _commandBuffer,
+    const VulkanRenderpassDesc* _desc,
+    const VkImageView* _views,
+    u32 _width, u32 _height,
+    const VkClearValue* _clearValues,
+    b8 _secondaryContents)
+{
+    //same load and store operations a render pass created from _desc would use
+    VkRenderingAttachmentInfo colorAttachments[RENDER_GRAPH_MAX_COLOR_ATTACHMENTS];
+    for(u32 i = 0; i < _desc->colorCount; ++i)
+    {
+        VkRenderingAttachmentInfo* attachment = &colorAttachments[i];
+        cZeroMemory(attachment, sizeof(VkRenderingAttachmentInfo));
+        attachment->sType = VK_STRUCTURE_TYPE_RENDERING_ATTACHMENT_INFO;
+        attachment->imageView = _views[i];
+        attachment->imageLayout = VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL;
+        attachment->loadOp = (_desc->clearMask & (1 << i)) ? VK_ATTACHMENT_LOAD_OP_CLEAR : VK_ATTACHMENT_LOAD_OP_LOAD;
+        attachment->storeOp = (_desc->storeMask & (1 << i)) ? VK_ATTACHMENT_STORE_OP_STORE : VK_ATTACHMENT_STORE_OP_DONT_CARE;
+        attachment->clearValue = _clearValues[i];
+    }
+
+    VkRenderingInfo renderingInfo = { VK_STRUCTURE_TYPE_RENDERING_INFO };
+    renderingInfo.flags = _secondaryContents ? VK_RENDERING_CONTENTS_SECONDARY_COMMAND_BUFFERS_BIT : 0;
+    renderingInfo.renderArea.offset.x = 0;
+    renderingInfo.renderArea.offset.y = 0;
+    renderingInfo.renderArea.extent.width = _width;
+    renderingInfo.renderArea.extent.height = _height;
+    renderingInfo.layerCount = 1;
+    renderingInfo.colorAttachmentCount = _desc->colorCount;
+    renderingInfo.pColorAttachments = colorAttachments;
+
+    //stencil is not attached, matching the don't care stencil operations of the render pass path
+    VkRenderingAttachmentInfo depthAttachment = { VK_STRUCTURE_TYPE_RENDERING_ATTACHMENT_INFO };
+    if(_desc->depthFormat != VK_FORMAT_UNDEFINED)
+    {
+        u32 bit = 1 << _desc->colorCount;
+        depthAttachment.imageView = _views[_desc->colorCount];
+        depthAttachment.imageLayout = _desc->depthReadOnly ? VK_IMAGE_LAYOUT_DEPTH_STENCIL_READ_ONLY_OPTIMAL : VK_IMAGE_LAYOUT_DEPTH_STENCIL_ATTACHMENT_OPTIMAL;
+        depthAttachment.loadOp = (_desc->clearMask & bit) ? VK_ATTACHMENT_LOAD_OP_CLEAR : VK_ATTACHMENT_LOAD_OP_LOAD;
+        depthAttachment.storeOp = (_desc->storeMask & bit) ? VK_ATTACHMENT_STORE_OP_STORE : VK_ATTACHMENT_STORE_OP_DONT_CARE;
+        depthAttachment.clearValue = _clearValues[_desc->colorCount];
+        renderingInfo.pDepthAttachment = &depthAttachment;
+    }
+
+    vkCmdBeginRendering(_commandBuffer->handle, &renderingInfo);
+    _commandBuffer->state = COMMAND_BUFFER_STATE_IN_RENDER_PASS;
+}
+
+void VulkanRenderpassEndRendering(VulkanCommandBuffer* _commandBuffer)
+{
+    vkCmdEndRendering(_commandBuffer->handle);
+    _commandBuffer->state = COMMAND_BUFFER_STATE_RECORDING;
 }
\ No newline at end of file
@@ -2,18 +2,41 @@
 
 #include "VulkanTypes.inl"
 
+//single subpass render pass, attachments are expected in the layout of their usage and left in it
 void VulkanRenderpassCreate(
     VulkanContext* _context,
-    VulkanRenderpass* _outRenderpass,
-    f32 _x, f32 _y, f32 _w, f32 _h,
-    f32 _r, f32 _g, f32 _b, f32 _a,
-    f32 _depth, u32 _stencil);
+    const VulkanRenderpassDesc* _desc,
+    VulkanRenderpass* _outRenderpass);
 
 void VulkanRenderpassDestroy(VulkanContext* _context, VulkanRenderpass* _renderpass);
 
+//TRUE if both describe the same attachments and operations
+b8 VulkanRenderpassDescEqual(const VulkanRenderpassDesc* _a, const VulkanRenderpassDesc* _b);
+
+//_clearValues holds one value per attachment, colors first then depth.
+//_contents selects between commands recorded inline and secondaries executed with vkCmdExecuteCommands
 void VulkanRenderpassBegin(
     VulkanCommandBuffer* _commandBuffer,
     VulkanRenderpass* _renderpass,
-    VkFramebuffer _framebuffer);
+    VkFramebuffer _framebuffer,
+    u32 _width, u32 _height,
+    const VkClearValue* _clearValues,
+    VkSubpassContents _contents);
+
+void VulkanRenderpassEnd(VulkanCommandBuffer* _commandBuffer, VulkanRenderpass* _renderpass);
+
+/**
+ * Begins a dynamic rendering instance with the attachments of _desc, no render pass or framebuffer
+ * object is involved. _views and _clearValues hold one entry per attachment, colors first then depth,
+ * attachments are expected in the layout of their usage like with VulkanRenderpassCreate.
+ * With _secondaryContents the instance is filled by secondaries begun with VulkanCommandBufferBeginSecondaryRendering.
+ */
+void VulkanRenderpassBeginRendering(
+    VulkanCommandBuffer* _commandBuffer,
+    const VulkanRenderpassDesc* _desc,
+    const VkImageView* _views,
+    u32 _width, u32 _height,
+    const VkClearValue* _clearValues,
+    b8 _secondaryContents);
 
-void VulkanRenderpassEnd(VulkanCommandBuffer* _commandBuffer, VulkanRenderpass* _renderpass);
\ No newline at end of file
+void VulkanRenderpassEndRendering(VulkanCommandBuffer* _commandBuffer);
\ No newline at end of file
@@ -0,0 +1,685 @@
+#include "VulkanShader.h"
+#include "VulkanUtils.h"
+
+#include "core/Logger.h"
+#include "core/CMemory.h"
+
+#include "platform/Filesystem.h"
+
+#include "containers/DArray.h"
+
+#define SPIRV_MAGIC 0x07230203
+#define SPIRV_HEADER_WORDS 5
+
+//the subset of the SPIR-V specification reflection needs
+#define SPIRV_OP_ENTRY_POINT 15
+#define SPIRV_OP_TYPE_BOOL 20
+#define SPIRV_OP_TYPE_INT 21
+#define SPIRV_OP_TYPE_FLOAT 22
+#define SPIRV_OP_TYPE_VECTOR 23
+#define SPIRV_OP_TYPE_MATRIX 24
+#define SPIRV_OP_TYPE_IMAGE 25
+#define SPIRV_OP_TYPE_SAMPLER 26
+#define SPIRV_OP_TYPE_SAMPLED_IMAGE 27
+#define SPIRV_OP_TYPE_ARRAY 28
+#define SPIRV_OP_TYPE_RUNTIME_ARRAY 29
+#define SPIRV_OP_TYPE_STRUCT 30
+#define SPIRV_OP_TYPE_POINTER 32
+#define SPIRV_OP_CONSTANT 43
+#define SPIRV_OP_VARIABLE 59
+#define SPIRV_OP_DECORATE 71
+#define SPIRV_OP_MEMBER_DECORATE 72
+
+#define SPIRV_DECORATION_BLOCK 2
+#define SPIRV_DECORATION_BUFFER_BLOCK 3
+#define SPIRV_DECORATION_ARRAY_STRIDE 6
+#define SPIRV_DECORATION_MATRIX_STRIDE 7
+#define SPIRV_DECORATION_BINDING 33
+#define SPIRV_DECORATION_DESCRIPTOR_SET 34
+#define SPIRV_DECORATION_OFFSET 35
+
+#define SPIRV_STORAGE_UNIFORM_CONSTANT 0
+#define SPIRV_STORAGE_UNIFORM 2
+#define SPIRV_STORAGE_PUSH_CONSTANT 9
+#define SPIRV_STORAGE_STORAGE_BUFFER 12
+
+#define SPIRV_DIM_BUFFER 5
+#define SPIRV_DIM_SUBPASS_DATA 6
+
+#define SPIRV_UNSET 0xFFFFFFFF
+
+//what reflection knows about one result id
+typedef struct SpirvId
+{
+    //word offset of the defining instruction, 0 if the id is not defined by an instruction of interest
+    u32 offset;
+    u32 set;
+    u32 binding;
+    u32 arrayStride;
+    b8 bufferBlock;
+} SpirvId;
+
+typedef struct SpirvModule
+{
+    const u32* code;
+    u64 wordCount;
+    u32 bound;
+    SpirvId* ids;
+} SpirvModule;
+
+b8 ShaderMapBinary(const char* _path, FileMapping* _outMapping);
+b8 SpirvDefinesResult(u32 _opcode, u32* _outResultWord);
+u32 SpirvTypeSize(const SpirvModule* _module, u32 _type, u32 _depth);
+u32 SpirvStructSize(const SpirvModule* _module, u32 _type, u32 _depth);
+b8 SpirvReflectVariable(const SpirvModule* _module, u32 _variable, VulkanShaderReflection* _reflection);
+VkShaderStageFlagBits SpirvStage(u32 _executionModel);
+void ShaderSortBindings(VkDescriptorSetLayoutBinding* _bindings, u32 _count);
+
+b8 VulkanShaderReflect(const u32* _code, u64 _wordCount, VulkanShaderReflection* _outReflection)
+{
+    cZeroMemory(_outReflection, sizeof(VulkanShaderReflection));
+    if(_wordCount < SPIRV_HEADER_WORDS || _code[0] != SPIRV_MAGIC)
+        return FALSE;
+
+    SpirvModule module;
+    module.code = _code;
+    module.wordCount = _wordCount;
+    module.bound = _code[3];
+    module.ids = cAllocate(sizeof(SpirvId) * module.bound, MEMORY_TAG_RENDERER);
+    for(u32 i = 0; i < module.bound; ++i)
+    {
+        module.ids[i].offset = 0;
+        module.ids[i].set = SPIRV_UNSET;
+        module.ids[i].binding = SPIRV_UNSET;
+        module.ids[i].arrayStride = 0;
+        module.ids[i].bufferBlock = FALSE;
+    }
+
+    //first pass, index the types, constants and variables by id and gather their decorations
+    b8 result = TRUE;
+    b8 foundEntryPoint = FALSE;
+    u64 offset = SPIRV_HEADER_WORDS;
+    while(offset < _wordCount)
+    {
+        u32 wordCount = _code[offset] >> 16;
+        u32 opcode = _code[offset] & 0xFFFF;
+        if(wordCount == 0 || offset + wordCount > _wordCount)
+        {
+            result = FALSE;
+            break;
+        }
+
+        u32 resultWord;
+        if(SpirvDefinesResult(opcode, &resultWord) && wordCount > resultWord && _code[offset + resultWord] < module.bound)
+            module.ids[_code[offset + resultWord]].offset = (u32)offset;
+
+        if(opcode == SPIRV_OP_ENTRY_POINT && !foundEntryPoint && wordCount > 1)
+        {
+            _outReflection->stage = SpirvStage(_code[offset + 1]);
+            foundEntryPoint = TRUE;
+        }
+        else if(opcode == SPIRV_OP_DECORATE && wordCount > 2 && _code[offset + 1] < module.bound)
+        {
+            SpirvId* id = &module.ids[_code[offset + 1]];
+            u32 decoration = _code[offset + 2];
+            u32 value = wordCount > 3 ? _code[offset + 3] : 0;
+            if(decoration == SPIRV_DECORATION_DESCRIPTOR_SET)
+                id->set = value;
+            else if(decoration == SPIRV_DECORATION_BINDING)
+                id->binding = value;
+            else if(decoration == SPIRV_DECORATION_ARRAY_STRIDE)
+                id->arrayStride = value;
+            else if(decoration == SPIRV_DECORATION_BUFFER_BLOCK)
+                id->bufferBlock = TRUE;
+        }
+
+        offset += wordCount;
+    }
+
+    //second pass over the variables, only resources and push constants matter
+    for(u32 i = 0; result && i < module.bound; ++i)
+    {
+        u32 variableOffset = module.ids[i].offset;
+        if(variableOffset && (_code[variableOffset] & 0xFFFF) == SPIRV_OP_VARIABLE)
+            result = SpirvReflectVariable(&module, i, _outReflection);
+    }
+
+    cFree(module.ids, sizeof(SpirvId) * module.bound, MEMORY_TAG_RENDERER);
+    return result && foundEntryPoint;
+}
+
+b8 VulkanShaderLibraryCreate(VulkanShaderLibrary* _outLibrary)
+{
+    _outLibrary->shaders = DArrayCreate(VulkanShader);
+    _outLibrary->freeHandles = DArrayCreate(u32);
+    _outLibrary->setLayouts = DArrayCreate(VulkanShaderSetLayout);
+    _outLibrary->pipelineLayouts = DArrayCreate(VulkanShaderPipelineLayout);
+    return TRUE;
+}
+
+void VulkanShaderLibraryDestroy(VulkanContext* _context, VulkanShaderLibrary* _library)
+{
+    if(!_library->shaders)
+        return;
+
+    VkDevice device = _context->device.logicalDevice;
+
+    u64 shaderCount = DArrayLength(_library->shaders);
+    for(u64 i = 0; i < shaderCount; ++i)
+    {
+        if(_library->shaders[i].references > 0)
+            vkDestroyShaderModule(device, _library->shaders[i].module, _context->allocator);
+    }
+
+    for(u64 i = 0; i < DArrayLength(_library->pipelineLayouts); ++i)
+        vkDestroyPipelineLayout(device, _library->pipelineLayouts[i].handle, _context->allocator);
+
+    for(u64 i = 0; i < DArrayLength(_library->setLayouts); ++i)
+        vkDestroyDescriptorSetLayout(device, _library->setLayouts[i].handle, _context->allocator);
+
+    DArrayDestroy(_library->shaders);
+    DArrayDestroy(_library->freeHandles);
+    DArrayDestroy(_library->setLayouts);
+    DArrayDestroy(_library->pipelineLayouts);
+    cZeroMemory(_library, sizeof(VulkanShaderLibrary));
+}
+
+u32 VulkanShaderLibraryLoad(VulkanContext* _context, VulkanShaderLibrary* _library, const char* _path)
+{
+    FileMapping mapping;
+    if(!ShaderMapBinary(_path, &mapping))
+        return RENDER_HANDLE_NONE;
+
+    const u32* code = (const u32*)mapping.data;
+    u64 wordCount = mapping.size / sizeof(u32);
+
+    //a 64 bit content hash stands in for the binary, collisions are not expected among a game's shaders
+    u64 hash = VulkanHashBytes(code, mapping.size, VULKAN_HASH_SEED);
+    u64 shaderCount = DArrayLength(_library->shaders);
+    for(u64 i = 0; i < shaderCount; ++i)
+    {
+        VulkanShader* shader = &_library->shaders[i];
+        if(shader->references > 0 && shader->hash == hash)
+        {
+            FilesystemUnmap(&mapping);
+            shader->references++;
+            return (u32)i;
+        }
+    }
+
+    VulkanShader shader = {};
+    shader.hash = hash;
+    shader.references = 1;
+    if(!VulkanShaderReflect(code, wordCount, &shader.reflection))
+    {
+        LOG_ERROR("Failed to reflect shader '%s'.", _path);
+        FilesystemUnmap(&mapping);
+        return RENDER_HANDLE_NONE;
+    }
+
+    //the driver copies the code, the file is released right after
+    VkShaderModuleCreateInfo createInfo = { VK_STRUCTURE_TYPE_SHADER_MODULE_CREATE_INFO };
+    createInfo.codeSize = mapping.size;
+    createInfo.pCode = code;
+    VkResult result = vkCreateShaderModule(_context->device.logicalDevice, &createInfo, _context->allocator, &shader.module);
+    FilesystemUnmap(&mapping);
+    if(result != VK_SUCCESS)
+    {
+        LOG_ERROR("vkCreateShaderModule failed for '%s'.", _path);
+        return RENDER_HANDLE_NONE;
+    }
+
+    u32 handle;
+    if(DArrayLength(_library->freeHandles) > 0)
+    {
+        DArrayPop(_library->freeHandles, &handle);
+        _library->shaders[handle] = shader;
+    }
+    else
+    {
+        handle = (u32)shaderCount;
+        DArrayPush(_library->shaders, shader);
+    }
+
+    return handle;
+}
+
+void VulkanShaderLibraryRelease(VulkanContext* _context, VulkanShaderLibrary* _library, u32* _shader)
+{
+    u32 handle = *_shader;
+    *_shader = RENDER_HANDLE_NONE;
+    if(handle >= DArrayLength(_library->shaders) || _library->shaders[handle].references == 0)
+        return;
+
+    VulkanShader* shader = &_library->shaders[handle];
+    if(--shader->references > 0)
+        return;
+
+    //pipelines keep their own copy of the code, the module is not needed once they exist
+    vkDestroyShaderModule(_context->device.logicalDevice, shader->module, _context->allocator);
+    cZeroMemory(shader, sizeof(VulkanShader));
+    DArrayPush(_library->freeHandles, handle);
+}
+
+VkDescriptorSetLayout VulkanShaderLibraryGetSetLayout(
+    VulkanContext* _context,
+    VulkanShaderLibrary* _library,
+    const VkDescriptorSetLayoutBinding* _bindings,
+    u32 _bindingCount)
+{
+    if(_bindingCount > VULKAN_SHADER_MAX_BINDINGS)
+    {
+        LOG_ERROR("Set layouts are limited to %u bindings.", VULKAN_SHADER_MAX_BINDINGS);
+        return 0;
+    }
+
+    //sorted so the order the bindings are listed in does not matter
+    VkDescriptorSetLayoutBinding bindings[VULKAN_SHADER_MAX_BINDINGS];
+    cCopyMemory(bindings, _bindings, sizeof(VkDescriptorSetLayoutBinding) * _bindingCount);
+    ShaderSortBindings(bindings, _bindingCount);
+
+    u64 hash = VulkanHashBytes(&_bindingCount, sizeof(u32), VULKAN_HASH_SEED);
+    for(u32 i = 0; i < _bindingCount; ++i)
+    {
+        u32 key[4] = { bindings[i].binding, (u32)bindings[i].descriptorType, bindings[i].descriptorCount, bindings[i].stageFlags };
+        hash = VulkanHashBytes(key, sizeof(key), hash);
+    }
+
+    for(u64 i = 0; i < DArrayLength(_library->setLayouts); ++i)
+    {
+        if(_library->setLayouts[i].hash == hash)
+            return _library->setLayouts[i].handle;
+    }
+
+    VkDescriptorSetLayoutCreateInfo createInfo = { VK_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_CREATE_INFO };
+    createInfo.bindingCount = _bindingCount;
+    createInfo.pBindings = bindings;
+
+    VulkanShaderSetLayout layout;
+    layout.hash = hash;
+    if(vkCreateDescriptorSetLayout(_context->device.logicalDevice, &createInfo, _context->allocator, &layout.handle) != VK_SUCCESS)
+    {
+        LOG_ERROR("Failed to create a descriptor set layout.");
+        return 0;
+    }
+
+    DArrayPush(_library->setLayouts, layout);
+    return layout.handle;
+}
+
+VkPipelineLayout VulkanShaderLibraryGetPipelineLayout(
+    VulkanContext* _context,
+    VulkanShaderLibrary* _library,
+    const u32* _shaders,
+    u32 _shaderCount)
+{
+    VkDescriptorSetLayoutBinding sets[VULKAN_SHADER_MAX_SETS][VULKAN_SHADER_MAX_BINDINGS];
+    u32 bindingCounts[VULKAN_SHADER_MAX_SETS] = {};
+    u32 setCount = 0;
+
+    //a set declaring a runtime sized array is the bindless table, its layout is the table's
+    b8 bindlessSets[VULKAN_SHADER_MAX_SETS] = {};
+
+    VkPushConstantRange pushRange = {};
+    for(u32 i = 0; i < _shaderCount; ++i)
+    {
+        const VulkanShaderReflection* reflection = VulkanShaderLibraryGetReflection(_library, _shaders[i]);
+        if(reflection->pushConstantSize > 0)
+        {
+            pushRange.stageFlags |= reflection->stage;
+            if(reflection->pushConstantSize > pushRange.size)
+                pushRange.size = reflection->pushConstantSize;
+        }
+
+        for(u32 j = 0; j < reflection->bindingCount; ++j)
+        {
+            const VulkanShaderBinding* binding = &reflection->bindings[j];
+            if(binding->set >= VULKAN_SHADER_MAX_SETS)
+            {
+                LOG_ERROR("Shader binding %u.%u is out of range.", binding->set, binding->binding);
+                return 0;
+            }
+
+            if(binding->count == 0)
+            {
+                if(!_context->bindlessTable.setLayout)
+                {
+                    LOG_ERROR("Shader binding %u.%u is runtime sized but the bindless table is unavailable.", binding->set, binding->binding);
+                    return 0;
+                }
+
+                bindlessSets[binding->set] = TRUE;
+                if(binding->set + 1 > setCount)
+                    setCount = binding->set + 1;
+                continue;
+            }
+
+            //stages sharing a binding must agree on what it is
+            VkDescriptorSetLayoutBinding* merged = 0;
+            for(u32 k = 0; k < bindingCounts[binding->set]; ++k)
+            {
+                if(sets[binding->set][k].binding == binding->binding)
+                    merged = &sets[binding->set][k];
+            }
+
+            if(merged)
+            {
+                if(merged->descriptorType != binding->type || merged->descriptorCount != binding->count)
+                {
+                    LOG_ERROR("Shader stages disagree on binding %u.%u.", binding->set, binding->binding);
+                    return 0;
+                }
+
+                merged->stageFlags |= reflection->stage;
+                continue;
+            }
+
+            if(bindingCounts[binding->set] == VULKAN_SHADER_MAX_BINDINGS)
+            {
+                LOG_ERROR("Set %u has more than %u bindings.", binding->set, VULKAN_SHADER_MAX_BINDINGS);
+                return 0;
+            }
+
+            VkDescriptorSetLayoutBinding* added = &sets[binding->set][bindingCounts[binding->set]++];
+            cZeroMemory(added, sizeof(VkDescriptorSetLayoutBinding));
+            added->binding = binding->binding;
+            added->descriptorType = binding->type;
+            added->descriptorCount = binding->count;
+            added->stageFlags = reflection->stage;
+            if(binding->set + 1 > setCount)
+                setCount = binding->set + 1;
+        }
+    }
+
+    //sets skipped by the shaders still need a layout, an empty one
+    VkDescriptorSetLayout setLayouts[VULKAN_SHADER_MAX_SETS];
+    for(u32 i = 0; i < setCount; ++i)
+    {
+        //the table's samplers are the only other binding, they come with its layout
+        if(bindlessSets[i])
+        {
+            setLayouts[i] = _context->bindlessTable.setLayout;
+            continue;
+        }
+
+        setLayouts[i] = VulkanShaderLibraryGetSetLayout(_context, _library, sets[i], bindingCounts[i]);
+        if(!setLayouts[i])
+            return 0;
+    }
+
+    u64 hash = VulkanHashBytes(setLayouts, sizeof(VkDescriptorSetLayout) * setCount, VULKAN_HASH_SEED);
+    hash = VulkanHashBytes(&pushRange, sizeof(VkPushConstantRange), hash);
+    for(u64 i = 0; i < DArrayLength(_library->pipelineLayouts); ++i)
+    {
+        if(_library->pipelineLayouts[i].hash == hash)
+            return _library->pipelineLayouts[i].handle;
+    }
+
+    VkPipelineLayoutCreateInfo createInfo = { VK_STRUCTURE_TYPE_PIPELINE_LAYOUT_CREATE_INFO };
+    createInfo.setLayoutCount = setCount;
+    createInfo.pSetLayouts = setLayouts;
+    createInfo.pushConstantRangeCount = pushRange.size > 0 ? 1 : 0;
+    createInfo.pPushConstantRanges = &pushRange;
+
+    VulkanShaderPipelineLayout layout;
+    layout.hash = hash;
+    if(vkCreatePipelineLayout(_context->device.logicalDevice, &createInfo, _context->allocator, &layout.handle) != VK_SUCCESS)
+    {
+        LOG_ERROR("Failed to create a pipeline layout.");
+        return 0;
+    }
+
+    DArrayPush(_library->pipelineLayouts, layout);
+    return layout.handle;
+}
+
+b8 ShaderMapBinary(const char* _path, FileMapping* _outMapping)
+{
+    if(!FilesystemMapRead(_path, _outMapping))
+    {
+        LOG_ERROR("Shader '%s' not found.", _path);
+        return FALSE;
+    }
+
+    //mappings are page aligned, the code can be read as words in place
+    if(_outMapping->size % sizeof(u32) != 0 || *(const u32*)_outMapping->data != SPIRV_MAGIC)
+    {
+        LOG_ERROR("Shader '%s' is not a SPIR-V binary.", _path);
+        FilesystemUnmap(_outMapping);
+        return FALSE;
+    }
+
+    return TRUE;
+}
+
+b8 SpirvDefinesResult(u32 _opcode, u32* _outResultWord)
+{
+    switch(_opcode)
+    {
+        case SPIRV_OP_TYPE_BOOL:
+        case SPIRV_OP_TYPE_INT:
+        case SPIRV_OP_TYPE_FLOAT:
+        case SPIRV_OP_TYPE_VECTOR:
+        case SPIRV_OP_TYPE_MATRIX:
+        case SPIRV_OP_TYPE_IMAGE:
+        case SPIRV_OP_TYPE_SAMPLER:
+        case SPIRV_OP_TYPE_SAMPLED_IMAGE:
+        case SPIRV_OP_TYPE_ARRAY:
+        case SPIRV_OP_TYPE_RUNTIME_ARRAY:
+        case SPIRV_OP_TYPE_STRUCT:
+        case SPIRV_OP_TYPE_POINTER:
+            *_outResultWord = 1;
+            return TRUE;
+        case SPIRV_OP_CONSTANT:
+        case SPIRV_OP_VARIABLE:
+            *_outResultWord = 2;
+            return TRUE;
+        default:
+            return FALSE;
+    }
+}
+
+u32 SpirvTypeSize(const SpirvModule* _module, u32 _type, u32 _depth)
+{
+    if(_type >= _module->bound || !_module->ids[_type].offset || _depth > 16)
+        return 0;
+
+    const u32* instruction = &_module->code[_module->ids[_type].offset];
+    switch(instruction[0] & 0xFFFF)
+    {
+        case SPIRV_OP_TYPE_BOOL:
+            return 4;
+        case SPIRV_OP_TYPE_INT:
+        case SPIRV_OP_TYPE_FLOAT:
+            return instruction[2] / 8;
+        case SPIRV_OP_TYPE_VECTOR:
+        case SPIRV_OP_TYPE_MATRIX:
+            return instruction[3] * SpirvTypeSize(_module, instruction[2], _depth + 1);
+        case SPIRV_OP_TYPE_ARRAY:
+        {
+            u32 lengthId = instruction[3];
+            if(lengthId >= _module->bound || !_module->ids[lengthId].offset)
+                return 0;
+
+            u32 length = _module->code[_module->ids[lengthId].offset + 3];
+            u32 stride = _module->ids[_type].arrayStride;
+            return length * (stride ? stride : SpirvTypeSize(_module, instruction[2], _depth + 1));
+        }
+        case SPIRV_OP_TYPE_STRUCT:
+            return SpirvStructSize(_module, _type, _depth);
+        default:
+            return 0;
+    }
+}
+
+u32 SpirvStructSize(const SpirvModule* _module, u32 _type, u32 _depth)
+{
+    const u32* instruction = &_module->code[_module->ids[_type].offset];
+    u32 memberCount = (instruction[0] >> 16) - 2;
+
+    //the block ends after the member reaching furthest, member offsets come from the decorations
+    u32 size = 0;
+    u64 offset = SPIRV_HEADER_WORDS;
+    while(offset < _module->wordCount)
+    {
+        const u32* decorate = &_module->code[offset];
+        u32 wordCount = decorate[0] >> 16;
+        if((decorate[0] & 0xFFFF) == SPIRV_OP_MEMBER_DECORATE && wordCount > 4 &&
+           decorate[1] == _type && decorate[2] < memberCount && decorate[3] == SPIRV_DECORATION_OFFSET)
+        {
+            u32 memberType = instruction[2 + decorate[2]];
+            u32 memberSize = SpirvTypeSize(_module, memberType, _depth + 1);
+
+            //matrices are laid out with their column stride, a mat3 column takes 16 bytes
+            const u32* matrix = memberType < _module->bound && _module->ids[memberType].offset ? &_module->code[_module->ids[memberType].offset] : 0;
+            u64 strideOffset = matrix && (matrix[0] & 0xFFFF) == SPIRV_OP_TYPE_MATRIX ? SPIRV_HEADER_WORDS : _module->wordCount;
+            while(strideOffset < _module->wordCount)
+            {
+                const u32* stride = &_module->code[strideOffset];
+                if((stride[0] & 0xFFFF) == SPIRV_OP_MEMBER_DECORATE && (stride[0] >> 16) > 4 &&
+                   stride[1] == _type && stride[2] == decorate[2] && stride[3] == SPIRV_DECORATION_MATRIX_STRIDE)
+                {
+                    memberSize = matrix[3] * stride[4];
+                    break;
+                }
+                strideOffset += stride[0] >> 16;
+            }
+
+            if(decorate[4] + memberSize > size)
+                size = decorate[4] + memberSize;
+        }
+
+        offset += wordCount;
+    }
+
+    return size;
+}
+
+b8 SpirvReflectVariable(const SpirvModule* _module, u32 _variable, VulkanShaderReflection* _reflection)
+{
+    const u32* code = _module->code;
+    const u32* variable = &code[_module->ids[_variable].offset];
+    u32 storageClass = variable[3];
+    if(storageClass != SPIRV_STORAGE_UNIFORM_CONSTANT && storageClass != SPIRV_STORAGE_UNIFORM &&
+       storageClass != SPIRV_STORAGE_STORAGE_BUFFER && storageClass != SPIRV_STORAGE_PUSH_CONSTANT)
+        return TRUE;
+
+    u32 pointerType = variable[1];
+    if(pointerType >= _module->bound || !_module->ids[pointerType].offset)
+        return FALSE;
+
+    u32 type = code[_module->ids[pointerType].offset + 3];
+    if(storageClass == SPIRV_STORAGE_PUSH_CONSTANT)
+    {
+        _reflection->pushConstantSize = SpirvTypeSize(_module, type, 0);
+        return TRUE;
+    }
+
+    const SpirvId* id = &_module->ids[_variable];
+    if(id->set == SPIRV_UNSET || id->binding == SPIRV_UNSET)
+        return TRUE;
+
+    //arrays of resources are one binding with several descriptors
+    u32 count = 1;
+    for(;;)
+    {
+        if(type >= _module->bound || !_module->ids[type].offset)
+            return FALSE;
+
+        const u32* instruction = &code[_module->ids[type].offset];
+        u32 opcode = instruction[0] & 0xFFFF;
+        if(opcode == SPIRV_OP_TYPE_ARRAY)
+        {
+            u32 lengthId = instruction[3];
+            if(lengthId >= _module->bound || !_module->ids[lengthId].offset)
+                return FALSE;
+            count *= code[_module->ids[lengthId].offset + 3];
+        }
+        else if(opcode == SPIRV_OP_TYPE_RUNTIME_ARRAY)
+        {
+            count = 0;
+        }
+        else
+        {
+            break;
+        }
+
+        type = instruction[2];
+    }
+
+    const u32* instruction = &code[_module->ids[type].offset];
+    VkDescriptorType descriptorType;
+    switch(instruction[0] & 0xFFFF)
+    {
+        case SPIRV_OP_TYPE_SAMPLER:
+            descriptorType = VK_DESCRIPTOR_TYPE_SAMPLER;
+            break;
+        case SPIRV_OP_TYPE_SAMPLED_IMAGE:
+            descriptorType = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER;
+            break;
+        case SPIRV_OP_TYPE_IMAGE:
+        {
+            //sampled is 1 for images read through a sampler and 2 for storage images
+            u32 dim = instruction[3];
+            u32 sampled = instruction[7];
+            if(dim == SPIRV_DIM_BUFFER)
+                descriptorType = sampled == 2 ? VK_DESCRIPTOR_TYPE_STORAGE_TEXEL_BUFFER : VK_DESCRIPTOR_TYPE_UNIFORM_TEXEL_BUFFER;
+            else if(dim == SPIRV_DIM_SUBPASS_DATA)
+                descriptorType = VK_DESCRIPTOR_TYPE_INPUT_ATTACHMENT;
+            else
+                descriptorType = sampled == 2 ? VK_DESCRIPTOR_TYPE_STORAGE_IMAGE : VK_DESCRIPTOR_TYPE_SAMPLED_IMAGE;
+            break;
+        }
+        case SPIRV_OP_TYPE_STRUCT:
+            //older SPIR-V declares storage buffers as uniform blocks decorated BufferBlock
+            descriptorType = storageClass == SPIRV_STORAGE_STORAGE_BUFFER || _module->ids[type].bufferBlock ?
+                VK_DESCRIPTOR_TYPE_STORAGE_BUFFER : VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER;
+            break;
+        default:
+            LOG_WARN("Unsupported resource type on binding %u.%u.", id->set, id->binding);
+            return TRUE;
+    }
+
+    if(_reflection->bindingCount == VULKAN_SHADER_MAX_BINDINGS)
+    {
+        LOG_ERROR("Shader declares more than %u bindings.", VULKAN_SHADER_MAX_BINDINGS);
+        return FALSE;
+    }
+
+    VulkanShaderBinding* binding = &_reflection->bindings[_reflection->bindingCount++];
+    binding->set = id->set;
+    binding->binding = id->binding;
+    binding->type = descriptorType;
+    binding->count = count;
+    return TRUE;
+}
+
+VkShaderStageFlagBits SpirvStage(u32 _executionModel)
+{
+    switch(_executionModel)
+    {
+        case 0: return VK_SHADER_STAGE_VERTEX_BIT;
+        case 1: return VK_SHADER_STAGE_TESSELLATION_CONTROL_BIT;
+        case 2: return VK_SHADER_STAGE_TESSELLATION_EVALUATION_BIT;
+        case 3: return VK_SHADER_STAGE_GEOMETRY_BIT;
+        case 4: return VK_SHADER_STAGE_FRAGMENT_BIT;
+        case 5: return VK_SHADER_STAGE_COMPUTE_BIT;
+        default: return VK_SHADER_STAGE_ALL;
+    }
+}
+
+void ShaderSortBindings(VkDescriptorSetLayoutBinding* _bindings, u32 _count)
+{
+    //insertion sort, a set has a handful of bindings
+    for(u32 i = 1; i < _count; ++i)
+    {
+        VkDescriptorSetLayoutBinding binding = _bindings[i];
+        u32 j = i;
+        while(j > 0 && _bindings[j - 1].binding > binding.binding)
+        {
+            _bindings[j] = _bindings[j - 1];
+            --j;
+        }
+        _bindings[j] = binding;
+    }
+}
\ No newline at end of file
@@ -0,0 +1,61 @@
+#pragma once
+
+#include "VulkanTypes.inl"
+
+//shaders are compiled to SPIR-V by the build scripts, paths are relative to the working directory
+#define VULKAN_SHADER_PATH "assets/shaders/"
+
+/**
+ * Reads the entry point's stage, the descriptor bindings and the push constant block size from SPIR-V.
+ * @returns FALSE if the binary is malformed or declares more than VULKAN_SHADER_MAX_BINDINGS bindings.
+ */
+b8 VulkanShaderReflect(const u32* _code, u64 _wordCount, VulkanShaderReflection* _outReflection);
+
+b8 VulkanShaderLibraryCreate(VulkanShaderLibrary* _outLibrary);
+
+//destroys every module and layout, the device must be idle
+void VulkanShaderLibraryDestroy(VulkanContext* _context, VulkanShaderLibrary* _library);
+
+/**
+ * Maps the SPIR-V binary at _path and creates its module, or adds a reference to the module of an
+ * identical binary loaded before. The binary is reflected once, when its module is created.
+ * @returns the shader handle, RENDER_HANDLE_NONE if the file is missing, not SPIR-V or rejected by the driver.
+ */
+u32 VulkanShaderLibraryLoad(VulkanContext* _context, VulkanShaderLibrary* _library, const char* _path);
+
+//drops a reference and sets *_shader to RENDER_HANDLE_NONE, the module is destroyed with the last one
+void VulkanShaderLibraryRelease(VulkanContext* _context, VulkanShaderLibrary* _library, u32* _shader);
+
+CINLINE VkShaderModule VulkanShaderLibraryGetModule(const VulkanShaderLibrary* _library, u32 _shader)
+{
+    return _library->shaders[_shader].module;
+}
+
+CINLINE const VulkanShaderReflection* VulkanShaderLibraryGetReflection(const VulkanShaderLibrary* _library, u32 _shader)
+{
+    return &_library->shaders[_shader].reflection;
+}
+
+/**
+ * Returns the set layout of _bindings, created on first request. Equal bindings in any order share
+ * one layout, so sets allocated by hand stay compatible with the layouts reflected from shaders.
+ * Immutable samplers are not supported. The layout is owned by the library.
+ */
+VkDescriptorSetLayout VulkanShaderLibraryGetSetLayout(
+    VulkanContext* _context,
+    VulkanShaderLibrary* _library,
+    const VkDescriptorSetLayoutBinding* _bindings,
+    u32 _bindingCount);
+
+/**
+ * Builds the pipeline layout of a set of shaders from their reflection. Bindings used by several
+ * stages are merged, the push constant range covers the largest block and every stage using one.
+ * Layouts are created on first request and owned by the library. A set declaring a runtime sized
+ * array takes the layout of the bindless table, see VulkanBindlessTableCreate.
+ * @returns the layout, 0 if the shaders declare conflicting bindings or a runtime sized one without the table.
+ */
+VkPipelineLayout VulkanShaderLibraryGetPipelineLayout(
+    VulkanContext* _context,
+    VulkanShaderLibrary* _library,
+    const u32* _shaders,
+    u32 _shaderCount);
\ No newline at end of file
@@ -0,0 +1,181 @@
+#include "VulkanStagingRing.h"
+
+#include "VulkanBuffer.h"
+#include "VulkanCommandBuffer.h"
+#include "VulkanTimeline.h"
+
+#include "core/Logger.h"
+#include "core/CMemory.h"
+
+#include "containers/DArray.h"
+
+b8 VulkanStagingRingCreate(VulkanContext* _context, u64 _size, VulkanStagingRing* _outRing)
+{
+    cZeroMemory(_outRing, sizeof(VulkanStagingRing));
+
+    if(!VulkanBufferCreate(
+        _context,
+        _size,
+        VK_BUFFER_USAGE_TRANSFER_SRC_BIT,
+        VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT,
+        TRUE,
+        &_outRing->buffer))
+    {
+        LOG_ERROR("Failed to create staging ring buffer.");
+        return FALSE;
+    }
+
+    u8 frameCount = _context->swapchain.maxFramesInFlight;
+    _outRing->frameHeads = DArrayReserve(u64, frameCount);
+    _outRing->frameValues = DArrayReserve(u64, frameCount);
+    _outRing->transferCommandBuffers = DArrayReserve(VulkanCommandBuffer, frameCount);
+    _outRing->acquireCommandBuffers = DArrayReserve(VulkanCommandBuffer, frameCount);
+    _outRing->transferCompleteSemaphores = DArrayReserve(VkSemaphore, frameCount);
+    _outRing->pendingAcquires = DArrayCreate(VkBufferMemoryBarrier);
+
+    for(u8 i = 0; i < frameCount; ++i)
+    {
+        _outRing->frameHeads[i] = 0;
+        _outRing->frameValues[i] = 0;
+        VulkanCommandBufferAllocate(_context, _context->device.transferCommandPool, TRUE, &_outRing->transferCommandBuffers[i]);
+        VulkanCommandBufferAllocate(_context, _context->device.graphicsCommandPool, TRUE, &_outRing->acquireCommandBuffers[i]);
+
+        VkSemaphoreCreateInfo semaphoreCreateInfo = { VK_STRUCTURE_TYPE_SEMAPHORE_CREATE_INFO };
+        VK_CHECK(vkCreateSemaphore(_context->device.logicalDevice, &semaphoreCreateInfo, _context->allocator, &_outRing->transferCompleteSemaphores[i]));
+    }
+
+    return TRUE;
+}
+
+void VulkanStagingRingDestroy(VulkanContext* _context, VulkanStagingRing* _ring)
+{
+    if(!_ring->frameHeads)
+        return;
+
+    u8 frameCount = _context->swapchain.maxFramesInFlight;
+    for(u8 i = 0; i < frameCount; ++i)
+    {
+        VulkanCommandBufferFree(_context, _context->device.transferCommandPool, &_ring->transferCommandBuffers[i]);
+        VulkanCommandBufferFree(_context, _context->device.graphicsCommandPool, &_ring->acquireCommandBuffers[i]);
+        vkDestroySemaphore(_context->device.logicalDevice, _ring->transferCompleteSemaphores[i], _context->allocator);
+    }
+
+    DArrayDestroy(_ring->frameHeads);
+    DArrayDestroy(_ring->frameValues);
+    DArrayDestroy(_ring->transferCommandBuffers);
+    DArrayDestroy(_ring->acquireCommandBuffers);
+    DArrayDestroy(_ring->transferCompleteSemaphores);
+    DArrayDestroy(_ring->pendingAcquires);
+
+    VulkanBufferDestroy(_context, &_ring->buffer);
+    cZeroMemory(_ring, sizeof(VulkanStagingRing));
+}
+
+void* VulkanStagingRingAllocate(VulkanContext* _context, VulkanStagingRing* _ring, u64 _size, u64* _outOffset)
+{
+    //the ring is reclaimed when the current frame's slot is opened, make sure that happened first
+    VulkanStagingRingGetCommandBuffer(_context, _ring);
+
+    u64 capacity = _ring->buffer.totalSize;
+    u64 alignment = _context->device.properties.limits.optimalBufferCopyOffsetAlignment;
+    if(alignment < 16)
+        alignment = 16;
+
+    u64 head = (_ring->head + alignment - 1) & ~(alignment - 1);
+
+    //a reservation may not straddle the end of the ring, skip to the start instead
+    u64 offset = head % capacity;
+    if(offset + _size > capacity)
+    {
+        head += capacity - offset;
+        offset = 0;
+    }
+
+    if(head + _size - _ring->tail > capacity)
+        return 0;
+
+    _ring->head = head + _size;
+    *_outOffset = offset;
+    return (u8*)_ring->buffer.allocation.mappedData + offset;
+}
+
+VulkanCommandBuffer* VulkanStagingRingGetCommandBuffer(VulkanContext* _context, VulkanStagingRing* _ring)
+{
+    if(_ring->recording)
+        return &_ring->transferCommandBuffers[_ring->frame];
+
+    //uploads can be issued between frames, before BeginFrame has waited on this slot.
+    //the graphics submission waits on the transfer, so its timeline value covers both command buffers and the ring space
+    u32 frame = _context->currentFrame;
+    if(!VulkanTimelineWait(_context, &_context->graphicsTimeline, _ring->frameValues[frame], UINT64_MAX))
+    {
+        LOG_WARN("Staging ring in-flight wait failure.");
+    }
+
+    if(_ring->frameHeads[frame] > _ring->tail)
+        _ring->tail = _ring->frameHeads[frame];
+
+    VulkanCommandBuffer* commandBuffer = &_ring->transferCommandBuffers[frame];
+    VK_CHECK(vkResetCommandBuffer(commandBuffer->handle, 0));
+    VulkanCommandBufferReset(commandBuffer);
+    VulkanCommandBufferBegin(commandBuffer, TRUE, FALSE, FALSE);
+    _ring->recording = TRUE;
+    _ring->frame = frame;
+
+    return commandBuffer;
+}
+
+void VulkanStagingRingSubmit(
+    VulkanContext* _context,
+    VulkanStagingRing* _ring,
+    VkSemaphore* _outWaitSemaphore,
+    VkCommandBuffer* _outAcquireCommandBuffer)
+{
+    *_outWaitSemaphore = 0;
+    *_outAcquireCommandBuffer = 0;
+
+    if(!_ring->recording)
+        return;
+
+    //the slot is normally the current frame, it differs when swapchain recreation reset the frame index
+    u32 frame = _ring->frame;
+    VulkanCommandBuffer* commandBuffer = &_ring->transferCommandBuffers[frame];
+    VulkanCommandBufferEnd(commandBuffer);
+
+    VkSubmitInfo submitInfo = { VK_STRUCTURE_TYPE_SUBMIT_INFO };
+    submitInfo.commandBufferCount = 1;
+    submitInfo.pCommandBuffers = &commandBuffer->handle;
+    submitInfo.signalSemaphoreCount = 1;
+    submitInfo.pSignalSemaphores = &_ring->transferCompleteSemaphores[frame];
+    VK_CHECK(vkQueueSubmit(_context->device.transferQueue, 1, &submitInfo, 0));
+    VulkanCommandBufferUpdateSubmitted(commandBuffer);
+
+    //acquire barriers have to be recorded on the receiving queue family
+    u32 acquireCount = DArrayLength(_ring->pendingAcquires);
+    if(acquireCount > 0)
+    {
+        VulkanCommandBuffer* acquire = &_ring->acquireCommandBuffers[frame];
+        VK_CHECK(vkResetCommandBuffer(acquire->handle, 0));
+        VulkanCommandBufferReset(acquire);
+        VulkanCommandBufferBegin(acquire, TRUE, FALSE, FALSE);
+
+        vkCmdPipelineBarrier(
+            acquire->handle,
+            VULKAN_STAGING_CONSUMER_STAGES,
+            VULKAN_STAGING_CONSUMER_STAGES,
+            0,
+            0, 0,
+            acquireCount, _ring->pendingAcquires,
+            0, 0);
+
+        VulkanCommandBufferEnd(acquire);
+        DArrayClear(_ring->pendingAcquires);
+
+        *_outAcquireCommandBuffer = acquire->handle;
+    }
+
+    _ring->frameHeads[frame] = _ring->head;
+    _ring->frameValues[frame] = _context->frameTimelineValues[_context->currentFrame];
+    _ring->recording = FALSE;
+    *_outWaitSemaphore = _ring->transferCompleteSemaphores[frame];
+}
\ No newline at end of file
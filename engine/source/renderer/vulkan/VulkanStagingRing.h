@@ -0,0 +1,44 @@
+#pragma once
+
+#include "VulkanTypes.inl"
+
+//pipeline stages that may read uploaded data, the graphics submission waits for the transfer at these stages.
+//Also used for buffers written by async compute, which go through the same acquire barriers
+#define VULKAN_STAGING_CONSUMER_STAGES         \
+    (VK_PIPELINE_STAGE_DRAW_INDIRECT_BIT |     \
+     VK_PIPELINE_STAGE_VERTEX_INPUT_BIT |      \
+     VK_PIPELINE_STAGE_VERTEX_SHADER_BIT |     \
+     VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT)
+
+#define VULKAN_STAGING_CONSUMER_ACCESS         \
+    (VK_ACCESS_INDIRECT_COMMAND_READ_BIT |     \
+     VK_ACCESS_VERTEX_ATTRIBUTE_READ_BIT |     \
+     VK_ACCESS_INDEX_READ_BIT |                \
+     VK_ACCESS_UNIFORM_READ_BIT |              \
+     VK_ACCESS_SHADER_READ_BIT)
+
+b8 VulkanStagingRingCreate(VulkanContext* _context, u64 _size, VulkanStagingRing* _outRing);
+
+void VulkanStagingRingDestroy(VulkanContext* _context, VulkanStagingRing* _ring);
+
+/**
+ * Reserves _size bytes of the persistently mapped ring for the current frame.
+ * @param _outOffset offset of the reservation within the ring buffer.
+ * @returns a pointer to write the data to, or 0 if the ring is full.
+ */
+void* VulkanStagingRingAllocate(VulkanContext* _context, VulkanStagingRing* _ring, u64 _size, u64* _outOffset);
+
+//returns the transfer command buffer of the current frame, starting it on first use
+VulkanCommandBuffer* VulkanStagingRingGetCommandBuffer(VulkanContext* _context, VulkanStagingRing* _ring);
+
+/**
+ * Submits the uploads recorded this frame on the transfer queue. Call before the graphics submission.
+ * @param _outWaitSemaphore semaphore the graphics submission must wait on, 0 if nothing was submitted.
+ * @param _outAcquireCommandBuffer command buffer holding the ownership acquire barriers, to be executed
+ * on the graphics queue ahead of the frame's commands. 0 if there is none.
+ */
+void VulkanStagingRingSubmit(
+    VulkanContext* _context,
+    VulkanStagingRing* _ring,
+    VkSemaphore* _outWaitSemaphore,
+    VkCommandBuffer* _outAcquireCommandBuffer);
\ No newline at end of file
@@ -0,0 +1,579 @@
+#include "VulkanStaticMesh.h"
+
+#include "VulkanBuffer.h"
+#include "VulkanShader.h"
+#include "VulkanUploader.h"
+#include "VulkanPipelineCache.h"
+#include "VulkanDeletionQueue.h"
+#include "VulkanDescriptors.h"
+
+#include "core/Logger.h"
+#include "core/CMemory.h"
+
+#include "math/CMath.h"
+
+#include "containers/DArray.h"
+
+#include <stddef.h>
+#include <stdio.h>
+
+b8 StaticMeshCreateInstanceBuffer(VulkanContext* _context, VulkanStaticMeshes* _meshes, u32 _frameIndex, u64 _instanceCount);
+Vec4 StaticMeshBoundingSphere(const StaticMeshData* _data);
+b8 StaticMeshCreatePipelines(VulkanContext* _context, const VulkanStaticMeshPipelineCache* _cache, const VulkanRenderGraph* _graph, VulkanStaticMeshPipelines* _outSet);
+b8 StaticMeshPassCompatible(const VulkanRenderpassDesc* _a, const VulkanRenderpassDesc* _b);
+
+b8 VulkanStaticMeshesCreate(VulkanContext* _context, u32 _frameCount, VulkanStaticMeshes* _outMeshes)
+{
+    cZeroMemory(_outMeshes, sizeof(VulkanStaticMeshes));
+    _outMeshes->meshes = DArrayCreate(VulkanStaticMesh);
+    _outMeshes->freeHandles = DArrayCreate(u32);
+    _outMeshes->viewProjection = Mat4Identity();
+
+    //set 0 holds the frame's instance transforms
+    VkDescriptorSetLayoutBinding binding = {};
+    binding.binding = 0;
+    binding.descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
+    binding.descriptorCount = 1;
+    binding.stageFlags = VK_SHADER_STAGE_VERTEX_BIT;
+
+    //the library hands out the same layout the shaders reflect to
+    _outMeshes->setLayout = VulkanShaderLibraryGetSetLayout(_context, &_context->shaderLibrary, &binding, 1);
+    if(!_outMeshes->setLayout)
+        return FALSE;
+
+    for(u32 i = 0; i < _frameCount; ++i)
+    {
+        if(!StaticMeshCreateInstanceBuffer(_context, _outMeshes, i, VULKAN_STATIC_MESH_MIN_INSTANCES))
+        {
+            LOG_ERROR("Failed to create the static mesh instance buffers.");
+            return FALSE;
+        }
+    }
+
+    //the meshes can still be created and uploaded without shaders, they just never draw
+    if(!VulkanStaticMeshPipelineCacheCreate(_context, "StaticMesh.vert.spv", &_outMeshes->pipelines))
+    {
+        LOG_WARN("Static mesh shaders are missing, static meshes will not be drawn.");
+    }
+
+    return TRUE;
+}
+
+void VulkanStaticMeshesDestroy(VulkanContext* _context, VulkanStaticMeshes* _meshes)
+{
+    if(!_meshes->meshes)
+        return;
+
+    u64 meshCount = DArrayLength(_meshes->meshes);
+    for(u64 i = 0; i < meshCount; ++i)
+    {
+        VulkanStaticMesh* mesh = &_meshes->meshes[i];
+        if(!mesh->live)
+            continue;
+
+        VulkanBufferDestroy(_context, &mesh->vertexBuffer);
+        VulkanBufferDestroy(_context, &mesh->indexBuffer);
+    }
+
+    DArrayDestroy(_meshes->meshes);
+    DArrayDestroy(_meshes->freeHandles);
+
+    VulkanStaticMeshPipelineCacheDestroy(_context, &_meshes->pipelines);
+
+    for(u32 i = 0; i < VULKAN_MAX_FRAMES_IN_FLIGHT; ++i)
+    {
+        if(_meshes->instanceBuffers[i].handle)
+            VulkanBufferDestroy(_context, &_meshes->instanceBuffers[i]);
+    }
+
+    cZeroMemory(_meshes, sizeof(VulkanStaticMeshes));
+}
+
+u32 VulkanStaticMeshCreate(VulkanContext* _context, VulkanStaticMeshes* _meshes, const StaticMeshData* _data, u64* _outTicket)
+{
+    *_outTicket = 0;
+
+    u64 stride = _data->format == STATIC_MESH_VERTEX_FORMAT_QUANTIZED ? sizeof(VertexQuantized) : sizeof(Vertex3D);
+    u64 vertexSize = stride * _data->vertexCount;
+
+    //16 bit indices halve the index fetch bandwidth of most props
+    b8 shortIndices = _data->vertexCount <= 0x10000;
+    u64 indexStride = shortIndices ? sizeof(u16) : sizeof(u32);
+    u64 indexSize = indexStride * _data->indexCount;
+
+    VulkanStaticMesh mesh;
+    cZeroMemory(&mesh, sizeof(VulkanStaticMesh));
+
+    if(!VulkanBufferCreate(_context, vertexSize, VK_BUFFER_USAGE_VERTEX_BUFFER_BIT | VK_BUFFER_USAGE_TRANSFER_DST_BIT,
+        VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT, TRUE, &mesh.vertexBuffer))
+    {
+        LOG_ERROR("Failed to create a static mesh vertex buffer of %llu bytes.", vertexSize);
+        return RENDER_HANDLE_NONE;
+    }
+
+    if(!VulkanBufferCreate(_context, indexSize, VK_BUFFER_USAGE_INDEX_BUFFER_BIT | VK_BUFFER_USAGE_TRANSFER_DST_BIT,
+        VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT, TRUE, &mesh.indexBuffer))
+    {
+        LOG_ERROR("Failed to create a static mesh index buffer of %llu bytes.", indexSize);
+        VulkanBufferDestroy(_context, &mesh.vertexBuffer);
+        return RENDER_HANDLE_NONE;
+    }
+
+    //the uploader copies into its staging memory right away, the source data is not referenced afterwards
+    VulkanUploaderEnqueueBuffer(_context, &_context->uploader, &mesh.vertexBuffer, 0, vertexSize, _data->vertices);
+
+    if(shortIndices)
+    {
+        u16* indices = cAllocate(indexSize, MEMORY_TAG_RENDERER);
+        for(u32 i = 0; i < _data->indexCount; ++i)
+            indices[i] = (u16)_data->indices[i];
+
+        mesh.uploadTicket = VulkanUploaderEnqueueBuffer(_context, &_context->uploader, &mesh.indexBuffer, 0, indexSize, indices);
+        cFree(indices, indexSize, MEMORY_TAG_RENDERER);
+    }
+    else
+    {
+        mesh.uploadTicket = VulkanUploaderEnqueueBuffer(_context, &_context->uploader, &mesh.indexBuffer, 0, indexSize, _data->indices);
+    }
+
+    //batches complete in order, the index upload's ticket covers the vertices too
+    mesh.indexType = shortIndices ? VK_INDEX_TYPE_UINT16 : VK_INDEX_TYPE_UINT32;
+    mesh.indexCount = _data->indexCount;
+    mesh.format = _data->format;
+    mesh.boundingSphere = StaticMeshBoundingSphere(_data);
+    mesh.live = TRUE;
+
+    if(_data->format == STATIC_MESH_VERTEX_FORMAT_QUANTIZED)
+    {
+        mesh.positionScale = Vec4FromVec3(_data->boundsExtent, 0.f);
+        mesh.positionOffset = Vec4FromVec3(_data->boundsCenter, 0.f);
+    }
+    else
+    {
+        mesh.positionScale = Vec4Create(1.f, 1.f, 1.f, 0.f);
+        mesh.positionOffset = Vec4Create(0.f, 0.f, 0.f, 0.f);
+    }
+
+    u32 handle;
+    if(DArrayLength(_meshes->freeHandles) > 0)
+    {
+        DArrayPop(_meshes->freeHandles, &handle);
+        _meshes->meshes[handle] = mesh;
+    }
+    else
+    {
+        handle = (u32)DArrayLength(_meshes->meshes);
+        DArrayPush(_meshes->meshes, mesh);
+    }
+
+    _meshes->pendingCount++;
+    *_outTicket = mesh.uploadTicket;
+    return handle;
+}
+
+b8 VulkanStaticMeshDestroy(VulkanContext* _context, VulkanStaticMeshes* _meshes, u32 _mesh)
+{
+    if(_mesh >= DArrayLength(_meshes->meshes) || !_meshes->meshes[_mesh].live)
+    {
+        LOG_WARN("VulkanStaticMeshDestroy called with an invalid mesh handle %u.", _mesh);
+        return FALSE;
+    }
+
+    VulkanStaticMesh* mesh = &_meshes->meshes[_mesh];
+
+    //copies still queued or running on the transfer queue reference the buffers, the deletion queue only tracks graphics work
+    if(!mesh->ready)
+    {
+        VulkanUploaderWait(_context, &_context->uploader, mesh->uploadTicket, UINT64_MAX);
+        _meshes->pendingCount--;
+    }
+
+    VulkanDeletionQueueRetireBuffer(_context, &_context->deletionQueue, &mesh->vertexBuffer);
+    VulkanDeletionQueueRetireBuffer(_context, &_context->deletionQueue, &mesh->indexBuffer);
+
+    cZeroMemory(mesh, sizeof(VulkanStaticMesh));
+    DArrayPush(_meshes->freeHandles, _mesh);
+    return TRUE;
+}
+
+b8 VulkanStaticMeshesPrepareFrame(VulkanContext* _context, VulkanStaticMeshes* _meshes, u32 _frameIndex, const RenderPacket* _packet)
+{
+    //completion is sampled once here, so every recording thread sees the same meshes as drawable.
+    //The frame's submission acquires whatever completed by now ahead of its commands
+    if(_meshes->pendingCount > 0)
+    {
+        u64 meshCount = DArrayLength(_meshes->meshes);
+        for(u64 i = 0; i < meshCount; ++i)
+        {
+            VulkanStaticMesh* mesh = &_meshes->meshes[i];
+            if(mesh->live && !mesh->ready && VulkanUploaderIsComplete(_context, &_context->uploader, mesh->uploadTicket))
+            {
+                mesh->ready = TRUE;
+                _meshes->pendingCount--;
+            }
+        }
+    }
+
+    _meshes->viewProjection = _packet->viewProjection;
+    _meshes->frameInstanceCount = 0;
+    _meshes->instanceSet = 0;
+    if(_packet->instanceCount == 0)
+        return TRUE;
+
+    //the slot's previous frame has completed, its buffer can be replaced
+    VulkanBuffer* buffer = &_meshes->instanceBuffers[_frameIndex];
+    u64 size = sizeof(Mat4) * _packet->instanceCount;
+    if(size > buffer->totalSize)
+    {
+        u64 capacity = buffer->totalSize / sizeof(Mat4);
+        if(capacity < VULKAN_STATIC_MESH_MIN_INSTANCES)
+            capacity = VULKAN_STATIC_MESH_MIN_INSTANCES;
+        while(capacity < _packet->instanceCount)
+            capacity *= 2;
+
+        VulkanDeletionQueueRetireBuffer(_context, &_context->deletionQueue, buffer);
+        if(!StaticMeshCreateInstanceBuffer(_context, _meshes, _frameIndex, capacity))
+        {
+            LOG_ERROR("Failed to grow the static mesh instance buffer to %llu transforms.", capacity);
+            return FALSE;
+        }
+    }
+
+    VulkanBufferLoadData(_context, buffer, 0, size, _packet->instances);
+
+    //the allocator reset the frame's pools in BeginFrame, the set lives until the slot comes around again
+    _meshes->instanceSet = VulkanDescriptorAllocatorAllocate(_context, &_context->descriptorAllocator, _meshes->setLayout);
+    if(!_meshes->instanceSet)
+        return FALSE;
+
+    VkDescriptorBufferInfo bufferInfo;
+    bufferInfo.buffer = buffer->handle;
+    bufferInfo.offset = 0;
+    bufferInfo.range = size;
+
+    VkWriteDescriptorSet write = { VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET };
+    write.dstSet = _meshes->instanceSet;
+    write.dstBinding = 0;
+    write.descriptorCount = 1;
+    write.descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
+    write.pBufferInfo = &bufferInfo;
+    vkUpdateDescriptorSets(_context->device.logicalDevice, 1, &write, 0, 0);
+
+    _meshes->frameInstanceCount = _packet->instanceCount;
+    return TRUE;
+}
+
+void VulkanStaticMeshPipelineCacheBeginPass(VulkanContext* _context, VulkanStaticMeshPipelineCache* _cache, const VulkanRenderGraph* _graph)
+{
+    _cache->pass = 0;
+    if(!_cache->layout || !_graph->passActive)
+        return;
+
+    for(u32 i = 0; i < _cache->setCount; ++i)
+    {
+        if(StaticMeshPassCompatible(&_cache->sets[i].desc, &_graph->passDesc))
+        {
+            _cache->pass = &_cache->sets[i];
+            return;
+        }
+    }
+
+    if(_cache->setCount == VULKAN_MAX_GRAPH_RENDERPASSES)
+    {
+        LOG_WARN("Too many pass layouts for static mesh pipelines, meshes are not drawn in this pass.");
+        return;
+    }
+
+    VulkanStaticMeshPipelines* set = &_cache->sets[_cache->setCount];
+    if(!StaticMeshCreatePipelines(_context, _cache, _graph, set))
+        return;
+
+    _cache->setCount++;
+    _cache->pass = set;
+}
+
+void VulkanStaticMeshesRecordDraw(
+    VulkanContext* _context,
+    const VulkanStaticMeshes* _meshes,
+    VulkanCommandBuffer* _commandBuffer,
+    const RenderDraw* _draw,
+    VulkanStaticMeshBinding* _binding)
+{
+    const VulkanStaticMeshPipelines* pipelines = _meshes->pipelines.pass;
+    if(!pipelines || _draw->mesh >= DArrayLength(_meshes->meshes))
+        return;
+
+    const VulkanStaticMesh* mesh = &_meshes->meshes[_draw->mesh];
+    if(!mesh->ready || _draw->instanceCount == 0 || _draw->firstInstance + _draw->instanceCount > _meshes->frameInstanceCount)
+        return;
+
+    VkPipeline pipeline = pipelines->pipelines[mesh->format];
+    if(!pipeline)
+        return;
+
+    if(pipeline != _binding->pipeline)
+    {
+        vkCmdBindPipeline(_commandBuffer->handle, VK_PIPELINE_BIND_POINT_GRAPHICS, pipeline);
+        _binding->pipeline = pipeline;
+
+        //every format shares the layout, so the sets and the camera stay bound across pipeline changes
+        if(!_binding->layoutBound)
+        {
+            VkDescriptorSet sets[2] = { _meshes->instanceSet, _meshes->pipelines.bindlessSet };
+            vkCmdBindDescriptorSets(_commandBuffer->handle, VK_PIPELINE_BIND_POINT_GRAPHICS, _meshes->pipelines.layout,
+                0, sets[1] ? 2 : 1, sets, 0, 0);
+            vkCmdPushConstants(_commandBuffer->handle, _meshes->pipelines.layout, VK_SHADER_STAGE_VERTEX_BIT,
+                offsetof(VulkanStaticMeshPushConstants, viewProjection), sizeof(Mat4), &_meshes->viewProjection);
+            _binding->layoutBound = TRUE;
+        }
+    }
+
+    if(_draw->mesh != _binding->mesh)
+    {
+        VulkanStaticMeshBindGeometry(_commandBuffer, _meshes->pipelines.layout, mesh);
+        _binding->mesh = _draw->mesh;
+    }
+
+    u32 indexCount = _draw->indexCount ? _draw->indexCount : mesh->indexCount;
+    u32 firstIndex = _draw->indexCount ? _draw->firstIndex : 0;
+    vkCmdDrawIndexed(_commandBuffer->handle, indexCount, _draw->instanceCount, firstIndex, _draw->vertexOffset, _draw->firstInstance);
+}
+
+b8 VulkanStaticMeshPipelineCacheCreate(VulkanContext* _context, const char* _vertexShader, VulkanStaticMeshPipelineCache* _cache)
+{
+    cZeroMemory(_cache, sizeof(VulkanStaticMeshPipelineCache));
+    VulkanShaderLibrary* library = &_context->shaderLibrary;
+
+    //every cache shares the fragment shader, the library loads it once
+    char path[256];
+    snprintf(path, sizeof(path), VULKAN_SHADER_PATH "%s", _vertexShader);
+    _cache->vertexShader = VulkanShaderLibraryLoad(_context, library, path);
+    _cache->bindlessSet = _context->bindlessTable.set;
+    _cache->fragmentShader = VulkanShaderLibraryLoad(_context, library,
+        _cache->bindlessSet ? VULKAN_SHADER_PATH "StaticMeshBindless.frag.spv" : VULKAN_SHADER_PATH "StaticMesh.frag.spv");
+    if(_cache->vertexShader == RENDER_HANDLE_NONE || _cache->fragmentShader == RENDER_HANDLE_NONE)
+        return FALSE;
+
+    u32 shaders[2] = { _cache->vertexShader, _cache->fragmentShader };
+    _cache->layout = VulkanShaderLibraryGetPipelineLayout(_context, library, shaders, 2);
+    return _cache->layout != 0;
+}
+
+void VulkanStaticMeshPipelineCacheDestroy(VulkanContext* _context, VulkanStaticMeshPipelineCache* _cache)
+{
+    VkDevice device = _context->device.logicalDevice;
+    for(u32 i = 0; i < _cache->setCount; ++i)
+    {
+        for(u32 j = 0; j < STATIC_MESH_VERTEX_FORMAT_COUNT; ++j)
+        {
+            if(_cache->sets[i].pipelines[j])
+                vkDestroyPipeline(device, _cache->sets[i].pipelines[j], _context->allocator);
+        }
+    }
+
+    //the layout belongs to the library
+    VulkanShaderLibraryRelease(_context, &_context->shaderLibrary, &_cache->vertexShader);
+    VulkanShaderLibraryRelease(_context, &_context->shaderLibrary, &_cache->fragmentShader);
+    cZeroMemory(_cache, sizeof(VulkanStaticMeshPipelineCache));
+}
+
+void VulkanStaticMeshBindGeometry(VulkanCommandBuffer* _commandBuffer, VkPipelineLayout _layout, const VulkanStaticMesh* _mesh)
+{
+    VkDeviceSize offset = 0;
+    vkCmdBindVertexBuffers(_commandBuffer->handle, 0, 1, &_mesh->vertexBuffer.handle, &offset);
+    vkCmdBindIndexBuffer(_commandBuffer->handle, _mesh->indexBuffer.handle, 0, _mesh->indexType);
+
+    //positionScale and positionOffset are adjacent in both structs
+    vkCmdPushConstants(_commandBuffer->handle, _layout, VK_SHADER_STAGE_VERTEX_BIT,
+        offsetof(VulkanStaticMeshPushConstants, positionScale), sizeof(Vec4) * 2, &_mesh->positionScale);
+}
+
+b8 StaticMeshCreateInstanceBuffer(VulkanContext* _context, VulkanStaticMeshes* _meshes, u32 _frameIndex, u64 _instanceCount)
+{
+    return VulkanBufferCreate(_context, sizeof(Mat4) * _instanceCount, VK_BUFFER_USAGE_STORAGE_BUFFER_BIT,
+        VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT, TRUE, &_meshes->instanceBuffers[_frameIndex]);
+}
+
+Vec4 StaticMeshBoundingSphere(const StaticMeshData* _data)
+{
+    //quantized positions never leave their bounds
+    if(_data->format == STATIC_MESH_VERTEX_FORMAT_QUANTIZED)
+        return Vec4FromVec3(_data->boundsCenter, Vec3Length(_data->boundsExtent));
+
+    //sphere around the bounding box, looser than the minimal sphere but found in one pass
+    const Vertex3D* vertices = _data->vertices;
+    Vec3 minimum = vertices[0].position;
+    Vec3 maximum = vertices[0].position;
+    for(u32 i = 1; i < _data->vertexCount; ++i)
+    {
+        for(u32 axis = 0; axis < 3; ++axis)
+        {
+            f32 value = vertices[i].position.elements[axis];
+            if(value < minimum.elements[axis])
+                minimum.elements[axis] = value;
+            if(value > maximum.elements[axis])
+                maximum.elements[axis] = value;
+        }
+    }
+
+    Vec3 center = Vec3Scale(Vec3Add(minimum, maximum), 0.5f);
+    return Vec4FromVec3(center, Vec3Length(Vec3Sub(maximum, center)));
+}
+
+b8 StaticMeshCreatePipelines(VulkanContext* _context, const VulkanStaticMeshPipelineCache* _cache, const VulkanRenderGraph* _graph, VulkanStaticMeshPipelines* _outSet)
+{
+    const VulkanRenderpassDesc* desc = &_graph->passDesc;
+
+    //quantized positions and normals are snorm, texcoords half floats. The shader decodes octahedral normals
+    //when the specialization constant is set, the missing z of the two component normal reads as 0
+    VkVertexInputBindingDescription bindings[STATIC_MESH_VERTEX_FORMAT_COUNT] = {
+        { 0, sizeof(Vertex3D), VK_VERTEX_INPUT_RATE_VERTEX },
+        { 0, sizeof(VertexQuantized), VK_VERTEX_INPUT_RATE_VERTEX }
+    };
+    VkVertexInputAttributeDescription attributes[STATIC_MESH_VERTEX_FORMAT_COUNT][3] = {
+        {
+            { 0, 0, VK_FORMAT_R32G32B32_SFLOAT, offsetof(Vertex3D, position) },
+            { 1, 0, VK_FORMAT_R32G32B32_SFLOAT, offsetof(Vertex3D, normal) },
+            { 2, 0, VK_FORMAT_R32G32_SFLOAT, offsetof(Vertex3D, texcoord) }
+        },
+        {
+            { 0, 0, VK_FORMAT_R16G16B16A16_SNORM, offsetof(VertexQuantized, position) },
+            { 1, 0, VK_FORMAT_R16G16_SNORM, offsetof(VertexQuantized, normal) },
+            { 2, 0, VK_FORMAT_R16G16_SFLOAT, offsetof(VertexQuantized, texcoord) }
+        }
+    };
+    VkBool32 quantized[STATIC_MESH_VERTEX_FORMAT_COUNT] = { VK_FALSE, VK_TRUE };
+
+    VkSpecializationMapEntry specializationEntry = { 0, 0, sizeof(VkBool32) };
+    VkSpecializationInfo specializations[STATIC_MESH_VERTEX_FORMAT_COUNT];
+    VkPipelineShaderStageCreateInfo stages[STATIC_MESH_VERTEX_FORMAT_COUNT][2];
+    VkPipelineVertexInputStateCreateInfo vertexInputs[STATIC_MESH_VERTEX_FORMAT_COUNT];
+
+    VkPipelineInputAssemblyStateCreateInfo inputAssembly = { VK_STRUCTURE_TYPE_PIPELINE_INPUT_ASSEMBLY_STATE_CREATE_INFO };
+    inputAssembly.topology = VK_PRIMITIVE_TOPOLOGY_TRIANGLE_LIST;
+
+    //viewport and scissor are set per secondary
+    VkPipelineViewportStateCreateInfo viewportState = { VK_STRUCTURE_TYPE_PIPELINE_VIEWPORT_STATE_CREATE_INFO };
+    viewportState.viewportCount = 1;
+    viewportState.scissorCount = 1;
+
+    VkDynamicState dynamicStates[2] = { VK_DYNAMIC_STATE_VIEWPORT, VK_DYNAMIC_STATE_SCISSOR };
+    VkPipelineDynamicStateCreateInfo dynamicState = { VK_STRUCTURE_TYPE_PIPELINE_DYNAMIC_STATE_CREATE_INFO };
+    dynamicState.dynamicStateCount = 2;
+    dynamicState.pDynamicStates = dynamicStates;
+
+    //the viewport is flipped, so counter clockwise stays the front face like with GL conventions
+    VkPipelineRasterizationStateCreateInfo rasterization = { VK_STRUCTURE_TYPE_PIPELINE_RASTERIZATION_STATE_CREATE_INFO };
+    rasterization.polygonMode = VK_POLYGON_MODE_FILL;
+    rasterization.cullMode = VK_CULL_MODE_BACK_BIT;
+    rasterization.frontFace = VK_FRONT_FACE_COUNTER_CLOCKWISE;
+    rasterization.lineWidth = 1.f;
+
+    VkPipelineMultisampleStateCreateInfo multisample = { VK_STRUCTURE_TYPE_PIPELINE_MULTISAMPLE_STATE_CREATE_INFO };
+    multisample.rasterizationSamples = VK_SAMPLE_COUNT_1_BIT;
+
+    b8 hasDepth = desc->depthFormat != VK_FORMAT_UNDEFINED;
+    VkPipelineDepthStencilStateCreateInfo depthStencil = { VK_STRUCTURE_TYPE_PIPELINE_DEPTH_STENCIL_STATE_CREATE_INFO };
+    depthStencil.depthTestEnable = hasDepth ? VK_TRUE : VK_FALSE;
+    depthStencil.depthWriteEnable = hasDepth && !desc->depthReadOnly ? VK_TRUE : VK_FALSE;
+    depthStencil.depthCompareOp = VK_COMPARE_OP_LESS;
+
+    //the fragment shader only writes the first color attachment, the others are left alone
+    VkPipelineColorBlendAttachmentState blendAttachments[RENDER_GRAPH_MAX_COLOR_ATTACHMENTS];
+    cZeroMemory(blendAttachments, sizeof(blendAttachments));
+    if(desc->colorCount > 0)
+    {
+        blendAttachments[0].colorWriteMask = VK_COLOR_COMPONENT_R_BIT | VK_COLOR_COMPONENT_G_BIT |
+                                             VK_COLOR_COMPONENT_B_BIT | VK_COLOR_COMPONENT_A_BIT;
+    }
+
+    VkPipelineColorBlendStateCreateInfo colorBlend = { VK_STRUCTURE_TYPE_PIPELINE_COLOR_BLEND_STATE_CREATE_INFO };
+    colorBlend.attachmentCount = desc->colorCount;
+    colorBlend.pAttachments = blendAttachments;
+
+    //dynamic rendering declares the attachment formats instead of a render pass
+    VkPipelineRenderingCreateInfo renderingInfo = { VK_STRUCTURE_TYPE_PIPELINE_RENDERING_CREATE_INFO };
+    renderingInfo.colorAttachmentCount = desc->colorCount;
+    renderingInfo.pColorAttachmentFormats = desc->colorFormats;
+    renderingInfo.depthAttachmentFormat = desc->depthFormat;
+    renderingInfo.stencilAttachmentFormat = VK_FORMAT_UNDEFINED;
+
+    VkGraphicsPipelineCreateInfo createInfos[STATIC_MESH_VERTEX_FORMAT_COUNT];
+    for(u32 i = 0; i < STATIC_MESH_VERTEX_FORMAT_COUNT; ++i)
+    {
+        specializations[i].mapEntryCount = 1;
+        specializations[i].pMapEntries = &specializationEntry;
+        specializations[i].dataSize = sizeof(VkBool32);
+        specializations[i].pData = &quantized[i];
+
+        VkPipelineShaderStageCreateInfo vertexStage = { VK_STRUCTURE_TYPE_PIPELINE_SHADER_STAGE_CREATE_INFO };
+        vertexStage.stage = VK_SHADER_STAGE_VERTEX_BIT;
+        vertexStage.module = VulkanShaderLibraryGetModule(&_context->shaderLibrary, _cache->vertexShader);
+        vertexStage.pName = "main";
+        vertexStage.pSpecializationInfo = &specializations[i];
+        stages[i][0] = vertexStage;
+
+        VkPipelineShaderStageCreateInfo fragmentStage = { VK_STRUCTURE_TYPE_PIPELINE_SHADER_STAGE_CREATE_INFO };
+        fragmentStage.stage = VK_SHADER_STAGE_FRAGMENT_BIT;
+        fragmentStage.module = VulkanShaderLibraryGetModule(&_context->shaderLibrary, _cache->fragmentShader);
+        fragmentStage.pName = "main";
+        stages[i][1] = fragmentStage;
+
+        VkPipelineVertexInputStateCreateInfo vertexInput = { VK_STRUCTURE_TYPE_PIPELINE_VERTEX_INPUT_STATE_CREATE_INFO };
+        vertexInput.vertexBindingDescriptionCount = 1;
+        vertexInput.pVertexBindingDescriptions = &bindings[i];
+        vertexInput.vertexAttributeDescriptionCount = 3;
+        vertexInput.pVertexAttributeDescriptions = attributes[i];
+        vertexInputs[i] = vertexInput;
+
+        VkGraphicsPipelineCreateInfo createInfo = { VK_STRUCTURE_TYPE_GRAPHICS_PIPELINE_CREATE_INFO };
+        createInfo.pNext = _graph->passRenderpass ? 0 : &renderingInfo;
+        createInfo.stageCount = 2;
+        createInfo.pStages = stages[i];
+        createInfo.pVertexInputState = &vertexInputs[i];
+        createInfo.pInputAssemblyState = &inputAssembly;
+        createInfo.pViewportState = &viewportState;
+        createInfo.pRasterizationState = &rasterization;
+        createInfo.pMultisampleState = &multisample;
+        createInfo.pDepthStencilState = &depthStencil;
+        createInfo.pColorBlendState = &colorBlend;
+        createInfo.pDynamicState = &dynamicState;
+        createInfo.layout = _cache->layout;
+        createInfo.renderPass = _graph->passRenderpass ? _graph->passRenderpass->handle : 0;
+        createInfo.subpass = 0;
+        createInfo.basePipelineIndex = -1;
+        createInfos[i] = createInfo;
+    }
+
+    //the formats compile on separate job threads
+    cZeroMemory(_outSet, sizeof(VulkanStaticMeshPipelines));
+    VkResult result = VulkanPipelineCacheCreateGraphicsPipelines(_context, STATIC_MESH_VERTEX_FORMAT_COUNT, createInfos, _outSet->pipelines);
+    if(result != VK_SUCCESS)
+    {
+        LOG_ERROR("Failed to create the static mesh pipelines.");
+        for(u32 i = 0; i < STATIC_MESH_VERTEX_FORMAT_COUNT; ++i)
+        {
+            if(_outSet->pipelines[i])
+                vkDestroyPipeline(_context->device.logicalDevice, _outSet->pipelines[i], _context->allocator);
+        }
+        cZeroMemory(_outSet, sizeof(VulkanStaticMeshPipelines));
+        return FALSE;
+    }
+
+    _outSet->desc = *desc;
+    return TRUE;
+}
+
+b8 StaticMeshPassCompatible(const VulkanRenderpassDesc* _a, const VulkanRenderpassDesc* _b)
+{
+    if(_a->colorCount != _b->colorCount || _a->depthFormat != _b->depthFormat || _a->depthReadOnly != _b->depthReadOnly)
+        return FALSE;
+
+    for(u32 i = 0; i < _a->colorCount; ++i)
+    {
+        if(_a->colorFormats[i] != _b->colorFormats[i])
+            return FALSE;
+    }
+
+    return TRUE;
+}
\ No newline at end of file
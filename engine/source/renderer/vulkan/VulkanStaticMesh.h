@@ -0,0 +1,82 @@
+#pragma once
+
+#include "VulkanTypes.inl"
+
+//layout of the StaticMesh.vert and StaticMeshIndirect.vert push constant blocks
+typedef struct VulkanStaticMeshPushConstants
+{
+    Mat4 viewProjection;
+    Vec4 positionScale;
+    Vec4 positionOffset;
+} VulkanStaticMeshPushConstants;
+
+/**
+ * Static meshes live in their own device local vertex and index buffers, uploaded once through the
+ * async uploader. Instances are drawn with one indexed draw per mesh, the vertex shader reads each
+ * instance's transform from a per-frame storage buffer with gl_InstanceIndex, so firstInstance
+ * selects the draw's range of the frame's transforms.
+ * Shaders that fail to load only disable mesh drawing, the renderer keeps working without them.
+ */
+b8 VulkanStaticMeshesCreate(VulkanContext* _context, u32 _frameCount, VulkanStaticMeshes* _outMeshes);
+
+//the device must be idle
+void VulkanStaticMeshesDestroy(VulkanContext* _context, VulkanStaticMeshes* _meshes);
+
+/**
+ * Creates the mesh's buffers and queues the upload of its vertices and indices.
+ * @param _outTicket uploader ticket covering both copies, 0 on failure.
+ * @returns the mesh handle, RENDER_HANDLE_NONE on failure.
+ */
+u32 VulkanStaticMeshCreate(VulkanContext* _context, VulkanStaticMeshes* _meshes, const StaticMeshData* _data, u64* _outTicket);
+
+//retires the mesh's buffers to the deletion queue, waiting for its upload first if that is still running.
+//FALSE for invalid handles
+b8 VulkanStaticMeshDestroy(VulkanContext* _context, VulkanStaticMeshes* _meshes, u32 _mesh);
+
+/**
+ * Marks meshes whose upload completed as drawable and copies the packet's instance transforms
+ * into the buffer of _frameIndex, growing it when needed, and points a transient set at it. Render
+ * thread, after the slot's previous frame completed and the descriptor allocator began the frame.
+ */
+b8 VulkanStaticMeshesPrepareFrame(VulkanContext* _context, VulkanStaticMeshes* _meshes, u32 _frameIndex, const RenderPacket* _packet);
+
+/**
+ * Loads _vertexShader, a file name under VULKAN_SHADER_PATH, and the shared fragment shader through
+ * the shader library, which also builds the pipeline layout from their reflection. The fragment shader
+ * is StaticMeshBindless.frag, sampling the bindless table, or StaticMesh.frag when the table is disabled.
+ * @returns FALSE when a shader is missing, the cache then never provides pipelines.
+ */
+b8 VulkanStaticMeshPipelineCacheCreate(VulkanContext* _context, const char* _vertexShader, VulkanStaticMeshPipelineCache* _cache);
+
+//the device must be idle
+void VulkanStaticMeshPipelineCacheDestroy(VulkanContext* _context, VulkanStaticMeshPipelineCache* _cache);
+
+//picks the pipelines for the attachments of the pass that just began, creating them on first use. Render thread
+void VulkanStaticMeshPipelineCacheBeginPass(VulkanContext* _context, VulkanStaticMeshPipelineCache* _cache, const VulkanRenderGraph* _graph);
+
+CINLINE void VulkanStaticMeshPipelineCacheEndPass(VulkanStaticMeshPipelineCache* _cache)
+{
+    _cache->pass = 0;
+}
+
+//binds the mesh's vertex and index buffers and pushes its position decode constants
+void VulkanStaticMeshBindGeometry(VulkanCommandBuffer* _commandBuffer, VkPipelineLayout _layout, const VulkanStaticMesh* _mesh);
+
+CINLINE void VulkanStaticMeshBindingReset(VulkanStaticMeshBinding* _binding)
+{
+    _binding->pipeline = 0;
+    _binding->mesh = RENDER_HANDLE_NONE;
+    _binding->layoutBound = FALSE;
+}
+
+/**
+ * Records a draw of _draw->mesh, binding the pipeline of the mesh's vertex format and the mesh's
+ * buffers when they differ from _binding. Draws of meshes still uploading, or with instances beyond
+ * the frame's transforms, are skipped. Safe to call from several recording threads at once.
+ */
+void VulkanStaticMeshesRecordDraw(
+    VulkanContext* _context,
+    const VulkanStaticMeshes* _meshes,
+    VulkanCommandBuffer* _commandBuffer,
+    const RenderDraw* _draw,
+    VulkanStaticMeshBinding* _binding);
\ No newline at end of file
@@ -1,13 +1,16 @@
 #include "VulkanSwapchain.h"
 
 #include "VulkanDevice.h"
+#include "VulkanDeletionQueue.h"
 #include "VulkanImage.h"
 
 #include "core/Logger.h"
 #include "core/CMemory.h"
 
-void create(VulkanContext* _context, u32 _width, u32 _height, VulkanSwapchain* _swapchain);
+void create(VulkanContext* _context, u32 _width, u32 _height, VkSwapchainKHR _oldHandle, VulkanSwapchain* _swapchain);
 void destroy(VulkanContext* _context, VulkanSwapchain* _swapchain);
+void createOffscreen(VulkanContext* _context, u32 _width, u32 _height, VulkanSwapchain* _swapchain);
+void destroyOffscreen(VulkanContext* _context, VulkanSwapchain* _swapchain);
 
 void VulkanSwapchainCreate(
     VulkanContext* _context,
@@ -16,7 +19,7 @@ void VulkanSwapchainCreate(
     VulkanSwapchain* _outSwapchain)
 {
     //simply create new swapchain
-    create(_context, _width, _height, _outSwapchain);
+    create(_context, _width, _height, 0, _outSwapchain);
 }
 
 void VulkanSwapchainRecreate(
@@ -25,13 +28,42 @@ void VulkanSwapchainRecreate(
     u32 _height,
     VulkanSwapchain* _swapchain)
 {
-    //destroy the old create the new one
-    destroy(_context, _swapchain);
-    create(_context, _width, _height, _swapchain);
+    //headless, frames in flight keep rendering into the old images until the deletion queue reaches them
+    if(!_context->surface)
+    {
+        for(u32 i = 0; i < _swapchain->imageCount; ++i)
+            VulkanDeletionQueueRetireImage(_context, &_context->deletionQueue, &_swapchain->offscreenImages[i]);
+
+        destroyOffscreen(_context, _swapchain);
+        createOffscreen(_context, _width, _height, _swapchain);
+        return;
+    }
+
+    //take the current resources out instead of waiting for the device, frames in flight keep using them
+    VkSwapchainKHR oldHandle = _swapchain->handle;
+    u32 oldImageCount = _swapchain->imageCount;
+    VkImageView* oldViews = _swapchain->views;
+
+    //images are owned by the old swapchain, only the array is ours
+    cFree(_swapchain->images, sizeof(VkImage) * _swapchain->imageCount, MEMORY_TAG_RENDERER);
+    _swapchain->images = 0;
+    _swapchain->views = 0;
+
+    //the old swapchain is handed to the new one, which may take over its presentation resources
+    create(_context, _width, _height, oldHandle, _swapchain);
+
+    //retired in dependency order, the queue destroys them in the same order
+    VulkanDeletionQueue* queue = &_context->deletionQueue;
+    for(u32 i = 0; i < oldImageCount; ++i)
+        VulkanDeletionQueueRetireImageView(_context, queue, &oldViews[i]);
+    VulkanDeletionQueueRetireSwapchain(_context, queue, &oldHandle);
+
+    cFree(oldViews, sizeof(VkImageView) * oldImageCount, MEMORY_TAG_RENDERER);
 }
 
 void VulkanSwapchainDestroy(VulkanContext* _context, VulkanSwapchain* _swapchain)
 {
+    vkDeviceWaitIdle(_context->device.logicalDevice);
     destroy(_context, _swapchain);
 }
 
@@ -43,6 +75,14 @@ b8 VulkanSwapchainAcquireNextImageIndex(
     VkFence _fence,
     u32* _outImageIndex)
 {
+    //headless, the image timeline values already keep the backend from reusing an image still being rendered
+    if(!_context->surface)
+    {
+        *_outImageIndex = _swapchain->nextOffscreenImage;
+        _swapchain->nextOffscreenImage = (_swapchain->nextOffscreenImage + 1) % _swapchain->imageCount;
+        return TRUE;
+    }
+
     VkResult result = vkAcquireNextImageKHR(_context->device.logicalDevice, 
         _swapchain->handle, 
         _timeoutNS, 
@@ -52,8 +92,8 @@ b8 VulkanSwapchainAcquireNextImageIndex(
     
     if(result == VK_ERROR_OUT_OF_DATE_KHR)
     {
-        //trigger swapchain recreation, then return from render loop
-        VulkanSwapchainRecreate(_context, _context->framebufferWidth, _context->framebufferHeight, _swapchain);
+        //trigger swapchain recreation at the start of the next frame, then return from render loop
+        _context->framebufferSizeGeneration++;
         return FALSE;
     }
     else if(result != VK_SUCCESS && result != VK_SUBOPTIMAL_KHR)
@@ -73,6 +113,13 @@ void VulkanSwapchainPresent(
     VkSemaphore _renderCompleteSemaphore,
     u32 _presentImageIndex)
 {
+    //headless, nothing to present, the frame stays in the offscreen image
+    if(!_context->surface)
+    {
+        _context->currentFrame = (_context->currentFrame + 1) % _swapchain->maxFramesInFlight;
+        return;
+    }
+
     //return the image to the swapchain for presentation
     VkPresentInfoKHR presentInfo = { VK_STRUCTURE_TYPE_PRESENT_INFO_KHR };
     presentInfo.waitSemaphoreCount = 1;
@@ -82,25 +129,48 @@ void VulkanSwapchainPresent(
     presentInfo.pImageIndices = &_presentImageIndex;
     presentInfo.pResults = 0;
 
+    //tag the present with the frame's timeline value so the low latency mode can wait on it
+    VkPresentIdKHR presentId = { VK_STRUCTURE_TYPE_PRESENT_ID_KHR };
+    uint64_t presentIdValue = _context->frameTimelineValues[_context->currentFrame];
+    if(_context->device.supportsPresentWait)
+    {
+        presentId.swapchainCount = 1;
+        presentId.pPresentIds = &presentIdValue;
+        presentInfo.pNext = &presentId;
+    }
+
     VkResult result = vkQueuePresentKHR(_presentQueue, &presentInfo);
     if(result == VK_ERROR_OUT_OF_DATE_KHR || result == VK_SUBOPTIMAL_KHR)
     {
         //swapchain is out of date, suboptimal or a framebuffer resize has occured, trigger swapchain recreation
-        VulkanSwapchainRecreate(_context, _context->framebufferWidth, _context->framebufferHeight, _swapchain);
+        //at the start of the next frame so the framebuffers are rebuilt with it
+        _context->framebufferSizeGeneration++;
     }
     else if (result != VK_SUCCESS)
         LOG_FATAL("Failed to present swapchain image.");
 
+    if(_context->device.supportsPresentWait)
+        _swapchain->lastPresentId = presentIdValue;
+
     //increment (and loop) the index
     _context->currentFrame = (_context->currentFrame + 1) % _swapchain->maxFramesInFlight;
 }
 
-void create(VulkanContext* _context, u32 _width, u32 _height, VulkanSwapchain* _swapchain)
+void create(VulkanContext* _context, u32 _width, u32 _height, VkSwapchainKHR _oldHandle, VulkanSwapchain* _swapchain)
 {
     LOG_INFO("Creating Vulkan swapchain...");
 
     VkExtent2D swapchainExtent = { _width, _height };
-    _swapchain->maxFramesInFlight = 2; //triple buffering
+    //set by the backend before the first creation, kept across recreation
+    if(_swapchain->maxFramesInFlight == 0)
+        _swapchain->maxFramesInFlight = 2; //double buffering
+    _swapchain->maxFramesInFlight = CCLAMP(_swapchain->maxFramesInFlight, 1, VULKAN_MAX_FRAMES_IN_FLIGHT);
+
+    if(!_context->surface)
+    {
+        createOffscreen(_context, _width, _height, _swapchain);
+        return;
+    }
 
     //choose swap surface format
     b8 found = FALSE;
@@ -120,18 +190,24 @@ void create(VulkanContext* _context, u32 _width, u32 _height, VulkanSwapchain* _
     if(!found)
         _swapchain->imageFormat = _context->device.swapchainSupport.formats[0];
 
-    //present mode
+    //present mode, FIFO is the only one guaranteed to be supported
     VkPresentModeKHR presentMode = VK_PRESENT_MODE_FIFO_KHR;
     for(u32 i = 0; i < _context->device.swapchainSupport.presentModeCount; ++i)
     {
         VkPresentModeKHR mode = _context->device.swapchainSupport.presentModes[i];
-        if(mode == VK_PRESENT_MODE_MAILBOX_KHR)
+        if(mode == _swapchain->requestedPresentMode)
         {
             presentMode = mode;
             break;
         }
     }
 
+    if(presentMode != _swapchain->requestedPresentMode)
+    {
+        LOG_WARN("Requested present mode is not supported, falling back to FIFO.");
+    }
+    _swapchain->presentMode = presentMode;
+
     //requery swapchain support
     VulkanDeviceQuerySwapchainSupport(_context->device.physicalDevice, _context->surface, &_context->device.swapchainSupport);
 
@@ -144,8 +220,16 @@ void create(VulkanContext* _context, u32 _width, u32 _height, VulkanSwapchain* _
     VkExtent2D max = _context->device.swapchainSupport.capabilities.maxImageExtent;
     swapchainExtent.width = CCLAMP(swapchainExtent.width, min.width, max.width);
     swapchainExtent.height = CCLAMP(swapchainExtent.height, min.height, max.height);
+    _swapchain->extent = swapchainExtent;
 
+    //requested image count, the surface minimum plus one by default
     u32 imageCount = _context->device.swapchainSupport.capabilities.minImageCount + 1;
+    if(_swapchain->requestedImageCount > 0)
+    {
+        imageCount = _swapchain->requestedImageCount;
+        if(imageCount < _context->device.swapchainSupport.capabilities.minImageCount)
+            imageCount = _context->device.swapchainSupport.capabilities.minImageCount;
+    }
     if(_context->device.swapchainSupport.capabilities.maxImageCount > 0 && imageCount > _context->device.swapchainSupport.capabilities.maxImageCount)
         imageCount = _context->device.swapchainSupport.capabilities.maxImageCount;
 
@@ -180,20 +264,19 @@ void create(VulkanContext* _context, u32 _width, u32 _height, VulkanSwapchain* _
     swapchainCreateInfo.compositeAlpha = VK_COMPOSITE_ALPHA_OPAQUE_BIT_KHR;
     swapchainCreateInfo.presentMode = presentMode;
     swapchainCreateInfo.clipped = VK_TRUE;
-    swapchainCreateInfo.oldSwapchain = 0;
+    swapchainCreateInfo.oldSwapchain = _oldHandle;
 
     VK_CHECK(vkCreateSwapchainKHR(_context->device.logicalDevice, &swapchainCreateInfo, _context->allocator, &_swapchain->handle));
 
-    //start with a 0 frame index
+    //start with a 0 frame index, nothing has been presented to the new swapchain
     _context->currentFrame = 0;
+    _swapchain->lastPresentId = 0;
 
     //images
     _swapchain->imageCount = 0;
     VK_CHECK(vkGetSwapchainImagesKHR(_context->device.logicalDevice, _swapchain->handle, &_swapchain->imageCount, 0));
-    if(!_swapchain->images)
-        _swapchain->images = (VkImage*)cAllocate(sizeof(VkImage) * _swapchain->imageCount, MEMORY_TAG_RENDERER);
-    if(!_swapchain->views)
-        _swapchain->views = (VkImageView*)cAllocate(sizeof(VkImageView) * _swapchain->imageCount, MEMORY_TAG_RENDERER);
+    _swapchain->images = (VkImage*)cAllocate(sizeof(VkImage) * _swapchain->imageCount, MEMORY_TAG_RENDERER);
+    _swapchain->views = (VkImageView*)cAllocate(sizeof(VkImageView) * _swapchain->imageCount, MEMORY_TAG_RENDERER);
     VK_CHECK(vkGetSwapchainImagesKHR(_context->device.logicalDevice, _swapchain->handle, &_swapchain->imageCount, _swapchain->images));
 
     //views
@@ -212,37 +295,84 @@ void create(VulkanContext* _context, u32 _width, u32 _height, VulkanSwapchain* _
         VK_CHECK(vkCreateImageView(_context->device.logicalDevice, &viewInfo, _context->allocator, &_swapchain->views[i]));
     }
 
-    //depth resources
-    if(!VulkanDeviceDetectDepthFormat(&_context->device))
-    {
-        _context->device.depthFormat = VK_FORMAT_UNDEFINED;
-        LOG_FATAL("Failed to find a supported format.");
-    }
-
-    VulkanImageCreate(
-        _context,
-        VK_IMAGE_TYPE_2D,
-        swapchainExtent.width,
-        swapchainExtent.height,
-        _context->device.depthFormat,
-        VK_IMAGE_TILING_OPTIMAL,
-        VK_IMAGE_USAGE_DEPTH_STENCIL_ATTACHMENT_BIT,
-        VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT,
-        TRUE,
-        VK_IMAGE_ASPECT_DEPTH_BIT,
-        &_swapchain->depthAttachment);
-
     LOG_INFO("Vulkan swapchain created successfully.");
 }
 
 void destroy(VulkanContext* _context, VulkanSwapchain* _swapchain)
 {
-    vkDeviceWaitIdle(_context->device.logicalDevice);
-    VulkanImageDestroy(_context, &_swapchain->depthAttachment);
+    if(!_context->surface)
+    {
+        for(u32 i = 0; i < _swapchain->imageCount; ++i)
+            VulkanImageDestroy(_context, &_swapchain->offscreenImages[i]);
+
+        destroyOffscreen(_context, _swapchain);
+        return;
+    }
 
     //only destroy the view, not the images, since those are owned by swapchain
     for(u32 i = 0; i < _swapchain->imageCount; ++i)
         vkDestroyImageView(_context->device.logicalDevice, _swapchain->views[i], _context->allocator);
-    
+
+    cFree(_swapchain->images, sizeof(VkImage) * _swapchain->imageCount, MEMORY_TAG_RENDERER);
+    cFree(_swapchain->views, sizeof(VkImageView) * _swapchain->imageCount, MEMORY_TAG_RENDERER);
+    _swapchain->images = 0;
+    _swapchain->views = 0;
+
     vkDestroySwapchainKHR(_context->device.logicalDevice, _swapchain->handle, _context->allocator);
+    _swapchain->handle = 0;
+}
+
+void createOffscreen(VulkanContext* _context, u32 _width, u32 _height, VulkanSwapchain* _swapchain)
+{
+    LOG_INFO("Creating offscreen images for headless rendering...");
+
+    //the same format a surface would usually be given, readable with a copy once rendered
+    _swapchain->imageFormat.format = VK_FORMAT_B8G8R8A8_UNORM;
+    _swapchain->imageFormat.colorSpace = VK_COLOR_SPACE_SRGB_NONLINEAR_KHR;
+    _swapchain->presentMode = VK_PRESENT_MODE_FIFO_KHR;
+    _swapchain->extent.width = _width;
+    _swapchain->extent.height = _height;
+    _swapchain->handle = 0;
+    _swapchain->lastPresentId = 0;
+    _context->currentFrame = 0;
+
+    //one image per frame in flight unless more were requested, nothing holds on to them for presentation
+    _swapchain->imageCount = _swapchain->requestedImageCount > 0 ? _swapchain->requestedImageCount : _swapchain->maxFramesInFlight;
+    _swapchain->nextOffscreenImage = 0;
+    _swapchain->offscreenImages = (VulkanImage*)cAllocate(sizeof(VulkanImage) * _swapchain->imageCount, MEMORY_TAG_RENDERER);
+    _swapchain->images = (VkImage*)cAllocate(sizeof(VkImage) * _swapchain->imageCount, MEMORY_TAG_RENDERER);
+    _swapchain->views = (VkImageView*)cAllocate(sizeof(VkImageView) * _swapchain->imageCount, MEMORY_TAG_RENDERER);
+
+    for(u32 i = 0; i < _swapchain->imageCount; ++i)
+    {
+        VulkanImageCreate(
+            _context,
+            VK_IMAGE_TYPE_2D,
+            _width,
+            _height,
+            _swapchain->imageFormat.format,
+            VK_IMAGE_TILING_OPTIMAL,
+            VK_IMAGE_USAGE_COLOR_ATTACHMENT_BIT | VK_IMAGE_USAGE_TRANSFER_SRC_BIT,
+            VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT,
+            TRUE,
+            VK_IMAGE_ASPECT_COLOR_BIT,
+            &_swapchain->offscreenImages[i]);
+
+        _swapchain->images[i] = _swapchain->offscreenImages[i].handle;
+        _swapchain->views[i] = _swapchain->offscreenImages[i].view;
+    }
+
+    LOG_INFO("Offscreen images created successfully.");
+}
+
+void destroyOffscreen(VulkanContext* _context, VulkanSwapchain* _swapchain)
+{
+    //the images themselves are destroyed or retired by the caller
+    cFree(_swapchain->offscreenImages, sizeof(VulkanImage) * _swapchain->imageCount, MEMORY_TAG_RENDERER);
+    cFree(_swapchain->images, sizeof(VkImage) * _swapchain->imageCount, MEMORY_TAG_RENDERER);
+    cFree(_swapchain->views, sizeof(VkImageView) * _swapchain->imageCount, MEMORY_TAG_RENDERER);
+    _swapchain->offscreenImages = 0;
+    _swapchain->images = 0;
+    _swapchain->views = 0;
+    _swapchain->imageCount = 0;
 }
\ No newline at end of file
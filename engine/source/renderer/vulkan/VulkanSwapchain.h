@@ -2,12 +2,22 @@
 
 #include "VulkanTypes.inl"
 
+/**
+ * Creates the swapchain for the context's surface. Headless contexts have no surface, owned
+ * offscreen images stand in for the swapchain images then, acquire hands them out round robin
+ * and present only advances the frame.
+ */
 void VulkanSwapchainCreate(
     VulkanContext* _context,
     u32 _width,
     u32 _height,
     VulkanSwapchain* _outSwapchain);
 
+/**
+ * Replaces the swapchain without waiting for the device. The old swapchain is passed as
+ * oldSwapchain, then it is handed to the deletion queue along with its views. Framebuffers
+ * using those views must be retired by the caller first.
+ */
 void VulkanSwapchainRecreate(
     VulkanContext* _context,
     u32 _width,
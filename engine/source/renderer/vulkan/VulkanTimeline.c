@@ -0,0 +1,80 @@
+#include "VulkanTimeline.h"
+#include "VulkanUtils.h"
+
+#include "core/Logger.h"
+#include "core/CMemory.h"
+
+b8 VulkanTimelineCreate(VulkanContext* _context, VulkanTimeline* _outTimeline)
+{
+    cZeroMemory(_outTimeline, sizeof(VulkanTimeline));
+
+    VkSemaphoreTypeCreateInfo typeCreateInfo = { VK_STRUCTURE_TYPE_SEMAPHORE_TYPE_CREATE_INFO };
+    typeCreateInfo.semaphoreType = VK_SEMAPHORE_TYPE_TIMELINE;
+    typeCreateInfo.initialValue = 0;
+
+    VkSemaphoreCreateInfo semaphoreCreateInfo = { VK_STRUCTURE_TYPE_SEMAPHORE_CREATE_INFO };
+    semaphoreCreateInfo.pNext = &typeCreateInfo;
+
+    VkResult result = vkCreateSemaphore(_context->device.logicalDevice, &semaphoreCreateInfo, _context->allocator, &_outTimeline->handle);
+    if(!VulkanResultIsSuccess(result))
+    {
+        LOG_ERROR("Failed to create timeline semaphore: '%s'", VulkanResultString(result, TRUE));
+        return FALSE;
+    }
+
+    return TRUE;
+}
+
+void VulkanTimelineDestroy(VulkanContext* _context, VulkanTimeline* _timeline)
+{
+    if(_timeline->handle)
+        vkDestroySemaphore(_context->device.logicalDevice, _timeline->handle, _context->allocator);
+
+    cZeroMemory(_timeline, sizeof(VulkanTimeline));
+}
+
+u64 VulkanTimelineNextValue(VulkanTimeline* _timeline)
+{
+    return ++_timeline->pendingValue;
+}
+
+u64 VulkanTimelineQuery(VulkanContext* _context, VulkanTimeline* _timeline)
+{
+    VK_CHECK(vkGetSemaphoreCounterValue(_context->device.logicalDevice, _timeline->handle, &_timeline->completedValue));
+    return _timeline->completedValue;
+}
+
+b8 VulkanTimelineIsReached(VulkanContext* _context, VulkanTimeline* _timeline, u64 _value)
+{
+    if(_value <= _timeline->completedValue)
+        return TRUE;
+
+    return _value <= VulkanTimelineQuery(_context, _timeline);
+}
+
+b8 VulkanTimelineWait(VulkanContext* _context, VulkanTimeline* _timeline, u64 _value, u64 _timeoutNS)
+{
+    if(VulkanTimelineIsReached(_context, _timeline, _value))
+        return TRUE;
+
+    uint64_t waitValue = _value;
+    VkSemaphoreWaitInfo waitInfo = { VK_STRUCTURE_TYPE_SEMAPHORE_WAIT_INFO };
+    waitInfo.semaphoreCount = 1;
+    waitInfo.pSemaphores = &_timeline->handle;
+    waitInfo.pValues = &waitValue;
+
+    VkResult result = vkWaitSemaphores(_context->device.logicalDevice, &waitInfo, _timeoutNS);
+    if(result == VK_TIMEOUT)
+        return FALSE;
+
+    if(!VulkanResultIsSuccess(result))
+    {
+        LOG_ERROR("vkWaitSemaphores failed: '%s'", VulkanResultString(result, TRUE));
+        return FALSE;
+    }
+
+    if(_value > _timeline->completedValue)
+        _timeline->completedValue = _value;
+
+    return TRUE;
+}
\ No newline at end of file
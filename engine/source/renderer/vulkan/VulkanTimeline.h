@@ -0,0 +1,24 @@
+#pragma once
+
+#include "VulkanTypes.inl"
+
+/**
+ * Timeline semaphore for one queue. Submissions signal increasing values handed out by
+ * VulkanTimelineNextValue, and the last value known to be reached is cached so most checks
+ * never reach the driver.
+ */
+b8 VulkanTimelineCreate(VulkanContext* _context, VulkanTimeline* _outTimeline);
+
+void VulkanTimelineDestroy(VulkanContext* _context, VulkanTimeline* _timeline);
+
+//reserves the value the next submission on this timeline signals
+u64 VulkanTimelineNextValue(VulkanTimeline* _timeline);
+
+//refreshes and returns the value reached by the device
+u64 VulkanTimelineQuery(VulkanContext* _context, VulkanTimeline* _timeline);
+
+//TRUE once _value was reached, queries the driver only if the cached value is behind
+b8 VulkanTimelineIsReached(VulkanContext* _context, VulkanTimeline* _timeline, u64 _value);
+
+//blocks until _value is reached or the timeout expires, returns FALSE on timeout
+b8 VulkanTimelineWait(VulkanContext* _context, VulkanTimeline* _timeline, u64 _value, u64 _timeoutNS);
\ No newline at end of file
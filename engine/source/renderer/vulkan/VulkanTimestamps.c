@@ -0,0 +1,133 @@
+#include "VulkanTimestamps.h"
+
+#include "core/Logger.h"
+#include "core/CMemory.h"
+
+#include "containers/DArray.h"
+
+void ReadTimestampResults(VulkanContext* _context, VulkanTimestamps* _timestamps, VulkanTimestampFrame* _frame);
+
+b8 VulkanTimestampsCreate(VulkanContext* _context, u32 _frameCount, VulkanTimestamps* _outTimestamps)
+{
+    cZeroMemory(_outTimestamps, sizeof(VulkanTimestamps));
+
+    u32 queueFamilyCount = 0;
+    vkGetPhysicalDeviceQueueFamilyProperties(_context->device.physicalDevice, &queueFamilyCount, 0);
+    VkQueueFamilyProperties queueFamilies[queueFamilyCount];
+    vkGetPhysicalDeviceQueueFamilyProperties(_context->device.physicalDevice, &queueFamilyCount, queueFamilies);
+
+    u32 validBits = queueFamilies[_context->device.graphicsQueueIndex].timestampValidBits;
+    f32 period = _context->device.properties.limits.timestampPeriod;
+    if(validBits == 0 || period <= 0.f)
+    {
+        LOG_WARN("Graphics queue does not support timestamps, GPU timings disabled.");
+        return TRUE;
+    }
+
+    _outTimestamps->supported = TRUE;
+    _outTimestamps->periodNS = period;
+    _outTimestamps->validMask = validBits >= 64 ? ~0ull : ((1ull << validBits) - 1);
+
+    VkQueryPoolCreateInfo poolCreateInfo = { VK_STRUCTURE_TYPE_QUERY_POOL_CREATE_INFO };
+    poolCreateInfo.queryType = VK_QUERY_TYPE_TIMESTAMP;
+    poolCreateInfo.queryCount = VULKAN_MAX_TIMESTAMP_SCOPES * 2;
+
+    _outTimestamps->frameCount = _frameCount;
+    _outTimestamps->frames = DArrayReserve(VulkanTimestampFrame, _frameCount);
+    for(u32 i = 0; i < _frameCount; ++i)
+    {
+        cZeroMemory(&_outTimestamps->frames[i], sizeof(VulkanTimestampFrame));
+        VK_CHECK(vkCreateQueryPool(_context->device.logicalDevice, &poolCreateInfo, _context->allocator, &_outTimestamps->frames[i].pool));
+    }
+
+    return TRUE;
+}
+
+void VulkanTimestampsDestroy(VulkanContext* _context, VulkanTimestamps* _timestamps)
+{
+    if(_timestamps->frames)
+    {
+        for(u32 i = 0; i < _timestamps->frameCount; ++i)
+            vkDestroyQueryPool(_context->device.logicalDevice, _timestamps->frames[i].pool, _context->allocator);
+
+        DArrayDestroy(_timestamps->frames);
+    }
+
+    cZeroMemory(_timestamps, sizeof(VulkanTimestamps));
+}
+
+void VulkanTimestampsBeginFrame(VulkanContext* _context, VulkanTimestamps* _timestamps, VulkanCommandBuffer* _commandBuffer, u32 _frame)
+{
+    if(!_timestamps->supported)
+        return;
+
+    _timestamps->frame = _frame % _timestamps->frameCount;
+    VulkanTimestampFrame* frame = &_timestamps->frames[_timestamps->frame];
+    if(frame->scopeCount > 0)
+        ReadTimestampResults(_context, _timestamps, frame);
+
+    vkCmdResetQueryPool(_commandBuffer->handle, frame->pool, 0, VULKAN_MAX_TIMESTAMP_SCOPES * 2);
+    frame->scopeCount = 0;
+}
+
+i32 VulkanTimestampsBeginScope(VulkanTimestamps* _timestamps, VulkanCommandBuffer* _commandBuffer, const char* _name)
+{
+    if(!_timestamps->supported)
+        return -1;
+
+    VulkanTimestampFrame* frame = &_timestamps->frames[_timestamps->frame];
+    if(frame->scopeCount == VULKAN_MAX_TIMESTAMP_SCOPES)
+    {
+        LOG_WARN("Out of timestamp scopes, '%s' is not timed.", _name);
+        return -1;
+    }
+
+    i32 index = frame->scopeCount++;
+    VulkanTimestampScope* scope = &frame->scopes[index];
+    scope->name = _name;
+    scope->beginQuery = index * 2;
+    scope->ended = FALSE;
+
+    vkCmdWriteTimestamp(_commandBuffer->handle, VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT, frame->pool, scope->beginQuery);
+    return index;
+}
+
+void VulkanTimestampsEndScope(VulkanTimestamps* _timestamps, VulkanCommandBuffer* _commandBuffer, i32 _scope)
+{
+    if(!_timestamps->supported || _scope < 0)
+        return;
+
+    VulkanTimestampFrame* frame = &_timestamps->frames[_timestamps->frame];
+    VulkanTimestampScope* scope = &frame->scopes[_scope];
+    vkCmdWriteTimestamp(_commandBuffer->handle, VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT, frame->pool, scope->beginQuery + 1);
+    scope->ended = TRUE;
+}
+
+void ReadTimestampResults(VulkanContext* _context, VulkanTimestamps* _timestamps, VulkanTimestampFrame* _frame)
+{
+    //value and availability per query, the frame has completed so no wait is needed
+    u32 queryCount = _frame->scopeCount * 2;
+    u64 data[VULKAN_MAX_TIMESTAMP_SCOPES * 2 * 2];
+    VkResult result = vkGetQueryPoolResults(
+        _context->device.logicalDevice,
+        _frame->pool,
+        0, queryCount,
+        sizeof(u64) * 2 * queryCount, data, sizeof(u64) * 2,
+        VK_QUERY_RESULT_64_BIT | VK_QUERY_RESULT_WITH_AVAILABILITY_BIT);
+    if(result != VK_SUCCESS && result != VK_NOT_READY)
+        return;
+
+    _timestamps->resultCount = 0;
+    for(u32 i = 0; i < _frame->scopeCount; ++i)
+    {
+        VulkanTimestampScope* scope = &_frame->scopes[i];
+        u32 begin = scope->beginQuery;
+        if(!scope->ended || !data[begin * 2 + 1] || !data[(begin + 1) * 2 + 1])
+            continue;
+
+        u64 ticks = ((data[(begin + 1) * 2] - data[begin * 2]) & _timestamps->validMask);
+        VulkanTimestampResult* timing = &_timestamps->results[_timestamps->resultCount++];
+        timing->name = scope->name;
+        timing->milliseconds = ticks * _timestamps->periodNS / 1000000.0;
+    }
+}
\ No newline at end of file
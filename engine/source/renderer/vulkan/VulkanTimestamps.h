@@ -0,0 +1,27 @@
+#pragma once
+
+#include "VulkanTypes.inl"
+
+/**
+ * GPU timestamp scopes. Each frame in flight owns a query pool, scopes write a timestamp at the
+ * top of the pipe when they begin and at the bottom when they end. Results are read back when the
+ * frame slot comes around again, after its timeline wait, so reading never stalls.
+ */
+b8 VulkanTimestampsCreate(VulkanContext* _context, u32 _frameCount, VulkanTimestamps* _outTimestamps);
+
+void VulkanTimestampsDestroy(VulkanContext* _context, VulkanTimestamps* _timestamps);
+
+/**
+ * Reads back the results of the frame that last used _frame and resets its queries.
+ * Must be recorded on the frame's primary command buffer outside of a render pass, once the frame's previous work completed.
+ */
+void VulkanTimestampsBeginFrame(VulkanContext* _context, VulkanTimestamps* _timestamps, VulkanCommandBuffer* _commandBuffer, u32 _frame);
+
+/**
+ * Opens a named scope, _name is not copied. Scopes may nest and be recorded on secondaries,
+ * but only from the render thread.
+ * @returns the scope index passed to VulkanTimestampsEndScope, or -1 when no scope is available.
+ */
+i32 VulkanTimestampsBeginScope(VulkanTimestamps* _timestamps, VulkanCommandBuffer* _commandBuffer, const char* _name);
+
+void VulkanTimestampsEndScope(VulkanTimestamps* _timestamps, VulkanCommandBuffer* _commandBuffer, i32 _scope);
\ No newline at end of file
@@ -2,6 +2,7 @@
 
 #include "Defines.h"
 #include "core/Asserts.h"
+#include "renderer/RendererTypes.inl"
 
 #include <vulkan/vulkan.h>
 
@@ -18,6 +19,10 @@ typedef struct VulkanSwapchainSupportInfo
     VkSurfaceFormatKHR* formats;
     u32 presentModeCount;
     VkPresentModeKHR* presentModes;
+
+    //allocated lengths of the arrays, support is queried again on every swapchain recreation
+    u32 formatCapacity;
+    u32 presentModeCapacity;
 } VulkanSwapchainSupportInfo;
 
 typedef struct VulkanDevice
@@ -28,29 +33,149 @@ typedef struct VulkanDevice
     i32 graphicsQueueIndex;
     i32 presentQueueIndex;
     i32 transferQueueIndex;
+    //a family without graphics when the device has one, otherwise the graphics family
+    i32 computeQueueIndex;
 
     VkQueue graphicsQueue;
     VkQueue presentQueue;
     VkQueue transferQueue;
+    VkQueue computeQueue;
 
     VkCommandPool graphicsCommandPool;
+    VkCommandPool transferCommandPool;
+    VkCommandPool computeCommandPool;
 
     VkPhysicalDeviceProperties properties;
     VkPhysicalDeviceFeatures features;
     VkPhysicalDeviceMemoryProperties memory;
 
     VkFormat depthFormat;
+
+    //VK_KHR_present_id and VK_KHR_present_wait are both enabled, used by the low latency mode
+    b8 supportsPresentWait;
+    PFN_vkWaitForPresentKHR waitForPresent;
+
+    //the dynamicRendering feature of Vulkan 1.3 is enabled
+    b8 supportsDynamicRendering;
+
+    //runtime sized, partially bound sampled image arrays updated after bind are enabled, see VulkanBindlessTable
+    b8 supportsDescriptorIndexing;
+    u32 maxBindlessTextures;
 } VulkanDevice;
 
+//smallest node handed out by the device memory allocator is 1 << VULKAN_MEMORY_MIN_NODE_SHIFT bytes
+#define VULKAN_MEMORY_MIN_NODE_SHIFT 8
+#define VULKAN_MEMORY_MAX_ORDERS 32
+#define VULKAN_MEMORY_DEDICATED_BLOCK -1
+
+typedef struct VulkanMemoryAllocation
+{
+    VkDeviceMemory memory;
+    VkDeviceSize offset;
+    VkDeviceSize size;
+    u32 memoryTypeIndex;
+
+    //block the allocation came from, VULKAN_MEMORY_DEDICATED_BLOCK if it owns memory
+    i32 blockIndex;
+    u8 order;
+
+    //points at offset within the persistently mapped block, 0 if not host visible
+    void* mappedData;
+} VulkanMemoryAllocation;
+
+typedef struct VulkanMemoryBlock
+{
+    VkDeviceMemory memory;
+    void* mapped;
+    VkDeviceSize used;
+
+    //holds optimally tiled images only, everything else goes to linear blocks
+    b8 optimal;
+
+    //darray of free node offsets per buddy order
+    VkDeviceSize* freeLists[VULKAN_MEMORY_MAX_ORDERS];
+} VulkanMemoryBlock;
+
+typedef struct VulkanMemoryAllocator
+{
+    //size of the blocks reserved and number of buddy orders, per memory type
+    VkDeviceSize blockSize[VK_MAX_MEMORY_TYPES];
+    u8 orderCount[VK_MAX_MEMORY_TYPES];
+
+    //darray of blocks per memory type, released blocks keep their slot with a null memory handle
+    VulkanMemoryBlock* blocks[VK_MAX_MEMORY_TYPES];
+
+    VkDeviceSize bufferImageGranularity;
+
+    //statistics per heap
+    VkDeviceSize heapUsed[VK_MAX_MEMORY_HEAPS];
+    VkDeviceSize heapReserved[VK_MAX_MEMORY_HEAPS];
+    u32 heapAllocationCount[VK_MAX_MEMORY_HEAPS];
+
+    //live vkAllocateMemory allocations, capped by maxMemoryAllocationCount
+    u32 deviceAllocationCount;
+} VulkanMemoryAllocator;
+
+//driver host allocations: command scope goes to a per-frame arena, small longer lived ones to size class pools
+#define VULKAN_HOST_ARENA_SIZE (256ull * 1024)
+#define VULKAN_HOST_POOL_CLASS_COUNT 7 //64B .. 4KiB
+#define VULKAN_HOST_POOL_PAGE_SIZE (64ull * 1024)
+#define VULKAN_HOST_SCOPE_COUNT (VK_SYSTEM_ALLOCATION_SCOPE_INSTANCE + 1)
+
+typedef struct VulkanHostPool
+{
+    u64 blockSize;
+
+    //intrusive singly linked list through the free blocks
+    void* freeList;
+
+    //darray of pages carved into blocks, only released on shutdown
+    void** pages;
+} VulkanHostPool;
+
+typedef struct VulkanHostAllocator
+{
+    VkAllocationCallbacks callbacks;
+
+    //drivers may call back from any thread that is inside a vulkan call
+    volatile i32 lock;
+
+    //bump allocated, individual frees are no-ops, rewound once per frame
+    u8* arena;
+    u64 arenaOffset;
+    u64 arenaPeak;
+    u32 arenaOverflowCount;
+
+    VulkanHostPool pools[VULKAN_HOST_POOL_CLASS_COUNT];
+
+    //statistics per VkSystemAllocationScope, in requested bytes
+    u64 scopeLive[VULKAN_HOST_SCOPE_COUNT];
+    u64 scopePeak[VULKAN_HOST_SCOPE_COUNT];
+    u64 scopeAllocationCount[VULKAN_HOST_SCOPE_COUNT];
+
+    //memory the driver allocated itself and reported through the internal notifications
+    u64 internalLive;
+} VulkanHostAllocator;
+
 typedef struct VulkanImage
 {
     VkImage handle;
-    VkDeviceMemory memory;
+    VulkanMemoryAllocation allocation;
     VkImageView view;
     u32 width;
     u32 height;
 } VulkanImage;
 
+typedef struct VulkanBuffer
+{
+    u64 totalSize;
+    VkBuffer handle;
+    VkBufferUsageFlags usage;
+    b8 isLocked;
+    VulkanMemoryAllocation allocation;
+    VkMemoryPropertyFlags memoryPropertyFlags;
+} VulkanBuffer;
+
 typedef enum VulkanRenderpassState
 {
     READY,
@@ -61,13 +186,25 @@ typedef enum VulkanRenderpassState
     NOT_ALLOCATED
 } VulkanRenderpassState;
 
+//attachment layout of a render pass. Attachments stay in the layout of their usage, transitions happen outside
+typedef struct VulkanRenderpassDesc
+{
+    u32 colorCount;
+    VkFormat colorFormats[RENDER_GRAPH_MAX_COLOR_ATTACHMENTS];
+
+    //VK_FORMAT_UNDEFINED without a depth attachment
+    VkFormat depthFormat;
+    b8 depthReadOnly;
+
+    //bit per attachment, colors first then depth
+    u32 clearMask;
+    u32 storeMask;
+} VulkanRenderpassDesc;
+
 typedef struct VulkanRenderpass
 {
     VkRenderPass handle;
-    f32 x, y, w, h;
-    f32 r, g, b, a;
-    f32 depth;
-    u32 stencil;
+    VulkanRenderpassDesc desc;
 
     VulkanRenderpassState state;
 } VulkanRenderpass;
@@ -80,21 +217,118 @@ typedef struct VulkanFramebuffer
     VulkanRenderpass* renderpass;
 } VulkanFramebuffer;
 
+//upper bound on frames recorded ahead of the device, the default is 2
+#define VULKAN_MAX_FRAMES_IN_FLIGHT 4
+
+typedef enum VulkanDeletionType
+{
+    VULKAN_DELETION_BUFFER,
+    VULKAN_DELETION_IMAGE,
+    VULKAN_DELETION_IMAGE_VIEW,
+    VULKAN_DELETION_FRAMEBUFFER,
+    VULKAN_DELETION_SWAPCHAIN
+} VulkanDeletionType;
+
+typedef struct VulkanDeletion
+{
+    //graphics timeline value after which the device no longer uses the resource
+    u64 retireValue;
+    VulkanDeletionType type;
+    union
+    {
+        VulkanBuffer buffer;
+        VulkanImage image;
+        VkImageView view;
+        VulkanFramebuffer framebuffer;
+        VkSwapchainKHR swapchain;
+    } resource;
+} VulkanDeletion;
+
+typedef struct VulkanDeletionQueue
+{
+    //in retire order, so retire values never decrease. darray
+    VulkanDeletion* entries;
+} VulkanDeletionQueue;
+
 typedef struct VulkanSwapchain
 {
     VkSurfaceFormatKHR imageFormat;
     u8 maxFramesInFlight;
+
+    //configuration kept across recreation, the present mode falls back to FIFO and 0 images means the surface minimum plus one
+    VkPresentModeKHR requestedPresentMode;
+    u32 requestedImageCount;
+    VkPresentModeKHR presentMode;
+
+    //id of the last present when present wait is supported, 0 before the first one
+    uint64_t lastPresentId;
+
     VkSwapchainKHR handle;
+    VkExtent2D extent;
     u32 imageCount;
     VkImage* images;
     VkImageView* views;
 
-    VulkanImage depthAttachment;
+    //headless only, owned images standing in for the swapchain ones, handed out round robin
+    VulkanImage* offscreenImages;
+    u32 nextOffscreenImage;
 
-    //framebuffers used for rendering to the screen.
-    VulkanFramebuffer* framebuffers;
 } VulkanSwapchain;
 
+#define VULKAN_MAX_GRAPH_RENDERPASSES 16
+#define VULKAN_MAX_GRAPH_FRAMEBUFFERS 32
+
+//transient image backing a RenderGraphPhysical, kept across frames while the graph keeps asking for it
+typedef struct VulkanGraphImage
+{
+    VulkanImage image;
+    VkFormat format;
+    VkImageUsageFlags usage;
+
+    //aspects transitioned by barriers, depth formats may carry stencil
+    VkImageAspectFlags barrierAspect;
+
+    //usage the last pass left the image in, possibly in an earlier frame
+    RenderGraphUsage lastUsage;
+} VulkanGraphImage;
+
+typedef struct VulkanGraphFramebuffer
+{
+    VkRenderPass renderpass;
+    u32 width;
+    u32 height;
+    u32 attachmentCount;
+    VkImageView attachments[RENDER_GRAPH_MAX_COLOR_ATTACHMENTS + 1];
+    VulkanFramebuffer framebuffer;
+} VulkanGraphFramebuffer;
+
+typedef struct VulkanRenderGraph
+{
+    //indexed by RenderGraphPhysical
+    VulkanGraphImage images[RENDER_GRAPH_MAX_RESOURCES];
+
+    //created on first use and kept, graphs usually look the same every frame
+    u32 renderpassCount;
+    VulkanRenderpass renderpasses[VULKAN_MAX_GRAPH_RENDERPASSES];
+
+    //keyed by attachment views, dropped whenever a view they use goes away
+    u32 framebufferCount;
+    VulkanGraphFramebuffer framebuffers[VULKAN_MAX_GRAPH_FRAMEBUFFERS];
+
+    //usage of the current swapchain image, undefined until the first pass of the frame
+    RenderGraphUsage backbufferUsage;
+
+    //pass being recorded, secondaries inherit its render pass and framebuffer, or its attachment
+    //formats with dynamic rendering. passRenderpass stays 0 with dynamic rendering
+    b8 passActive;
+    VulkanRenderpassDesc passDesc;
+    VulkanRenderpass* passRenderpass;
+    VkFramebuffer passFramebuffer;
+    u32 passWidth;
+    u32 passHeight;
+    i32 passTimestampScope;
+} VulkanRenderGraph;
+
 typedef enum VulkanCommandBufferState
 {
     COMMAND_BUFFER_STATE_READY,
@@ -113,12 +347,463 @@ typedef struct VulkanCommandBuffer
     VulkanCommandBufferState state;
 } VulkanCommandBuffer;
 
+//upper bound on threads recording secondary command buffers for a single frame
+#define VULKAN_MAX_RECORD_THREADS 16
+
+typedef struct VulkanThreadCommands
+{
+    //command pools are externally synchronized, each recording thread gets its own
+    VkCommandPool pool;
+
+    //darray of secondaries allocated so far, reused in order after each pool reset
+    VulkanCommandBuffer* secondaries;
+    u32 usedCount;
+
+    //secondaries before this one were already executed, each render pass executes its own
+    u32 executedCount;
+} VulkanThreadCommands;
+
+typedef struct VulkanFrameCommands
+{
+    //reset as a whole with vkResetCommandPool once the frame's fence has signaled
+    VkCommandPool pool;
+    VulkanCommandBuffer primary;
+
+    u32 threadCount;
+    VulkanThreadCommands threads[VULKAN_MAX_RECORD_THREADS];
+} VulkanFrameCommands;
+
 typedef struct VulkanFence
 {
     VkFence handle;
     b8 isSignaled;
 } VulkanFence;
 
+//timestamp scopes per frame, each scope takes a begin and an end query
+#define VULKAN_MAX_TIMESTAMP_SCOPES 32
+
+typedef struct VulkanTimestampScope
+{
+    //not copied, must outlive the frame's readback
+    const char* name;
+    u32 beginQuery;
+    b8 ended;
+} VulkanTimestampScope;
+
+typedef struct VulkanTimestampFrame
+{
+    VkQueryPool pool;
+    VulkanTimestampScope scopes[VULKAN_MAX_TIMESTAMP_SCOPES];
+    u32 scopeCount;
+} VulkanTimestampFrame;
+
+typedef struct VulkanTimestampResult
+{
+    const char* name;
+    f64 milliseconds;
+} VulkanTimestampResult;
+
+typedef struct VulkanTimestamps
+{
+    //FALSE when the graphics queue cannot write timestamps, every call is then a no-op
+    b8 supported;
+    f64 periodNS;
+    u64 validMask;
+
+    //darray per frame in flight, results are read back when the slot comes around again
+    VulkanTimestampFrame* frames;
+    u32 frameCount;
+    u32 frame;
+
+    //scopes of the most recent frame the device has finished
+    VulkanTimestampResult results[VULKAN_MAX_TIMESTAMP_SCOPES];
+    u32 resultCount;
+} VulkanTimestamps;
+
+typedef struct VulkanTimeline
+{
+    VkSemaphore handle;
+
+    //last value handed to a submission and last value known to be reached by the device
+    //uint64_t rather than u64 since vulkan reads and writes them through pointers
+    uint64_t pendingValue;
+    uint64_t completedValue;
+} VulkanTimeline;
+
+//size of the host visible ring that per-frame uploads are staged through
+#define VULKAN_STAGING_RING_SIZE (32ull * 1024 * 1024)
+
+typedef struct VulkanStagingRing
+{
+    VulkanBuffer buffer;
+
+    //monotonic byte counters, the ring offset is the counter modulo the ring size
+    u64 head;
+    u64 tail;
+
+    //darray of the head at the time each slot was submitted, and the graphics timeline value covering that submission
+    u64* frameHeads;
+    u64* frameValues;
+
+    //darray per frame in flight, copies are recorded on the transfer queue
+    VulkanCommandBuffer* transferCommandBuffers;
+    //darray per frame in flight, queue family acquire barriers recorded on the graphics queue
+    VulkanCommandBuffer* acquireCommandBuffers;
+    //darray per frame in flight, signaled by the transfer submission and waited on by graphics
+    VkSemaphore* transferCompleteSemaphores;
+
+    //darray of acquire barriers for the uploads recorded this frame
+    VkBufferMemoryBarrier* pendingAcquires;
+
+    //TRUE once the transfer command buffer of the current frame has been started, frame is the slot it uses
+    b8 recording;
+    u32 frame;
+} VulkanStagingRing;
+
+//async uploads are recorded into a small ring of batches, each with its own staging buffer
+#define VULKAN_UPLOAD_BATCH_COUNT 4
+#define VULKAN_UPLOAD_STAGING_SIZE (8ull * 1024 * 1024)
+
+typedef struct VulkanUploadBatch
+{
+    VulkanCommandBuffer commandBuffer;
+    VulkanBuffer staging;
+    u64 stagingUsed;
+
+    //timeline value signaled when the batch completes
+    uint64_t signalValue;
+
+    //darray of queue family acquire barriers, handed to the graphics queue once the batch completes
+    VkBufferMemoryBarrier* acquires;
+} VulkanUploadBatch;
+
+typedef struct VulkanUploader
+{
+    VkCommandPool commandPool;
+
+    //signaled with each batch's signalValue on the transfer queue, values double as upload tickets
+    VulkanTimeline timeline;
+
+    VulkanUploadBatch batches[VULKAN_UPLOAD_BATCH_COUNT];
+    u32 currentBatch;
+    b8 recording;
+
+    //batches up to this value had their acquire barriers handed to the graphics queue
+    u64 acquiredValue;
+} VulkanUploader;
+
+typedef struct VulkanCompute
+{
+    //signaled by every compute submission, values are handed out on submit
+    VulkanTimeline timeline;
+
+    //one per frame in flight from the device's compute pool, darrays
+    VulkanCommandBuffer* commandBuffers;
+    u64* frameValues;
+
+    u32 frame;
+    b8 recording;
+
+    //last compute value submitted this frame, the frame's graphics submission waits on it. 0 if none
+    u64 graphicsWaitValue;
+} VulkanCompute;
+
+#define VULKAN_SHADER_MAX_BINDINGS 16
+#define VULKAN_SHADER_MAX_SETS 4
+
+//descriptor binding declared by a shader, a count of 0 is a runtime sized array
+typedef struct VulkanShaderBinding
+{
+    u32 set;
+    u32 binding;
+    VkDescriptorType type;
+    u32 count;
+} VulkanShaderBinding;
+
+//descriptor and push constant usage read from a SPIR-V module
+typedef struct VulkanShaderReflection
+{
+    VkShaderStageFlagBits stage;
+    u32 bindingCount;
+    VulkanShaderBinding bindings[VULKAN_SHADER_MAX_BINDINGS];
+
+    //size of the push constant block in bytes, 0 without one
+    u32 pushConstantSize;
+} VulkanShaderReflection;
+
+typedef struct VulkanShader
+{
+    //hash of the SPIR-V binary, loads of an identical binary share the module
+    u64 hash;
+    VkShaderModule module;
+    VulkanShaderReflection reflection;
+
+    //0 for free slots
+    u32 references;
+} VulkanShader;
+
+typedef struct VulkanShaderSetLayout
+{
+    //hash of the bindings
+    u64 hash;
+    VkDescriptorSetLayout handle;
+} VulkanShaderSetLayout;
+
+typedef struct VulkanShaderPipelineLayout
+{
+    //hash of the set layouts and the push constant range
+    u64 hash;
+    VkPipelineLayout handle;
+} VulkanShaderPipelineLayout;
+
+typedef struct VulkanShaderLibrary
+{
+    //darray indexed by shader handle, freeHandles are reused first
+    VulkanShader* shaders;
+    u32* freeHandles;
+
+    //darrays of deduplicated layouts, kept until the library is destroyed
+    VulkanShaderSetLayout* setLayouts;
+    VulkanShaderPipelineLayout* pipelineLayouts;
+} VulkanShaderLibrary;
+
+//sets per transient pool, descriptors are sized from the ratios in VulkanDescriptors.c
+#define VULKAN_DESCRIPTOR_POOL_SETS 256
+
+//pools of one frame in flight, reset together once the frame's work completed
+typedef struct VulkanDescriptorFramePools
+{
+    //darray, pools past current are empty
+    VkDescriptorPool* pools;
+    u32 current;
+} VulkanDescriptorFramePools;
+
+typedef struct VulkanDescriptorAllocator
+{
+    VulkanDescriptorFramePools frames[VULKAN_MAX_FRAMES_IN_FLIGHT];
+    u32 frameCount;
+    u32 frameIndex;
+} VulkanDescriptorAllocator;
+
+//upper bound of the bindless table, lowered to the device limit
+#define VULKAN_BINDLESS_MAX_TEXTURES 16384
+
+//binding 1 of the bindless set, immutable samplers indexed by the shaders alongside the texture
+typedef enum VulkanBindlessSampler
+{
+    VULKAN_BINDLESS_SAMPLER_LINEAR_REPEAT,
+    VULKAN_BINDLESS_SAMPLER_LINEAR_CLAMP,
+    VULKAN_BINDLESS_SAMPLER_NEAREST_CLAMP,
+    VULKAN_BINDLESS_SAMPLER_COUNT
+} VulkanBindlessSampler;
+
+typedef struct VulkanBindlessRelease
+{
+    u32 index;
+
+    //graphics timeline value after which no submitted frame reads the slot
+    u64 retireValue;
+} VulkanBindlessRelease;
+
+typedef struct VulkanBindlessTable
+{
+    //0 when the device lacks descriptor indexing, nothing can be added then
+    VkDescriptorSetLayout setLayout;
+    VkDescriptorPool pool;
+    VkDescriptorSet set;
+    VkSampler samplers[VULKAN_BINDLESS_SAMPLER_COUNT];
+
+    //white texture in slot 0, what materials without a texture of their own sample
+    VulkanImage defaultTexture;
+
+    u32 capacity;
+
+    //slots below are written or free, slots above were never used
+    u32 highWater;
+
+    //darray of slots ready for reuse
+    u32* freeIndices;
+
+    //darray of removed slots in retire order, returned to freeIndices once their frames completed
+    VulkanBindlessRelease* releases;
+} VulkanBindlessTable;
+
+typedef struct VulkanStaticMesh
+{
+    //device local, filled once by the async uploader
+    VulkanBuffer vertexBuffer;
+    VulkanBuffer indexBuffer;
+    VkIndexType indexType;
+    u32 indexCount;
+    StaticMeshVertexFormat format;
+
+    //pushed when the mesh is bound, decodes quantized positions. Identity for interleaved meshes
+    Vec4 positionScale;
+    Vec4 positionOffset;
+
+    //local space center in xyz and radius in w, used for culling
+    Vec4 boundingSphere;
+
+    //draws are skipped until the upload completed, ready is refreshed once per frame on the render thread
+    u64 uploadTicket;
+    b8 ready;
+    b8 live;
+} VulkanStaticMesh;
+
+//static mesh pipelines for the attachment formats of a pass, indexed by StaticMeshVertexFormat
+typedef struct VulkanStaticMeshPipelines
+{
+    //only formats and the read only depth flag are compared, operations do not affect compatibility
+    VulkanRenderpassDesc desc;
+    VkPipeline pipelines[STATIC_MESH_VERTEX_FORMAT_COUNT];
+} VulkanStaticMeshPipelines;
+
+//static mesh pipelines of one shader pair and layout, created for each pass layout the meshes are drawn in
+typedef struct VulkanStaticMeshPipelineCache
+{
+    //shader library handles, released with the cache
+    u32 vertexShader;
+    u32 fragmentShader;
+
+    //reflected from the shaders and owned by the shader library, 0 when a shader could not be loaded and nothing is drawn
+    VkPipelineLayout layout;
+
+    //the bindless table bound at set 1 when the fragment shader reads it, 0 for the untextured fallback
+    VkDescriptorSet bindlessSet;
+
+    //kept until shutdown
+    u32 setCount;
+    VulkanStaticMeshPipelines sets[VULKAN_MAX_GRAPH_RENDERPASSES];
+
+    //pipelines of the pass being recorded, 0 outside of passes
+    const VulkanStaticMeshPipelines* pass;
+} VulkanStaticMeshPipelineCache;
+
+//smallest per-frame instance buffer, in transforms
+#define VULKAN_STATIC_MESH_MIN_INSTANCES 1024
+
+typedef struct VulkanStaticMeshes
+{
+    //darray indexed by mesh handle, freeHandles are reused first
+    VulkanStaticMesh* meshes;
+    u32* freeHandles;
+
+    //meshes whose upload has not been seen completing yet
+    u32 pendingCount;
+
+    //owned by the shader library
+    VkDescriptorSetLayout setLayout;
+    VulkanStaticMeshPipelineCache pipelines;
+
+    //per frame in flight, host visible transforms read by the vertex shader through gl_InstanceIndex
+    VulkanBuffer instanceBuffers[VULKAN_MAX_FRAMES_IN_FLIGHT];
+
+    //transient, allocated from the descriptor allocator each frame that has instances
+    VkDescriptorSet instanceSet;
+
+    //transforms written for the current frame, draws beyond them are skipped
+    u32 frameInstanceCount;
+    Mat4 viewProjection;
+} VulkanStaticMeshes;
+
+//static mesh state bound while recording a chunk of draws, every chunk starts unbound
+typedef struct VulkanStaticMeshBinding
+{
+    VkPipeline pipeline;
+    u32 mesh;
+    b8 layoutBound;
+} VulkanStaticMeshBinding;
+
+//one object as GpuCull.comp reads it, std430 layout
+typedef struct VulkanGpuCullObject
+{
+    //local space, copied from the mesh
+    Vec4 boundingSphere;
+
+    //mesh handle, also the index of the batch's draw command
+    u32 batch;
+    u32 live;
+    u32 padding[2];
+} VulkanGpuCullObject;
+
+//smallest object and batch capacities of the device buffers
+#define VULKAN_GPU_SCENE_MIN_OBJECTS 1024
+#define VULKAN_GPU_SCENE_MIN_BATCHES 64
+
+//local size of GpuCull.comp
+#define VULKAN_GPU_SCENE_CULL_GROUP_SIZE 64
+
+/**
+ * Persistent static mesh instances culled on the device. The CPU keeps a mirror of every object and
+ * only uploads what changed, the cull shader fills one indirect draw per mesh.
+ */
+typedef struct VulkanGpuScene
+{
+    //darrays indexed by object handle, freeHandles are reused first
+    Mat4* transforms;
+    VulkanGpuCullObject* objects;
+    u32* freeHandles;
+
+    //darray of objects changed since the last upload, dirtyFlags prevents duplicates
+    u32* dirtyObjects;
+    b8* dirtyFlags;
+
+    //TRUE when the device buffers were recreated and the whole mirror is uploaded next frame
+    b8 uploadAll;
+
+    //darray of live objects per batch, indexed by mesh handle
+    u32* batchObjectCounts;
+
+    //device local, shared by every frame in flight. The cull is ordered after the previous frame's draws
+    VulkanBuffer transformBuffer;
+    VulkanBuffer objectBuffer;
+    VulkanBuffer visibleBuffer;
+    VulkanBuffer drawBuffer;
+    u32 objectCapacity;
+    u32 batchCapacity;
+
+    //bumped whenever the device buffers are recreated, the frame's sets are rewritten when they lag behind
+    u64 generation;
+    u64 setGenerations[VULKAN_MAX_FRAMES_IN_FLIGHT];
+
+    //per frame in flight, host visible source of the frame's copies
+    VulkanBuffer uploadBuffers[VULKAN_MAX_FRAMES_IN_FLIGHT];
+
+    //darrays of copy regions, reused every frame
+    VkBufferCopy* transformCopies;
+    VkBufferCopy* objectCopies;
+
+    //owned by the shader library
+    VkDescriptorSetLayout cullSetLayout;
+    VkDescriptorSetLayout drawSetLayout;
+    VkDescriptorPool descriptorPool;
+    VkDescriptorSet cullSets[VULKAN_MAX_FRAMES_IN_FLIGHT];
+    VkDescriptorSet drawSets[VULKAN_MAX_FRAMES_IN_FLIGHT];
+
+    //0 when GpuCull.comp could not be loaded, nothing is culled or drawn then. The layout is the shader library's
+    VkPipelineLayout cullLayout;
+    VkPipeline cullPipeline;
+
+    //StaticMeshIndirect.vert with the draw set
+    VulkanStaticMeshPipelineCache pipelines;
+
+    //batches whose commands the current frame's cull filled, 0 when nothing was culled
+    u32 frameBatchCount;
+    Mat4 viewProjection;
+} VulkanGpuScene;
+
+typedef struct VulkanPipelineCacheStats
+{
+    //TRUE if the cache was seeded from disk
+    b8 warm;
+    u64 loadedBytes;
+    f64 loadSeconds;
+
+    //accumulated pipeline creation cost, compare between cold and warm runs
+    u32 pipelineCount;
+    f64 pipelineCreateSeconds;
+} VulkanPipelineCacheStats;
+
 typedef struct VulkanContext
 {
     //the framebuffers current width and height
@@ -142,11 +827,43 @@ typedef struct VulkanContext
 
     VulkanDevice device;
 
+    //host allocations made by the driver, context.allocator points at its callbacks
+    VulkanHostAllocator hostAllocator;
+
+    //device memory sub-allocator
+    VulkanMemoryAllocator memoryAllocator;
+
+    //gpu timings per frame and per pass
+    VulkanTimestamps timestamps;
+
+    //resources released while frames in flight may still use them
+    VulkanDeletionQueue deletionQueue;
+
     VulkanSwapchain swapchain;
-    VulkanRenderpass mainRenderpass;
+
+    //render passes, framebuffers and transient images of the frontend's render graph
+    VulkanRenderGraph renderGraph;
+
+    //persisted between runs, pass to every pipeline creation
+    VkPipelineCache pipelineCache;
+    VulkanPipelineCacheStats pipelineCacheStats;
+
+    //shader modules and the layouts reflected from them
+    VulkanShaderLibrary shaderLibrary;
+
+    //transient sets reset every frame and the bindless sampled image table
+    VulkanDescriptorAllocator descriptorAllocator;
+    VulkanBindlessTable bindlessTable;
+
+    //per-frame uploads, submitted ahead of the graphics work each frame
+    VulkanStagingRing stagingRing;
+
+    //async content uploads, polled for completion
+    VulkanUploader uploader;
 
     //darray commandbuffers
-    VulkanCommandBuffer* graphicsCommandBuffers;
+    //darray of command pools and buffers per frame in flight, indexed by currentFrame
+    VulkanFrameCommands* frameCommands;
 
     //darray image semaphore
     VkSemaphore* imageAvailableSemaphores;
@@ -154,16 +871,40 @@ typedef struct VulkanContext
     //darray queue semaphores
     VkSemaphore* queueCompleteSemaphores;
 
-    u32 inFlightFenceCount;
-    VulkanFence* inFlightFences;
+    //graphics queue timeline, frame N signals N + 1 when its work completes
+    VulkanTimeline graphicsTimeline;
+
+    //darray of the graphics timeline value covering the last submission of each frame in flight
+    u64* frameTimelineValues;
+
+    //darray of the graphics timeline value of the last frame that rendered to each swapchain image
+    u64* imageTimelineValues;
+
+    //frames submitted but not yet finished by the device, measured at the start of the frame
+    u32 frameLatency;
 
-    //holds pointers to fences that exist and owned somewhere else
-    VulkanFence** imagesInFlight;
+    //async compute, overlaps the graphics queue when the device has a separate compute family
+    VulkanCompute compute;
+
+    //static mesh buffers, pipelines and per-frame instance data
+    VulkanStaticMeshes staticMeshes;
+
+    //static mesh objects culled and drawn indirectly
+    VulkanGpuScene gpuScene;
+
+    //wait for the previous frame before sampling input, see VulkanRendererBackendPaceFrame
+    b8 lowLatency;
+
+    //passes use vkCmdBeginRendering, no render pass or framebuffer objects are created
+    b8 dynamicRendering;
 
     u32 imageIndex;
     u32 currentFrame;
 
     b8 recreatingSwapchain;
 
+    //set when the graphics submit failed, no further frame is started
+    b8 deviceLost;
+
     i32 (*FindMemoryIndex)(u32 _typeFilter, u32 _propertyFlags);
 } VulkanContext;
\ No newline at end of file
@@ -0,0 +1,252 @@
+#include "VulkanUploader.h"
+
+#include "VulkanBuffer.h"
+#include "VulkanCommandBuffer.h"
+#include "VulkanStagingRing.h"
+#include "VulkanTimeline.h"
+
+#include "core/Logger.h"
+#include "core/CMemory.h"
+
+#include "containers/DArray.h"
+
+VulkanUploadBatch* BeginUploadBatch(VulkanContext* _context, VulkanUploader* _uploader);
+void RetireUploadBatches(VulkanContext* _context, VulkanUploader* _uploader);
+
+b8 VulkanUploaderCreate(VulkanContext* _context, VulkanUploader* _outUploader)
+{
+    cZeroMemory(_outUploader, sizeof(VulkanUploader));
+
+    //own pool so recording uploads never contends with the per-frame transfer work
+    VkCommandPoolCreateInfo poolCreateInfo = { VK_STRUCTURE_TYPE_COMMAND_POOL_CREATE_INFO };
+    poolCreateInfo.queueFamilyIndex = _context->device.transferQueueIndex;
+    poolCreateInfo.flags = VK_COMMAND_POOL_CREATE_TRANSIENT_BIT | VK_COMMAND_POOL_CREATE_RESET_COMMAND_BUFFER_BIT;
+    VK_CHECK(vkCreateCommandPool(_context->device.logicalDevice, &poolCreateInfo, _context->allocator, &_outUploader->commandPool));
+
+    if(!VulkanTimelineCreate(_context, &_outUploader->timeline))
+        return FALSE;
+
+    for(u32 i = 0; i < VULKAN_UPLOAD_BATCH_COUNT; ++i)
+    {
+        VulkanUploadBatch* batch = &_outUploader->batches[i];
+        VulkanCommandBufferAllocate(_context, _outUploader->commandPool, TRUE, &batch->commandBuffer);
+        batch->acquires = DArrayCreate(VkBufferMemoryBarrier);
+
+        if(!VulkanBufferCreate(
+            _context,
+            VULKAN_UPLOAD_STAGING_SIZE,
+            VK_BUFFER_USAGE_TRANSFER_SRC_BIT,
+            VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT,
+            TRUE,
+            &batch->staging))
+        {
+            LOG_ERROR("Failed to create upload staging buffer.");
+            return FALSE;
+        }
+    }
+
+    return TRUE;
+}
+
+void VulkanUploaderDestroy(VulkanContext* _context, VulkanUploader* _uploader)
+{
+    if(!_uploader->commandPool)
+        return;
+
+    for(u32 i = 0; i < VULKAN_UPLOAD_BATCH_COUNT; ++i)
+    {
+        VulkanUploadBatch* batch = &_uploader->batches[i];
+        VulkanBufferDestroy(_context, &batch->staging);
+        if(batch->acquires)
+            DArrayDestroy(batch->acquires);
+    }
+
+    //command buffers are freed with the pool
+    vkDestroyCommandPool(_context->device.logicalDevice, _uploader->commandPool, _context->allocator);
+    VulkanTimelineDestroy(_context, &_uploader->timeline);
+
+    cZeroMemory(_uploader, sizeof(VulkanUploader));
+}
+
+u64 VulkanUploaderEnqueueBuffer(
+    VulkanContext* _context,
+    VulkanUploader* _uploader,
+    VulkanBuffer* _buffer,
+    u64 _offset,
+    u64 _size,
+    const void* _data)
+{
+    b8 transferOwnership = _context->device.transferQueueIndex != _context->device.graphicsQueueIndex;
+
+    const u8* source = _data;
+    u64 remaining = _size;
+    u64 destOffset = _offset;
+    u64 ticket = 0;
+
+    while(remaining > 0)
+    {
+        VulkanUploadBatch* batch = BeginUploadBatch(_context, _uploader);
+        u64 available = batch->staging.totalSize - batch->stagingUsed;
+        if(available == 0)
+        {
+            //batch is full, send it off and continue in the next one
+            VulkanUploaderSubmit(_context, _uploader);
+            continue;
+        }
+
+        u64 chunk = remaining < available ? remaining : available;
+        cCopyMemory((u8*)batch->staging.allocation.mappedData + batch->stagingUsed, source, chunk);
+
+        VkBufferCopy copyRegion;
+        copyRegion.srcOffset = batch->stagingUsed;
+        copyRegion.dstOffset = destOffset;
+        copyRegion.size = chunk;
+        vkCmdCopyBuffer(batch->commandBuffer.handle, batch->staging.handle, _buffer->handle, 1, &copyRegion);
+
+        if(transferOwnership)
+        {
+            //release now, the acquire is recorded on the graphics queue once the batch has completed
+            VkBufferMemoryBarrier barrier = { VK_STRUCTURE_TYPE_BUFFER_MEMORY_BARRIER };
+            barrier.srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+            barrier.dstAccessMask = 0;
+            barrier.srcQueueFamilyIndex = _context->device.transferQueueIndex;
+            barrier.dstQueueFamilyIndex = _context->device.graphicsQueueIndex;
+            barrier.buffer = _buffer->handle;
+            barrier.offset = destOffset;
+            barrier.size = chunk;
+
+            vkCmdPipelineBarrier(
+                batch->commandBuffer.handle,
+                VK_PIPELINE_STAGE_TRANSFER_BIT,
+                VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT,
+                0,
+                0, 0,
+                1, &barrier,
+                0, 0);
+
+            barrier.srcAccessMask = 0;
+            barrier.dstAccessMask = VULKAN_STAGING_CONSUMER_ACCESS;
+            DArrayPush(batch->acquires, barrier);
+        }
+
+        //keep copy sources aligned
+        u64 used = (batch->stagingUsed + chunk + 15) & ~15ull;
+        batch->stagingUsed = used < batch->staging.totalSize ? used : batch->staging.totalSize;
+
+        source += chunk;
+        destOffset += chunk;
+        remaining -= chunk;
+        ticket = batch->signalValue;
+    }
+
+    return ticket;
+}
+
+void VulkanUploaderSubmit(VulkanContext* _context, VulkanUploader* _uploader)
+{
+    if(!_uploader->recording)
+        return;
+
+    VulkanUploadBatch* batch = &_uploader->batches[_uploader->currentBatch];
+    VulkanCommandBufferEnd(&batch->commandBuffer);
+
+    VkTimelineSemaphoreSubmitInfo timelineInfo = { VK_STRUCTURE_TYPE_TIMELINE_SEMAPHORE_SUBMIT_INFO };
+    timelineInfo.signalSemaphoreValueCount = 1;
+    timelineInfo.pSignalSemaphoreValues = &batch->signalValue;
+
+    VkSubmitInfo submitInfo = { VK_STRUCTURE_TYPE_SUBMIT_INFO };
+    submitInfo.pNext = &timelineInfo;
+    submitInfo.commandBufferCount = 1;
+    submitInfo.pCommandBuffers = &batch->commandBuffer.handle;
+    submitInfo.signalSemaphoreCount = 1;
+    submitInfo.pSignalSemaphores = &_uploader->timeline.handle;
+
+    VK_CHECK(vkQueueSubmit(_context->device.transferQueue, 1, &submitInfo, 0));
+    VulkanCommandBufferUpdateSubmitted(&batch->commandBuffer);
+
+    _uploader->recording = FALSE;
+    _uploader->currentBatch = (_uploader->currentBatch + 1) % VULKAN_UPLOAD_BATCH_COUNT;
+}
+
+b8 VulkanUploaderIsComplete(VulkanContext* _context, VulkanUploader* _uploader, u64 _ticket)
+{
+    return VulkanTimelineIsReached(_context, &_uploader->timeline, _ticket);
+}
+
+b8 VulkanUploaderWait(VulkanContext* _context, VulkanUploader* _uploader, u64 _ticket, u64 _timeoutNS)
+{
+    if(VulkanTimelineIsReached(_context, &_uploader->timeline, _ticket))
+        return TRUE;
+
+    //the ticket may belong to the batch still being recorded
+    if(_uploader->recording && _ticket >= _uploader->batches[_uploader->currentBatch].signalValue)
+        VulkanUploaderSubmit(_context, _uploader);
+
+    return VulkanTimelineWait(_context, &_uploader->timeline, _ticket, _timeoutNS);
+}
+
+u64 VulkanUploaderCollectAcquires(VulkanContext* _context, VulkanUploader* _uploader, VulkanStagingRing* _ring)
+{
+    //nothing submitted since the last hand off, skip the driver query
+    if(_uploader->timeline.pendingValue <= _uploader->acquiredValue)
+        return 0;
+
+    u64 completedValue = VulkanTimelineQuery(_context, &_uploader->timeline);
+    if(completedValue <= _uploader->acquiredValue)
+        return 0;
+
+    RetireUploadBatches(_context, _uploader);
+
+    //acquire barriers are recorded by the ring, make sure this frame's slot is open even without ring uploads
+    if(DArrayLength(_ring->pendingAcquires) > 0)
+        VulkanStagingRingGetCommandBuffer(_context, _ring);
+
+    _uploader->acquiredValue = completedValue;
+    return completedValue;
+}
+
+VulkanUploadBatch* BeginUploadBatch(VulkanContext* _context, VulkanUploader* _uploader)
+{
+    VulkanUploadBatch* batch = &_uploader->batches[_uploader->currentBatch];
+    if(_uploader->recording)
+        return batch;
+
+    //only blocks when every batch is still in flight
+    if(batch->signalValue > _uploader->timeline.completedValue)
+    {
+        LOG_DEBUG("All upload batches in flight, waiting for batch %llu.", batch->signalValue);
+        VulkanUploaderWait(_context, _uploader, batch->signalValue, UINT64_MAX);
+    }
+
+    //acquires of a batch that completed between frames still have to reach the graphics queue
+    if(DArrayLength(batch->acquires) > 0)
+        RetireUploadBatches(_context, _uploader);
+
+    VK_CHECK(vkResetCommandBuffer(batch->commandBuffer.handle, 0));
+    VulkanCommandBufferReset(&batch->commandBuffer);
+    VulkanCommandBufferBegin(&batch->commandBuffer, TRUE, FALSE, FALSE);
+
+    batch->stagingUsed = 0;
+    batch->signalValue = VulkanTimelineNextValue(&_uploader->timeline);
+    _uploader->recording = TRUE;
+
+    return batch;
+}
+
+void RetireUploadBatches(VulkanContext* _context, VulkanUploader* _uploader)
+{
+    VulkanStagingRing* ring = &_context->stagingRing;
+
+    for(u32 i = 0; i < VULKAN_UPLOAD_BATCH_COUNT; ++i)
+    {
+        VulkanUploadBatch* batch = &_uploader->batches[i];
+        if(batch->signalValue > _uploader->timeline.completedValue)
+            continue;
+
+        u64 count = DArrayLength(batch->acquires);
+        for(u64 j = 0; j < count; ++j)
+            DArrayPush(ring->pendingAcquires, batch->acquires[j]);
+
+        DArrayClear(batch->acquires);
+    }
+}
\ No newline at end of file
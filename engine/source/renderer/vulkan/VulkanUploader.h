@@ -0,0 +1,41 @@
+#pragma once
+
+#include "VulkanTypes.inl"
+
+/**
+ * Asynchronous uploads for content streaming. Copies are batched into command buffers from the
+ * uploader's own transfer pool and submitted on the transfer queue, each submit signals a timeline
+ * semaphore. Tickets returned by the enqueue functions are timeline values, so completion can be
+ * polled without waiting on any queue.
+ */
+b8 VulkanUploaderCreate(VulkanContext* _context, VulkanUploader* _outUploader);
+
+void VulkanUploaderDestroy(VulkanContext* _context, VulkanUploader* _uploader);
+
+/**
+ * Queues a copy of _data into _buffer. Data larger than a batch is split across several batches.
+ * @returns a ticket to poll with VulkanUploaderIsComplete, 0 on failure.
+ */
+u64 VulkanUploaderEnqueueBuffer(
+    VulkanContext* _context,
+    VulkanUploader* _uploader,
+    VulkanBuffer* _buffer,
+    u64 _offset,
+    u64 _size,
+    const void* _data);
+
+//submits the batch being recorded, if any. Called once per frame by the backend.
+void VulkanUploaderSubmit(VulkanContext* _context, VulkanUploader* _uploader);
+
+//non-blocking, TRUE once the upload identified by _ticket has finished on the device
+b8 VulkanUploaderIsComplete(VulkanContext* _context, VulkanUploader* _uploader, u64 _ticket);
+
+//blocks until _ticket completes or the timeout elapses, submitting its batch first if needed
+b8 VulkanUploaderWait(VulkanContext* _context, VulkanUploader* _uploader, u64 _ticket, u64 _timeoutNS);
+
+/**
+ * Hands the acquire barriers of completed batches to the staging ring, so they run on the graphics
+ * queue ahead of this frame's commands.
+ * @returns the timeline value the graphics submission must wait on, 0 if nothing completed since the last call.
+ */
+u64 VulkanUploaderCollectAcquires(VulkanContext* _context, VulkanUploader* _uploader, VulkanStagingRing* _ring);
\ No newline at end of file
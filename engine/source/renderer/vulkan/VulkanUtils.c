@@ -133,4 +133,18 @@ b8 VulkanResultIsSuccess(VkResult _result)
         case VK_ERROR_UNKNOWN:
             return FALSE;
     }
+}
+
+u64 VulkanHashBytes(const void* _data, u64 _size, u64 _seed)
+{
+    //64 bit FNV-1a
+    const u8* data = (const u8*)_data;
+    u64 hash = _seed;
+    for(u64 i = 0; i < _size; ++i)
+    {
+        hash ^= data[i];
+        hash *= 0x100000001B3ull;
+    }
+
+    return hash;
 }
\ No newline at end of file
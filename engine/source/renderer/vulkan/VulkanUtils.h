@@ -14,4 +14,9 @@ const char* VulkanResultString(VkResult _result, b8 _getExtended);
  * Inticates if the passed result is a success or an error as defined by the Vulkan spec.
  * @returns True if success; otherwise false. Defaults to true for unknown result types.
  */
-b8 VulkanResultIsSuccess(VkResult _result);
\ No newline at end of file
+b8 VulkanResultIsSuccess(VkResult _result);
+
+//64 bit FNV-1a offset basis, pass a previous hash as _seed to continue it over more data
+#define VULKAN_HASH_SEED 0xCBF29CE484222325ull
+
+u64 VulkanHashBytes(const void* _data, u64 _size, u64 _seed);
\ No newline at end of file
@@ -0,0 +1,520 @@
+#include "scene/Transform.h"
+
+#include "core/Logger.h"
+#include "core/CMemory.h"
+#include "core/Job.h"
+
+#include "containers/DArray.h"
+
+void* TransformResizeArray(void* _array, u64 _stride, u32 _count, u32 _oldCapacity, u32 _newCapacity);
+b8 TransformGrow(TransformHierarchy* _hierarchy);
+u32 TransformLookup(const TransformHierarchy* _hierarchy, u32 _id);
+void TransformMarkDirty(TransformHierarchy* _hierarchy, u32 _index);
+void TransformMoveNode(TransformHierarchy* _hierarchy, u32 _dst, u32 _src);
+void TransformPermute(void* _array, u64 _stride, const u32* _order, u32 _count, void* _scratch);
+void TransformRebuildOrder(TransformHierarchy* _hierarchy);
+void TransformUpdateJobRun(void* _data, u32 _index, u32 _threadIndex);
+
+//nodes per job of the parallel update, levels smaller than two jobs are not worth waking the workers for
+#define TRANSFORM_UPDATE_BATCH 1024
+
+typedef struct TransformUpdateJob
+{
+    TransformHierarchy* hierarchy;
+    u32 first;
+    u32 count;
+} TransformUpdateJob;
+
+b8 TransformHierarchyCreate(u32 _capacity, TransformHierarchy* _outHierarchy)
+{
+    cZeroMemory(_outHierarchy, sizeof(TransformHierarchy));
+    _outHierarchy->levelStarts = DArrayCreate(u32);
+    _outHierarchy->indices = DArrayReserve(u32, _capacity > 0 ? _capacity : 1);
+    _outHierarchy->freeIds = DArrayCreate(u32);
+    _outHierarchy->firstDirtyLevel = TRANSFORM_INVALID_ID;
+
+    //the level table always ends with count, even for an empty hierarchy
+    DArrayPush(_outHierarchy->levelStarts, (u32)0);
+
+    _outHierarchy->capacity = 0;
+    while(_outHierarchy->capacity < _capacity)
+    {
+        if(!TransformGrow(_outHierarchy))
+        {
+            TransformHierarchyDestroy(_outHierarchy);
+            return FALSE;
+        }
+    }
+
+    return TRUE;
+}
+
+void TransformHierarchyDestroy(TransformHierarchy* _hierarchy)
+{
+    u32 capacity = _hierarchy->capacity;
+    if(capacity > 0)
+    {
+        cFree(_hierarchy->positions, sizeof(Vec3) * capacity, MEMORY_TAG_TRANSFORM);
+        cFree(_hierarchy->rotations, sizeof(Quat) * capacity, MEMORY_TAG_TRANSFORM);
+        cFree(_hierarchy->scales, sizeof(Vec3) * capacity, MEMORY_TAG_TRANSFORM);
+        cFree(_hierarchy->worlds, sizeof(Mat4) * capacity, MEMORY_TAG_TRANSFORM);
+        cFree(_hierarchy->parents, sizeof(u32) * capacity, MEMORY_TAG_TRANSFORM);
+        cFree(_hierarchy->parentIds, sizeof(u32) * capacity, MEMORY_TAG_TRANSFORM);
+        cFree(_hierarchy->ids, sizeof(u32) * capacity, MEMORY_TAG_TRANSFORM);
+        cFree(_hierarchy->depths, sizeof(u32) * capacity, MEMORY_TAG_TRANSFORM);
+        cFree(_hierarchy->dirty, sizeof(u8) * capacity, MEMORY_TAG_TRANSFORM);
+    }
+
+    if(_hierarchy->levelStarts)
+        DArrayDestroy(_hierarchy->levelStarts);
+    if(_hierarchy->indices)
+        DArrayDestroy(_hierarchy->indices);
+    if(_hierarchy->freeIds)
+        DArrayDestroy(_hierarchy->freeIds);
+
+    cZeroMemory(_hierarchy, sizeof(TransformHierarchy));
+}
+
+u32 TransformCreate(TransformHierarchy* _hierarchy, u32 _parent)
+{
+    if(_parent != TRANSFORM_INVALID_ID && TransformLookup(_hierarchy, _parent) == TRANSFORM_INVALID_ID)
+        return TRANSFORM_INVALID_ID;
+
+    if(_hierarchy->count == _hierarchy->capacity && !TransformGrow(_hierarchy))
+    {
+        LOG_ERROR("TransformCreate: failed to grow the hierarchy past %u nodes.", _hierarchy->capacity);
+        return TRANSFORM_INVALID_ID;
+    }
+
+    u32 id;
+    u32 index = _hierarchy->count++;
+    if(DArrayLength(_hierarchy->freeIds) > 0)
+    {
+        DArrayPop(_hierarchy->freeIds, &id);
+        _hierarchy->indices[id] = index;
+    }
+    else
+    {
+        id = (u32)DArrayLength(_hierarchy->indices);
+        DArrayPush(_hierarchy->indices, index);
+    }
+
+    _hierarchy->positions[index] = Vec3Zero();
+    _hierarchy->rotations[index] = QuatIdentity();
+    _hierarchy->scales[index] = Vec3One();
+    _hierarchy->worlds[index] = Mat4Identity();
+    _hierarchy->parents[index] = TRANSFORM_INVALID_ID;
+    _hierarchy->parentIds[index] = _parent;
+    _hierarchy->ids[index] = id;
+    _hierarchy->depths[index] = 0;
+    _hierarchy->dirty[index] = TRUE;
+
+    //the depth is not known until the order is rebuilt
+    _hierarchy->orderDirty = TRUE;
+    return id;
+}
+
+void TransformDestroy(TransformHierarchy* _hierarchy, u32 _id)
+{
+    u32 index = TransformLookup(_hierarchy, _id);
+    if(index == TRANSFORM_INVALID_ID)
+        return;
+
+    u32 parent = _hierarchy->parentIds[index];
+    for(u32 i = 0; i < _hierarchy->count; ++i)
+    {
+        if(_hierarchy->parentIds[i] == _id)
+        {
+            _hierarchy->parentIds[i] = parent;
+            _hierarchy->dirty[i] = TRUE;
+        }
+    }
+
+    //swap the last node into the hole, the rebuild puts it back in depth order
+    u32 last = --_hierarchy->count;
+    if(index != last)
+    {
+        TransformMoveNode(_hierarchy, index, last);
+        _hierarchy->indices[_hierarchy->ids[index]] = index;
+    }
+
+    _hierarchy->indices[_id] = TRANSFORM_INVALID_ID;
+    DArrayPush(_hierarchy->freeIds, _id);
+    _hierarchy->orderDirty = TRUE;
+}
+
+b8 TransformSetParent(TransformHierarchy* _hierarchy, u32 _id, u32 _parent)
+{
+    u32 index = TransformLookup(_hierarchy, _id);
+    if(index == TRANSFORM_INVALID_ID)
+        return FALSE;
+
+    //walk up from the new parent, meeting _id on the way would close a cycle
+    for(u32 ancestor = _parent; ancestor != TRANSFORM_INVALID_ID; )
+    {
+        if(ancestor == _id)
+        {
+            LOG_ERROR("TransformSetParent: %u is a descendant of %u.", _parent, _id);
+            return FALSE;
+        }
+
+        u32 ancestorIndex = TransformLookup(_hierarchy, ancestor);
+        if(ancestorIndex == TRANSFORM_INVALID_ID)
+            return FALSE;
+
+        ancestor = _hierarchy->parentIds[ancestorIndex];
+    }
+
+    if(_hierarchy->parentIds[index] == _parent)
+        return TRUE;
+
+    _hierarchy->parentIds[index] = _parent;
+    _hierarchy->dirty[index] = TRUE;
+    _hierarchy->orderDirty = TRUE;
+    return TRUE;
+}
+
+u32 TransformGetParent(const TransformHierarchy* _hierarchy, u32 _id)
+{
+    u32 index = TransformLookup(_hierarchy, _id);
+    return index == TRANSFORM_INVALID_ID ? TRANSFORM_INVALID_ID : _hierarchy->parentIds[index];
+}
+
+void TransformSetPosition(TransformHierarchy* _hierarchy, u32 _id, Vec3 _position)
+{
+    u32 index = TransformLookup(_hierarchy, _id);
+    if(index == TRANSFORM_INVALID_ID)
+        return;
+
+    _hierarchy->positions[index] = _position;
+    TransformMarkDirty(_hierarchy, index);
+}
+
+void TransformSetRotation(TransformHierarchy* _hierarchy, u32 _id, Quat _rotation)
+{
+    u32 index = TransformLookup(_hierarchy, _id);
+    if(index == TRANSFORM_INVALID_ID)
+        return;
+
+    _hierarchy->rotations[index] = _rotation;
+    TransformMarkDirty(_hierarchy, index);
+}
+
+void TransformSetScale(TransformHierarchy* _hierarchy, u32 _id, Vec3 _scale)
+{
+    u32 index = TransformLookup(_hierarchy, _id);
+    if(index == TRANSFORM_INVALID_ID)
+        return;
+
+    _hierarchy->scales[index] = _scale;
+    TransformMarkDirty(_hierarchy, index);
+}
+
+void TransformSetLocal(TransformHierarchy* _hierarchy, u32 _id, Vec3 _position, Quat _rotation, Vec3 _scale)
+{
+    u32 index = TransformLookup(_hierarchy, _id);
+    if(index == TRANSFORM_INVALID_ID)
+        return;
+
+    _hierarchy->positions[index] = _position;
+    _hierarchy->rotations[index] = _rotation;
+    _hierarchy->scales[index] = _scale;
+    TransformMarkDirty(_hierarchy, index);
+}
+
+Vec3 TransformGetPosition(const TransformHierarchy* _hierarchy, u32 _id)
+{
+    u32 index = TransformLookup(_hierarchy, _id);
+    return index == TRANSFORM_INVALID_ID ? Vec3Zero() : _hierarchy->positions[index];
+}
+
+Quat TransformGetRotation(const TransformHierarchy* _hierarchy, u32 _id)
+{
+    u32 index = TransformLookup(_hierarchy, _id);
+    return index == TRANSFORM_INVALID_ID ? QuatIdentity() : _hierarchy->rotations[index];
+}
+
+Vec3 TransformGetScale(const TransformHierarchy* _hierarchy, u32 _id)
+{
+    u32 index = TransformLookup(_hierarchy, _id);
+    return index == TRANSFORM_INVALID_ID ? Vec3One() : _hierarchy->scales[index];
+}
+
+const Mat4* TransformGetWorld(const TransformHierarchy* _hierarchy, u32 _id)
+{
+    u32 index = TransformLookup(_hierarchy, _id);
+    return index == TRANSFORM_INVALID_ID ? 0 : &_hierarchy->worlds[index];
+}
+
+void TransformHierarchyUpdate(TransformHierarchy* _hierarchy)
+{
+    u32 level = TransformHierarchyBeginUpdate(_hierarchy);
+    if(level == TransformHierarchyGetLevelCount(_hierarchy))
+        return;
+
+    //levels are contiguous and in order, so the rest of the hierarchy is one range
+    u32 first = _hierarchy->levelStarts[level];
+    TransformHierarchyUpdateRange(_hierarchy, first, _hierarchy->count - first);
+    TransformHierarchyEndUpdate(_hierarchy);
+}
+
+void TransformHierarchyUpdateParallel(TransformHierarchy* _hierarchy)
+{
+    u32 levelCount = TransformHierarchyGetLevelCount(_hierarchy);
+    u32 level = TransformHierarchyBeginUpdate(_hierarchy);
+    if(level == levelCount)
+        return;
+
+    //runs of small levels are updated as one range on this thread, only large levels go to the workers
+    u32 inlineFirst = _hierarchy->levelStarts[level];
+    for(; level < levelCount; ++level)
+    {
+        u32 first, count;
+        TransformHierarchyGetLevel(_hierarchy, level, &first, &count);
+        if(count < TRANSFORM_UPDATE_BATCH * 2)
+            continue;
+
+        if(first > inlineFirst)
+            TransformHierarchyUpdateRange(_hierarchy, inlineFirst, first - inlineFirst);
+
+        //returns once the whole level is done, so the next level sees final parents
+        TransformUpdateJob job = { _hierarchy, first, count };
+        JobRunParallel(TransformUpdateJobRun, &job, (count + TRANSFORM_UPDATE_BATCH - 1) / TRANSFORM_UPDATE_BATCH);
+        inlineFirst = first + count;
+    }
+
+    if(_hierarchy->count > inlineFirst)
+        TransformHierarchyUpdateRange(_hierarchy, inlineFirst, _hierarchy->count - inlineFirst);
+
+    TransformHierarchyEndUpdate(_hierarchy);
+}
+
+u32 TransformHierarchyBeginUpdate(TransformHierarchy* _hierarchy)
+{
+    if(_hierarchy->orderDirty)
+        TransformRebuildOrder(_hierarchy);
+
+    u32 levelCount = TransformHierarchyGetLevelCount(_hierarchy);
+    return _hierarchy->firstDirtyLevel < levelCount ? _hierarchy->firstDirtyLevel : levelCount;
+}
+
+u32 TransformHierarchyGetLevelCount(const TransformHierarchy* _hierarchy)
+{
+    return (u32)DArrayLength(_hierarchy->levelStarts) - 1;
+}
+
+void TransformHierarchyGetLevel(const TransformHierarchy* _hierarchy, u32 _level, u32* _outFirst, u32* _outCount)
+{
+    *_outFirst = _hierarchy->levelStarts[_level];
+    *_outCount = _hierarchy->levelStarts[_level + 1] - _hierarchy->levelStarts[_level];
+}
+
+void TransformHierarchyUpdateRange(TransformHierarchy* _hierarchy, u32 _first, u32 _count)
+{
+    const Vec3* positions = _hierarchy->positions;
+    const Quat* rotations = _hierarchy->rotations;
+    const Vec3* scales = _hierarchy->scales;
+    const u32* parents = _hierarchy->parents;
+    Mat4* worlds = _hierarchy->worlds;
+    u8* dirty = _hierarchy->dirty;
+
+    u32 end = _first + _count;
+    for(u32 i = _first; i < end; ++i)
+    {
+        //parents always sit at lower indices, so their flag and world matrix are final here
+        u32 parent = parents[i];
+        if(parent != TRANSFORM_INVALID_ID)
+            dirty[i] |= dirty[parent];
+
+        if(!dirty[i])
+            continue;
+
+        Mat4 local = Mat4FromTRS(positions[i], rotations[i], scales[i]);
+        worlds[i] = parent == TRANSFORM_INVALID_ID ? local : Mat4Mul(&worlds[parent], &local);
+    }
+}
+
+void TransformHierarchyEndUpdate(TransformHierarchy* _hierarchy)
+{
+    if(_hierarchy->firstDirtyLevel == TRANSFORM_INVALID_ID)
+        return;
+
+    u32 first = _hierarchy->levelStarts[_hierarchy->firstDirtyLevel];
+    cZeroMemory(&_hierarchy->dirty[first], _hierarchy->count - first);
+    _hierarchy->firstDirtyLevel = TRANSFORM_INVALID_ID;
+}
+
+void TransformUpdateJobRun(void* _data, u32 _index, u32 _threadIndex)
+{
+    TransformUpdateJob* job = (TransformUpdateJob*)_data;
+    u32 first = job->first + _index * TRANSFORM_UPDATE_BATCH;
+    u32 end = job->first + job->count;
+    u32 count = end - first < TRANSFORM_UPDATE_BATCH ? end - first : TRANSFORM_UPDATE_BATCH;
+    TransformHierarchyUpdateRange(job->hierarchy, first, count);
+}
+
+void* TransformResizeArray(void* _array, u64 _stride, u32 _count, u32 _oldCapacity, u32 _newCapacity)
+{
+    void* result = cAllocate(_stride * _newCapacity, MEMORY_TAG_TRANSFORM);
+    if(_array)
+    {
+        cCopyMemory(result, _array, _stride * _count);
+        cFree(_array, _stride * _oldCapacity, MEMORY_TAG_TRANSFORM);
+    }
+
+    return result;
+}
+
+b8 TransformGrow(TransformHierarchy* _hierarchy)
+{
+    u32 oldCapacity = _hierarchy->capacity;
+    if(oldCapacity >= 0x80000000)
+        return FALSE;
+
+    u32 newCapacity = oldCapacity > 0 ? oldCapacity * 2 : 64;
+    u32 count = _hierarchy->count;
+
+    _hierarchy->positions = TransformResizeArray(_hierarchy->positions, sizeof(Vec3), count, oldCapacity, newCapacity);
+    _hierarchy->rotations = TransformResizeArray(_hierarchy->rotations, sizeof(Quat), count, oldCapacity, newCapacity);
+    _hierarchy->scales = TransformResizeArray(_hierarchy->scales, sizeof(Vec3), count, oldCapacity, newCapacity);
+    _hierarchy->worlds = TransformResizeArray(_hierarchy->worlds, sizeof(Mat4), count, oldCapacity, newCapacity);
+    _hierarchy->parents = TransformResizeArray(_hierarchy->parents, sizeof(u32), count, oldCapacity, newCapacity);
+    _hierarchy->parentIds = TransformResizeArray(_hierarchy->parentIds, sizeof(u32), count, oldCapacity, newCapacity);
+    _hierarchy->ids = TransformResizeArray(_hierarchy->ids, sizeof(u32), count, oldCapacity, newCapacity);
+    _hierarchy->depths = TransformResizeArray(_hierarchy->depths, sizeof(u32), count, oldCapacity, newCapacity);
+    _hierarchy->dirty = TransformResizeArray(_hierarchy->dirty, sizeof(u8), count, oldCapacity, newCapacity);
+    _hierarchy->capacity = newCapacity;
+    return TRUE;
+}
+
+u32 TransformLookup(const TransformHierarchy* _hierarchy, u32 _id)
+{
+    if(_id >= DArrayLength(_hierarchy->indices) || _hierarchy->indices[_id] == TRANSFORM_INVALID_ID)
+    {
+        LOG_WARN("Transform %u does not exist.", _id);
+        return TRANSFORM_INVALID_ID;
+    }
+
+    return _hierarchy->indices[_id];
+}
+
+void TransformMarkDirty(TransformHierarchy* _hierarchy, u32 _index)
+{
+    _hierarchy->dirty[_index] = TRUE;
+
+    //while the order is dirty the depth is stale, the rebuild finds the first dirty level itself
+    if(!_hierarchy->orderDirty && _hierarchy->depths[_index] < _hierarchy->firstDirtyLevel)
+        _hierarchy->firstDirtyLevel = _hierarchy->depths[_index];
+}
+
+void TransformMoveNode(TransformHierarchy* _hierarchy, u32 _dst, u32 _src)
+{
+    _hierarchy->positions[_dst] = _hierarchy->positions[_src];
+    _hierarchy->rotations[_dst] = _hierarchy->rotations[_src];
+    _hierarchy->scales[_dst] = _hierarchy->scales[_src];
+    _hierarchy->worlds[_dst] = _hierarchy->worlds[_src];
+    _hierarchy->parentIds[_dst] = _hierarchy->parentIds[_src];
+    _hierarchy->ids[_dst] = _hierarchy->ids[_src];
+    _hierarchy->dirty[_dst] = _hierarchy->dirty[_src];
+}
+
+void TransformPermute(void* _array, u64 _stride, const u32* _order, u32 _count, void* _scratch)
+{
+    u8* src = _array;
+    u8* dst = _scratch;
+    for(u32 i = 0; i < _count; ++i)
+        cCopyMemory(dst + i * _stride, src + (u64)_order[i] * _stride, _stride);
+
+    cCopyMemory(_array, _scratch, _stride * _count);
+}
+
+void TransformRebuildOrder(TransformHierarchy* _hierarchy)
+{
+    u32 count = _hierarchy->count;
+    u32* depths = _hierarchy->depths;
+    u32* parentIds = _hierarchy->parentIds;
+    u32* indices = _hierarchy->indices;
+
+    DArrayClear(_hierarchy->levelStarts);
+    _hierarchy->orderDirty = FALSE;
+    _hierarchy->firstDirtyLevel = TRANSFORM_INVALID_ID;
+    if(count == 0)
+    {
+        DArrayPush(_hierarchy->levelStarts, (u32)0);
+        return;
+    }
+
+    u32* order = cAllocate(sizeof(u32) * count, MEMORY_TAG_TRANSFORM);
+    void* scratch = cAllocate(sizeof(Mat4) * count, MEMORY_TAG_TRANSFORM);
+
+    //children of every node as one packed list, filled backwards so siblings keep their order
+    u32* childStarts = scratch;
+    u32* children = childStarts + count + 1;
+    cZeroMemory(childStarts, sizeof(u32) * (count + 1));
+
+    u32 rootCount = 0;
+    for(u32 i = 0; i < count; ++i)
+    {
+        if(parentIds[i] == TRANSFORM_INVALID_ID)
+        {
+            order[rootCount++] = i;
+            depths[i] = 0;
+        }
+        else
+        {
+            childStarts[indices[parentIds[i]]]++;
+        }
+    }
+
+    for(u32 i = 1; i <= count; ++i)
+        childStarts[i] += childStarts[i - 1];
+    for(u32 i = count; i-- > 0; )
+    {
+        if(parentIds[i] != TRANSFORM_INVALID_ID)
+            children[--childStarts[indices[parentIds[i]]]] = i;
+    }
+
+    //breadth first from the roots. That sorts by depth and keeps siblings next to each other, so the
+    //update pass reads the parents of a level front to back
+    u32 tail = rootCount;
+    for(u32 head = 0; head < tail; ++head)
+    {
+        u32 node = order[head];
+        for(u32 child = childStarts[node]; child < childStarts[node + 1]; ++child)
+        {
+            depths[children[child]] = depths[node] + 1;
+            order[tail++] = children[child];
+        }
+    }
+
+    for(u32 i = 0; i < count; ++i)
+    {
+        if(i == 0 || depths[order[i]] != depths[order[i - 1]])
+            DArrayPush(_hierarchy->levelStarts, i);
+    }
+    DArrayPush(_hierarchy->levelStarts, count);
+
+    TransformPermute(_hierarchy->positions, sizeof(Vec3), order, count, scratch);
+    TransformPermute(_hierarchy->rotations, sizeof(Quat), order, count, scratch);
+    TransformPermute(_hierarchy->scales, sizeof(Vec3), order, count, scratch);
+    TransformPermute(_hierarchy->worlds, sizeof(Mat4), order, count, scratch);
+    TransformPermute(_hierarchy->parentIds, sizeof(u32), order, count, scratch);
+    TransformPermute(_hierarchy->ids, sizeof(u32), order, count, scratch);
+    TransformPermute(_hierarchy->depths, sizeof(u32), order, count, scratch);
+    TransformPermute(_hierarchy->dirty, sizeof(u8), order, count, scratch);
+
+    for(u32 i = 0; i < count; ++i)
+        indices[_hierarchy->ids[i]] = i;
+
+    for(u32 i = 0; i < count; ++i)
+    {
+        u32 parentId = parentIds[i];
+        _hierarchy->parents[i] = parentId == TRANSFORM_INVALID_ID ? TRANSFORM_INVALID_ID : indices[parentId];
+
+        if(_hierarchy->dirty[i] && depths[i] < _hierarchy->firstDirtyLevel)
+            _hierarchy->firstDirtyLevel = depths[i];
+    }
+
+    cFree(scratch, sizeof(Mat4) * count, MEMORY_TAG_TRANSFORM);
+    cFree(order, sizeof(u32) * count, MEMORY_TAG_TRANSFORM);
+}
\ No newline at end of file
@@ -0,0 +1,86 @@
+#pragma once
+
+#include "math/CMath.h"
+
+#define TRANSFORM_INVALID_ID 0xFFFFFFFF
+
+/**
+ * Local and world transforms of a scene graph, stored as structure of arrays and sorted by depth so
+ * every parent precedes its children. World matrices are rebuilt in one linear pass that starts at the
+ * first level holding a dirty node, a dirty node dirties its children as the pass reaches them.
+ * Ids are stable, dense indices change whenever the depth order is rebuilt.
+ */
+typedef struct TransformHierarchy
+{
+    u32 count;
+    u32 capacity;
+
+    //dense arrays, indexed in depth order
+    Vec3* positions;
+    Quat* rotations;
+    Vec3* scales;
+    Mat4* worlds;
+    //dense index of the parent, TRANSFORM_INVALID_ID for roots. Only valid while the order is not dirty
+    u32* parents;
+    u32* parentIds;
+    u32* ids;
+    u32* depths;
+    u8* dirty;
+
+    //darray, first dense index of every level followed by count
+    u32* levelStarts;
+    //darray, dense index of every id, TRANSFORM_INVALID_ID for destroyed ids
+    u32* indices;
+    //darray, destroyed ids to hand out again
+    u32* freeIds;
+
+    //set when nodes are created, destroyed or reparented, the order is rebuilt on the next update
+    b8 orderDirty;
+    //lowest level holding a dirty node, TRANSFORM_INVALID_ID when every world matrix is current
+    u32 firstDirtyLevel;
+} TransformHierarchy;
+
+CAPI b8 TransformHierarchyCreate(u32 _capacity, TransformHierarchy* _outHierarchy);
+CAPI void TransformHierarchyDestroy(TransformHierarchy* _hierarchy);
+
+//_parent can be TRANSFORM_INVALID_ID for a root. The new node starts at the identity
+CAPI u32 TransformCreate(TransformHierarchy* _hierarchy, u32 _parent);
+
+//children of a destroyed node are moved to its parent and keep their local transforms
+CAPI void TransformDestroy(TransformHierarchy* _hierarchy, u32 _id);
+
+//returns FALSE if _parent is _id or one of its descendants
+CAPI b8 TransformSetParent(TransformHierarchy* _hierarchy, u32 _id, u32 _parent);
+CAPI u32 TransformGetParent(const TransformHierarchy* _hierarchy, u32 _id);
+
+CAPI void TransformSetPosition(TransformHierarchy* _hierarchy, u32 _id, Vec3 _position);
+CAPI void TransformSetRotation(TransformHierarchy* _hierarchy, u32 _id, Quat _rotation);
+CAPI void TransformSetScale(TransformHierarchy* _hierarchy, u32 _id, Vec3 _scale);
+CAPI void TransformSetLocal(TransformHierarchy* _hierarchy, u32 _id, Vec3 _position, Quat _rotation, Vec3 _scale);
+
+CAPI Vec3 TransformGetPosition(const TransformHierarchy* _hierarchy, u32 _id);
+CAPI Quat TransformGetRotation(const TransformHierarchy* _hierarchy, u32 _id);
+CAPI Vec3 TransformGetScale(const TransformHierarchy* _hierarchy, u32 _id);
+
+//world matrix as of the last update
+CAPI const Mat4* TransformGetWorld(const TransformHierarchy* _hierarchy, u32 _id);
+
+//updates every dirty subtree on the calling thread
+CAPI void TransformHierarchyUpdate(TransformHierarchy* _hierarchy);
+
+//same as TransformHierarchyUpdate, large levels are spread over the job system one level at a time.
+//Must not be called from inside a job
+CAPI void TransformHierarchyUpdateParallel(TransformHierarchy* _hierarchy);
+
+/**
+ * Split form of TransformHierarchyUpdate for running the pass on several threads.
+ * BeginUpdate rebuilds the depth order if needed and returns the first level to update, or the level
+ * count when nothing is dirty. Every level from there on is then split into ranges that can run in
+ * parallel, but all ranges of a level must finish before any range of the next level starts.
+ * EndUpdate clears the dirty flags once every level is done.
+ */
+CAPI u32 TransformHierarchyBeginUpdate(TransformHierarchy* _hierarchy);
+CAPI u32 TransformHierarchyGetLevelCount(const TransformHierarchy* _hierarchy);
+CAPI void TransformHierarchyGetLevel(const TransformHierarchy* _hierarchy, u32 _level, u32* _outFirst, u32* _outCount);
+CAPI void TransformHierarchyUpdateRange(TransformHierarchy* _hierarchy, u32 _first, u32 _count);
+CAPI void TransformHierarchyEndUpdate(TransformHierarchy* _hierarchy);
\ No newline at end of file
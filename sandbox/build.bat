@@ -17,5 +17,8 @@ SET includeFlags=-Isource -I../engine/source/
 SET linkerFlags=-L../bin/ -lengine.lib
 SET defines=-D_DEBUG -DCIMPORT
 
+REM The inline math in the engine headers follows the engine's instruction set, see engine/build.bat
+IF "%CMATH_SIMD%"=="avx2" SET compilerFlags=%compilerFlags% -mavx2 -mfma
+
 ECHO "Building %assembly%%..."
 clang %cFilenames% %compilerFlags% -o ../bin/%assembly%.exe %defines% %includeFlags% %linkerFlags%
\ No newline at end of file
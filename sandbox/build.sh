@@ -17,6 +17,11 @@ includeFlags="-Isource -I../engine/source"
 linkerFlags="-L../bin/ -lengine -Wl,-rpath,."
 defines="-D_DEBUG -DCIMPORT"
 
+#the inline math in the engine headers follows the engine's instruction set, see engine/build.sh
+if [ "$CMATH_SIMD" = "avx2" ]; then
+    compilerFlags="$compilerFlags -mavx2 -mfma"
+fi
+
 echo "Building $assembly..."
 echo clang $cFilenames $compilerFlags -o ../bin/$assembly $defines $includeFlags $linkerFlags
 clang $cFilenames $compilerFlags -o ../bin/$assembly $defines $includeFlags $linkerFlags
\ No newline at end of file
@@ -13,6 +13,10 @@ b8 CreateGame(Game* _outGame)
     _outGame->appConfig.startWidth = 1280;
     _outGame->appConfig.startHeight = 720;
     _outGame->appConfig.name = "Cranbi Engine Sandbox";
+    _outGame->appConfig.renderer.presentMode = RENDERER_PRESENT_MODE_MAILBOX;
+    _outGame->appConfig.renderer.framesInFlight = 2;
+    _outGame->appConfig.renderer.swapchainImageCount = 0;
+    _outGame->appConfig.renderer.lowLatency = FALSE;
     _outGame->initialize = GameInitialize;
     _outGame->update = GameUpdate;
     _outGame->render = GameRender;